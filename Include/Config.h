@@ -31,11 +31,48 @@ private:
     std::string shoppingCartFilePath; // 购物车数据文件路径
     std::string ordersFilePath;     // 订单数据文件路径
     std::string promotionsFilePath; // 促销数据文件路径
+    std::string ordersArchiveFilePath; // 订单归档文件路径
+    std::string inventoryLedgerFilePath; // 库存流水文件路径
+    std::string couponCampaignsFilePath; // 优惠券活动文件路径
+    std::string couponCodesFilePath; // 优惠券码库文件路径
+    std::string couponRedemptionsFilePath; // 优惠券核销日志文件路径
+    std::string promotionUsageFilePath;    // 促销每人使用次数日志文件路径
+    std::string waitlistFilePath;          // 到货候补日志文件路径
+    std::string logFilePath;        // 日志文件路径
+    std::string logLevel;           // 日志级别（debug/info/warn/error）
     
     // 自动更新时间配置
     bool autoUpdateEnabled;         // 是否开启自动更新
     int pendingToShippedSeconds;    // 待发货到已发货的秒数
     int shippedToDeliveredSeconds;  // 已发货到已签收的秒数
+    
+    // 下单去重配置
+    int idempotencyTtlSeconds;      // 下单请求键的有效秒数
+    int idempotencyCapacity;        // 最多记录的下单请求数
+    
+    // 库存配置
+    int lowStockThreshold;          // 低库存预警阈值
+    int ledgerCheckpointInterval;   // 库存流水检查点间隔（记录条数）
+    int flashSaleShards;            // 秒杀商品的库存分片数（0表示按CPU核数）
+
+    // 热销排行配置
+    int leaderboardTopK;            // 每个榜单的名次数
+    bool leaderboardSketchEnabled;  // 是否使用Count-Min Sketch近似计数
+    int sketchWidth;                // Sketch每行的计数器数
+    int sketchDepth;                // Sketch行数
+
+    // 促销配置
+    std::string stackingPolicy;     // 满减叠加策略（stack_all/best_of/max_n）
+    int maxStackedReductions;       // 最多叠加的满减数（max_n策略）
+
+    // 准入控制配置
+    int searchConcurrency;          // 模糊搜索并发上限（0表示不限制）
+    int searchQueue;                // 模糊搜索排队数
+    int listingConcurrency;         // 商品列表并发上限
+    int listingQueue;               // 商品列表排队数
+    int reportConcurrency;          // 报表生成并发上限
+    int reportQueue;                // 报表生成排队数
+    int admissionWaitMs;            // 排队最长等待时间（毫秒）
 
     static Config* instance;        // 单例实例指针
     
@@ -113,6 +150,60 @@ public:
      * @return 促销数据文件路径
      */
     std::string getPromotionsFilePath() const { return promotionsFilePath; }
+    
+    /**
+     * @brief 获取订单归档文件路径
+     * @return 订单归档文件路径
+     */
+    std::string getOrdersArchiveFilePath() const { return ordersArchiveFilePath; }
+    
+    /**
+     * @brief 获取库存流水文件路径
+     * @return 库存流水文件路径
+     */
+    std::string getInventoryLedgerFilePath() const { return inventoryLedgerFilePath; }
+    
+    /**
+     * @brief 获取优惠券活动文件路径
+     * @return 优惠券活动文件路径
+     */
+    std::string getCouponCampaignsFilePath() const { return couponCampaignsFilePath; }
+    
+    /**
+     * @brief 获取优惠券码库文件路径
+     * @return 优惠券码库文件路径
+     */
+    std::string getCouponCodesFilePath() const { return couponCodesFilePath; }
+    
+    /**
+     * @brief 获取优惠券核销日志文件路径
+     * @return 优惠券核销日志文件路径
+     */
+    std::string getCouponRedemptionsFilePath() const { return couponRedemptionsFilePath; }
+    
+    /**
+     * @brief 获取促销每人使用次数日志文件路径
+     * @return 促销每人使用次数日志文件路径
+     */
+    std::string getPromotionUsageFilePath() const { return promotionUsageFilePath; }
+    
+    /**
+     * @brief 获取到货候补日志文件路径
+     * @return 到货候补日志文件路径
+     */
+    std::string getWaitlistFilePath() const { return waitlistFilePath; }
+    
+    /**
+     * @brief 获取日志文件路径
+     * @return 日志文件路径
+     */
+    std::string getLogFilePath() const { return logFilePath; }
+    
+    /**
+     * @brief 获取日志级别
+     * @return 日志级别字符串
+     */
+    std::string getLogLevel() const { return logLevel; }
 
     /**
      * @brief 获取是否开启自动更新
@@ -131,6 +222,114 @@ public:
      * @return 秒数
      */
     int getShippedToDeliveredSeconds() const { return shippedToDeliveredSeconds; }
+
+    /**
+     * @brief 获取下单请求键的有效秒数
+     * @return 秒数
+     */
+    int getIdempotencyTtlSeconds() const { return idempotencyTtlSeconds; }
+
+    /**
+     * @brief 获取最多记录的下单请求数
+     * @return 请求数
+     */
+    int getIdempotencyCapacity() const { return idempotencyCapacity; }
+
+    /**
+     * @brief 获取低库存预警阈值
+     * @return 阈值（库存小于该值视为低库存）
+     */
+    int getLowStockThreshold() const { return lowStockThreshold; }
+
+    /**
+     * @brief 获取库存流水检查点间隔
+     * @return 间隔（记录条数）
+     */
+    int getLedgerCheckpointInterval() const { return ledgerCheckpointInterval; }
+
+    /**
+     * @brief 获取秒杀商品的库存分片数
+     * @return 分片数（0表示按CPU核数）
+     */
+    int getFlashSaleShards() const { return flashSaleShards; }
+
+    /**
+     * @brief 获取热销榜名次数
+     * @return 名次数
+     */
+    int getLeaderboardTopK() const { return leaderboardTopK; }
+
+    /**
+     * @brief 获取热销榜是否使用Count-Min Sketch
+     * @return true使用近似计数，false精确计数
+     */
+    bool isLeaderboardSketchEnabled() const { return leaderboardSketchEnabled; }
+
+    /**
+     * @brief 获取Sketch每行的计数器数
+     * @return 计数器数
+     */
+    int getSketchWidth() const { return sketchWidth; }
+
+    /**
+     * @brief 获取Sketch行数
+     * @return 行数
+     */
+    int getSketchDepth() const { return sketchDepth; }
+
+    /**
+     * @brief 获取满减叠加策略
+     * @return 策略字符串（stack_all/best_of/max_n）
+     */
+    std::string getStackingPolicy() const { return stackingPolicy; }
+
+    /**
+     * @brief 获取最多叠加的满减数
+     * @return 满减数
+     */
+    int getMaxStackedReductions() const { return maxStackedReductions; }
+
+    /**
+     * @brief 获取模糊搜索的并发上限
+     * @return 上限（0表示不限制）
+     */
+    int getSearchConcurrency() const { return searchConcurrency; }
+
+    /**
+     * @brief 获取模糊搜索的排队数
+     * @return 排队数
+     */
+    int getSearchQueue() const { return searchQueue; }
+
+    /**
+     * @brief 获取商品列表的并发上限
+     * @return 上限（0表示不限制）
+     */
+    int getListingConcurrency() const { return listingConcurrency; }
+
+    /**
+     * @brief 获取商品列表的排队数
+     * @return 排队数
+     */
+    int getListingQueue() const { return listingQueue; }
+
+    /**
+     * @brief 获取报表生成的并发上限
+     * @return 上限（0表示不限制）
+     */
+    int getReportConcurrency() const { return reportConcurrency; }
+
+    /**
+     * @brief 获取报表生成的排队数
+     * @return 排队数
+     */
+    int getReportQueue() const { return reportQueue; }
+
+    /**
+     * @brief 获取准入排队的最长等待时间
+     * @return 毫秒
+     */
+    int getAdmissionWaitMs() const { return admissionWaitMs; }
     
     /**
      * @brief 析构函数
@@ -12,6 +12,8 @@
 #include "UserManage/User.h"
 #include "ItemManage/Item.h"
 
+class Order;
+
 /**
  * @brief 用于身份验证和路径的配置 Abstraction Provider
  */
@@ -37,6 +39,38 @@ public:
     virtual const std::vector<std::shared_ptr<Customer>>& getCustomers() const = 0;
 };
 
+/**
+ * @brief 商品变更类型
+ */
+enum class ItemChangeKind {
+    ADDED,
+    REMOVED,
+    PRICE,
+    STOCK,
+    DETAILS
+};
+
+/**
+ * @brief 商品变更监听者抽象，依赖商品数据的缓存通过它失效（每批变更只通知一次）
+ */
+class IItemChangeListener {
+public:
+    virtual ~IItemChangeListener() = default;
+    virtual void onItemsChanged(const std::vector<std::string>& itemIds, ItemChangeKind kind) = 0;
+};
+
+/**
+ * @brief 库存变动原因
+ */
+enum class StockMovementReason {
+    OPENING,
+    SALE,
+    ROLLBACK,
+    RESTOCK,
+    ADJUSTMENT,
+    IMPORT
+};
+
 /**
  * @brief 被搜索、订单、购物车和报表使用的商品仓库抽象
  */
@@ -49,8 +83,22 @@ public:
     virtual bool deleteItem(const std::string& itemId) = 0;
     virtual std::shared_ptr<Item> findItemById(const std::string& itemId) = 0;
     virtual std::vector<std::shared_ptr<Item>> getItemsByCategory(const std::string& category) = 0;
-    virtual const std::vector<std::shared_ptr<Item>>& getAllItems() const = 0;
+    virtual std::vector<std::shared_ptr<Item>> getAllItems() const = 0;
     virtual bool isItemIdExists(const std::string& itemId) const = 0;
+    virtual void refreshItemIndexes(const std::string& itemId) = 0;
+    virtual bool adjustStock(const std::string& itemId, int delta, StockMovementReason reason,
+                             const std::string& reference) = 0;
+    virtual void addChangeListener(IItemChangeListener* listener) = 0;
+    virtual void removeChangeListener(IItemChangeListener* listener) = 0;
+};
+
+/**
+ * @brief 订单事件观察者抽象，推荐、排行等派生数据通过它增量更新
+ */
+class IOrderObserver {
+public:
+    virtual ~IOrderObserver() = default;
+    virtual void onOrderCreated(const Order& order) = 0;
 };
 
 #endif // DEPENDENCY_INTERFACES_H
@@ -0,0 +1,202 @@
+/**
+ * @file FlashSaleStock.h
+ * @brief 秒杀库存（按分片拆分的热点商品库存计数）的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef FLASH_SALE_STOCK_H
+#define FLASH_SALE_STOCK_H
+
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <string>
+#include <atomic>
+#include <shared_mutex>
+#include <cstdint>
+
+/**
+ * @class ShardedStockCounter
+ * @brief 分片库存计数器：库存分散到多个缓存行对齐的原子分片，线程优先扣减自己的分片
+ *
+ * 特点：
+ * 1. 每个线程首次使用时分配一个固定的分片，不同线程的扣减落在不同缓存行上，互不争用
+ * 2. 本地分片不足时依次从其他分片窃取：每次取走对方剩余量的一半（至少取够所需），
+ *    多取的部分存入本地分片，之后的扣减又回到本地
+ * 3. 每个单位只会被一次CAS从某个分片中取走，分片总和从不小于0，因此不会超卖；
+ *    凑不够时把已取走的部分放回本地分片
+ */
+class ShardedStockCounter {
+private:
+    /**
+     * @struct Shard
+     * @brief 独占一个缓存行的分片
+     */
+    struct alignas(64) Shard {
+        std::atomic<int64_t> units{0};
+    };
+
+    std::unique_ptr<Shard[]> shards;    // 分片数组
+    size_t shardCount;                  // 分片数
+
+    /**
+     * @brief 当前线程对应的分片下标
+     */
+    size_t homeShard() const;
+
+    /**
+     * @brief 从分片中最多取走want个单位（至少取need个，不足need时不取）
+     * @return 实际取走的数量
+     */
+    static int64_t grab(Shard& shard, int64_t need, int64_t want);
+
+public:
+    /**
+     * @brief 构造函数
+     * @param total 总库存（平均分配到各分片）
+     * @param shardCount 分片数（0表示按CPU核数）
+     */
+    ShardedStockCounter(int64_t total, size_t shardCount);
+
+    /**
+     * @brief 扣减库存
+     * @param quantity 数量
+     * @return 扣减成功返回true，库存不足返回false（不扣减）
+     */
+    bool take(int64_t quantity);
+
+    /**
+     * @brief 归还库存（放入当前线程的分片）
+     * @param quantity 数量
+     */
+    void give(int64_t quantity);
+
+    /**
+     * @brief 剩余库存（各分片之和，并发修改时为近似值）
+     * @return 剩余库存
+     */
+    int64_t remaining() const;
+
+    /**
+     * @brief 获取分片数
+     * @return 分片数
+     */
+    size_t getShardCount() const { return shardCount; }
+};
+
+/**
+ * @struct FlashSaleStatus
+ * @brief 某个商品的秒杀状态
+ *
+ * 任意时刻 allotment = remaining + inFlight + committed
+ */
+struct FlashSaleStatus {
+    std::string itemId;         // 商品ID
+    int64_t allotment = 0;      // 秒杀配额
+    int64_t remaining = 0;      // 剩余配额
+    int64_t inFlight = 0;       // 已抢到、订单尚未完成的数量
+    int64_t committed = 0;      // 已成单（已从商品库存扣减）的数量
+    size_t shards = 0;          // 分片数
+};
+
+/**
+ * @class FlashSaleStock
+ * @brief 秒杀库存：为开启秒杀的商品维护分片计数器，作为下单前的抢购闸门
+ *
+ * 秒杀配额从商品当前库存中划出，但不修改Item::stock：
+ * 抢到配额（claim）只扣减分片计数；订单完成时由下单流程照常按单扣减商品库存，并记入commit；
+ * 订单失败时release把配额还回分片。因此商品库存始终精确等于已成单后的库存，
+ * 关闭秒杀时剩余配额自然并回商品库存，无需回写。
+ * 抢购闸门在调用线程中完成，配额售罄后的请求立即被拒绝，不进入下单队列
+ */
+class FlashSaleStock {
+private:
+    /**
+     * @struct Entry
+     * @brief 一个秒杀商品
+     */
+    struct Entry {
+        ShardedStockCounter counter;        // 剩余配额
+        int64_t allotment;                  // 配额
+        std::atomic<int64_t> inFlight;      // 抢到但未完成
+        std::atomic<int64_t> committed;     // 已成单
+
+        Entry(int64_t allotment, size_t shards)
+            : counter(allotment, shards), allotment(allotment), inFlight(0), committed(0) {}
+    };
+
+    mutable std::shared_mutex mutex;                                    // 商品表读写锁
+    std::unordered_map<std::string, std::shared_ptr<Entry>> entries;    // 商品ID -> 秒杀状态
+    size_t shardCount;                                                  // 每个商品的分片数
+
+    /**
+     * @brief 查找秒杀商品
+     */
+    std::shared_ptr<Entry> find(const std::string& itemId) const;
+
+    /**
+     * @brief 生成状态快照
+     */
+    static FlashSaleStatus snapshot(const std::string& itemId, const Entry& entry);
+
+public:
+    /**
+     * @brief 构造函数
+     * @param shardCount 每个商品的分片数（0表示按CPU核数）
+     */
+    explicit FlashSaleStock(size_t shardCount = 0);
+
+    /**
+     * @brief 开启秒杀
+     * @param itemId 商品ID
+     * @param allotment 秒杀配额（不应超过商品当前库存）
+     * @return 成功返回true，配额非正或商品已在秒杀中返回false
+     */
+    bool enable(const std::string& itemId, int64_t allotment);
+
+    /**
+     * @brief 关闭秒杀（进行中的订单不受影响）
+     * @param itemId 商品ID
+     * @param finalStatus 输出：关闭时的状态（可为空）
+     * @return 商品在秒杀中返回true，否则返回false
+     */
+    bool disable(const std::string& itemId, FlashSaleStatus* finalStatus = nullptr);
+
+    /**
+     * @brief 商品是否在秒杀中
+     * @param itemId 商品ID
+     * @return 在秒杀中返回true
+     */
+    bool isEnabled(const std::string& itemId) const;
+
+    /**
+     * @brief 抢购配额
+     * @param itemId 商品ID
+     * @param quantity 数量
+     * @return 抢到返回true，配额不足或商品不在秒杀中返回false
+     */
+    bool claim(const std::string& itemId, int quantity);
+
+    /**
+     * @brief 订单失败，归还配额
+     * @param itemId 商品ID
+     * @param quantity 数量
+     */
+    void release(const std::string& itemId, int quantity);
+
+    /**
+     * @brief 订单完成，配额已从商品库存扣减
+     * @param itemId 商品ID
+     * @param quantity 数量
+     */
+    void commit(const std::string& itemId, int quantity);
+
+    /**
+     * @brief 获取全部秒杀商品的状态
+     * @return 状态列表（按商品ID排序）
+     */
+    std::vector<FlashSaleStatus> getStatus() const;
+};
+
+#endif // FLASH_SALE_STOCK_H
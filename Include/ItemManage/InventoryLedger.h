@@ -0,0 +1,197 @@
+/**
+ * @file InventoryLedger.h
+ * @brief 库存流水账（只追加、定长记录）的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef INVENTORY_LEDGER_H
+#define INVENTORY_LEDGER_H
+
+#include "ItemManage/Item.h"
+#include "Interfaces/DependencyInterfaces.h"
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+#include <ctime>
+
+// 前向声明
+class Order;
+
+/**
+ * @struct LedgerRecord
+ * @brief 一条库存变动记录
+ */
+struct LedgerRecord {
+    time_t time = 0;                                    // 变动时间
+    std::string itemId;                                 // 商品ID（最长20字节）
+    int delta = 0;                                      // 库存变化量
+    int stockAfter = 0;                                 // 变动后的库存
+    StockMovementReason reason = StockMovementReason::ADJUSTMENT;  // 变动原因
+    std::string reference;                              // 关联单号（如订单编号，最长24字节）
+};
+
+/**
+ * @struct ReconcileEntry
+ * @brief 对账结果中不一致的一项
+ */
+struct ReconcileEntry {
+    std::string itemId;             // 商品ID
+    long long orderedQuantity;      // 订单中的销售数量
+    long long ledgerQuantity;       // 流水账中的净销售数量（销售减回滚）
+};
+
+/**
+ * @class InventoryLedger
+ * @brief 库存流水账，记录每一次库存变动，支持任意时刻的库存回溯和与订单对账
+ *
+ * 文件格式：8字节魔数后跟若干64字节定长记录
+ *   [0,8) 时间  [8,12) 变化量  [12,16) 变动后库存  [16] 原因  [17,20) 保留
+ *   [20,40) 商品ID  [40,64) 关联单号，整数均为小端序
+ *
+ * 特点：
+ * 1. 只追加不修改；定长记录可以按下标直接定位，记录时间单调不减，可按时间二分查找
+ * 2. 每隔固定条数在内存中保存一次检查点（只保存自上一个检查点以来变化过的商品库存），
+ *    打开文件时顺序扫描一遍重建；查询时刻T的库存只需读取
+ *    “T之前最近的检查点”到T之间的记录，该段没有此商品时再向前查找检查点
+ * 3. 对账时订单和流水记录分块并行汇总，再按商品合并比较
+ */
+class InventoryLedger {
+public:
+    static const size_t RECORD_SIZE = 64;       // 记录字节数
+    static const size_t HEADER_SIZE = 8;        // 文件头字节数
+
+private:
+    /**
+     * @struct Checkpoint
+     * @brief 检查点：前recordCount条记录应用后，自上一个检查点以来变化过的商品库存
+     */
+    struct Checkpoint {
+        uint64_t recordCount;                           // 已应用的记录数
+        time_t time;                                    // 最后一条已应用记录的时间
+        std::unordered_map<std::string, int> changed;   // 商品ID -> 库存（仅变化过的商品）
+    };
+
+    std::string filePath;                               // 流水账文件路径
+    size_t checkpointInterval;                          // 检查点间隔（记录条数）
+    std::ofstream writer;                               // 追加写入流
+    uint64_t recordCount;                               // 记录总数
+    time_t lastTime;                                    // 最后一条记录的时间
+    std::unordered_map<std::string, int> latestStock;   // 当前各商品在流水账中的库存
+    std::unordered_map<std::string, int> pendingChanges;  // 自上一个检查点以来变化过的商品库存
+    std::vector<Checkpoint> checkpoints;                // 检查点（按记录数升序）
+    mutable std::mutex mutex;                           // 互斥锁
+
+    /**
+     * @brief 追加一条记录（调用者需持有锁）
+     */
+    bool appendLocked(LedgerRecord record);
+
+    /**
+     * @brief 应用一条记录到内存状态，必要时生成检查点（调用者需持有锁）
+     */
+    void applyLocked(const LedgerRecord& record);
+
+    /**
+     * @brief 读取第index条记录
+     */
+    bool readRecord(std::ifstream& in, uint64_t index, LedgerRecord& record) const;
+
+    /**
+     * @brief 按顺序读取[begin, end)范围内的记录（分批读取）
+     * @param visitor 对每条记录调用的函数
+     * @return 读取成功返回true
+     */
+    template <typename Visitor>
+    bool scan(std::ifstream& in, uint64_t begin, uint64_t end, Visitor visitor) const;
+
+    /**
+     * @brief 计算时间不晚于at的记录条数（二分查找）
+     * @param count 输出的记录条数
+     * @return 读取成功返回true
+     */
+    bool countUntil(std::ifstream& in, time_t at, uint64_t& count) const;
+
+public:
+    /**
+     * @brief 构造函数
+     * @param filePath 流水账文件路径
+     * @param checkpointInterval 检查点间隔（记录条数）
+     */
+    InventoryLedger(const std::string& filePath, size_t checkpointInterval = 1000);
+
+    /**
+     * @brief 打开流水账：读取已有记录并重建检查点，再与当前商品库存对齐
+     *
+     * 流水账中没有的商品记一条期初记录；库存与流水账不一致的商品（如数据文件被手工修改）
+     * 记一条调整记录，保证之后的回溯结果与实际库存一致
+     *
+     * @param items 当前全部商品
+     * @return 打开成功返回true，否则返回false
+     */
+    bool open(const std::vector<std::shared_ptr<Item>>& items);
+
+    /**
+     * @brief 记录一次库存变动
+     * @param itemId 商品ID
+     * @param delta 变化量
+     * @param stockAfter 变动后的库存
+     * @param reason 变动原因
+     * @param reference 关联单号
+     * @return 写入成功返回true
+     */
+    bool record(const std::string& itemId, int delta, int stockAfter,
+                StockMovementReason reason, const std::string& reference);
+
+    /**
+     * @brief 查询某一时刻的商品库存
+     * @param itemId 商品ID
+     * @param at 时刻
+     * @param stock 输出的库存
+     * @param found 输出：该时刻商品是否已有记录
+     * @return 读取成功返回true，读取流水账文件失败返回false
+     */
+    bool stockAt(const std::string& itemId, time_t at, int& stock, bool& found) const;
+
+    /**
+     * @brief 获取商品在时间范围内的变动记录
+     * @param itemId 商品ID
+     * @param from 时间下界（含）
+     * @param to 时间上界（含）
+     * @param records 输出的变动记录（按时间升序）
+     * @return 读取成功返回true，读取流水账文件失败返回false
+     */
+    bool history(const std::string& itemId, time_t from, time_t to, std::vector<LedgerRecord>& records) const;
+
+    /**
+     * @brief 与订单对账：比较订单中的销售数量和流水账中的净销售数量
+     *
+     * 只统计流水账开始之后的订单；订单和流水记录分块并行汇总
+     *
+     * @param orders 订单列表
+     * @param mismatches 输出：数量不一致的商品
+     * @param threadCount 线程数（0表示使用硬件并发数）
+     * @return 读取成功返回true，读取流水账文件失败返回false
+     */
+    bool reconcile(const std::vector<std::shared_ptr<Order>>& orders,
+                   std::vector<ReconcileEntry>& mismatches, size_t threadCount = 0) const;
+
+    /**
+     * @brief 获取记录总数
+     * @return 记录数
+     */
+    uint64_t size() const;
+
+    /**
+     * @brief 获取变动原因的显示字符串
+     * @param reason 变动原因
+     * @return 显示字符串
+     */
+    static std::string reasonToString(StockMovementReason reason);
+};
+
+#endif // INVENTORY_LEDGER_H
@@ -10,6 +10,7 @@
 
 #include <string>
 #include <map>
+#include <atomic>
 
 /**
  * @class Item
@@ -25,7 +26,7 @@ private:
     std::string category;       // 商品类别
     double price;               // 商品价格
     std::string description;    // 商品描述
-    int stock;                  // 库存数量
+    std::atomic<int> stock;     // 库存数量（下单线程和界面线程并发读写）
 
 public:
     /**
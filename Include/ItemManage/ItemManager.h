@@ -10,14 +10,88 @@
 
 #include "ItemManage/Item.h"
 #include "Interfaces/DependencyInterfaces.h"
+#include "Services/QueryResults.h"
+#include "Services/SortedIndex.h"
+#include "ItemManage/StockWatch.h"
+#include "ItemManage/InventoryLedger.h"
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <memory>
 #include <string>
+#include <istream>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
 
 // 前向声明
 class PromotionManager;
 
+/**
+ * @struct ItemImportStats
+ * @brief 批量导入商品的统计结果
+ */
+struct ItemImportStats {
+    size_t totalRows = 0;           // 读取的数据行数（不含表头和空行）
+    size_t invalidRows = 0;         // 格式错误的行数
+    size_t duplicateRows = 0;       // 被同批次后续行覆盖的重复行数
+    size_t inserted = 0;            // 新增商品数
+    size_t updated = 0;             // 更新的已有商品数
+    bool saved = true;              // 数据文件是否保存成功
+    double elapsedSeconds = 0.0;    // 总耗时（秒）
+    double rowsPerSecond = 0.0;     // 吞吐量（行/秒）
+};
+
+/**
+ * @brief 批量导入进度回调，参数为已解析行数和总行数
+ */
+using ImportProgressCallback = std::function<void(size_t processed, size_t total)>;
+
+/**
+ * @struct ItemFilter
+ * @brief 批量更新的商品筛选条件（所有非空条件同时满足才命中）
+ */
+struct ItemFilter {
+    std::string category;                           // 商品类别（为空表示不限）
+    bool hasPriceRange = false;                     // 是否限定价格区间
+    double minPrice = 0.0;                          // 最低价格（含）
+    double maxPrice = 0.0;                          // 最高价格（含）
+    std::vector<std::string> itemIds;               // 商品ID列表（为空表示不限）
+    std::function<bool(const Item&)> predicate;     // 自定义谓词（可选）
+};
+
+/**
+ * @enum BulkUpdateField
+ * @brief 批量更新的字段
+ */
+enum class BulkUpdateField {
+    PRICE,          // 价格
+    STOCK           // 库存
+};
+
+/**
+ * @enum BulkUpdateOp
+ * @brief 批量更新的运算
+ */
+enum class BulkUpdateOp {
+    SET,            // 设为定值
+    SCALE,          // 乘以系数
+    ADD             // 加上增量（可为负）
+};
+
+/**
+ * @struct BulkUpdateStats
+ * @brief 批量更新的统计结果
+ */
+struct BulkUpdateStats {
+    size_t matched = 0;             // 命中的商品数
+    size_t changed = 0;             // 值实际发生变化的商品数
+    size_t clamped = 0;             // 库存超出int上限被截断的商品数
+    size_t rejected = 0;            // 结果不是有限数而保持原值的商品数
+    bool saved = true;              // 数据文件是否保存成功
+    double elapsedSeconds = 0.0;    // 总耗时（秒）
+};
+
 /**
  * @class ItemManager
  * @brief 商品管理器类，负责商品的增删改查和CSV文件操作
@@ -25,14 +99,34 @@ class PromotionManager;
  * 特点：
  * 1. 使用vector存储所有商品对象（顺序存储）
  * 2. 使用map<类别, vector<商品指针>>建立类别索引
- * 3. 支持动态表头，可由管理员自定义字段
+ * 3. 使用哈希表建立商品ID索引，按ID查找为O(1)
+ * 4. 维护价格、名称、库存三个有序索引，支持游标分页的排序列表
+ * 5. 维护当前最大的数字商品ID，生成新ID为O(1)
+ * 6. 支持从CSV批量导入（并行解析、一次性更新索引、一次性保存）
+ * 7. 支持按类别或谓词批量调整价格和库存（连续数组上统一运算、一次性保存）
+ * 8. 商品变更时通知已注册的监听者，批量操作每批只通知一次
+ * 9. 用索引最小堆监视库存，库存变化时O(log N)更新，支持低库存报表和预警回调
+ * 10. 启用库存流水账后，每次库存变动（销售、补货、调整、导入）都追加一条流水记录
+ * 11. 支持动态表头，可由管理员自定义字段
+ * 12. 读写锁保护商品列表、索引和文件写入，库存检查与扣减在同一把锁内完成；监听者在释放锁后收到通知
  */
 class ItemManager : public IItemRepository {
 private:
     std::vector<std::shared_ptr<Item>> items;           // 所有商品列表
     std::map<std::string, std::vector<std::shared_ptr<Item>>> categoryIndex;  // 类别索引
+    std::unordered_map<std::string, std::shared_ptr<Item>> itemById;         // 商品ID索引
+    std::unordered_map<std::string, std::string> indexedCategory;             // 商品在类别索引中的类别
+    SortedIndex<double> priceIndex;                     // 价格有序索引
+    SortedIndex<std::string> nameIndex;                 // 名称有序索引
+    SortedIndex<int> stockIndex;                        // 库存有序索引
+    StockWatch stockWatch;                              // 低库存监视器
+    std::unique_ptr<InventoryLedger> ledger;            // 库存流水账（未启用时为空）
+    long long maxNumericItemId;                         // 当前最大的数字商品ID
     std::vector<std::string> headers;                   // CSV表头（动态）
     std::string filePath;                               // 数据文件路径
+    std::vector<IItemChangeListener*> changeListeners;  // 商品变更监听者
+    mutable std::shared_mutex mutex;                    // 商品列表、索引和监听者列表的读写锁
+    std::mutex fileMutex;                               // 保存文件互斥（在mutex之后获取）
     
     /**
      * @brief 解析CSV行数据
@@ -56,10 +150,64 @@ private:
     void rebuildCategoryIndex();
     
     /**
-     * @brief 生成新的商品ID
-     * @return 新的唯一商品ID
+     * @brief 重建全部索引（ID索引、类别索引和排序索引）
      */
-    std::string generateNewItemId();
+    void rebuildIndexes();
+    
+    /**
+     * @brief 将商品写入ID索引和排序索引
+     * @param item 商品对象
+     */
+    void indexItem(const std::shared_ptr<Item>& item);
+    
+    /**
+     * @brief 从所有索引中移除商品
+     * @param item 商品对象
+     */
+    void unindexItem(const std::shared_ptr<Item>& item);
+    
+    /**
+     * @brief 若商品ID为数字，更新当前最大的数字商品ID
+     * @param itemId 商品ID
+     */
+    void noteItemId(const std::string& itemId);
+    
+    /**
+     * @brief 按商品当前值刷新排序索引和类别索引（不通知监听者）
+     * @param item 商品对象
+     * @return 发生变化的字段类型（价格、库存、其他信息）
+     */
+    std::vector<ItemChangeKind> reindexItem(const std::shared_ptr<Item>& item);
+    
+    /**
+     * @brief 收集满足筛选条件的商品
+     * @param filter 筛选条件
+     * @return 命中的商品（按商品列表顺序，不重复）
+     */
+    std::vector<std::shared_ptr<Item>> collectMatching(const ItemFilter& filter) const;
+    
+    /**
+     * @brief 通知所有监听者一批商品发生了变更（调用者不能持有mutex）
+     * @param itemIds 变更的商品ID
+     * @param kind 变更类型
+     */
+    void notifyItemsChanged(const std::vector<std::string>& itemIds, ItemChangeKind kind);
+    
+    /**
+     * @brief 库存已被直接修改后写入流水记录（未启用流水账或库存未变化时忽略）
+     * @param item 商品对象
+     * @param oldStock 修改前的库存
+     * @param reason 变动原因
+     * @param reference 关联单号
+     */
+    void recordStockChange(const std::shared_ptr<Item>& item, int oldStock,
+                           StockMovementReason reason, const std::string& reference);
+    
+    /**
+     * @brief 写入商品数据文件（调用者需持有mutex）
+     * @return 保存成功返回true，否则返回false
+     */
+    bool writeFile();
 
 public:
     /**
@@ -68,6 +216,102 @@ public:
      */
     ItemManager(const std::string& filePath);
     
+    /**
+     * @brief 生成新的商品ID（当前最大数字ID + 1）
+     * @return 新的唯一商品ID
+     */
+    std::string generateNewItemId() const;
+    
+    /**
+     * @brief 从CSV流批量导入商品（按商品ID插入或更新）
+     * 
+     * 处理流程：
+     * 1. 读取全部行后按线程数分块并行解析和校验
+     * 2. 按行号顺序用哈希表去重，同一ID以最后一行为准；ID为空的行自动分配新ID
+     * 3. 一次性更新所有索引，最后只保存一次文件；价格或库存变化的商品另按PRICE/STOCK通知
+     * 
+     * 行格式与商品数据文件相同：item_id,item_name,category,price,description,stock，
+     * 以item_id开头的首行视为表头并跳过
+     * 
+     * @param in 输入流
+     * @param progress 进度回调（可选，在调用线程中触发）
+     * @param threadCount 解析线程数（0表示使用硬件并发数）
+     * @return 导入统计
+     */
+    ItemImportStats bulkUpsertFromCSV(std::istream& in, const ImportProgressCallback& progress = nullptr,
+                                      size_t threadCount = 0);
+    
+    /**
+     * @brief 从CSV文件批量导入商品
+     * @param importPath CSV文件路径
+     * @param stats 输出的导入统计
+     * @param progress 进度回调（可选）
+     * @return 文件可读返回true，否则返回false
+     */
+    bool bulkUpsertFromFile(const std::string& importPath, ItemImportStats& stats,
+                            const ImportProgressCallback& progress = nullptr);
+    
+    /**
+     * @brief 按筛选条件批量调整价格或库存
+     * 
+     * 处理流程：
+     * 1. 通过类别索引、价格索引或ID索引缩小候选集，再按其余条件过滤
+     * 2. 把命中商品的字段值收集到连续数组，用无分支的统一公式 v = v * a + b 计算
+     *    （SET: a=0,b=x；SCALE: a=x,b=0；ADD: a=1,b=x），结果下限为0，便于编译器向量化
+     * 3. 写回商品并刷新索引，最后只保存一次文件、只通知一次监听者
+     * 
+     * 价格保留两位小数，库存四舍五入为整数，超过int上限时截断为上限并计入clamped；
+     * 溢出为inf或nan的结果不写入，商品保持原值并计入rejected
+     * 
+     * @param filter 筛选条件
+     * @param field 要调整的字段
+     * @param op 运算
+     * @param operand 运算参数
+     * @return 更新统计
+     */
+    BulkUpdateStats bulkUpdate(const ItemFilter& filter, BulkUpdateField field, BulkUpdateOp op, double operand);
+    
+    /**
+     * @brief 调整商品库存并写入流水记录
+     * 
+     * 检查和扣减在写锁内完成，调整后库存不能为负；
+     * 成功时刷新索引并通知监听者，但不保存文件（由调用者统一保存）
+     * 
+     * @param itemId 商品ID
+     * @param delta 变化量（销售为负，补货为正）
+     * @param reason 变动原因
+     * @param reference 关联单号（如订单编号）
+     * @return 调整成功返回true，商品不存在或库存不足返回false
+     */
+    bool adjustStock(const std::string& itemId, int delta, StockMovementReason reason,
+                     const std::string& reference) override;
+    
+    /**
+     * @brief 启用库存流水账（应在加载商品数据之后调用）
+     * @param ledgerPath 流水账文件路径
+     * @param checkpointInterval 检查点间隔（记录条数）
+     * @return 启用成功返回true，否则返回false
+     */
+    bool enableLedger(const std::string& ledgerPath, size_t checkpointInterval);
+    
+    /**
+     * @brief 获取库存流水账
+     * @return 流水账指针（未启用时为nullptr）
+     */
+    const InventoryLedger* getLedger() const { return ledger.get(); }
+    
+    /**
+     * @brief 注册商品变更监听者（不接管所有权）
+     * @param listener 监听者
+     */
+    void addChangeListener(IItemChangeListener* listener) override;
+    
+    /**
+     * @brief 注销商品变更监听者
+     * @param listener 监听者
+     */
+    void removeChangeListener(IItemChangeListener* listener) override;
+    
     /**
      * @brief 从CSV文件加载商品数据
      * @return 加载成功返回true，否则返回false
@@ -110,9 +354,9 @@ public:
     
     /**
      * @brief 获取所有商品列表
-     * @return 所有商品
+     * @return 所有商品（快照）
      */
-    const std::vector<std::shared_ptr<Item>>& getAllItems() const override { return items; }
+    std::vector<std::shared_ptr<Item>> getAllItems() const override;
     
     /**
      * @brief 获取所有类别
@@ -126,6 +370,62 @@ public:
      */
     const std::vector<std::string>& getHeaders() const { return headers; }
     
+    /**
+     * @brief 查询所有商品（不产生输出）
+     * @param promotionManager 促销管理器指针（可选，用于填充促销标签和满减活动）
+     * @return 商品列表快照
+     */
+    ItemListing queryItems(PromotionManager* promotionManager = nullptr) const;
+    
+    /**
+     * @brief 按排序字段分页查询商品
+     * 
+     * 基于有序索引的游标分页，每页代价为O(log N + limit)
+     * 
+     * @param sortKey 排序字段
+     * @param descending 是否降序
+     * @param cursor 上一页返回的游标（空字符串表示第一页）
+     * @param limit 每页数量
+     * @param promotionManager 促销管理器指针（可选，用于填充促销标签）
+     * @return 分页结果
+     */
+    ListPage<ItemRow> queryItemPage(ItemSortKey sortKey, bool descending, const std::string& cursor,
+                                    size_t limit, PromotionManager* promotionManager = nullptr) const;
+    
+    /**
+     * @brief 商品的价格、名称、库存或类别被直接修改后，刷新该商品的索引
+     * 
+     * 有字段发生变化时按变化类型通知监听者
+     * 
+     * @param itemId 商品ID
+     */
+    void refreshItemIndexes(const std::string& itemId) override;
+    
+    /**
+     * @brief 查询低库存商品（不产生输出）
+     * @param limit 库存小于该值的商品被返回（小于0时使用当前阈值）
+     * @return 商品行，按库存升序
+     */
+    std::vector<ItemRow> queryLowStock(int limit = -1) const;
+    
+    /**
+     * @brief 设置低库存阈值
+     * @param threshold 阈值
+     */
+    void setLowStockThreshold(int threshold) { stockWatch.setThreshold(threshold); }
+    
+    /**
+     * @brief 获取低库存阈值
+     * @return 阈值
+     */
+    int getLowStockThreshold() const { return stockWatch.getThreshold(); }
+    
+    /**
+     * @brief 设置低库存预警回调（库存跌破阈值或售罄时触发）
+     * @param callback 回调函数
+     */
+    void setLowStockAlert(LowStockCallback callback) { stockWatch.setAlertCallback(std::move(callback)); }
+    
     /**
      * @brief 显示所有商品信息（表格形式）
      * @param promotionManager 促销管理器指针（可选，用于显示促销标签）
@@ -10,6 +10,7 @@
 
 #include "ItemManage/Item.h"
 #include "Interfaces/DependencyInterfaces.h"
+#include "Services/AdmissionController.h"
 #include <vector>
 #include <memory>
 #include <string>
@@ -40,6 +41,31 @@ struct SearchResult {
         : item(item), similarityScore(score) {}
 };
 
+/**
+ * @enum SearchMatchKind
+ * @brief 综合搜索最终采用的匹配方式
+ */
+enum class SearchMatchKind {
+    EXACT_NAME,             ///< 名称精确匹配
+    CATEGORY,               ///< 类别精确匹配
+    PRICE_RANGE,            ///< 价格区间匹配
+    FUZZY,                  ///< 名称模糊匹配
+    DEGRADED,               ///< 精确匹配无结果，且模糊搜索未获准入（降级为只做精确搜索）
+    INVALID_PRICE_FORMAT,   ///< 价格区间格式错误
+    INVALID_PRICE_VALUE     ///< 价格无法解析
+};
+
+/**
+ * @struct SearchOutcome
+ * @brief 综合搜索的结果（不含任何输出，由调用方决定如何展示）
+ */
+struct SearchOutcome {
+    SearchMatchKind kind;               // 匹配方式
+    std::vector<SearchResult> results;  // 搜索结果
+    double minPrice;                    // 价格区间下界（仅PRICE_RANGE有效）
+    double maxPrice;                    // 价格区间上界（仅PRICE_RANGE有效）
+};
+
 /**
  * @class ItemSearcher
  * @brief 商品搜索类，提供多种搜索方式
@@ -48,10 +74,12 @@ struct SearchResult {
  * 1. 优先进行精确搜索
  * 2. 如果精确搜索无结果，自动进行模糊搜索
  * 3. 模糊搜索使用Levenshtein编辑距离算法计算相似度
+ * 4. 设置准入控制器后，模糊搜索需先获得准入，未获准入时降级为只返回精确搜索结果
  */
 class ItemSearcher {
 private:
     IItemRepository* itemManager;   // 商品管理器指针
+    AdmissionController* admission; // 准入控制器（可为空）
     
     /**
      * @brief 计算两个字符串的Levenshtein编辑距离
@@ -90,6 +118,12 @@ public:
      * @param itemManager 商品管理器指针
      */
     ItemSearcher(IItemRepository* itemManager);
+
+    /**
+     * @brief 设置准入控制器（模糊搜索按OperationClass::SEARCH申请准入）
+     * @param admission 准入控制器（为空表示不限制）
+     */
+    void setAdmissionController(AdmissionController* admission) { this->admission = admission; }
     
     /**
      * @brief 根据商品名称精确搜索
@@ -122,7 +156,15 @@ public:
     std::vector<SearchResult> fuzzySearchByName(const std::string& keyword, double threshold = 0.5);
     
     /**
-     * @brief 综合搜索（先精确后模糊）
+     * @brief 综合查询（先精确后模糊），只计算结果，不产生任何输出
+     * @param keyword 关键字
+     * @param searchType 搜索类型（使用SearchType枚举）
+     * @return 搜索结果及其匹配方式
+     */
+    SearchOutcome query(const std::string& keyword, SearchType searchType = SearchType::ALL);
+    
+    /**
+     * @brief 综合搜索（先精确后模糊），并在控制台输出匹配摘要
      * @param keyword 关键字
      * @param searchType 搜索类型（使用SearchType枚举）
      * @return 搜索结果列表
@@ -0,0 +1,126 @@
+/**
+ * @file StockWatch.h
+ * @brief 低库存监视器的定义（索引最小堆）
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef STOCK_WATCH_H
+#define STOCK_WATCH_H
+
+#include <vector>
+#include <unordered_map>
+#include <string>
+#include <utility>
+#include <functional>
+#include <mutex>
+
+/**
+ * @brief 低库存预警回调，参数为商品ID和当前库存
+ */
+using LowStockCallback = std::function<void(const std::string& itemId, int stock)>;
+
+/**
+ * @class StockWatch
+ * @brief 按库存维护的索引最小堆
+ *
+ * 特点：
+ * 1. 堆顶是库存最低的商品，另用哈希表记录每个商品在堆中的位置，
+ *    库存变化时原地上浮或下沉，每次更新为O(log N)
+ * 2. 低库存报表从堆顶开始遍历，遇到不低于阈值的节点即剪掉整棵子树，
+ *    代价只与命中数量有关，不需要全量扫描
+ * 3. 已有商品的库存从阈值以上降到阈值以下、或降为0时触发预警回调
+ * 4. 内部加锁，报表可以在其他线程读取
+ */
+class StockWatch {
+public:
+    using Entry = std::pair<int, std::string>;      // (库存, 商品ID)
+
+private:
+    std::vector<Entry> heap;                            // 堆数组
+    std::unordered_map<std::string, size_t> position;   // 商品ID -> 堆中位置
+    int threshold;                                      // 低库存阈值
+    LowStockCallback alertCallback;                     // 预警回调
+    mutable std::mutex mutex;                           // 互斥锁
+
+    /**
+     * @brief 交换堆中两个位置并更新位置表
+     */
+    void swapAt(size_t a, size_t b);
+
+    /**
+     * @brief 上浮
+     * @return 最终位置
+     */
+    size_t siftUp(size_t index);
+
+    /**
+     * @brief 下沉
+     */
+    void siftDown(size_t index);
+
+public:
+    /**
+     * @brief 构造函数
+     * @param threshold 低库存阈值（库存小于该值视为低库存）
+     */
+    explicit StockWatch(int threshold = 10);
+
+    /**
+     * @brief 插入或更新商品库存
+     * @param itemId 商品ID
+     * @param stock 当前库存
+     */
+    void update(const std::string& itemId, int stock);
+
+    /**
+     * @brief 移除商品
+     * @param itemId 商品ID
+     */
+    void remove(const std::string& itemId);
+
+    /**
+     * @brief 清空
+     */
+    void clear();
+
+    /**
+     * @brief 设置低库存阈值
+     * @param value 阈值
+     */
+    void setThreshold(int value);
+
+    /**
+     * @brief 获取低库存阈值
+     * @return 阈值
+     */
+    int getThreshold() const;
+
+    /**
+     * @brief 设置预警回调（在更新库存的线程中、锁外调用）
+     * @param callback 回调函数
+     */
+    void setAlertCallback(LowStockCallback callback);
+
+    /**
+     * @brief 获取库存低于阈值的商品
+     * @param limit 阈值（库存小于该值的商品被返回）
+     * @return (库存, 商品ID)，按库存升序
+     */
+    std::vector<Entry> below(int limit) const;
+
+    /**
+     * @brief 获取库存最低的商品
+     * @param entry 输出的(库存, 商品ID)
+     * @return 堆非空返回true
+     */
+    bool lowest(Entry& entry) const;
+
+    /**
+     * @brief 获取监视的商品数
+     * @return 商品数
+     */
+    size_t size() const;
+};
+
+#endif // STOCK_WATCH_H
@@ -0,0 +1,231 @@
+/**
+ * @file Logger.h
+ * @brief 异步结构化日志器的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <chrono>
+#include <initializer_list>
+#include <cstdint>
+
+/**
+ * @enum LogLevel
+ * @brief 日志级别枚举
+ */
+enum class LogLevel {
+    DEBUG,          // 调试信息
+    INFO,           // 一般信息
+    WARN,           // 警告
+    ERROR           // 错误
+};
+
+/**
+ * @struct LogField
+ * @brief 结构化日志字段（键值对）
+ */
+struct LogField {
+    std::string key;        // 字段名
+    std::string value;      // 字段值
+};
+
+/**
+ * @struct LogRecord
+ * @brief 一条日志记录
+ */
+struct LogRecord {
+    LogLevel level;                                     // 日志级别
+    std::chrono::system_clock::time_point timestamp;    // 记录时间
+    const char* component;                              // 产生日志的模块名（字符串常量）
+    std::string message;                                // 日志消息
+    std::vector<LogField> fields;                       // 结构化字段
+};
+
+/**
+ * @class Logger
+ * @brief 异步结构化日志器，将诊断信息与面向用户的控制台输出分离
+ *
+ * 特点：
+ * 1. 采用单例模式，提供全局唯一的日志访问点
+ * 2. 调用方把日志记录写入无锁环形缓冲区（多生产者、单消费者），不会阻塞在I/O上
+ * 3. 后台输出线程批量写入日志文件，每批只刷新一次
+ * 4. 缓冲区满时丢弃新记录并计数，保证业务线程永不等待
+ * 5. 未启动后台线程时，警告和错误级别的日志同步写到std::clog
+ * 6. 停止时先等待正在写入的调用方完成，再让后台线程输出剩余记录，已写入的记录不会丢失
+ */
+class Logger {
+private:
+    /**
+     * @struct Slot
+     * @brief 环形缓冲区槽位，sequence用于生产者与消费者之间的同步
+     */
+    struct Slot {
+        std::atomic<size_t> sequence;   // 槽位序号
+        LogRecord record;               // 日志记录
+    };
+
+    std::unique_ptr<Slot[]> ring;       // 环形缓冲区
+    size_t capacity;                    // 缓冲区容量（2的幂）
+    size_t mask;                        // 下标掩码
+    std::atomic<size_t> enqueuePos;     // 生产者写入位置
+    size_t dequeuePos;                  // 消费者读取位置（仅后台线程访问）
+
+    std::atomic<bool> running;          // 是否接受新记录
+    std::atomic<bool> sinkStopping;     // 通知后台线程做最后一次输出后退出
+    std::atomic<int> activeProducers;   // 正在写入缓冲区的调用方数量
+    std::thread sinkThread;             // 后台输出线程
+    std::ofstream sinkFile;             // 日志文件
+    std::atomic<int> minLevel;          // 最低输出级别
+    std::atomic<uint64_t> droppedCount; // 因缓冲区满而丢弃的记录数
+
+    /**
+     * @brief 私有构造函数，防止外部实例化
+     */
+    Logger();
+
+    /**
+     * @brief 尝试将记录写入环形缓冲区
+     * @param record 日志记录
+     * @return 写入成功返回true，缓冲区已满返回false
+     */
+    bool tryPush(LogRecord&& record);
+
+    /**
+     * @brief 尝试从环形缓冲区取出一条记录（仅后台线程调用）
+     * @param record 输出的日志记录
+     * @return 取到记录返回true，否则返回false
+     */
+    bool tryPop(LogRecord& record);
+
+    /**
+     * @brief 后台输出线程函数
+     */
+    void sinkLoop();
+
+    /**
+     * @brief 将日志记录格式化为一行文本
+     * @param record 日志记录
+     * @return 格式化后的文本（不含换行）
+     */
+    static std::string formatRecord(const LogRecord& record);
+
+    /**
+     * @brief 写出一个字段值（必要时加引号并转义）
+     * @param out 输出流
+     * @param value 字段值
+     */
+    static void appendValue(std::ostream& out, const std::string& value);
+
+public:
+    /**
+     * @brief 获取Logger单例实例
+     * @return Logger实例指针
+     */
+    static Logger* getInstance();
+
+    /**
+     * @brief 启动后台输出线程
+     * @param logFilePath 日志文件路径（以追加方式打开，目录不存在时自动创建）
+     * @param level 最低输出级别
+     * @param bufferCapacity 环形缓冲区容量（向上取整为2的幂）
+     * @return 启动成功返回true，否则返回false
+     */
+    bool start(const std::string& logFilePath, LogLevel level = LogLevel::INFO,
+               size_t bufferCapacity = 8192);
+
+    /**
+     * @brief 停止后台线程，输出缓冲区中剩余的记录并关闭文件
+     *
+     * 此后的日志按未启动处理
+     */
+    void stop();
+
+    /**
+     * @brief 写入一条日志
+     * @param level 日志级别
+     * @param component 模块名（需为字符串常量）
+     * @param message 日志消息
+     * @param fields 结构化字段
+     */
+    void log(LogLevel level, const char* component, std::string message,
+             std::initializer_list<LogField> fields = {});
+
+    /**
+     * @brief 写入调试日志
+     */
+    void debug(const char* component, std::string message, std::initializer_list<LogField> fields = {}) {
+        log(LogLevel::DEBUG, component, std::move(message), fields);
+    }
+
+    /**
+     * @brief 写入一般信息日志
+     */
+    void info(const char* component, std::string message, std::initializer_list<LogField> fields = {}) {
+        log(LogLevel::INFO, component, std::move(message), fields);
+    }
+
+    /**
+     * @brief 写入警告日志
+     */
+    void warn(const char* component, std::string message, std::initializer_list<LogField> fields = {}) {
+        log(LogLevel::WARN, component, std::move(message), fields);
+    }
+
+    /**
+     * @brief 写入错误日志
+     */
+    void error(const char* component, std::string message, std::initializer_list<LogField> fields = {}) {
+        log(LogLevel::ERROR, component, std::move(message), fields);
+    }
+
+    /**
+     * @brief 检查某个级别是否会被输出
+     * @param level 日志级别
+     * @return 会输出返回true
+     */
+    bool isEnabled(LogLevel level) const {
+        return static_cast<int>(level) >= minLevel.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 设置最低输出级别
+     * @param level 日志级别
+     */
+    void setLevel(LogLevel level) { minLevel.store(static_cast<int>(level)); }
+
+    /**
+     * @brief 获取因缓冲区满而丢弃的记录数
+     * @return 丢弃数量
+     */
+    uint64_t getDroppedCount() const { return droppedCount.load(); }
+
+    /**
+     * @brief 将字符串转换为日志级别（不区分大小写，无法识别时返回INFO）
+     * @param levelStr 级别字符串（debug/info/warn/error）
+     * @return 日志级别
+     */
+    static LogLevel parseLevel(const std::string& levelStr);
+
+    /**
+     * @brief 获取日志级别的字符串表示
+     * @param level 日志级别
+     * @return 级别字符串
+     */
+    static const char* levelToString(LogLevel level);
+
+    /**
+     * @brief 析构函数
+     */
+    ~Logger();
+};
+
+#endif // LOGGER_H
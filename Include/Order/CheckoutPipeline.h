@@ -0,0 +1,312 @@
+/**
+ * @file CheckoutPipeline.h
+ * @brief 分阶段下单流水线（校验、计价、预留、持久化、确认）的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef CHECKOUT_PIPELINE_H
+#define CHECKOUT_PIPELINE_H
+
+#include "Order/OrderManager.h"
+#include "Promotion/PromotionManager.h"
+#include "ItemManage/FlashSaleStock.h"
+#include "Interfaces/DependencyInterfaces.h"
+#include <vector>
+#include <deque>
+#include <memory>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+#include <chrono>
+
+/**
+ * @enum CheckoutStatus
+ * @brief 下单结果
+ */
+enum class CheckoutStatus {
+    CREATED,                // 订单已创建
+    DUPLICATE,              // 重复提交，返回原订单
+    INVALID,                // 请求无效（空商品、数量非法、商品不存在等）
+    OUT_OF_STOCK,           // 库存不足
+    PROMOTION_EXHAUSTED,    // 限次促销已用尽
+    COUPON_REJECTED,        // 优惠券不可用或核销失败
+    PERSIST_FAILED          // 写入文件失败，预留已撤销
+};
+
+/**
+ * @struct CheckoutRequest
+ * @brief 下单请求
+ */
+struct CheckoutRequest {
+    std::string userId;                                         // 用户ID
+    std::vector<std::pair<std::shared_ptr<Item>, int>> items;   // 商品及数量
+    std::string shippingAddress;                                // 收货地址
+    std::string couponCode;                                     // 优惠券码（可为空）
+    std::string requestKey;                                     // 客户端请求键（为空表示不去重）
+};
+
+/**
+ * @struct CheckoutOutcome
+ * @brief 下单结果
+ */
+struct CheckoutOutcome {
+    CheckoutStatus status = CheckoutStatus::INVALID;    // 结果
+    std::string message;                                // 失败原因
+    std::shared_ptr<Order> order;                       // 创建（或重复提交对应）的订单
+    PromotionResult pricing{};                          // 计价结果（未设置促销管理器时只有原价）
+    double latencyMs = 0.0;                             // 从提交到确认的耗时（毫秒）
+};
+
+/**
+ * @struct CheckoutStats
+ * @brief 流水线统计
+ */
+struct CheckoutStats {
+    uint64_t submitted = 0;     // 提交数
+    uint64_t created = 0;       // 创建的订单数
+    uint64_t rejected = 0;      // 失败数
+    uint64_t duplicates = 0;    // 重复提交数
+    uint64_t batches = 0;       // 持久化批次数
+    uint64_t maxBatch = 0;      // 最大批量
+
+    /**
+     * @brief 平均每批订单数
+     */
+    double averageBatch() const { return batches > 0 ? static_cast<double>(created) / batches : 0.0; }
+};
+
+/**
+ * @class StageQueue
+ * @brief 阶段之间的有界阻塞队列
+ *
+ * 队列满时生产者等待，使积压不超过容量，单个订单的排队时间有上界；
+ * 关闭后不再接受新元素，消费者取完剩余元素后退出
+ */
+template <typename T>
+class StageQueue {
+private:
+    std::deque<T> items;
+    size_t capacity;
+    bool closed;
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 容量
+     */
+    explicit StageQueue(size_t capacity) : capacity(capacity > 0 ? capacity : 1), closed(false) {}
+
+    /**
+     * @brief 放入元素（队列满时等待）
+     * @return 队列已关闭返回false（此时不移动value）
+     */
+    bool push(T&& value) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this]() { return closed || items.size() < capacity; });
+        if (closed) {
+            return false;
+        }
+        items.push_back(std::move(value));
+        notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief 取出一个元素（队列空时等待）
+     * @return 队列已关闭且为空返回false
+     */
+    bool pop(T& value) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this]() { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+        value = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief 取出当前积压的全部元素（最多max个，队列空时等待）
+     * @return 取出的元素数，队列已关闭且为空返回0
+     */
+    size_t popAll(std::vector<T>& out, size_t max) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this]() { return closed || !items.empty(); });
+        size_t count = 0;
+        while (!items.empty() && count < max) {
+            out.push_back(std::move(items.front()));
+            items.pop_front();
+            ++count;
+        }
+        notFull.notify_all();
+        return count;
+    }
+
+    /**
+     * @brief 关闭队列并唤醒所有等待者
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notEmpty.notify_all();
+        notFull.notify_all();
+    }
+};
+
+/**
+ * @class CheckoutPipeline
+ * @brief 下单流水线：把下单拆为五个阶段，每个阶段一个线程，阶段之间用有界队列连接
+ *
+ * 阶段：
+ * 1. 校验：商品非空、数量为正、商品仍存在、地址非空
+ * 2. 计价：计算原价和促销结果（含优惠券校验）
+ * 3. 预留：逐个扣减库存，占用限次促销和优惠券；任一步失败时回滚已完成的步骤
+ * 4. 持久化：一次取出积压的全部订单（最多maxBatch个）作为一批，订单和商品文件各只写一次；
+ *    写入失败时整批撤销预留，订单不进入订单列表
+ * 5. 确认：登记请求键结果，兑现调用者的future
+ *
+ * 库存修改和商品文件写入由商品仓库的读写锁保护，预留和持久化两个线程可以同时工作；
+ * 某个阶段失败的请求直接进入确认阶段。持久化期间到达的订单在队列中积累，
+ * 并发越高每批越大，写文件的次数随之减少。订单观察者在持久化线程中收到通知
+ *
+ * 设置秒杀库存后，秒杀商品在提交时先在调用线程抢购配额，抢不到立即返回库存不足；
+ * 订单完成时记为成单，失败时归还配额
+ */
+class CheckoutPipeline {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @struct Job
+     * @brief 流经各阶段的下单任务
+     */
+    struct Job {
+        CheckoutRequest request;
+        std::promise<CheckoutOutcome> promise;
+        CheckoutOutcome outcome;
+        Clock::time_point submitted;
+        bool failed = false;            // 已失败，跳过后续阶段
+        std::vector<std::pair<std::string, int>> flashClaims;   // 已抢到的秒杀配额
+    };
+    using JobPtr = std::unique_ptr<Job>;
+
+    OrderManager* orderManager;             // 订单管理器
+    IItemRepository* itemRepository;        // 商品仓库
+    PromotionManager* promotionManager;     // 促销管理器（可为空）
+    FlashSaleStock* flashSale;              // 秒杀库存（可为空）
+    size_t maxBatch;                        // 每批最多持久化的订单数
+
+    StageQueue<JobPtr> validateQueue;       // 待校验
+    StageQueue<JobPtr> priceQueue;          // 待计价
+    StageQueue<JobPtr> reserveQueue;        // 待预留
+    StageQueue<JobPtr> persistQueue;        // 待持久化
+    StageQueue<JobPtr> ackQueue;            // 待确认
+
+    std::vector<std::thread> stages;        // 各阶段线程
+    std::atomic<bool> running;              // 是否运行中
+    std::mutex lifecycleMutex;              // 启动和停止互斥
+
+    std::atomic<uint64_t> submittedCount;
+    std::atomic<uint64_t> createdCount;
+    std::atomic<uint64_t> rejectedCount;
+    std::atomic<uint64_t> duplicateCount;
+    std::atomic<uint64_t> batchCount;
+    std::atomic<uint64_t> maxBatchSeen;
+
+    /**
+     * @brief 标记任务失败
+     */
+    static void fail(Job& job, CheckoutStatus status, const std::string& message);
+
+    /**
+     * @brief 把任务交给下一阶段（失败的任务直接交给确认阶段）
+     */
+    void forward(JobPtr job, StageQueue<JobPtr>& next);
+
+    /**
+     * @brief 结算秒杀配额（成单记入commit，失败归还）
+     */
+    void settleFlashClaims(Job& job);
+
+    /**
+     * @brief 撤销已完成预留的任务占用的库存、限次促销和优惠券
+     */
+    void releaseReservation(Job& job);
+
+    void validateStage();
+    void priceStage();
+    void reserveStage();
+    void persistStage();
+    void ackStage();
+
+public:
+    /**
+     * @brief 构造函数
+     * @param orderManager 订单管理器
+     * @param itemRepository 商品仓库
+     * @param promotionManager 促销管理器（可为空，为空时不计算促销）
+     * @param queueCapacity 每个阶段队列的容量
+     * @param maxBatch 每批最多持久化的订单数（1表示逐单写入）
+     */
+    CheckoutPipeline(OrderManager* orderManager, IItemRepository* itemRepository,
+                     PromotionManager* promotionManager,
+                     size_t queueCapacity = 1024, size_t maxBatch = 256);
+
+    /**
+     * @brief 析构函数，处理完已提交的请求后停止
+     */
+    ~CheckoutPipeline();
+
+    CheckoutPipeline(const CheckoutPipeline&) = delete;
+    CheckoutPipeline& operator=(const CheckoutPipeline&) = delete;
+
+    /**
+     * @brief 设置秒杀库存（需在start之前调用）
+     * @param flashSale 秒杀库存（为空表示不启用抢购闸门）
+     */
+    void setFlashSale(FlashSaleStock* flashSale) { this->flashSale = flashSale; }
+
+    /**
+     * @brief 启动各阶段线程
+     */
+    void start();
+
+    /**
+     * @brief 停止接受新请求，处理完已提交的请求后结束各阶段线程（停止后不能再次启动）
+     */
+    void stop();
+
+    /**
+     * @brief 提交下单请求
+     *
+     * 带请求键时先在调用线程登记：重复提交直接返回原订单，同键请求正在处理时等待其完成；
+     * 之后抢购秒杀配额，配额不足时直接返回库存不足
+     * @param request 下单请求
+     * @return 下单结果的future
+     */
+    std::future<CheckoutOutcome> submit(CheckoutRequest request);
+
+    /**
+     * @brief 获取统计
+     * @return 统计信息
+     */
+    CheckoutStats getStats() const;
+
+    /**
+     * @brief 获取下单结果的显示字符串
+     * @param status 下单结果
+     * @return 显示字符串
+     */
+    static std::string statusToString(CheckoutStatus status);
+};
+
+#endif // CHECKOUT_PIPELINE_H
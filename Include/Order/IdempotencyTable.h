@@ -0,0 +1,135 @@
+/**
+ * @file IdempotencyTable.h
+ * @brief 下单幂等表（按客户端请求键去重）的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef IDEMPOTENCY_TABLE_H
+#define IDEMPOTENCY_TABLE_H
+
+#include "Order/Order.h"
+#include <unordered_map>
+#include <deque>
+#include <memory>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @struct IdempotencyStats
+ * @brief 幂等表统计
+ */
+struct IdempotencyStats {
+    uint64_t requests = 0;      // 带请求键的下单请求数
+    uint64_t hits = 0;          // 命中已有结果（重复提交）的次数
+    uint64_t waits = 0;         // 其中等待进行中的首个请求完成的次数
+    uint64_t expired = 0;       // 到期清除的记录数
+    uint64_t evicted = 0;       // 因容量不足提前清除的记录数
+    size_t entries = 0;         // 当前记录数
+};
+
+/**
+ * @class IdempotencyTable
+ * @brief 请求键 -> 订单的有界、按时间过期的并发表
+ *
+ * 特点：
+ * 1. 按键的哈希分段，每段一把锁，不同请求互不阻塞
+ * 2. 所有记录的存活时间相同且从完成时算起，完成顺序即过期顺序，每段用一个先进先出队列记录完成次序，
+ *    清理时只检查队首，均摊O(1)；超过容量时同样从队首淘汰最早完成的记录；进行中的记录不入队，不会被清除
+ * 3. 首个请求处理期间到达的重复请求在段内等待，首个请求完成后直接取得同一结果；
+ *    首个请求失败时删除记录，重复请求接手重新执行
+ */
+class IdempotencyTable {
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    static const size_t SHARD_COUNT = 16;   // 分段数（2的幂）
+
+    /**
+     * @struct Entry
+     * @brief 一条记录
+     */
+    struct Entry {
+        std::shared_ptr<Order> order;       // 结果订单（进行中为空）
+        bool done = false;                  // 首个请求是否已完成
+        uint64_t sequence = 0;              // 插入序号（区分同键的新旧记录）
+    };
+
+    /**
+     * @struct Shard
+     * @brief 表的一段
+     */
+    struct Shard {
+        std::mutex mutex;                                       // 段锁
+        std::condition_variable settled;                        // 进行中的请求完成时通知
+        std::unordered_map<std::string, Entry> entries;         // 请求键 -> 记录
+        std::deque<std::pair<Clock::time_point, std::pair<std::string, uint64_t>>> fifo;  // (完成时间, (键, 序号))
+    };
+
+    mutable Shard shards[SHARD_COUNT];      // 各段
+    size_t shardCapacity;                   // 每段容量
+    Clock::duration ttl;                    // 记录存活时间
+    std::atomic<uint64_t> nextSequence;     // 下一个插入序号
+
+    std::atomic<uint64_t> requestCount;     // 统计：请求数
+    std::atomic<uint64_t> hitCount;         // 统计：命中数
+    std::atomic<uint64_t> waitCount;        // 统计：等待数
+    std::atomic<uint64_t> expiredCount;     // 统计：到期清除数
+    std::atomic<uint64_t> evictedCount;     // 统计：容量淘汰数
+
+    /**
+     * @brief 键所在的段
+     */
+    Shard& shardOf(const std::string& key) const;
+
+    /**
+     * @brief 清除段内到期的记录，并在超过容量时淘汰最早完成的记录（调用者需持有段锁）
+     */
+    void prune(Shard& shard, Clock::time_point now);
+
+public:
+    /**
+     * @brief 构造函数
+     * @param capacity 最多保存的记录数
+     * @param ttlSeconds 记录存活秒数
+     */
+    IdempotencyTable(size_t capacity, int ttlSeconds);
+
+    /**
+     * @brief 修改容量和存活时间（保留现有记录，之后按新参数清理）
+     * @param capacity 最多保存的记录数
+     * @param ttlSeconds 记录存活秒数
+     */
+    void configure(size_t capacity, int ttlSeconds);
+
+    /**
+     * @brief 开始一个请求
+     *
+     * 键已有完成的记录时返回false并给出原订单；键正在处理时等待其完成；
+     * 否则登记为进行中并返回true，调用者执行下单后必须调用finish
+     * @param key 请求键
+     * @param existing 重复请求时返回原订单
+     * @return 需要执行下单返回true，重复请求返回false
+     */
+    bool begin(const std::string& key, std::shared_ptr<Order>& existing);
+
+    /**
+     * @brief 结束一个请求
+     * @param key 请求键
+     * @param order 下单结果（为空表示失败，删除记录以允许重试）
+     */
+    void finish(const std::string& key, const std::shared_ptr<Order>& order);
+
+    /**
+     * @brief 获取统计
+     * @return 统计信息
+     */
+    IdempotencyStats getStats() const;
+};
+
+#endif // IDEMPOTENCY_TABLE_H
@@ -71,18 +71,6 @@ public:
      */
     Order();
     
-    /**
-     * @brief 构造函数
-     * @param userId 用户ID（用户名）
-     * @param items 购买的商品列表（Item指针和数量的pair）
-     * @param shippingAddress 收货地址
-     * @param itemManager 商品管理器指针，用于获取商品信息和更新库存
-     */
-    Order(const std::string& userId, 
-          const std::vector<std::pair<std::shared_ptr<Item>, int>>& items,
-          const std::string& shippingAddress,
-          class IItemRepository* itemManager);
-    
     /**
      * @brief 从CSV数据构造订单（用于数据加载）
      * @param orderId 订单编号
@@ -126,6 +114,7 @@ public:
     
     // Setter方法
     void setStatus(OrderStatus newStatus);
+    void setOrderId(const std::string& newOrderId) { orderId = newOrderId; }
     void setShippingAddress(const std::string& address) { shippingAddress = address; }
     
     /**
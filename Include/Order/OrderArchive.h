@@ -0,0 +1,123 @@
+/**
+ * @file OrderArchive.h
+ * @brief 订单归档文件（字典压缩的二进制格式）的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef ORDER_ARCHIVE_H
+#define ORDER_ARCHIVE_H
+
+#include "Order/Order.h"
+#include <vector>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * @struct ArchiveBlockInfo
+ * @brief 归档数据块的头部信息
+ */
+struct ArchiveBlockInfo {
+    uint32_t orderCount;        // 块内订单数量
+    time_t minTime;             // 块内最早订单时间
+    time_t maxTime;             // 块内最晚订单时间
+    uint32_t payloadSize;       // 块数据区字节数
+    uint32_t checksum;          // 数据区校验和（FNV-1a）
+};
+
+/**
+ * @class OrderArchive
+ * @brief 订单归档类，负责订单历史的压缩存储与按时间范围读取
+ *
+ * 归档文件由文件头和若干独立的数据块组成：
+ * 1. 每个数据块自带字符串字典（商品ID、商品名称、收货地址、用户ID），
+ *    订单中只保存字典下标，块之间互不依赖，可以单独解码
+ * 2. 订单时间按块内前一个订单做差分编码，状态修改时间相对订单时间差分编码
+ * 3. 价格和金额转换为“分”的定点整数，与数量一起使用变长整数（varint）编码
+ * 4. 块头记录时间范围，按时间扫描时不相交的块直接跳过，不做解码
+ */
+class OrderArchive {
+private:
+    std::string filePath;       // 归档文件路径
+    size_t ordersPerBlock;      // 每个数据块容纳的订单数量
+
+    /**
+     * @brief 将一组订单编码为一个数据块的数据区
+     * @param orders 订单列表（已按时间排序）
+     * @param begin 起始下标
+     * @param end 结束下标（不含）
+     * @param info 输出的块头信息
+     * @return 数据区字节
+     */
+    std::string encodeBlock(const std::vector<std::shared_ptr<Order>>& orders,
+                            size_t begin, size_t end, ArchiveBlockInfo& info) const;
+
+    /**
+     * @brief 解码一个数据块的数据区
+     * @param payload 数据区字节
+     * @param info 块头信息
+     * @param from 时间下界（含）
+     * @param to 时间上界（含）
+     * @param out 解码出的订单（只追加时间范围内的订单）
+     * @return 解码成功返回true，数据损坏返回false
+     */
+    bool decodeBlock(const std::string& payload, const ArchiveBlockInfo& info,
+                     time_t from, time_t to,
+                     std::vector<std::shared_ptr<Order>>& out) const;
+
+    /**
+     * @brief 读取归档文件并解码时间范围内的所有块
+     * @param from 时间下界（含）
+     * @param to 时间上界（含）
+     * @param out 输出订单列表
+     * @return 读取成功返回true，否则返回false
+     */
+    bool readRange(time_t from, time_t to, std::vector<std::shared_ptr<Order>>& out) const;
+
+public:
+    /**
+     * @brief 构造函数
+     * @param filePath 归档文件路径
+     * @param ordersPerBlock 每个数据块的订单数量（默认4096）
+     */
+    explicit OrderArchive(const std::string& filePath, size_t ordersPerBlock = 4096);
+
+    /**
+     * @brief 将订单写入归档文件（覆盖原文件）
+     *
+     * 订单会先按下单时间排序，使每个块的时间范围尽量紧凑
+     *
+     * @param orders 订单列表
+     * @return 写入成功返回true，否则返回false
+     */
+    bool write(const std::vector<std::shared_ptr<Order>>& orders) const;
+
+    /**
+     * @brief 读取归档中的全部订单
+     * @param out 输出订单列表（按时间升序追加）
+     * @return 读取成功返回true，否则返回false
+     */
+    bool readAll(std::vector<std::shared_ptr<Order>>& out) const;
+
+    /**
+     * @brief 按时间范围扫描归档
+     *
+     * 只解码时间范围与[from, to]相交的数据块
+     *
+     * @param from 时间下界（含）
+     * @param to 时间上界（含）
+     * @param out 输出订单列表（按时间升序追加）
+     * @return 读取成功返回true，否则返回false
+     */
+    bool scanTimeRange(time_t from, time_t to, std::vector<std::shared_ptr<Order>>& out) const;
+
+    /**
+     * @brief 获取归档文件路径
+     * @return 文件路径
+     */
+    const std::string& getFilePath() const { return filePath; }
+};
+
+#endif // ORDER_ARCHIVE_H
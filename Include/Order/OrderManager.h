@@ -9,8 +9,14 @@
 #define ORDER_MANAGER_H
 
 #include "Order/Order.h"
+#include "Order/OrderTimeline.h"
+#include "Order/IdempotencyTable.h"
 #include "Interfaces/DependencyInterfaces.h"
+#include "Services/QueryResults.h"
+#include "Services/SortedIndex.h"
 #include <vector>
+#include <unordered_map>
+#include <array>
 #include <memory>
 #include <string>
 #include <thread>
@@ -24,16 +30,36 @@
  * 主要功能：
  * 1. 从CSV文件加载订单数据
  * 2. 保存订单数据到CSV文件
- * 3. 创建新订单
+ * 3. 批量提交下单流水线已完成库存扣减的订单，一批订单只写一次文件
  * 4. 查询订单
  * 5. 管理订单状态
  * 6. 自动状态更新（待发货->已发货->已签收）
+ * 7. 维护订单ID哈希索引及时间、金额、状态有序索引，支持游标分页的排序列表
+ * 8. 按状态维护成员集合和计数器，状态计数O(1)，按状态列出订单O(k)
+ * 9. 维护全局和按用户划分的时间索引，按日期范围查询只访问范围内的订单
+ * 10. 新订单创建后通知已注册的订单观察者
+ * 11. 按“用户 + 请求键”登记下单请求，重复提交直接返回原订单，不再检查库存和写文件
+ * 12. 统一分配订单编号并保证唯一，加载时为重复的编号重新编号
  */
 class OrderManager {
 private:
     std::vector<std::shared_ptr<Order>> orders;     // 所有订单列表
+    std::unordered_map<std::string, std::shared_ptr<Order>> orderById;  // 订单ID索引
+    SortedIndex<time_t> timeIndex;                  // 下单时间有序索引
+    SortedIndex<double> amountIndex;                // 订单总额有序索引
+    SortedIndex<int> statusIndex;                   // 订单状态有序索引
+    
+    // 按状态划分的成员集合与计数（下标为OrderStatus的整数值）
+    static constexpr size_t STATUS_COUNT = 3;
+    std::array<std::unordered_map<std::string, std::shared_ptr<Order>>, STATUS_COUNT> statusMembers;
+    std::array<std::atomic<size_t>, STATUS_COUNT> statusCounts;
+    
+    OrderTimeline timeline;                         // 全部订单的时间索引
+    std::unordered_map<std::string, OrderTimeline> userTimelines;  // 用户ID -> 该用户订单的时间索引
     std::string filePath;                           // 数据文件路径
     std::shared_ptr<IItemRepository> itemManager;   // 商品管理器（接口）
+    std::vector<IOrderObserver*> orderObservers;    // 订单观察者
+    IdempotencyTable idempotency;                   // 下单请求键 -> 订单
     
     // 自动状态更新相关
     std::atomic<bool> autoUpdateEnabled;            // 自动更新是否启用
@@ -41,6 +67,7 @@ private:
     mutable std::mutex ordersMutex;                 // 订单列表互斥锁（mutable以支持const函数）
     int pendingToShippedSeconds;                    // 待发货到已发货的秒数
     int shippedToDeliveredSeconds;                  // 已发货到已签收的秒数
+    uint64_t orderSequence;                         // 订单编号序号（受ordersMutex保护）
     
     /**
      * @brief 解析CSV行数据
@@ -56,6 +83,35 @@ private:
      */
     std::string trim(const std::string& str);
     
+    /**
+     * @brief 将订单加入所有索引（调用方需持有ordersMutex）
+     * @param order 订单对象
+     */
+    void indexOrder(const std::shared_ptr<Order>& order);
+    
+    /**
+     * @brief 生成一个未被占用的订单编号（调用方需持有ordersMutex）
+     * @param userId 用户ID
+     * @param timestamp 下单时间
+     * @return 订单编号
+     */
+    std::string nextOrderId(const std::string& userId, time_t timestamp);
+    
+    /**
+     * @brief 根据当前订单列表重建所有索引（调用方需持有ordersMutex）
+     *
+     * 编号与已索引订单重复的订单会被重新编号
+     * @return 重新编号的订单数
+     */
+    size_t rebuildIndexes();
+    
+    /**
+     * @brief 修改订单状态并同步状态索引、状态集合和计数（调用方需持有ordersMutex）
+     * @param order 订单对象
+     * @param newStatus 新状态
+     */
+    void applyStatus(const std::shared_ptr<Order>& order, OrderStatus newStatus);
+    
     /**
      * @brief 自动更新订单状态的线程函数
      */
@@ -74,6 +130,13 @@ private:
      * @return 商品信息字符串
      */
     std::string orderItemsToString(const std::vector<OrderItem>& items);
+    
+    /**
+     * @brief 幂等表中的键（请求键按用户隔离）
+     */
+    static std::string idempotencyKey(const std::string& userId, const std::string& requestKey) {
+        return userId + '\x1f' + requestKey;
+    }
 
 public:
     /**
@@ -96,15 +159,83 @@ public:
     bool saveToFile();
     
     /**
-     * @brief 创建新订单
+     * @brief 将全部订单导出为压缩归档文件
+     * @param archivePath 归档文件路径
+     * @return 导出成功返回true，否则返回false
+     */
+    bool exportToArchive(const std::string& archivePath) const;
+    
+    /**
+     * @brief 从压缩归档文件加载订单数据（替换当前订单列表）
+     * @param archivePath 归档文件路径
+     * @return 加载成功返回true，否则返回false
+     */
+    bool loadFromArchive(const std::string& archivePath);
+    
+    /**
+     * @brief 按时间范围扫描归档文件（不影响当前订单列表）
+     * @param archivePath 归档文件路径
+     * @param from 开始时间（含）
+     * @param to 结束时间（含）
+     * @param result 输出：时间范围内的订单（按时间升序）
+     * @return 扫描成功返回true；归档不存在或损坏返回false
+     */
+    bool scanArchiveByTime(const std::string& archivePath, time_t from, time_t to,
+                           std::vector<std::shared_ptr<Order>>& result) const;
+    
+    /**
+     * @brief 分配订单编号
+     *
+     * 编号由用户ID、下单时间和序号生成，并与已有订单核对，保证不重复
+     * @param userId 用户ID
+     * @param timestamp 下单时间
+     * @return 订单编号
+     */
+    std::string allocateOrderId(const std::string& userId, time_t timestamp);
+    
+    /**
+     * @brief 登记一个带请求键的下单请求（同键请求正在处理时等待其完成）
      * @param userId 用户ID
-     * @param cartItems 购物车商品列表
-     * @param shippingAddress 收货地址
-     * @return 创建成功返回订单对象指针，失败返回nullptr
+     * @param requestKey 客户端请求键
+     * @param existing 重复提交时返回原订单
+     * @return 需要执行下单返回true，重复提交返回false；登记后必须调用finishRequest
      */
-    std::shared_ptr<Order> createOrder(const std::string& userId,
-                                       const std::vector<std::pair<std::shared_ptr<Item>, int>>& cartItems,
-                                       const std::string& shippingAddress);
+    bool beginRequest(const std::string& userId, const std::string& requestKey, std::shared_ptr<Order>& existing) {
+        return idempotency.begin(idempotencyKey(userId, requestKey), existing);
+    }
+    
+    /**
+     * @brief 结束一个带请求键的下单请求
+     * @param userId 用户ID
+     * @param requestKey 客户端请求键
+     * @param order 下单结果（为空表示失败，允许重试）
+     */
+    void finishRequest(const std::string& userId, const std::string& requestKey, const std::shared_ptr<Order>& order) {
+        idempotency.finish(idempotencyKey(userId, requestKey), order);
+    }
+    
+    /**
+     * @brief 批量提交订单：加入订单列表和索引，只保存一次文件，再逐个通知观察者
+     *
+     * 订单应已完成库存扣减；观察者在调用线程中收到通知。
+     * 保存失败时从订单列表和索引中移除本批订单，也不通知观察者
+     * @param batch 订单列表
+     * @return 保存成功返回true，否则返回false
+     */
+    bool commitOrders(const std::vector<std::shared_ptr<Order>>& batch);
+    
+    /**
+     * @brief 设置下单去重的容量和有效时间（保留已有记录）
+     * @param capacity 最多记录的请求数
+     * @param ttlSeconds 请求键的有效秒数
+     */
+    void setIdempotencyPolicy(size_t capacity, int ttlSeconds) { idempotency.configure(capacity, ttlSeconds); }
+    
+    /**
+     * @brief 获取下单去重统计
+     * @return 统计信息
+     */
+    IdempotencyStats getIdempotencyStats() const { return idempotency.getStats(); }
     
     /**
      * @brief 根据订单ID查找订单
@@ -116,7 +247,7 @@ public:
     /**
      * @brief 根据用户ID获取该用户的所有订单
      * @param userId 用户ID
-     * @return 订单列表
+     * @return 订单列表（按下单时间升序）
      */
     std::vector<std::shared_ptr<Order>> getOrdersByUserId(const std::string& userId);
     
@@ -134,6 +265,89 @@ public:
      */
     bool updateOrderStatus(const std::string& orderId, OrderStatus newStatus);
     
+    /**
+     * @brief 查询所有订单（只在复制快照期间持有订单锁）
+     * @return 订单行列表
+     */
+    std::vector<OrderRow> queryAllOrders() const;
+    
+    /**
+     * @brief 查询某个用户的订单（只在复制快照期间持有订单锁）
+     * @param userId 用户ID
+     * @return 订单行列表
+     */
+    std::vector<OrderRow> queryUserOrders(const std::string& userId) const;
+    
+    /**
+     * @brief 按排序字段分页查询订单
+     * 
+     * 基于有序索引的游标分页，每页代价为O(log N + limit)
+     * 
+     * @param sortKey 排序字段
+     * @param descending 是否降序
+     * @param cursor 上一页返回的游标（空字符串表示第一页）
+     * @param limit 每页数量
+     * @return 分页结果
+     */
+    ListPage<OrderRow> queryOrderPage(OrderSortKey sortKey, bool descending,
+                                      const std::string& cursor, size_t limit) const;
+    
+    /**
+     * @brief 获取某个状态的订单数量（读取原子计数器，不加锁）
+     * @param status 订单状态
+     * @return 订单数量
+     */
+    size_t countOrdersByStatus(OrderStatus status) const;
+    
+    /**
+     * @brief 获取某个状态的全部订单
+     * @param status 订单状态
+     * @return 订单列表（顺序不保证）
+     */
+    std::vector<std::shared_ptr<Order>> getOrdersByStatus(OrderStatus status) const;
+    
+    /**
+     * @brief 查询某个状态的全部订单（按下单时间升序，只在复制快照期间持锁）
+     * @param status 订单状态
+     * @return 订单行列表
+     */
+    std::vector<OrderRow> queryOrdersByStatus(OrderStatus status) const;
+    
+    /**
+     * @brief 获取时间范围内的订单
+     * @param from 开始时间（含）
+     * @param to 结束时间（含）
+     * @return 订单列表（按下单时间升序）
+     */
+    std::vector<std::shared_ptr<Order>> getOrdersInTimeRange(time_t from, time_t to) const;
+    
+    /**
+     * @brief 获取某个用户在时间范围内的订单
+     * @param userId 用户ID
+     * @param from 开始时间（含）
+     * @param to 结束时间（含）
+     * @return 订单列表（按下单时间升序）
+     */
+    std::vector<std::shared_ptr<Order>> getUserOrdersInTimeRange(const std::string& userId,
+                                                                 time_t from, time_t to) const;
+    
+    /**
+     * @brief 获取时间范围内处于某个状态的订单
+     * @param from 开始时间（含）
+     * @param to 结束时间（含）
+     * @param status 订单状态
+     * @return 订单列表（按下单时间升序）
+     */
+    std::vector<std::shared_ptr<Order>> getOrdersInTimeRangeByStatus(time_t from, time_t to,
+                                                                     OrderStatus status) const;
+    
+    /**
+     * @brief 将订单转换为订单行快照
+     * @param order 订单对象
+     * @return 订单行
+     */
+    static OrderRow toOrderRow(const Order& order);
+    
     /**
      * @brief 显示所有订单信息（表格形式）
      */
@@ -145,6 +359,18 @@ public:
      */
     void displayUserOrders(const std::string& userId) const;
     
+    /**
+     * @brief 注册订单观察者（不接管所有权）
+     * @param observer 观察者
+     */
+    void addOrderObserver(IOrderObserver* observer);
+    
+    /**
+     * @brief 注销订单观察者
+     * @param observer 观察者
+     */
+    void removeOrderObserver(IOrderObserver* observer);
+    
     /**
      * @brief 启用自动状态更新
      * @param pendingToShipped 待发货到已发货的秒数（默认10秒）
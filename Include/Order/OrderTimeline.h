@@ -0,0 +1,67 @@
+/**
+ * @file OrderTimeline.h
+ * @brief 订单时间索引的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef ORDER_TIMELINE_H
+#define ORDER_TIMELINE_H
+
+#include "Order/Order.h"
+#include <vector>
+#include <memory>
+#include <ctime>
+
+/**
+ * @class OrderTimeline
+ * @brief 按下单时间排序的订单索引
+ *
+ * 特点：
+ * 1. 使用按时间有序的连续数组保存(时间, 订单)对，范围查询用二分查找定位边界，
+ *    代价为O(log N + 命中数量)
+ * 2. 新订单基本按时间顺序到达，时间不早于末尾时直接追加（O(1)）；
+ *    否则二分定位后插入，保持有序
+ */
+class OrderTimeline {
+public:
+    using Entry = std::pair<time_t, std::shared_ptr<Order>>;
+
+private:
+    std::vector<Entry> entries;     // 按时间升序排列的订单
+
+public:
+    /**
+     * @brief 插入一个订单
+     * @param order 订单对象
+     */
+    void insert(const std::shared_ptr<Order>& order);
+
+    /**
+     * @brief 清空索引
+     */
+    void clear() { entries.clear(); }
+
+    /**
+     * @brief 获取索引中的订单数量
+     * @return 订单数量
+     */
+    size_t size() const { return entries.size(); }
+
+    /**
+     * @brief 定位时间范围[from, to]对应的区间
+     * @param from 时间下界（含）
+     * @param to 时间上界（含）
+     * @return 区间的起止迭代器
+     */
+    std::pair<std::vector<Entry>::const_iterator, std::vector<Entry>::const_iterator>
+    range(time_t from, time_t to) const;
+
+    /**
+     * @brief 按时间升序获取全部订单
+     * @return 订单条目
+     */
+    const std::vector<Entry>& getEntries() const { return entries; }
+};
+
+#endif // ORDER_TIMELINE_H
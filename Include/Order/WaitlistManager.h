@@ -0,0 +1,239 @@
+/**
+ * @file WaitlistManager.h
+ * @brief 到货候补队列（按商品先到先得、补货后批量分配）的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef WAITLIST_MANAGER_H
+#define WAITLIST_MANAGER_H
+
+#include "Order/CheckoutPipeline.h"
+#include "Interfaces/DependencyInterfaces.h"
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <ctime>
+#include <cstdint>
+
+/**
+ * @enum WaitlistJoinStatus
+ * @brief 加入候补的结果
+ */
+enum class WaitlistJoinStatus {
+    JOINED,             // 已加入
+    ALREADY_WAITING,    // 已在该商品的候补队列中
+    INVALID,            // 参数无效（数量非正、用户或地址为空）
+    WRITE_FAILED        // 写入候补日志失败
+};
+
+/**
+ * @struct WaitlistEntryView
+ * @brief 候补记录（对外展示用）
+ */
+struct WaitlistEntryView {
+    uint64_t ticket = 0;            // 候补编号（全局递增）
+    std::string itemId;             // 商品ID
+    std::string userId;             // 用户名
+    int quantity = 0;               // 候补数量
+    std::string shippingAddress;    // 收货地址
+    time_t joinedAt = 0;            // 加入时间
+    size_t position = 0;            // 在该商品队列中的位置（从1开始）
+};
+
+/**
+ * @struct WaitlistNotice
+ * @brief 到货通知：候补已自动下单，等待顾客查看
+ */
+struct WaitlistNotice {
+    uint64_t ticket = 0;            // 候补编号
+    std::string itemId;             // 商品ID
+    std::string userId;             // 用户名
+    int quantity = 0;               // 数量
+    std::string orderId;            // 自动创建的订单ID
+    time_t servedAt = 0;            // 下单时间
+};
+
+/**
+ * @struct WaitlistSummary
+ * @brief 某个商品的候补汇总
+ */
+struct WaitlistSummary {
+    std::string itemId;             // 商品ID
+    size_t entries = 0;             // 候补人数
+    long long units = 0;            // 候补总数量
+};
+
+/**
+ * @struct WaitlistServeResult
+ * @brief 一次补货分配的结果
+ */
+struct WaitlistServeResult {
+    size_t served = 0;                      // 成功下单的候补数
+    size_t requeued = 0;                    // 下单失败、放回队首的候补数
+    long long allocatedUnits = 0;           // 分配的库存数量
+    std::vector<WaitlistNotice> notices;    // 本次产生的到货通知
+};
+
+/**
+ * @class WaitlistManager
+ * @brief 到货候补管理器：商品缺货时顾客排队候补，补货后按排队顺序批量自动下单
+ *
+ * 特点：
+ * 1. 每个商品一个先进先出队列，加入候补是O(1)的队尾追加加一条日志，取代缺货时的反复重试
+ * 2. 队列项只保存编号、时间、数量和两个32位字符串编号（用户名、地址驻留在字符串表中），每项32字节
+ * 3. 补货时从队首起依次取出库存足够满足的候补，遇到第一个满足不了的即停止，保证不插队；
+ *    取出的候补一次性提交给下单流水线，由持久化阶段作为一批写入；下单失败的候补按原顺序放回队首
+ * 4. 下单成功后为顾客生成到货通知，顾客登录时查看并确认
+ * 5. 加入、取消、下单、确认通知各追加一条日志记录，启动时重放；
+ *    日志记录数远多于有效记录时，加载后重写为紧凑的日志
+ *
+ * 日志格式：8字节魔数后跟若干记录，每条记录为27字节头部加商品ID、用户名和附加文本：
+ *   [0,1) 类型  [1,9) 候补编号  [9,17) 时间  [17,21) 数量
+ *   [21,23) 商品ID长度  [23,25) 用户名长度  [25,27) 附加文本长度（加入时为地址，下单时为订单ID）
+ *   整数均为小端序
+ */
+class WaitlistManager {
+private:
+    /**
+     * @struct Entry
+     * @brief 队列中的一个候补
+     */
+    struct Entry {
+        uint64_t ticket;        // 候补编号
+        int64_t joinedAt;       // 加入时间
+        uint32_t user;          // 用户名编号
+        uint32_t address;       // 地址编号
+        int32_t quantity;       // 数量
+    };
+
+    std::string filePath;                                           // 日志文件路径
+    mutable std::mutex mutex;                                       // 队列和通知锁
+    std::unordered_map<std::string, std::deque<Entry>> queues;      // 商品ID -> 候补队列
+    std::unordered_map<std::string, uint64_t> waitingKeys;          // 用户名+商品ID -> 候补编号
+    std::unordered_map<std::string, std::vector<WaitlistNotice>> notices;   // 用户名 -> 未查看的通知
+    std::vector<std::string> strings;                               // 编号 -> 字符串
+    std::unordered_map<std::string, uint32_t> stringIds;            // 字符串 -> 编号
+    uint64_t nextTicket;                                            // 下一个候补编号
+
+    std::ofstream writer;                                           // 日志追加写入流
+    uint64_t recordCount;                                           // 日志记录数
+
+    /**
+     * @brief 获取字符串编号，不存在时分配（调用者需持有锁）
+     */
+    uint32_t intern(const std::string& value);
+
+    /**
+     * @brief 生成用户名+商品ID的去重键
+     */
+    static std::string waitingKey(const std::string& userId, const std::string& itemId);
+
+    /**
+     * @brief 在队列中移除指定编号的候补（调用者需持有锁）
+     * @return 找到并移除返回true
+     */
+    bool removeTicket(const std::string& itemId, uint64_t ticket, Entry* removed);
+
+    /**
+     * @brief 生成候补记录的展示结构（调用者需持有锁）
+     */
+    WaitlistEntryView view(const std::string& itemId, const Entry& entry, size_t position) const;
+
+    /**
+     * @brief 追加一条日志记录（调用者需持有锁）
+     */
+    bool appendLog(uint8_t type, uint64_t ticket, int64_t time, int32_t quantity,
+                   const std::string& itemId, const std::string& userId, const std::string& text);
+
+    /**
+     * @brief 把当前队列和通知重写为紧凑日志（调用者需持有锁）
+     */
+    bool compact();
+
+    /**
+     * @brief 有效记录数（队列项与通知之和，调用者需持有锁）
+     */
+    size_t liveRecords() const;
+
+public:
+    /**
+     * @brief 构造函数
+     * @param filePath 日志文件路径
+     */
+    explicit WaitlistManager(const std::string& filePath);
+
+    /**
+     * @brief 加载日志（文件不存在时创建），必要时压缩
+     * @return 加载成功返回true，否则返回false
+     */
+    bool loadFromFile();
+
+    /**
+     * @brief 加入候补
+     * @param userId 用户名
+     * @param itemId 商品ID
+     * @param quantity 数量
+     * @param shippingAddress 到货后自动下单使用的收货地址
+     * @param position 输出：在队列中的位置（可为空；已在队列中时为现有位置）
+     * @return 加入结果
+     */
+    WaitlistJoinStatus join(const std::string& userId, const std::string& itemId, int quantity,
+                            const std::string& shippingAddress, size_t* position = nullptr);
+
+    /**
+     * @brief 取消候补
+     * @param userId 用户名
+     * @param itemId 商品ID
+     * @return 在队列中并已取消返回true
+     */
+    bool cancel(const std::string& userId, const std::string& itemId);
+
+    /**
+     * @brief 获取商品的候补队列
+     * @param itemId 商品ID
+     * @return 候补记录（按排队顺序）
+     */
+    std::vector<WaitlistEntryView> getItemWaitlist(const std::string& itemId) const;
+
+    /**
+     * @brief 获取顾客的全部候补
+     * @param userId 用户名
+     * @return 候补记录（按候补编号排序）
+     */
+    std::vector<WaitlistEntryView> getUserWaitlist(const std::string& userId) const;
+
+    /**
+     * @brief 获取各商品的候补汇总
+     * @return 汇总列表（按商品ID排序，不含空队列）
+     */
+    std::vector<WaitlistSummary> getSummary() const;
+
+    /**
+     * @brief 按当前库存为商品的候补分配库存并批量下单
+     * @param itemId 商品ID
+     * @param itemRepository 商品仓库
+     * @param checkoutPipeline 下单流水线
+     * @return 分配结果
+     */
+    WaitlistServeResult serve(const std::string& itemId, IItemRepository* itemRepository,
+                              CheckoutPipeline* checkoutPipeline);
+
+    /**
+     * @brief 取出顾客未查看的到货通知（取出即视为已查看）
+     * @param userId 用户名
+     * @return 通知列表（按下单顺序）
+     */
+    std::vector<WaitlistNotice> takeNotices(const std::string& userId);
+
+    /**
+     * @brief 获取候补总数
+     * @return 所有队列的候补数之和
+     */
+    size_t size() const;
+};
+
+#endif // WAITLIST_MANAGER_H
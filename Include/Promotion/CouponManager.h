@@ -0,0 +1,251 @@
+/**
+ * @file CouponManager.h
+ * @brief 大规模一次性优惠券码管理器的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef COUPON_MANAGER_H
+#define COUPON_MANAGER_H
+
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * @brief 优惠券校验或核销结果
+ */
+enum class CouponStatus {
+    OK,                 // 可用（或核销成功）
+    INVALID_FORMAT,     // 券码格式错误
+    NOT_FOUND,          // 券码不存在
+    ALREADY_REDEEMED,   // 已被使用
+    NOT_STARTED,        // 活动未开始
+    EXPIRED,            // 活动已结束
+    BELOW_MIN_SPEND,    // 未达到使用门槛
+    STORAGE_ERROR       // 核销记录写入失败
+};
+
+/**
+ * @struct CouponCampaign
+ * @brief 优惠券活动（同一活动的券码面额和有效期相同）
+ */
+struct CouponCampaign {
+    uint32_t campaignId = 0;        // 活动ID（从1开始递增）
+    std::string name;               // 活动名称
+    double amountOff = 0.0;         // 面额（直接减免的金额）
+    double minSpend = 0.0;          // 使用门槛（满减和折扣后的金额）
+    time_t startTime = 0;           // 开始时间
+    time_t endTime = 0;             // 结束时间
+    uint64_t codeCount = 0;         // 券码数量
+    uint64_t redeemedCount = 0;     // 已核销数量（仅在汇总查询时填写）
+};
+
+/**
+ * @struct CouponCheck
+ * @brief 券码校验结果
+ */
+struct CouponCheck {
+    CouponStatus status = CouponStatus::NOT_FOUND;  // 校验结果
+    uint32_t campaignId = 0;                        // 所属活动ID
+    std::string campaignName;                       // 所属活动名称
+    double amountOff = 0.0;                         // 面额
+    double minSpend = 0.0;                          // 使用门槛
+};
+
+/**
+ * @class CouponManager
+ * @brief 优惠券码管理器，面向百万级一次性券码
+ *
+ * 券码为12位Base32字符（去掉易混淆的I、O、0、1），恰好打包为一个60位整数。
+ *
+ * 特点：
+ * 1. 所有券码打包后全局排序，存放在连续数组中，每个券码8字节加4字节的活动下标；
+ *    券码是均匀随机数，按高位建一张目录（平均每格约4个券码），查找代价为O(1)期望
+ * 2. 查找前先过Bloom过滤器（每个券码约10位，7个哈希），伪造的券码绝大多数不访问数组即被拒绝
+ * 3. 核销状态是与券码数组平行的位图，核销用fetch_or原子置位，同一券码并发核销只有一个成功；
+ *    查询和核销只持有共享锁，生成新活动时才持有独占锁
+ * 4. 持久化分三个文件：活动列表（CSV）、券码库（只追加的二进制文件）、
+ *    核销日志（只追加的定长记录，启动时重放得到位图）
+ *
+ * 券码库格式：8字节魔数后跟若干12字节记录 [0,8) 券码  [8,12) 活动ID
+ * 核销日志格式：8字节魔数后跟若干48字节记录
+ *   [0,8) 券码  [8,16) 时间  [16] 类型（1核销，2退回）  [17,24) 保留  [24,48) 关联单号，
+ *   整数均为小端序
+ */
+class CouponManager {
+public:
+    static const size_t CODE_LENGTH = 12;           // 券码字符数
+    static const uint64_t INVALID_CODE = ~0ULL;     // 无效券码
+
+private:
+    static const size_t NOT_FOUND_INDEX = ~static_cast<size_t>(0);
+
+    std::string campaignsFilePath;                      // 活动列表文件路径
+    std::string codesFilePath;                          // 券码库文件路径
+    std::string redemptionLogFilePath;                  // 核销日志文件路径
+
+    std::vector<CouponCampaign> campaigns;              // 活动列表（按ID升序）
+    std::unordered_map<uint32_t, uint32_t> campaignIndex;  // 活动ID -> 下标
+
+    // 券码表（生成新活动时整体重建）
+    std::vector<uint64_t> codes;                        // 排序后的券码
+    std::vector<uint32_t> codeCampaigns;                // 与codes平行：活动下标
+    std::vector<uint32_t> directory;                    // 高位目录：第b格的券码范围为[directory[b], directory[b+1])
+    unsigned directoryShift;                            // 券码右移多少位得到目录格号
+    std::vector<uint64_t> bloom;                        // Bloom过滤器位数组
+    uint64_t bloomMask;                                 // Bloom过滤器位数减一（位数为2的幂）
+    std::unique_ptr<std::atomic<uint64_t>[]> redeemed;  // 与codes平行的核销位图
+    size_t redeemedWords;                               // 位图的字数
+
+    mutable std::shared_mutex tableMutex;               // 券码表读写锁
+    std::ofstream logWriter;                            // 核销日志追加写入流
+    std::mutex logMutex;                                // 核销日志写入锁
+
+    /**
+     * @brief 在券码表中查找券码（调用者需持有tableMutex）
+     * @return 券码下标，不存在返回NOT_FOUND_INDEX
+     */
+    size_t findIndex(uint64_t code) const;
+
+    /**
+     * @brief 查询第index个券码是否已核销（调用者需持有tableMutex）
+     */
+    bool isRedeemedAt(size_t index) const;
+
+    /**
+     * @brief 由codes重建目录和Bloom过滤器（调用者需持有独占锁）
+     */
+    void rebuildLookup();
+
+    /**
+     * @brief 检查活动的有效期和门槛（调用者需持有tableMutex）
+     */
+    CouponCheck checkCampaign(uint32_t slot, double orderAmount, time_t now) const;
+
+    /**
+     * @brief 追加一条核销日志
+     */
+    bool appendLog(uint64_t code, uint8_t type, const std::string& reference);
+
+    /**
+     * @brief 读取活动列表
+     */
+    bool loadCampaigns();
+
+    /**
+     * @brief 保存活动列表
+     */
+    bool saveCampaigns() const;
+
+    /**
+     * @brief 读取券码库并构建券码表（调用者需持有独占锁）
+     */
+    bool loadCodes();
+
+    /**
+     * @brief 打开核销日志并重放（调用者需持有独占锁）
+     */
+    bool openRedemptionLog();
+
+public:
+    /**
+     * @brief 构造函数
+     * @param campaignsFilePath 活动列表文件路径
+     * @param codesFilePath 券码库文件路径
+     * @param redemptionLogFilePath 核销日志文件路径
+     */
+    CouponManager(const std::string& campaignsFilePath, const std::string& codesFilePath,
+                  const std::string& redemptionLogFilePath);
+
+    /**
+     * @brief 加载活动、券码和核销日志（文件不存在时创建空文件）
+     * @return 加载成功返回true，否则返回false
+     */
+    bool loadFromFile();
+
+    /**
+     * @brief 创建优惠券活动并生成券码
+     *
+     * 券码写入券码库，同时按XXXX-XXXX-XXXX格式逐行导出到exportPath以便分发
+     *
+     * @param name 活动名称
+     * @param amountOff 面额
+     * @param minSpend 使用门槛
+     * @param startTime 开始时间
+     * @param endTime 结束时间
+     * @param count 券码数量
+     * @param exportPath 导出文件路径
+     * @return 新活动ID，失败返回0
+     */
+    uint32_t createCampaign(const std::string& name, double amountOff, double minSpend,
+                            time_t startTime, time_t endTime, size_t count, const std::string& exportPath);
+
+    /**
+     * @brief 校验券码（不核销）
+     * @param code 券码（不区分大小写，可带连字符）
+     * @param orderAmount 用于判断门槛的订单金额
+     * @param now 当前时间
+     * @return 校验结果
+     */
+    CouponCheck check(const std::string& code, double orderAmount, time_t now) const;
+
+    /**
+     * @brief 核销券码：校验通过后原子地标记为已使用并写入核销日志
+     * @param code 券码
+     * @param orderAmount 用于判断门槛的订单金额
+     * @param reference 关联单号或用户名（最长24字节）
+     * @return 核销结果，并发核销同一券码时只有一个返回OK
+     */
+    CouponStatus tryRedeem(const std::string& code, double orderAmount, const std::string& reference);
+
+    /**
+     * @brief 退回已核销的券码（下单失败时调用）
+     * @param code 券码
+     * @param reference 关联单号或用户名
+     * @return 退回成功返回true
+     */
+    bool release(const std::string& code, const std::string& reference);
+
+    /**
+     * @brief 获取所有活动及其核销数量
+     * @return 活动列表
+     */
+    std::vector<CouponCampaign> getCampaignSummaries() const;
+
+    /**
+     * @brief 获取券码总数
+     * @return 券码数
+     */
+    size_t size() const;
+
+    /**
+     * @brief 把券码解析为60位整数
+     * @param code 券码（不区分大小写，忽略连字符和空格）
+     * @return 打包后的券码，格式错误返回INVALID_CODE
+     */
+    static uint64_t encode(const std::string& code);
+
+    /**
+     * @brief 把60位整数格式化为XXXX-XXXX-XXXX
+     * @param value 打包后的券码
+     * @return 券码字符串
+     */
+    static std::string format(uint64_t value);
+
+    /**
+     * @brief 获取校验结果的显示字符串
+     * @param status 校验结果
+     * @return 显示字符串
+     */
+    static std::string statusToString(CouponStatus status);
+};
+
+#endif // COUPON_MANAGER_H
@@ -9,6 +9,7 @@
 #define PROMOTION_H
 
 #include <string>
+#include <vector>
 #include <ctime>
 
 /**
@@ -20,12 +21,26 @@ enum class PromotionType {
     FULL_REDUCTION  // 满减促销
 };
 
+/**
+ * @enum PromotionScope
+ * @brief 折扣促销的适用范围
+ *
+ * 范围保存在target_item_id字段中：
+ * "-1"表示全场，"cat:类别"表示整个类别，"set:ID1|ID2|..."表示一组商品，其他值表示单个商品
+ */
+enum class PromotionScope {
+    ALL,        // 全场
+    ITEM,       // 单个商品
+    CATEGORY,   // 商品类别
+    ITEM_SET    // 商品集合
+};
+
 /**
  * @class Promotion
  * @brief 促销活动类，表示系统中的促销活动信息
  * 
  * 促销活动包括两种类型：
- * 1. 限时折扣：对特定商品或全场商品应用折扣率
+ * 1. 限时折扣：对特定商品、一组商品、某个类别或全场商品应用折扣率
  * 2. 满减活动：订单总额达到门槛金额时减免一定金额
  * 
  * 所有促销活动都有有效期限制
@@ -40,12 +55,18 @@ private:
     time_t endTime;                 // 有效期结束时间
     
     // 折扣促销特有字段
-    std::string targetItemId;       // 目标商品ID（空表示全场）
+    std::string targetItemId;       // 目标范围（见PromotionScope）
     double discountRate;            // 折扣率（如0.8表示8折）
+    PromotionScope scope;           // 由targetItemId解析出的适用范围
+    std::string targetCategory;     // 类别范围的类别名
+    std::vector<std::string> targetItemIds;  // 单品或集合范围的商品ID
     
     // 满减促销特有字段
     double thresholdAmount;         // 满减门槛金额
     double reductionAmount;         // 减免金额
+    std::string stackGroup;         // 互斥组（同组满减最多使用一个，空表示不分组）
+
+    int perUserLimit;               // 每位顾客最多使用次数（0表示不限）
 
 public:
     /**
@@ -60,7 +81,7 @@ public:
      * @param isActive 是否启用
      * @param startTime 有效期开始时间
      * @param endTime 有效期结束时间
-     * @param targetItemId 目标商品ID（"-1"表示全场）
+     * @param targetItemId 目标范围（"-1"表示全场，"cat:类别"，"set:ID1|ID2"或单个商品ID）
      * @param discountRate 折扣率
      */
     Promotion(const std::string& promotionId,
@@ -105,6 +126,11 @@ public:
     double getDiscountRate() const { return discountRate; }
     double getThresholdAmount() const { return thresholdAmount; }
     double getReductionAmount() const { return reductionAmount; }
+    const std::string& getStackGroup() const { return stackGroup; }
+    int getPerUserLimit() const { return perUserLimit; }
+    PromotionScope getScope() const { return scope; }
+    const std::string& getTargetCategory() const { return targetCategory; }
+    const std::vector<std::string>& getTargetItemIds() const { return targetItemIds; }
     
     // Setter方法
     void setPromotionId(const std::string& id) { promotionId = id; }
@@ -112,10 +138,12 @@ public:
     void setIsActive(bool active) { isActive = active; }
     void setStartTime(time_t time) { startTime = time; }
     void setEndTime(time_t time) { endTime = time; }
-    void setTargetItemId(const std::string& id) { targetItemId = id; }
+    void setTargetItemId(const std::string& id);
     void setDiscountRate(double rate) { discountRate = rate; }
     void setThresholdAmount(double amount) { thresholdAmount = amount; }
     void setReductionAmount(double amount) { reductionAmount = amount; }
+    void setStackGroup(const std::string& group) { stackGroup = group; }
+    void setPerUserLimit(int limit) { perUserLimit = limit > 0 ? limit : 0; }
     
     /**
      * @brief 检查促销活动是否有效
@@ -132,13 +160,35 @@ public:
      * @brief 检查某个商品是否适用该促销
      * 
      * 仅对折扣促销有效：
-     * 1. 如果targetItemId为空，表示全场适用
-     * 2. 否则仅对指定商品ID适用
+     * 1. 全场范围对所有商品适用
+     * 2. 类别范围对该类别的商品适用
+     * 3. 单品或集合范围仅对指定商品ID适用
      * 
      * @param itemId 商品ID
+     * @param category 商品类别（为空时类别范围的促销不适用）
      * @return 适用返回true，否则返回false
      */
-    bool isApplicableToItem(const std::string& itemId) const;
+    bool isApplicableToItem(const std::string& itemId, const std::string& category = "") const;
+
+    /**
+     * @brief 获取适用范围的显示文本
+     * @return 如“全场”、“类别: Phone”、“商品: 1, 2”
+     */
+    std::string getScopeDescription() const;
+
+    /**
+     * @brief 由目标范围字符串构造类别范围
+     * @param category 类别名
+     * @return 目标范围字符串
+     */
+    static std::string categoryTarget(const std::string& category);
+
+    /**
+     * @brief 由商品ID列表构造集合范围
+     * @param itemIds 商品ID列表
+     * @return 目标范围字符串
+     */
+    static std::string itemSetTarget(const std::vector<std::string>& itemIds);
     
     /**
      * @brief 计算商品折扣后的价格
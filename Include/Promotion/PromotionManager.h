@@ -9,10 +9,20 @@
 #define PROMOTION_MANAGER_H
 
 #include "Promotion/Promotion.h"
+#include "Promotion/CouponManager.h"
+#include "Promotion/ReductionLadder.h"
+#include "Promotion/PromotionUsageTracker.h"
 #include "ItemManage/Item.h"
+#include "Services/QueryResults.h"
+#include "Interfaces/DependencyInterfaces.h"
 #include <vector>
+#include <unordered_map>
 #include <memory>
 #include <string>
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include <ctime>
 
 /**
  * @struct PromotionResult
@@ -26,8 +36,52 @@ struct PromotionResult {
     double finalTotal;              // 最终支付总额（折扣+满减后）
     double totalSavings;            // 总节省金额
     std::vector<std::string> appliedPromotions;  // 应用的促销描述列表
+    std::vector<std::string> appliedPromotionIds;  // 应用的促销ID（去重，用于记录每人使用次数）
     std::vector<std::pair<std::string, double>> itemDiscounts;  // 商品折扣明细（商品名，折扣金额）
     double totalReduction;          // 满减总金额
+    std::string couponCode;         // 使用的优惠券码（未使用为空）
+    CouponStatus couponStatus;      // 优惠券校验结果
+    std::string couponName;         // 优惠券所属活动名称
+    double couponDiscount;          // 优惠券减免金额
+};
+
+/**
+ * @struct PricingTable
+ * @brief 某一时段内的定价表
+ *
+ * 由促销列表在某个时刻构建，构建后只读，可被多个线程同时使用；
+ * 到达下一个促销开始或结束时间（validUntil），或促销被修改（version不再等于促销版本）时，
+ * 由新构建的表整体替换
+ */
+struct PricingTable {
+    uint64_t version = 0;               // 构建时的促销版本
+    time_t builtFor = 0;                // 构建所对应的时刻
+    time_t validUntil = 0;              // 有效至（不含）：下一个促销开始或结束时间
+    std::unordered_map<std::string, std::shared_ptr<Promotion>> itemDiscounts;      // 商品ID -> 最优的单品或集合折扣
+    std::unordered_map<std::string, std::shared_ptr<Promotion>> categoryDiscounts;  // 类别 -> 最优的类别折扣
+    std::shared_ptr<Promotion> storeWideDiscount;                   // 最优的全场折扣
+    std::vector<std::shared_ptr<Promotion>> limitedDiscounts;       // 有效的限次折扣（因人而异，不进入上面的表）
+    std::vector<std::shared_ptr<Promotion>> activeReductions;       // 有效的满减（按门槛升序）
+    std::vector<std::shared_ptr<Promotion>> limitedReductions;      // 其中限次的满减
+    ReductionLadder ladder;                                         // 有效满减的阶梯
+    std::unordered_map<std::string, std::string> displayTags;       // 促销ID -> 预先生成的标签文本
+
+    /**
+     * @brief 获取有效促销的标签文本
+     * @param promotion 促销活动
+     * @return 标签文本
+     */
+    std::string tagOf(const Promotion& promotion) const;
+};
+
+/**
+ * @struct PromotionEvent
+ * @brief 促销的生效或结束事件
+ */
+struct PromotionEvent {
+    time_t time;                // 触发时间
+    std::string promotionId;    // 促销ID
+    bool activation;            // true为生效，false为结束
 };
 
 /**
@@ -39,11 +93,60 @@ struct PromotionResult {
  * 2. 添加、删除、修改促销活动
  * 3. 查询有效的促销活动
  * 4. 计算订单的促销优惠
+ * 5. 维护可原子替换的定价表，查询商品折扣时不再逐个扫描促销
+ * 6. 结算时使用优惠券，在折扣和满减之后抵扣
+ * 7. 满减按叠加策略和互斥组求解
+ * 8. 按顾客限制促销的使用次数
  */
 class PromotionManager {
 private:
     std::vector<std::shared_ptr<Promotion>> promotions;  // 促销活动列表
     std::string filePath;                                 // 数据文件路径
+    IItemRepository* itemRepository;                      // 商品仓库（用于查询商品类别）
+    CouponManager* couponManager;                         // 优惠券管理器（可选）
+    PromotionUsageTracker* usageTracker;                  // 每人使用次数计数器（可选）
+    StackingPolicy stackingPolicy;                        // 满减叠加策略
+    size_t maxStacked;                                    // 最多叠加的满减数（MAX_N策略）
+
+    // 定价表
+    mutable std::mutex promotionsMutex;                   // 促销列表锁
+    std::atomic<uint64_t> promotionVersion;               // 促销版本（每次修改加一）
+    std::shared_ptr<const PricingTable> pricingTable;     // 当前定价表（只通过std::atomic_load/atomic_store访问）
+    std::atomic<bool> scheduled;                          // 是否由定时器按时替换定价表
+    std::function<void()> changeListener;                 // 促销修改后的回调
+
+    /**
+     * @brief 促销版本加一并通知监听者（所有修改都以此结束）
+     */
+    void markChanged();
+
+    /**
+     * @brief 获取当前定价表，版本过时（或未启用定时器且已过期）时重建
+     *
+     * 定价表整体原子替换：促销修改后在下次查询时重建；启用定时器时由PromotionScheduler
+     * 在促销开始或结束时换上预先构建好的表，否则在查询时检查表是否过期
+     * @return 定价表
+     */
+    std::shared_ptr<const PricingTable> currentPricing();
+
+    /**
+     * @brief 顾客是否已用尽某个限次促销
+     * @param promotion 促销活动
+     * @param userId 用户名（为空时不检查）
+     * @return 已用尽返回true
+     */
+    bool isExhaustedFor(const std::shared_ptr<Promotion>& promotion, const std::string& userId) const;
+
+    /**
+     * @brief 在定价表中查找商品对某位顾客有效的最优折扣
+     * @param table 定价表
+     * @param itemId 商品ID
+     * @param category 商品类别
+     * @param userId 用户名（为空时不检查使用次数）
+     * @return 折扣促销，没有返回nullptr
+     */
+    std::shared_ptr<Promotion> bestDiscountFor(const PricingTable& table, const std::string& itemId,
+                                               const std::string& category, const std::string& userId) const;
     
     /**
      * @brief 去除字符串首尾空格
@@ -84,13 +187,99 @@ public:
      * @brief 析构函数
      */
     ~PromotionManager();
-    
+
+    /**
+     * @brief 设置商品仓库（只按商品ID查询类别的接口需要）
+     * @param repository 商品仓库
+     */
+    void setItemRepository(IItemRepository* repository) { itemRepository = repository; }
+
+    /**
+     * @brief 在锁内读取促销列表，构建某个时刻的定价表（不替换当前表）
+     *
+     * 表中按商品ID、类别和全场保存最优折扣，并包含按门槛排序的满减阶梯和标签文本；
+     * 限次折扣不进入折扣表，单独保存以便按顾客筛选。
+     * 修改促销的方法只在控制台线程调用并持有促销列表锁，因此本函数可在定时器线程调用
+     * @param now 定价表对应的时刻
+     * @return 定价表
+     */
+    std::shared_ptr<const PricingTable> buildPricingTable(time_t now) const;
+
+    /**
+     * @brief 原子地换上定价表
+     * @param table 定价表
+     * @return 表的版本与当前促销版本一致时替换并返回true，否则不替换并返回false
+     */
+    bool installPricingTable(std::shared_ptr<const PricingTable> table);
+
+    /**
+     * @brief 获取某个时刻之后的促销生效和结束事件（在锁内读取，可在定时器线程调用）
+     * @param now 当前时间
+     * @return 事件列表（按时间升序）
+     */
+    std::vector<PromotionEvent> getUpcomingEvents(time_t now) const;
+
+    /**
+     * @brief 设置是否由定时器按时替换定价表（启用后查询时不再检查过期时间）
+     * @param enabled 是否启用
+     */
+    void setScheduled(bool enabled) { scheduled.store(enabled); }
+
+    /**
+     * @brief 设置促销修改后的回调
+     * @param listener 回调函数（为空表示取消）
+     */
+    void setChangeListener(std::function<void()> listener) { changeListener = std::move(listener); }
+
+    /**
+     * @brief 设置满减叠加策略
+     * @param policy 叠加策略
+     * @param maxStacked 最多叠加的满减数（MAX_N策略）
+     */
+    void setStackingPolicy(StackingPolicy policy, size_t maxStacked);
+
+    /**
+     * @brief 获取满减叠加策略
+     * @return 叠加策略
+     */
+    StackingPolicy getStackingPolicy() const { return stackingPolicy; }
+
+    /**
+     * @brief 获取最多叠加的满减数
+     * @return 最多叠加的满减数（MAX_N策略）
+     */
+    size_t getMaxStacked() const { return maxStacked; }
+
+    /**
+     * @brief 设置优惠券管理器
+     * @param manager 优惠券管理器
+     */
+    void setCouponManager(CouponManager* manager) { couponManager = manager; }
+
+    /**
+     * @brief 获取优惠券管理器
+     * @return 优惠券管理器，未设置返回nullptr
+     */
+    CouponManager* getCouponManager() const { return couponManager; }
+
+    /**
+     * @brief 设置每人使用次数计数器（未设置时不限制使用次数）
+     * @param tracker 计数器
+     */
+    void setUsageTracker(PromotionUsageTracker* tracker) { usageTracker = tracker; }
+
     /**
      * @brief 从CSV文件加载促销数据
      * @return 加载成功返回true，否则返回false
      */
     bool loadFromFile();
     
+    /**
+     * @brief 替换促销列表（不写入文件），用于促销模拟
+     * @param list 促销活动列表
+     */
+    void assignPromotions(const std::vector<std::shared_ptr<Promotion>>& list);
+    
     /**
      * @brief 保存促销数据到CSV文件
      * @return 保存成功返回true，否则返回false
@@ -144,9 +333,9 @@ public:
     bool updateDiscountRate(const std::string& promotionId, double newRate);
     
     /**
-     * @brief 修改折扣促销的目标商品
+     * @brief 修改折扣促销的目标范围
      * @param promotionId 促销活动ID
-     * @param newItemId 新的目标商品ID（空字符串表示全场）
+     * @param newItemId 新的目标范围（"-1"表示全场，"cat:类别"，"set:ID1|ID2"或单个商品ID）
      * @return 修改成功返回true，否则返回false（仅对折扣促销有效）
      */
     bool updateDiscountTargetItem(const std::string& promotionId, const std::string& newItemId);
@@ -185,7 +374,8 @@ public:
     /**
      * @brief 获取某个商品当前有效的折扣促销
      * 
-     * 如果有多个有效的折扣促销，返回折扣率最低的（优惠最大的）
+     * 如果有多个有效的折扣促销，返回折扣率最低的（优惠最大的）；
+     * 查询定价表，代价为O(1)；限次折扣不区分顾客，视为可用
      * 
      * @param itemId 商品ID
      * @return 有效的折扣促销对象，如果没有返回nullptr
@@ -202,16 +392,63 @@ public:
      * @brief 计算一组商品的促销优惠结果
      * 
      * 计算流程：
-     * 1. 遍历商品，计算每个商品的折扣价
-     * 2. 累加得到折扣后总额
-     * 3. 应用满减优惠
-     * 4. 返回详细的促销结果
+     * 1. 遍历商品，按商品ID和当前类别查定价表得到最优折扣（跳过顾客已用尽的限次促销）
+     * 2. 按叠加策略（全部叠加、只取最优、最多N个）和互斥组求解满减，
+     *    并比较“放弃部分折扣以达到更高满减门槛”的组合，取总价最低者；
+     *    顾客用尽某个限次满减时临时编译不含它的阶梯，其余顾客仍使用共享阶梯
+     * 3. 累加得到折扣后总额和满减总额
+     * 4. 由CouponManager校验优惠券（不核销），可用时从满减后的金额中抵扣
+     * 5. 返回详细的促销结果
      * 
      * @param items 商品及数量的列表
+     * @param couponCode 优惠券码（空字符串表示不使用）
+     * @param userId 用户名（空字符串表示不检查每人使用次数）
      * @return 促销计算结果
      */
     PromotionResult calculatePromotionResult(
-        const std::vector<std::pair<std::shared_ptr<Item>, int>>& items);
+        const std::vector<std::pair<std::shared_ptr<Item>, int>>& items,
+        const std::string& couponCode = "",
+        const std::string& userId = "");
+
+    /**
+     * @brief 为订单记录限次促销的使用次数
+     * 
+     * 逐个检查并加一，任何一个已达到上限时撤销已记录的部分
+     * 
+     * @param result 促销计算结果
+     * @param userId 用户名
+     * @return 全部记录成功返回true，否则返回false
+     */
+    bool reserveUsage(const PromotionResult& result, const std::string& userId);
+
+    /**
+     * @brief 撤销订单记录的限次促销使用次数（下单失败时调用）
+     * @param result 促销计算结果
+     * @param userId 用户名
+     */
+    void releaseUsage(const PromotionResult& result, const std::string& userId);
+
+    /**
+     * @brief 为一组商品核销优惠券
+     * 
+     * 按折扣和满减后的金额判断门槛，校验通过后原子地标记为已使用
+     * 
+     * @param items 商品及数量的列表
+     * @param couponCode 优惠券码
+     * @param reference 关联单号或用户名
+     * @param userId 用户名（用于按每人使用次数计算金额，空字符串表示不检查）
+     * @return 核销结果
+     */
+    CouponStatus redeemCoupon(
+        const std::vector<std::pair<std::shared_ptr<Item>, int>>& items,
+        const std::string& couponCode, const std::string& reference,
+        const std::string& userId = "");
+    
+    /**
+     * @brief 查询所有促销活动（不产生输出）
+     * @return 促销行列表
+     */
+    std::vector<PromotionRow> queryAllPromotions() const;
     
     /**
      * @brief 显示所有促销活动
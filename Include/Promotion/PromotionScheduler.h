@@ -0,0 +1,87 @@
+/**
+ * @file PromotionScheduler.h
+ * @brief 促销定时器（按促销开始和结束时间替换定价表）的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef PROMOTION_SCHEDULER_H
+#define PROMOTION_SCHEDULER_H
+
+#include "Promotion/PromotionManager.h"
+#include <queue>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * @class PromotionScheduler
+ * @brief 促销定时器：用一个后台线程和一个按时间排序的事件队列驱动促销的生效与结束
+ *
+ * 特点：
+ * 1. 队列中保存所有尚未发生的生效和结束事件，线程睡眠到最早的事件时间，
+ *    到点后一次处理同一时刻的全部事件，并原子地换上该时刻的定价表
+ * 2. 下一时刻的定价表在等待之前就已构建好，到点时只需替换指针
+ * 3. 启用后PromotionManager查询时只比较版本号，不再逐次检查有效期
+ * 4. 促销被修改时由PromotionManager回调通知，线程立即重建当前定价表并重新生成事件队列
+ *
+ * 线程调用PromotionManager时不持有定时器的锁，避免与持有促销列表锁并回调的修改操作互相等待
+ */
+class PromotionScheduler {
+private:
+    /**
+     * @struct LaterFirst
+     * @brief 事件比较器（时间早的在堆顶）
+     */
+    struct LaterFirst {
+        bool operator()(const PromotionEvent& a, const PromotionEvent& b) const { return a.time > b.time; }
+    };
+
+    PromotionManager* manager;                                      // 促销管理器
+    std::priority_queue<PromotionEvent, std::vector<PromotionEvent>, LaterFirst> events;  // 待触发事件
+    std::shared_ptr<const PricingTable> prepared;                   // 为下一个事件时间预先构建的定价表
+    std::thread timerThread;                                        // 定时器线程
+    std::mutex mutex;                                               // 保护下面的标志和事件队列
+    std::condition_variable wakeup;                                 // 停止或促销修改时唤醒线程
+    bool running;                                                   // 是否运行中
+    bool changed;                                                   // 促销是否被修改
+
+    /**
+     * @brief 定时器线程主循环
+     */
+    void run();
+
+    /**
+     * @brief 促销被修改时的回调
+     */
+    void notifyChanged();
+
+public:
+    /**
+     * @brief 构造函数
+     * @param manager 促销管理器
+     */
+    explicit PromotionScheduler(PromotionManager* manager);
+
+    /**
+     * @brief 析构函数，停止定时器
+     */
+    ~PromotionScheduler();
+
+    PromotionScheduler(const PromotionScheduler&) = delete;
+    PromotionScheduler& operator=(const PromotionScheduler&) = delete;
+
+    /**
+     * @brief 启动定时器
+     */
+    void start();
+
+    /**
+     * @brief 停止定时器（促销管理器恢复为查询时检查有效期）
+     */
+    void stop();
+};
+
+#endif // PROMOTION_SCHEDULER_H
@@ -0,0 +1,106 @@
+/**
+ * @file PromotionSimulator.h
+ * @brief 促销模拟器（用历史订单或购物车评估一组促销的成本）的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef PROMOTION_SIMULATOR_H
+#define PROMOTION_SIMULATOR_H
+
+#include "Promotion/Promotion.h"
+#include "Promotion/ReductionLadder.h"
+#include "Order/Order.h"
+#include "ShoppingCart/ShoppingCart.h"
+#include "Interfaces/DependencyInterfaces.h"
+#include <vector>
+#include <memory>
+#include <string>
+#include <functional>
+
+/**
+ * @struct SimulationReport
+ * @brief 模拟结果
+ */
+struct SimulationReport {
+    size_t basketCount = 0;         // 重放的订单（或购物车）数
+    size_t affectedCount = 0;       // 享受到优惠的订单数
+    double originalTotal = 0.0;     // 原价总额
+    double discountCost = 0.0;      // 折扣成本
+    double reductionCost = 0.0;     // 满减成本
+    double finalTotal = 0.0;        // 优惠后总额
+    size_t threads = 0;             // 使用的线程数
+    double elapsedSeconds = 0.0;    // 耗时（秒）
+    std::vector<std::pair<std::string, size_t>> promotionUsage;  // (促销ID, 使用该促销的订单数)，按订单数降序
+
+    /**
+     * @brief 优惠总成本
+     */
+    double totalCost() const { return discountCost + reductionCost; }
+};
+
+/**
+ * @class PromotionSimulator
+ * @brief 促销模拟器：把一组候选促销套用到历史订单或当前购物车上，统计优惠成本
+ *
+ * 特点：
+ * 1. 计价直接使用PromotionManager::calculatePromotionResult，与真实结算的折扣、满减叠加规则一致
+ * 2. 每个工作线程持有一个只装载候选促销的PromotionManager（定价表各自独立，互不加锁），
+ *    线程通过原子游标按块领取订单，边计价边累加到线程内的统计，最后合并，不保存逐单结果
+ * 3. 历史订单按下单时的价格重建商品，类别取自当前商品仓库（已删除的商品视为无类别）
+ * 4. 可忽略候选促销的有效期，用于评估尚未开始的活动；不考虑每人限用次数和优惠券
+ *
+ * 模拟期间商品仓库只被读取，调用方需保证没有并发修改商品
+ */
+class PromotionSimulator {
+private:
+    std::vector<std::shared_ptr<Promotion>> candidates;     // 候选促销（已按需展开有效期）
+    IItemRepository* itemRepository;                        // 商品仓库（用于类别范围的折扣）
+    StackingPolicy stackingPolicy;                          // 满减叠加策略
+    size_t maxStacked;                                      // 最多叠加的满减数
+    size_t threadCount;                                     // 工作线程数
+
+    /**
+     * @brief 用于填充第i个订单商品列表的函数
+     */
+    using BasketSource = std::function<void(size_t, std::vector<std::pair<std::shared_ptr<Item>, int>>&)>;
+
+    /**
+     * @brief 并行重放count个订单
+     * @param count 订单数
+     * @param source 订单商品列表的来源
+     * @return 模拟结果
+     */
+    SimulationReport run(size_t count, const BasketSource& source) const;
+
+public:
+    /**
+     * @brief 构造函数
+     * @param promotions 候选促销
+     * @param itemRepository 商品仓库
+     * @param stackingPolicy 满减叠加策略
+     * @param maxStacked 最多叠加的满减数（MAX_N策略）
+     * @param ignoreSchedule 是否忽略有效期（视为一直有效，仍遵守启用状态）
+     * @param threadCount 工作线程数（0表示按CPU核数）
+     */
+    PromotionSimulator(const std::vector<std::shared_ptr<Promotion>>& promotions,
+                       IItemRepository* itemRepository,
+                       StackingPolicy stackingPolicy, size_t maxStacked,
+                       bool ignoreSchedule, size_t threadCount = 0);
+
+    /**
+     * @brief 重放历史订单
+     * @param orders 订单列表
+     * @return 模拟结果
+     */
+    SimulationReport replayOrders(const std::vector<std::shared_ptr<Order>>& orders) const;
+
+    /**
+     * @brief 重放购物车（按当前价格）
+     * @param carts 购物车列表
+     * @return 模拟结果
+     */
+    SimulationReport replayCarts(const std::vector<std::shared_ptr<ShoppingCart>>& carts) const;
+};
+
+#endif // PROMOTION_SIMULATOR_H
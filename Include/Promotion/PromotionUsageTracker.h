@@ -0,0 +1,141 @@
+/**
+ * @file PromotionUsageTracker.h
+ * @brief 每位顾客的促销使用次数计数器的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef PROMOTION_USAGE_TRACKER_H
+#define PROMOTION_USAGE_TRACKER_H
+
+#include <vector>
+#include <unordered_map>
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <shared_mutex>
+#include <cstdint>
+
+/**
+ * @class PromotionUsageTracker
+ * @brief 记录每个（顾客, 促销）的使用次数，用于“每人限用N次”的促销
+ *
+ * 特点：
+ * 1. 用户名和促销ID各自映射为32位编号，二者拼成64位键；计数保存在分段的开放寻址哈希表中，
+ *    每段一把锁，每项只占12字节，内存与实际使用记录数成正比，与顾客数 × 促销数无关
+ * 2. 查询时顾客从未使用过任何限次促销则直接返回0，不访问计数表
+ * 3. tryConsume在段锁内完成“检查是否达到上限并加一”，同一顾客并发下单不会超用
+ * 4. 每次计数变化追加一条变长记录到日志文件，启动时重放；
+ *    日志记录数远多于计数项数时，加载后把当前计数重写为一份紧凑的日志
+ *
+ * 日志格式：8字节魔数后跟若干记录，每条记录为16字节头部加用户名和促销ID：
+ *   [0,8) 时间  [8,12) 变化量  [12,14) 用户名长度  [14,16) 促销ID长度，整数均为小端序
+ */
+class PromotionUsageTracker {
+private:
+    static const size_t STRIPE_COUNT = 64;      // 分段数（2的幂）
+
+    /**
+     * @struct Stripe
+     * @brief 计数表的一段（开放寻址，线性探测）
+     */
+    struct Stripe {
+        std::mutex mutex;                       // 段锁
+        std::vector<uint64_t> keys;             // 键（0表示空位）
+        std::vector<uint32_t> counts;           // 与keys平行：使用次数
+        size_t size = 0;                        // 已占用的位置数
+    };
+
+    std::string filePath;                                       // 日志文件路径
+    mutable Stripe stripes[STRIPE_COUNT];                       // 计数表各段
+
+    mutable std::shared_mutex internMutex;                      // 编号表读写锁
+    std::unordered_map<std::string, uint32_t> userIds;          // 用户名 -> 编号
+    std::unordered_map<std::string, uint32_t> promotionIds;     // 促销ID -> 编号
+    std::vector<std::string> userNames;                         // 编号 -> 用户名
+    std::vector<std::string> promotionNames;                    // 编号 -> 促销ID
+
+    std::ofstream writer;                                       // 日志追加写入流
+    std::mutex logMutex;                                        // 日志写入锁
+    uint64_t recordCount;                                       // 日志记录数
+
+    /**
+     * @brief 查找已有编号，不存在返回false
+     */
+    bool lookupKey(const std::string& userId, const std::string& promotionId, uint64_t& key) const;
+
+    /**
+     * @brief 获取编号，不存在时分配
+     */
+    uint64_t internKey(const std::string& userId, const std::string& promotionId);
+
+    /**
+     * @brief 键所在的段
+     */
+    Stripe& stripeOf(uint64_t key) const;
+
+    /**
+     * @brief 在段中查找键的位置，不存在时返回空位（调用者需持有段锁）
+     */
+    static size_t probe(const Stripe& stripe, uint64_t key);
+
+    /**
+     * @brief 获取键的计数引用，不存在时插入（调用者需持有段锁）
+     */
+    static uint32_t& slotFor(Stripe& stripe, uint64_t key);
+
+    /**
+     * @brief 追加一条日志记录
+     */
+    bool appendLog(const std::string& userId, const std::string& promotionId, int32_t delta);
+
+    /**
+     * @brief 把当前计数重写为紧凑日志
+     */
+    bool compact();
+
+public:
+    /**
+     * @brief 构造函数
+     * @param filePath 日志文件路径
+     */
+    explicit PromotionUsageTracker(const std::string& filePath);
+
+    /**
+     * @brief 加载日志（文件不存在时创建），必要时压缩
+     * @return 加载成功返回true，否则返回false
+     */
+    bool loadFromFile();
+
+    /**
+     * @brief 获取顾客使用某个促销的次数
+     * @param userId 用户名
+     * @param promotionId 促销ID
+     * @return 使用次数
+     */
+    uint32_t getUsage(const std::string& userId, const std::string& promotionId) const;
+
+    /**
+     * @brief 未达到上限时把使用次数加一并写入日志
+     * @param userId 用户名
+     * @param promotionId 促销ID
+     * @param limit 每人上限
+     * @return 成功返回true，已达到上限或写入失败返回false
+     */
+    bool tryConsume(const std::string& userId, const std::string& promotionId, uint32_t limit);
+
+    /**
+     * @brief 撤销一次使用（下单失败时调用）
+     * @param userId 用户名
+     * @param promotionId 促销ID
+     */
+    void release(const std::string& userId, const std::string& promotionId);
+
+    /**
+     * @brief 获取计数项数（有使用记录的（顾客, 促销）对数）
+     * @return 计数项数
+     */
+    size_t size() const;
+};
+
+#endif // PROMOTION_USAGE_TRACKER_H
@@ -0,0 +1,130 @@
+/**
+ * @file ReductionLadder.h
+ * @brief 满减阶梯（按门槛预编译的满减叠加求解器）的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef REDUCTION_LADDER_H
+#define REDUCTION_LADDER_H
+
+#include "Promotion/Promotion.h"
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <cstdint>
+
+/**
+ * @brief 满减叠加策略
+ */
+enum class StackingPolicy {
+    STACK_ALL,  // 所有达到门槛的满减都叠加（互斥组内只取一个）
+    BEST_OF,    // 只使用减免金额最大的一个满减
+    MAX_N       // 最多叠加N个满减（互斥组内只取一个）
+};
+
+/**
+ * @struct ReductionPick
+ * @brief 某个金额下选中的满减组合
+ */
+struct ReductionPick {
+    double total = 0.0;                                     // 减免总金额
+    std::vector<std::shared_ptr<Promotion>> promotions;     // 选中的满减（按减免金额降序）
+};
+
+/**
+ * @class ReductionLadder
+ * @brief 满减阶梯：把有效的满减按门槛预编译，查询任意金额下减免最多的合法组合
+ *
+ * 满减的减免金额与订单金额无关，因此在“每个互斥组最多一个、总数最多N个”的约束下，
+ * 先取每组内可用的最大减免、再取其中最大的N个即为最优组合。
+ *
+ * 编译结果：
+ * 1. 每个互斥组一条阶梯：门槛升序，附带前缀最优（门槛不超过第i档时该组最大的减免）
+ * 2. 未分组的满减合成一条阶梯：叠加全部时可用的档全部入选；最多N个时附带前缀前N名
+ * 3. 只取最优时所有满减合成一条阶梯
+ *
+ * 查询时在每条阶梯上二分查找可用的最高档，代价为O(组数 × log 档数 + N)；
+ * 同一编译版本内按金额（分）缓存查询结果。编译后查询不修改阶梯本身（缓存有独立的锁），
+ * 可被多个线程同时查询
+ */
+class ReductionLadder {
+private:
+    /**
+     * @struct Ladder
+     * @brief 一条按门槛升序的阶梯
+     */
+    struct Ladder {
+        std::vector<double> thresholds;                 // 门槛（升序）
+        std::vector<size_t> promotionIndex;             // 与thresholds平行：满减在promotions中的下标
+        std::vector<size_t> prefixBest;                 // 前i+1档中减免最大的满减下标
+        std::vector<std::vector<size_t>> prefixTop;     // 前i+1档中减免最大的N个（仅未分组阶梯，最多N个时）
+
+        /**
+         * @brief 门槛不超过amount的档数
+         */
+        size_t reachable(double amount) const;
+    };
+
+    StackingPolicy policy;                                  // 叠加策略
+    size_t maxStacked;                                      // 最多叠加的满减数（MAX_N）
+    std::vector<std::shared_ptr<Promotion>> promotions;     // 编译时有效的满减
+    std::vector<Ladder> groups;                             // 各互斥组的阶梯
+    Ladder ungrouped;                                       // 未分组满减的阶梯
+    std::vector<double> allThresholds;                      // 全部门槛（升序去重）
+    mutable std::unordered_map<long long, ReductionPick> memo;  // 金额（分） -> 查询结果
+    mutable std::mutex memoMutex;                           // 查询缓存锁
+
+    /**
+     * @brief 按门槛排序并计算前缀最优
+     */
+    void buildLadder(Ladder& ladder, std::vector<size_t> members);
+
+public:
+    /**
+     * @brief 构造函数
+     */
+    ReductionLadder();
+
+    /**
+     * @brief 编译满减阶梯并清空查询缓存
+     * @param reductions 此刻有效的满减促销
+     * @param policy 叠加策略
+     * @param maxStacked 最多叠加的满减数（MAX_N策略）
+     */
+    void compile(const std::vector<std::shared_ptr<Promotion>>& reductions,
+                 StackingPolicy policy, size_t maxStacked);
+
+    /**
+     * @brief 查询金额下减免最多的合法满减组合
+     * @param amount 折扣后的订单金额
+     * @return 选中的满减组合
+     */
+    ReductionPick best(double amount) const;
+
+    /**
+     * @brief 获取位于(low, high]之间的门槛
+     * @param low 下界（不含）
+     * @param high 上界（含）
+     * @return 门槛（升序）
+     */
+    std::vector<double> thresholdsBetween(double low, double high) const;
+
+    /**
+     * @brief 解析叠加策略字符串（stack_all、best_of、max_n）
+     * @param str 策略字符串
+     * @return 叠加策略，无法识别时返回STACK_ALL
+     */
+    static StackingPolicy parsePolicy(const std::string& str);
+
+    /**
+     * @brief 获取叠加策略的显示字符串
+     * @param policy 叠加策略
+     * @return 显示字符串
+     */
+    static std::string policyToString(StackingPolicy policy);
+};
+
+#endif // REDUCTION_LADDER_H
@@ -0,0 +1,191 @@
+/**
+ * @file AdmissionController.h
+ * @brief 准入控制器（按操作类别限制并发、排队和拒绝）的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef ADMISSION_CONTROLLER_H
+#define ADMISSION_CONTROLLER_H
+
+#include <array>
+#include <deque>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @enum OperationClass
+ * @brief 受准入控制的高开销操作类别
+ */
+enum class OperationClass {
+    SEARCH,     // 模糊搜索
+    LISTING,    // 全量商品列表
+    REPORT      // 报表生成
+};
+
+const size_t OPERATION_CLASS_COUNT = 3;
+
+/**
+ * @struct AdmissionLimits
+ * @brief 某类操作的准入限制
+ */
+struct AdmissionLimits {
+    size_t maxConcurrent = 0;   // 最多同时执行数（0表示不限制）
+    size_t maxQueued = 0;       // 执行数已满时最多排队数（0表示不排队，直接拒绝）
+    int maxWaitMs = 0;          // 排队最长等待时间（毫秒），超时视为拒绝
+};
+
+/**
+ * @struct AdmissionStats
+ * @brief 某类操作的准入统计
+ */
+struct AdmissionStats {
+    OperationClass operationClass = OperationClass::SEARCH;   // 操作类别
+    AdmissionLimits limits;         // 当前限制
+    size_t running = 0;             // 正在执行数
+    size_t queued = 0;              // 当前队列深度
+    size_t peakQueued = 0;          // 历史最大队列深度
+    uint64_t admitted = 0;          // 准入数
+    uint64_t queuedAdmitted = 0;    // 经过排队后准入的数量
+    uint64_t rejected = 0;          // 队列已满被拒绝数
+    uint64_t timedOut = 0;          // 排队超时被拒绝数
+    double totalWaitMs = 0.0;       // 排队准入的总等待时间（毫秒）
+    double maxWaitMs = 0.0;         // 最长等待时间（毫秒）
+
+    /**
+     * @brief 排队准入的平均等待时间（毫秒）
+     */
+    double averageWaitMs() const { return queuedAdmitted > 0 ? totalWaitMs / queuedAdmitted : 0.0; }
+};
+
+/**
+ * @class AdmissionController
+ * @brief 准入控制器：为每类高开销操作设置并发上限和有界等待队列
+ *
+ * 特点：
+ * 1. 执行数未满且无人排队时直接准入；否则按到达顺序排队，队首在有空位时准入
+ * 2. 队列已满或等待超时时拒绝，调用方据此放弃请求或返回降级结果（例如只做精确搜索），
+ *    使突发的搜索、列表和报表不会占满CPU，下单流水线的延迟保持稳定
+ * 3. 准入凭证（Permit）析构时自动归还执行名额
+ */
+class AdmissionController {
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @struct Lane
+     * @brief 一类操作的执行名额和等待队列
+     */
+    struct Lane {
+        mutable std::mutex mutex;
+        std::condition_variable ready;      // 名额释放或队首变化
+        AdmissionLimits limits;
+        size_t running = 0;
+        std::deque<uint64_t> waiting;       // 排队者的票号（按到达顺序）
+        uint64_t nextTicket = 0;
+        AdmissionStats stats;
+    };
+
+    std::array<Lane, OPERATION_CLASS_COUNT> lanes;
+
+    /**
+     * @brief 归还执行名额
+     */
+    void release(OperationClass operationClass);
+
+public:
+    /**
+     * @class Permit
+     * @brief 准入凭证，持有期间占用一个执行名额
+     */
+    class Permit {
+    private:
+        AdmissionController* owner;         // 为空表示未准入
+        OperationClass operationClass;
+        double waitedMs;
+
+    public:
+        Permit() : owner(nullptr), operationClass(OperationClass::SEARCH), waitedMs(0.0) {}
+        Permit(AdmissionController* owner, OperationClass operationClass, double waitedMs)
+            : owner(owner), operationClass(operationClass), waitedMs(waitedMs) {}
+        Permit(Permit&& other) noexcept
+            : owner(other.owner), operationClass(other.operationClass), waitedMs(other.waitedMs) {
+            other.owner = nullptr;
+        }
+        Permit& operator=(Permit&& other) noexcept {
+            if (this != &other) {
+                reset();
+                owner = other.owner;
+                operationClass = other.operationClass;
+                waitedMs = other.waitedMs;
+                other.owner = nullptr;
+            }
+            return *this;
+        }
+        Permit(const Permit&) = delete;
+        Permit& operator=(const Permit&) = delete;
+        ~Permit() { reset(); }
+
+        /**
+         * @brief 是否已准入
+         */
+        bool granted() const { return owner != nullptr; }
+        explicit operator bool() const { return granted(); }
+
+        /**
+         * @brief 准入前的排队时间（毫秒）
+         */
+        double getWaitedMs() const { return waitedMs; }
+
+        /**
+         * @brief 提前归还执行名额
+         */
+        void reset() {
+            if (owner) {
+                owner->release(operationClass);
+                owner = nullptr;
+            }
+        }
+    };
+
+    /**
+     * @brief 构造函数，各类操作默认不限制
+     */
+    AdmissionController();
+
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    /**
+     * @brief 设置某类操作的准入限制（正在排队的请求按新限制判断）
+     * @param operationClass 操作类别
+     * @param limits 准入限制
+     */
+    void configure(OperationClass operationClass, const AdmissionLimits& limits);
+
+    /**
+     * @brief 申请执行名额（必要时排队等待）
+     * @param operationClass 操作类别
+     * @return 准入凭证，未准入时granted()为false
+     */
+    Permit admit(OperationClass operationClass);
+
+    /**
+     * @brief 获取各类操作的统计
+     * @return 统计列表（按操作类别顺序）
+     */
+    std::vector<AdmissionStats> getStats() const;
+
+    /**
+     * @brief 获取操作类别的显示字符串
+     * @param operationClass 操作类别
+     * @return 显示字符串
+     */
+    static std::string classToString(OperationClass operationClass);
+};
+
+#endif // ADMISSION_CONTROLLER_H
@@ -0,0 +1,137 @@
+/**
+ * @file CoPurchaseEngine.h
+ * @brief “经常一起购买”推荐引擎的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef CO_PURCHASE_ENGINE_H
+#define CO_PURCHASE_ENGINE_H
+
+#include "Order/Order.h"
+#include "Interfaces/DependencyInterfaces.h"
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <string>
+#include <mutex>
+#include <cstdint>
+
+/**
+ * @struct RelatedItem
+ * @brief 推荐结果中的一项
+ */
+struct RelatedItem {
+    std::string itemId;     // 商品ID
+    uint64_t score;         // 共同购买次数（购物车推荐时为各商品得分之和）
+};
+
+/**
+ * @class CoPurchaseEngine
+ * @brief 基于订单共现的“经常一起购买”推荐引擎
+ *
+ * 特点：
+ * 1. 商品ID映射为连续的整数下标，两件商品出现在同一订单中即共现一次
+ * 2. 完整的共现计数按行保存为稀疏矩阵（每行按下标有序的数组），用于增量更新
+ * 3. 查询使用CSR布局的只读邻接表：每个商品只保留共现次数最高的K个邻居，
+ *    单品查询为O(K)，购物车查询为O(购物车商品数 × K)
+ * 4. 全量构建时订单分块并行处理，共现对用计数排序按行归位，再按行并行合并计数和截取前K个邻居
+ * 5. 新订单只重算受影响商品的邻居列表，写入覆盖表；覆盖表过大时合并回CSR
+ */
+class CoPurchaseEngine : public IOrderObserver {
+public:
+    /**
+     * @struct Neighbor
+     * @brief 邻接表中的一个邻居
+     */
+    struct Neighbor {
+        uint32_t item;      // 商品下标
+        uint32_t count;     // 共现次数
+    };
+
+private:
+    size_t neighborsPerItem;                                    // 每个商品保留的邻居数K
+    std::unordered_map<std::string, uint32_t> indexOf;          // 商品ID -> 下标
+    std::vector<std::string> itemIds;                           // 下标 -> 商品ID
+    std::vector<std::vector<Neighbor>> counts;                  // 完整共现计数（按行，行内按下标升序）
+
+    // CSR邻接表：第i行的邻居为neighbors[rowOffsets[i], rowOffsets[i + 1])，按共现次数降序
+    std::vector<uint64_t> rowOffsets;
+    std::vector<Neighbor> neighbors;
+
+    std::unordered_map<uint32_t, std::vector<Neighbor>> overlay;  // 增量更新后的行（优先于CSR）
+    mutable std::mutex mutex;                                   // 互斥锁
+
+    /**
+     * @brief 获取或分配商品下标（调用者需持有锁）
+     */
+    uint32_t internItem(const std::string& itemId);
+
+    /**
+     * @brief 从一行完整计数中选出前K个邻居
+     */
+    std::vector<Neighbor> topNeighbors(const std::vector<Neighbor>& row) const;
+
+    /**
+     * @brief 获取某行当前的邻居列表（调用者需持有锁）
+     * @param row 商品下标
+     * @param begin 输出的起始指针
+     * @param end 输出的结束指针
+     */
+    void rowNeighbors(uint32_t row, const Neighbor*& begin, const Neighbor*& end) const;
+
+    /**
+     * @brief 把覆盖表合并回CSR（调用者需持有锁）
+     */
+    void compact();
+
+public:
+    /**
+     * @brief 构造函数
+     * @param neighborsPerItem 每个商品保留的邻居数K
+     */
+    explicit CoPurchaseEngine(size_t neighborsPerItem = 20);
+
+    /**
+     * @brief 用全部订单重建共现矩阵
+     * @param orders 订单列表
+     * @param threadCount 线程数（0表示使用硬件并发数）
+     */
+    void rebuild(const std::vector<std::shared_ptr<Order>>& orders, size_t threadCount = 0);
+
+    /**
+     * @brief 增量加入一个订单
+     * @param order 订单对象
+     */
+    void addOrder(const Order& order);
+
+    /**
+     * @brief 订单创建事件（增量加入订单）
+     * @param order 订单对象
+     */
+    void onOrderCreated(const Order& order) override { addOrder(order); }
+
+    /**
+     * @brief 获取与某商品经常一起购买的商品
+     * @param itemId 商品ID
+     * @param limit 返回数量上限（不超过K）
+     * @return 推荐商品，按共现次数降序
+     */
+    std::vector<RelatedItem> relatedItems(const std::string& itemId, size_t limit) const;
+
+    /**
+     * @brief 获取与购物车中的商品经常一起购买的商品（不含购物车中已有的商品）
+     * @param cartItemIds 购物车中的商品ID
+     * @param limit 返回数量上限
+     * @return 推荐商品，按得分降序
+     */
+    std::vector<RelatedItem> relatedToCart(const std::vector<std::string>& cartItemIds, size_t limit) const;
+
+    /**
+     * @brief 获取参与共现的商品数
+     * @return 商品数
+     */
+    size_t itemCount() const;
+};
+
+#endif // CO_PURCHASE_ENGINE_H
@@ -120,6 +120,18 @@ private:
                                      const std::string& outputPath);
 
 public:
+    /**
+     * @brief 统计一组订单的类别和商品数据（供推荐等其他服务复用）
+     * @param orders 订单列表
+     * @param itemManager 商品管理器，用于获取商品类别信息
+     * @param categoryStats 按类别统计的数据（输出参数）
+     * @param itemStats 按商品统计的数据（输出参数）
+     */
+    static void CollectStatistics(const std::vector<std::shared_ptr<Order>>& orders,
+                                  IItemRepository* itemManager,
+                                  std::map<std::string, CategoryStatistics>& categoryStats,
+                                  std::map<std::string, ItemStatistics>& itemStats);
+
     /**
      * @brief 为顾客生成购买数据统计报告
      * 
@@ -0,0 +1,103 @@
+/**
+ * @file ListingRenderer.h
+ * @brief 列表渲染器的定义（控制台、CSV、JSON）
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef LISTING_RENDERER_H
+#define LISTING_RENDERER_H
+
+#include "Services/QueryResults.h"
+#include "ItemManage/ItemSearcher.h"
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @enum RenderFormat
+ * @brief 输出格式枚举
+ */
+enum class RenderFormat {
+    CONSOLE,        // 控制台表格
+    CSV,            // CSV文本
+    JSON            // JSON数组
+};
+
+/**
+ * @class ListingRenderer
+ * @brief 列表渲染器，把查询结果输出为指定格式
+ *
+ * 各管理器只负责在持锁期间生成结果快照（见QueryResults.h），
+ * 渲染器只读取快照，输出期间不持有任何管理器的锁
+ */
+class ListingRenderer {
+public:
+    /**
+     * @brief 渲染商品列表
+     * @param listing 商品列表查询结果
+     * @param format 输出格式
+     * @param os 输出流
+     */
+    static void renderItems(const ItemListing& listing, RenderFormat format, std::ostream& os);
+
+    /**
+     * @brief 渲染订单列表
+     * @param rows 订单行
+     * @param includeUser 是否包含用户ID列（管理员视图为true，顾客视图为false）
+     * @param format 输出格式
+     * @param os 输出流
+     */
+    static void renderOrders(const std::vector<OrderRow>& rows, bool includeUser,
+                             RenderFormat format, std::ostream& os);
+
+    /**
+     * @brief 渲染促销活动列表
+     * @param rows 促销行
+     * @param format 输出格式
+     * @param os 输出流
+     */
+    static void renderPromotions(const std::vector<PromotionRow>& rows, RenderFormat format, std::ostream& os);
+
+    /**
+     * @brief 以简要形式在控制台渲染当前有效的促销活动
+     * @param rows 促销行（只输出isValid为true的行）
+     * @param os 输出流
+     */
+    static void renderActivePromotions(const std::vector<PromotionRow>& rows, std::ostream& os);
+
+    /**
+     * @brief 渲染顾客列表
+     * @param rows 顾客行
+     * @param format 输出格式
+     * @param os 输出流
+     */
+    static void renderCustomers(const std::vector<CustomerRow>& rows, RenderFormat format, std::ostream& os);
+
+    /**
+     * @brief 渲染搜索结果
+     * @param results 搜索结果
+     * @param showSimilarity 是否输出相似度
+     * @param format 输出格式
+     * @param os 输出流
+     */
+    static void renderSearchResults(const std::vector<SearchResult>& results, bool showSimilarity,
+                                    RenderFormat format, std::ostream& os);
+
+    /**
+     * @brief 输出搜索的匹配摘要（如“找到N个精确匹配结果”）
+     * @param outcome 搜索结果
+     * @param os 输出流
+     */
+    static void renderSearchSummary(const SearchOutcome& outcome, std::ostream& os);
+
+    /**
+     * @brief 将字符串解析为输出格式（console/csv/json，不区分大小写）
+     * @param str 格式字符串
+     * @param format 输出的格式
+     * @return 解析成功返回true，否则返回false
+     */
+    static bool parseFormat(const std::string& str, RenderFormat& format);
+};
+
+#endif // LISTING_RENDERER_H
@@ -0,0 +1,166 @@
+/**
+ * @file PersonalRecommender.h
+ * @brief 基于顾客类别偏好的个性化推荐服务的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef PERSONAL_RECOMMENDER_H
+#define PERSONAL_RECOMMENDER_H
+
+#include "Order/Order.h"
+#include "Order/OrderManager.h"
+#include "Interfaces/DependencyInterfaces.h"
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include <mutex>
+#include <cstdint>
+
+/**
+ * @struct Recommendation
+ * @brief 个性化推荐结果中的一项
+ */
+struct Recommendation {
+    std::string itemId;     // 商品ID
+    std::string category;   // 商品类别
+    double score;           // 推荐得分（类别偏好 × 类别内热度）
+};
+
+/**
+ * @class PersonalRecommender
+ * @brief 个性化推荐服务
+ *
+ * 特点：
+ * 1. 复用CustomerReportService的类别统计，按金额占比和频度占比各一半算出归一化的类别偏好向量
+ * 2. 每个类别预先计算有货商品的热销榜（按销量降序，热度按类别内最高销量归一化），
+ *    商品得分 = 类别偏好 × 热度；各类别热销榜多路归并即可按得分降序取出前N个，已购买过的商品跳过
+ * 3. 每位顾客的偏好向量和前N个推荐结果都会缓存，缓存记录所依赖类别的榜单版本：
+ *    顾客本人下单时丢弃其偏好向量；其他订单或商品变动只使相关类别的榜单失效，
+ *    下次查询时发现版本变化才重算推荐（无需重新扫描订单）
+ * 4. 命中缓存时查询代价为O(偏好类别数 + N)
+ * 5. 没有购买记录的顾客按所有类别均匀偏好，即推荐各类别的热销商品
+ */
+class PersonalRecommender : public IOrderObserver, public IItemChangeListener {
+private:
+    /**
+     * @struct Candidate
+     * @brief 类别热销榜中的一项
+     */
+    struct Candidate {
+        std::string itemId;     // 商品ID
+        double popularity;      // 类别内热度（0, 1]
+    };
+
+    /**
+     * @struct CategoryTable
+     * @brief 类别热销榜
+     */
+    struct CategoryTable {
+        std::vector<Candidate> top;     // 有货商品，按热度降序
+        uint64_t version = 0;           // 榜单版本（每次重算加一）
+        bool dirty = true;              // 是否需要重算
+    };
+
+    /**
+     * @struct CustomerProfile
+     * @brief 顾客偏好和推荐缓存
+     */
+    struct CustomerProfile {
+        std::vector<std::pair<std::string, double>> affinity;  // 类别 -> 偏好（和为1）
+        std::unordered_set<std::string> purchased;              // 已购买的商品
+        std::vector<uint64_t> versions;                         // 计算推荐时各偏好类别的榜单版本
+        std::vector<Recommendation> cached;                     // 缓存的推荐结果
+        bool cacheValid = false;                                // 推荐结果是否已计算
+    };
+
+    /**
+     * @struct ItemInfo
+     * @brief 推荐器记录的商品状态
+     */
+    struct ItemInfo {
+        std::string category;   // 商品类别
+        bool available;         // 是否有货
+    };
+
+    OrderManager* orderManager;                                     // 订单管理器
+    IItemRepository* itemRepository;                                // 商品仓库
+    size_t topN;                                                    // 每位顾客缓存的推荐数
+    size_t perCategoryLimit;                                        // 每个类别热销榜的长度
+    std::unordered_map<std::string, long long> sales;               // 商品ID -> 累计销量
+    std::unordered_map<std::string, ItemInfo> items;                // 商品ID -> 类别和有货状态
+    std::unordered_map<std::string, CategoryTable> categories;      // 类别 -> 热销榜
+    std::unordered_map<std::string, CustomerProfile> profiles;      // 用户名 -> 偏好和推荐缓存
+    std::unordered_map<std::string, uint64_t> orderEpochs;          // 用户名 -> 下单次数（判断偏好计算期间是否有新订单）
+    mutable std::mutex mutex;                                       // 互斥锁
+
+    /**
+     * @brief 标记类别热销榜需要重算（调用者需持有锁）
+     */
+    void markDirty(const std::string& category);
+
+    /**
+     * @brief 获取类别热销榜，必要时重算（调用者需持有锁）
+     */
+    CategoryTable& tableFor(const std::string& category);
+
+    /**
+     * @brief 由顾客的订单计算偏好向量和已购商品（不持有锁）
+     */
+    CustomerProfile buildProfile(const std::string& username) const;
+
+    /**
+     * @brief 按偏好向量多路归并各类别热销榜，计算前N个推荐（调用者需持有锁）
+     */
+    void computeRecommendations(CustomerProfile& profile);
+
+    /**
+     * @brief 检查缓存依赖的榜单版本是否仍然有效（调用者需持有锁）
+     */
+    bool isCacheFresh(CustomerProfile& profile);
+
+public:
+    /**
+     * @brief 构造函数
+     * @param orderManager 订单管理器
+     * @param itemRepository 商品仓库
+     * @param topN 每位顾客缓存的推荐数
+     * @param perCategoryLimit 每个类别热销榜的长度
+     */
+    PersonalRecommender(OrderManager* orderManager, IItemRepository* itemRepository,
+                        size_t topN = 10, size_t perCategoryLimit = 50);
+
+    /**
+     * @brief 析构函数，注销商品变更监听
+     */
+    ~PersonalRecommender() override;
+
+    /**
+     * @brief 用全部订单和商品重建销量和热销榜，并清空所有顾客缓存
+     */
+    void rebuild();
+
+    /**
+     * @brief 获取顾客的个性化推荐
+     * @param username 用户名
+     * @param limit 返回数量上限（不超过topN）
+     * @return 推荐结果，按得分降序
+     */
+    std::vector<Recommendation> recommend(const std::string& username, size_t limit);
+
+    /**
+     * @brief 订单创建事件：累加销量，丢弃下单顾客的偏好，使相关类别榜单失效
+     * @param order 订单对象
+     */
+    void onOrderCreated(const Order& order) override;
+
+    /**
+     * @brief 商品变更事件：上下架、改类别或有货状态变化时使相关类别榜单失效
+     * @param itemIds 变更的商品ID
+     * @param kind 变更类型
+     */
+    void onItemsChanged(const std::vector<std::string>& itemIds, ItemChangeKind kind) override;
+};
+
+#endif // PERSONAL_RECOMMENDER_H
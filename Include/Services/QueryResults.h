@@ -0,0 +1,109 @@
+/**
+ * @file QueryResults.h
+ * @brief 查询结果结构体的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef QUERY_RESULTS_H
+#define QUERY_RESULTS_H
+
+#include <string>
+#include <vector>
+#include <ctime>
+
+/**
+ * @struct ItemRow
+ * @brief 商品列表中的一行（查询时的快照）
+ */
+struct ItemRow {
+    std::string itemId;             // 商品ID
+    std::string itemName;           // 商品名称
+    std::string category;           // 商品类别
+    double price;                   // 价格
+    std::string description;        // 描述
+    int stock;                      // 库存
+    std::string promotionTag;       // 促销标签（无促销时为空）
+};
+
+/**
+ * @struct ItemListing
+ * @brief 商品列表查询结果
+ */
+struct ItemListing {
+    std::vector<ItemRow> rows;                      // 商品行
+    std::vector<std::string> fullReductionTags;     // 当前有效的满减活动标签
+};
+
+/**
+ * @struct OrderRow
+ * @brief 订单列表中的一行（查询时的快照）
+ */
+struct OrderRow {
+    std::string orderId;            // 订单编号
+    std::string userId;             // 用户ID
+    time_t orderTime;               // 订单时间
+    double totalAmount;             // 订单总额
+    std::string status;             // 订单状态（显示字符串）
+};
+
+/**
+ * @struct PromotionRow
+ * @brief 促销列表中的一行（查询时的快照）
+ */
+struct PromotionRow {
+    std::string promotionId;        // 促销ID
+    std::string promotionName;      // 促销名称
+    std::string type;               // 促销类型（显示字符串）
+    bool isActive;                  // 是否启用
+    bool isValid;                   // 当前是否有效（启用且在有效期内）
+    time_t endTime;                 // 结束时间
+    std::string displayTag;         // 促销标签
+};
+
+/**
+ * @struct CustomerRow
+ * @brief 顾客列表中的一行（查询时的快照）
+ */
+struct CustomerRow {
+    std::string username;           // 用户名
+    std::string password;           // 密码
+    std::string phone;              // 手机号
+};
+
+/**
+ * @enum ItemSortKey
+ * @brief 商品列表排序字段
+ */
+enum class ItemSortKey {
+    PRICE,          // 按价格
+    NAME,           // 按名称
+    STOCK           // 按库存
+};
+
+/**
+ * @enum OrderSortKey
+ * @brief 订单列表排序字段
+ */
+enum class OrderSortKey {
+    TIME,           // 按下单时间
+    AMOUNT,         // 按订单总额
+    STATUS          // 按订单状态
+};
+
+/**
+ * @struct ListPage
+ * @brief 分页查询结果
+ *
+ * nextCursor为下一页的游标，传回查询函数即可继续翻页；为空表示已是最后一页；
+ * 游标损坏时invalidCursor为true，不会退回第一页
+ */
+template <typename Row>
+struct ListPage {
+    std::vector<Row> rows;          // 本页数据
+    std::string nextCursor;         // 下一页游标
+    size_t totalCount = 0;          // 记录总数
+    bool invalidCursor = false;     // 传入的游标无法解析（本页为空）
+};
+
+#endif // QUERY_RESULTS_H
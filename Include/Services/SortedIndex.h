@@ -0,0 +1,215 @@
+/**
+ * @file SortedIndex.h
+ * @brief 可增量维护的有序索引模板（用于分页排序列表）
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef SORTED_INDEX_H
+#define SORTED_INDEX_H
+
+#include <set>
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * @class SortedIndex
+ * @brief 按(排序键, 记录ID)排序的索引
+ *
+ * 特点：
+ * 1. 使用std::set保存(键, ID)对，ID作为次级排序键保证顺序唯一且稳定
+ * 2. 额外记录每个ID当前的键，记录修改后只需删除旧条目、插入新条目，复杂度O(log N)
+ * 3. 分页采用游标（keyset）方式：从上一页最后一条记录之后继续，
+ *    取第N页的代价为O(log N + 页大小)，与页码无关
+ *
+ * @tparam K 排序键类型（需支持operator<）
+ */
+template <typename K>
+class SortedIndex {
+private:
+    std::set<std::pair<K, std::string>> entries;    // 有序条目
+    std::unordered_map<std::string, K> keyOf;       // ID -> 当前键
+
+public:
+    /**
+     * @brief 插入或更新一条记录的键
+     * @param id 记录ID
+     * @param key 新的排序键
+     */
+    void upsert(const std::string& id, const K& key) {
+        auto it = keyOf.find(id);
+        if (it != keyOf.end()) {
+            if (!(it->second < key) && !(key < it->second)) {
+                return;     // 键未变化
+            }
+            entries.erase(std::make_pair(it->second, id));
+            it->second = key;
+        } else {
+            keyOf.emplace(id, key);
+        }
+        entries.emplace(key, id);
+    }
+
+    /**
+     * @brief 删除一条记录
+     * @param id 记录ID
+     */
+    void erase(const std::string& id) {
+        auto it = keyOf.find(id);
+        if (it == keyOf.end()) {
+            return;
+        }
+        entries.erase(std::make_pair(it->second, id));
+        keyOf.erase(it);
+    }
+
+    /**
+     * @brief 清空索引
+     */
+    void clear() {
+        entries.clear();
+        keyOf.clear();
+    }
+
+    /**
+     * @brief 获取索引中的记录数
+     * @return 记录数
+     */
+    size_t size() const { return entries.size(); }
+
+    /**
+     * @brief 获取记录当前的键
+     * @param id 记录ID
+     * @param key 输出的键
+     * @return 记录存在返回true
+     */
+    bool getKey(const std::string& id, K& key) const {
+        auto it = keyOf.find(id);
+        if (it == keyOf.end()) {
+            return false;
+        }
+        key = it->second;
+        return true;
+    }
+
+    /**
+     * @brief 获取键在[low, high]范围内的所有记录ID
+     * @param low 键下界（含）
+     * @param high 键上界（含）
+     * @return 记录ID（按键升序）
+     */
+    std::vector<std::string> rangeIds(const K& low, const K& high) const {
+        std::vector<std::string> ids;
+        auto it = entries.lower_bound(std::make_pair(low, std::string()));
+        for (; it != entries.end() && !(high < it->first); ++it) {
+            ids.push_back(it->second);
+        }
+        return ids;
+    }
+
+    /**
+     * @brief 取一页记录ID
+     * @param cursor 上一页返回的游标（空字符串表示第一页）
+     * @param descending 是否降序
+     * @param limit 每页数量
+     * @param ids 输出本页记录ID（按排序顺序）
+     * @param nextCursor 输出下一页的游标（没有更多数据时为空）
+     * @return 游标无法解析时返回false且本页为空（不会退回第一页），否则返回true
+     */
+    bool page(const std::string& cursor, bool descending, size_t limit,
+              std::vector<std::string>& ids, std::string& nextCursor) const {
+        ids.clear();
+        nextCursor.clear();
+
+        std::pair<K, std::string> after;
+        bool hasCursor = !cursor.empty();
+        if (hasCursor && !decodeCursor(cursor, after)) {
+            return false;
+        }
+        if (limit == 0) {
+            return true;
+        }
+
+        if (!descending) {
+            auto it = hasCursor ? entries.upper_bound(after) : entries.begin();
+            for (; it != entries.end() && ids.size() < limit; ++it) {
+                ids.push_back(it->second);
+            }
+            if (it != entries.end() && !ids.empty()) {
+                nextCursor = encodeCursor(*std::prev(it));
+            }
+        } else {
+            auto it = hasCursor ? entries.lower_bound(after) : entries.end();
+            while (it != entries.begin() && ids.size() < limit) {
+                --it;
+                ids.push_back(it->second);
+            }
+            if (it != entries.begin() && !ids.empty()) {
+                nextCursor = encodeCursor(*it);
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief 将索引条目编码为游标字符串（格式：键|ID）
+     */
+    static std::string encodeCursor(const std::pair<K, std::string>& entry) {
+        return encodeKey(entry.first) + "|" + entry.second;
+    }
+
+    /**
+     * @brief 解析游标字符串
+     * @return 解析成功返回true
+     */
+    static bool decodeCursor(const std::string& cursor, std::pair<K, std::string>& entry) {
+        // ID中不含'|'，键（如商品名称）可能含'|'，因此从右侧切分
+        size_t sep = cursor.rfind('|');
+        if (sep == std::string::npos) {
+            return false;
+        }
+        entry.second = cursor.substr(sep + 1);
+        return decodeKey(cursor.substr(0, sep), entry.first);
+    }
+
+private:
+    static std::string encodeKey(const std::string& key) { return key; }
+    static std::string encodeKey(double key) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.17g", key);
+        return buffer;
+    }
+    static std::string encodeKey(long long key) { return std::to_string(key); }
+    static std::string encodeKey(long key) { return std::to_string(key); }
+    static std::string encodeKey(int key) { return std::to_string(key); }
+
+    static bool decodeKey(const std::string& str, std::string& key) { key = str; return true; }
+    static bool decodeKey(const std::string& str, double& key) {
+        char* end = nullptr;
+        key = std::strtod(str.c_str(), &end);
+        return !str.empty() && end == str.c_str() + str.size();
+    }
+    static bool decodeKey(const std::string& str, long long& key) {
+        char* end = nullptr;
+        key = std::strtoll(str.c_str(), &end, 10);
+        return !str.empty() && end == str.c_str() + str.size();
+    }
+    static bool decodeKey(const std::string& str, long& key) {
+        char* end = nullptr;
+        key = std::strtol(str.c_str(), &end, 10);
+        return !str.empty() && end == str.c_str() + str.size();
+    }
+    static bool decodeKey(const std::string& str, int& key) {
+        char* end = nullptr;
+        key = static_cast<int>(std::strtol(str.c_str(), &end, 10));
+        return !str.empty() && end == str.c_str() + str.size();
+    }
+};
+
+#endif // SORTED_INDEX_H
@@ -0,0 +1,230 @@
+/**
+ * @file TopSellerLeaderboard.h
+ * @brief 滑动时间窗口热销排行榜的定义
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#ifndef TOP_SELLER_LEADERBOARD_H
+#define TOP_SELLER_LEADERBOARD_H
+
+#include "Order/Order.h"
+#include "Interfaces/DependencyInterfaces.h"
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <string>
+#include <mutex>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * @brief 排行榜时间窗口
+ */
+enum class LeaderboardWindow {
+    HOUR,   // 最近一小时
+    DAY,    // 最近一天
+    WEEK    // 最近一周
+};
+
+/**
+ * @struct LeaderboardEntry
+ * @brief 排行榜中的一项
+ */
+struct LeaderboardEntry {
+    std::string itemId;     // 商品ID
+    long long quantity;     // 窗口内销量（近似模式下为估计值）
+};
+
+/**
+ * @class TopSellerLeaderboard
+ * @brief 由订单创建事件驱动的热销排行榜
+ *
+ * 特点：
+ * 1. 按时间分桶计数：最近一小时用60个1分钟的桶，最近一天和一周共用168个1小时的桶；
+ *    桶滚出窗口时从窗口计数中减去，不回看订单历史
+ * 2. 每个窗口、每个类别（以及全部商品）各维护一个大小为K的索引最小堆，
+ *    销量增加时O(log K)更新；桶过期导致销量下降时，按受影响的类别重建一次堆
+ * 3. 读取时返回缓存的有序快照，快照只在堆变化后重排一次，读取代价为O(K)
+ * 4. 精确模式下各桶和窗口保存逐商品计数；近似模式用Count-Min Sketch代替，
+ *    内存与商品数无关，适合商品种类极多的场景；估计值只会偏大，Sketch无法列出过期桶中的商品，
+ *    因此每个榜单多保留若干倍的候选，桶过期后重估候选并补位
+ */
+class TopSellerLeaderboard : public IOrderObserver {
+private:
+    static const size_t WINDOW_COUNT = 3;           // 窗口数
+    static const size_t MINUTE_BUCKETS = 60;        // 分钟桶数（覆盖一小时）
+    static const size_t HOUR_BUCKETS = 168;         // 小时桶数（覆盖一周）
+    static const size_t DAY_HOURS = 24;             // 一天的小时桶数
+
+    /**
+     * @struct Bucket
+     * @brief 一个时间桶
+     */
+    struct Bucket {
+        long long slot = -1;                                // 桶对应的时间片（时间 / 桶宽度）
+        std::unordered_map<std::string, long long> counts;  // 精确模式：商品ID -> 销量
+        std::vector<uint32_t> cells;                        // 近似模式：Sketch计数
+    };
+
+    /**
+     * @struct Board
+     * @brief 一个类别的前K名（索引最小堆）
+     */
+    struct Board {
+        std::vector<std::pair<long long, std::string>> heap;    // (销量, 商品ID)，堆顶销量最小
+        std::unordered_map<std::string, size_t> position;       // 商品ID -> 堆中位置
+        std::vector<LeaderboardEntry> snapshot;                 // 按销量降序的快照
+        bool snapshotValid = false;                             // 快照是否有效
+    };
+
+    /**
+     * @struct WindowState
+     * @brief 一个窗口的计数和排行
+     */
+    struct WindowState {
+        // 精确模式：类别 -> (商品ID -> 销量)
+        std::unordered_map<std::string, std::unordered_map<std::string, long long>> counts;
+        std::vector<uint32_t> cells;                            // 近似模式：窗口内Sketch计数
+        std::unordered_map<std::string, Board> boards;          // 类别 -> 前K名（空字符串表示全部商品）
+    };
+
+    IItemRepository* itemRepository;                        // 商品仓库（用于获取类别）
+    size_t topK;                                            // 每个榜单保留的名次
+    bool useSketch;                                         // 是否使用Count-Min Sketch
+    size_t sketchWidth;                                     // Sketch每行的计数器数
+    size_t sketchDepth;                                     // Sketch行数
+    size_t boardCapacity;                                   // 堆的容量（近似模式下多保留候选）
+    std::vector<Bucket> minuteBuckets;                      // 分钟桶（环形）
+    std::vector<Bucket> hourBuckets;                        // 小时桶（环形）
+    long long minuteHead;                                   // 最新的分钟时间片
+    long long hourHead;                                     // 最新的小时时间片
+    WindowState windows[WINDOW_COUNT];                      // 各窗口状态
+    std::unordered_map<std::string, std::string> itemCategories;   // 商品ID -> 类别（首次出现时记录）
+    mutable std::mutex mutex;                               // 互斥锁
+
+    /**
+     * @brief 获取商品类别（调用者需持有锁）
+     */
+    const std::string& categoryOf(const std::string& itemId);
+
+    /**
+     * @brief 计算商品在Sketch第row行的位置
+     */
+    size_t cellIndex(const std::string& itemId, size_t row) const;
+
+    /**
+     * @brief 在Sketch中累加计数
+     */
+    void sketchAdd(std::vector<uint32_t>& cells, const std::string& itemId, long long quantity) const;
+
+    /**
+     * @brief 从Sketch中估计计数（各行最小值）
+     */
+    long long sketchEstimate(const std::vector<uint32_t>& cells, const std::string& itemId) const;
+
+    /**
+     * @brief 把商品的最新销量提交给榜单（调用者需持有锁）
+     */
+    void offer(Board& board, const std::string& itemId, long long quantity);
+
+    /**
+     * @brief 堆操作（调用者需持有锁）
+     */
+    void swapAt(Board& board, size_t a, size_t b);
+    size_t siftUp(Board& board, size_t index);
+    void siftDown(Board& board, size_t index);
+
+    /**
+     * @brief 把一笔销量计入窗口（调用者需持有锁）
+     */
+    void addToWindow(LeaderboardWindow window, const std::string& itemId, long long quantity);
+
+    /**
+     * @brief 从窗口中减去一个过期的桶，记录受影响的类别（调用者需持有锁）
+     */
+    void expireFromWindow(LeaderboardWindow window, const Bucket& bucket,
+                          std::unordered_set<std::string>& affected);
+
+    /**
+     * @brief 销量下降后重建受影响类别的榜单（调用者需持有锁）
+     */
+    void rebuildBoards(LeaderboardWindow window, const std::unordered_set<std::string>& affected);
+
+    /**
+     * @brief 把一笔销量计入所在的桶和窗口，超出一周的销量忽略（调用者需持有锁）
+     */
+    void recordLocked(const std::string& itemId, long long quantity, time_t time);
+
+    /**
+     * @brief 推进时间，滚出过期的桶（调用者需持有锁）
+     */
+    void advance(time_t now);
+
+    /**
+     * @brief 清空所有桶和窗口（调用者需持有锁）
+     */
+    void resetLocked();
+
+    /**
+     * @brief 重置桶的内容
+     */
+    void resetBucket(Bucket& bucket, long long slot) const;
+
+public:
+    /**
+     * @brief 构造函数
+     * @param itemRepository 商品仓库
+     * @param topK 每个榜单保留的名次
+     * @param useSketch 是否使用Count-Min Sketch（近似模式）
+     * @param sketchWidth Sketch每行的计数器数
+     * @param sketchDepth Sketch行数
+     */
+    TopSellerLeaderboard(IItemRepository* itemRepository, size_t topK = 10, bool useSketch = false,
+                         size_t sketchWidth = 4096, size_t sketchDepth = 4);
+
+    /**
+     * @brief 记录一笔销量
+     * @param itemId 商品ID
+     * @param quantity 数量
+     * @param time 销售时间
+     */
+    void record(const std::string& itemId, long long quantity, time_t time);
+
+    /**
+     * @brief 用历史订单预热（只计入最近一周的订单，启动时调用一次）
+     * @param orders 订单列表
+     */
+    void seed(const std::vector<std::shared_ptr<Order>>& orders);
+
+    /**
+     * @brief 订单创建事件（计入订单中的每件商品）
+     * @param order 订单对象
+     */
+    void onOrderCreated(const Order& order) override;
+
+    /**
+     * @brief 获取热销排行
+     * @param window 时间窗口
+     * @param category 类别（空字符串表示全部商品）
+     * @param limit 返回数量上限（不超过K）
+     * @return 排行，按销量降序
+     */
+    std::vector<LeaderboardEntry> top(LeaderboardWindow window, const std::string& category, size_t limit);
+
+    /**
+     * @brief 是否为近似模式
+     * @return 使用Count-Min Sketch返回true
+     */
+    bool isApproximate() const { return useSketch; }
+
+    /**
+     * @brief 获取窗口的显示名称
+     * @param window 时间窗口
+     * @return 显示名称
+     */
+    static std::string windowToString(LeaderboardWindow window);
+};
+
+#endif // TOP_SELLER_LEADERBOARD_H
@@ -11,20 +11,39 @@
 #include <vector>
 #include <memory>
 #include <utility>
+#include <string>
+#include <functional>
 #include "ItemManage/Item.h"
 #include "UserManage/User.h"
 
+/**
+ * @brief 购物车商品增删回调，参数为商品ID和该商品现在是否在购物车中
+ */
+using CartMembershipListener = std::function<void(const std::string& itemId, bool inCart)>;
+
 /**
  * @class ShoppingCart
  * @brief 购物车类，管理单个用户的购物车信息
  * 
  * 每个顾客都有一个购物车，用于存储待购买的商品及数量
  * 提供添加、删除、修改、查询商品等功能
+ * 商品种类发生增删时通过回调通知管理器（用于维护商品到购物车的反向索引），
+ * 总价按需计算后缓存，商品数量或价格变化时失效
  */
 class ShoppingCart {
 private:
     std::shared_ptr<Customer> owner;                                    // 购物车所有者
     std::vector<std::pair<std::shared_ptr<Item>, int>> cartItems;       // 购物车中的商品及数量
+    CartMembershipListener membershipListener;                          // 商品增删回调
+    mutable double cachedTotalPrice;                                    // 缓存的总价
+    mutable bool totalPriceValid;                                       // 缓存的总价是否有效
+    
+    /**
+     * @brief 通知商品增删并使总价缓存失效
+     * @param itemId 商品ID
+     * @param inCart 商品现在是否在购物车中
+     */
+    void notifyMembership(const std::string& itemId, bool inCart);
 
 public:
     /**
@@ -138,6 +157,24 @@ public:
     std::vector<std::pair<std::shared_ptr<Item>, int>>::iterator 
         findItemById(const std::string& itemId);
     
+    /**
+     * @brief 从购物车中移除商品，不产生输出（用于商品下架时的级联清理）
+     * @param itemId 商品ID
+     * @return 购物车中有该商品返回true
+     */
+    bool discardItem(const std::string& itemId);
+    
+    /**
+     * @brief 使缓存的总价失效（商品价格变化时由管理器调用）
+     */
+    void invalidatePriceCache() { totalPriceValid = false; }
+    
+    /**
+     * @brief 设置商品增删回调
+     * @param listener 回调函数
+     */
+    void setMembershipListener(CartMembershipListener listener) { membershipListener = std::move(listener); }
+    
     /**
      * @brief 直接添加商品到购物车（不进行重复检查，用于加载数据）
      * @param item 商品指针
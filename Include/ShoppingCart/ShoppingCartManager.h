@@ -9,6 +9,8 @@
 #define SHOPPING_CART_MANAGER_H
 
 #include <map>
+#include <set>
+#include <unordered_map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -24,12 +26,16 @@
  * 2. 从CSV文件加载购物车数据
  * 3. 将购物车数据保存到CSV文件
  * 4. 提供获取和创建用户购物车的接口
+ * 5. 维护商品ID到购物车（用户名）的反向索引，在购物车增删商品时增量更新
+ * 6. 作为商品变更监听者：商品删除时只清理包含该商品的购物车，
+ *    价格变化时只使这些购物车的总价缓存失效，代价与受影响的购物车数量成正比
  */
-class ShoppingCartManager {
+class ShoppingCartManager : public IItemChangeListener {
 private:
     std::string filePath;                                               // 购物车数据文件路径
     std::map<std::string, std::shared_ptr<ShoppingCart>> carts;         // 用户名到购物车的映射
     std::shared_ptr<IItemRepository> itemManager;                       // 商品管理器指针（用于查找商品）
+    std::unordered_map<std::string, std::set<std::string>> cartsByItem; // 商品ID -> 包含该商品的用户名
     
     /**
      * @brief 去除字符串首尾空格
@@ -51,6 +57,28 @@ private:
      * @return 数组字符串
      */
     std::string vectorToArrayString(const std::vector<int>& vec);
+    
+    /**
+     * @brief 把购物车接入反向索引（登记已有商品并设置增删回调）
+     * @param username 用户名
+     * @param cart 购物车
+     */
+    void attachCart(const std::string& username, const std::shared_ptr<ShoppingCart>& cart);
+    
+    /**
+     * @brief 从反向索引中移除购物车
+     * @param username 用户名
+     * @param cart 购物车
+     */
+    void detachCart(const std::string& username, const std::shared_ptr<ShoppingCart>& cart);
+    
+    /**
+     * @brief 更新反向索引中的一条关系
+     * @param itemId 商品ID
+     * @param username 用户名
+     * @param inCart 商品是否在该用户的购物车中
+     */
+    void updateReverseIndex(const std::string& itemId, const std::string& username, bool inCart);
 
 public:
     /**
@@ -115,15 +143,42 @@ public:
     int getCartCount() const { return carts.size(); }
     
     /**
-     * @brief 设置商品管理器
+     * @brief 获取所有非空购物车
+     * @return 购物车列表（按用户名排序）
+     */
+    std::vector<std::shared_ptr<ShoppingCart>> getAllCarts() const;
+    
+    /**
+     * @brief 设置商品管理器（并在新的商品管理器上注册为变更监听者）
      * @param itemMgr 商品管理器指针
      */
-    void setItemManager(std::shared_ptr<IItemRepository> itemMgr) { itemManager = itemMgr; }
+    void setItemManager(std::shared_ptr<IItemRepository> itemMgr);
+    
+    /**
+     * @brief 统计购物车中有指定商品的用户数
+     * @param itemId 商品ID
+     * @return 用户数
+     */
+    size_t countCartsContaining(const std::string& itemId) const;
+    
+    /**
+     * @brief 获取购物车中有指定商品的用户
+     * @param itemId 商品ID
+     * @return 用户名列表（按用户名排序）
+     */
+    std::vector<std::string> getCartsContaining(const std::string& itemId) const;
+    
+    /**
+     * @brief 响应商品变更：删除时级联清理购物车并保存，价格变化时使总价缓存失效
+     * @param itemIds 变更的商品ID
+     * @param kind 变更类型
+     */
+    void onItemsChanged(const std::vector<std::string>& itemIds, ItemChangeKind kind) override;
     
     /**
      * @brief 析构函数
      */
-    ~ShoppingCartManager();
+    ~ShoppingCartManager() override;
 };
 
 #endif // SHOPPING_CART_MANAGER_H
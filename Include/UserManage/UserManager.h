@@ -10,7 +10,9 @@
 
 #include "UserManage/User.h"
 #include "Interfaces/DependencyInterfaces.h"
+#include "Services/QueryResults.h"
 #include <vector>
+#include <map>
 #include <memory>
 
 /**
@@ -23,10 +25,12 @@
  * 3. 添加新用户
  * 4. 查找用户
  * 5. 更新用户信息
+ * 6. 维护按用户名有序的索引，支持按用户名查找和游标分页
  */
 class UserManager : public IUserRepository {
 private:
     std::vector<std::shared_ptr<Customer>> customers;  // 顾客列表
+    std::map<std::string, std::shared_ptr<Customer>> usernameIndex;  // 用户名有序索引
     std::string filePath;                              // 数据文件路径
     
     /**
@@ -97,6 +101,18 @@ public:
      */
     const std::vector<std::shared_ptr<Customer>>& getCustomers() const override { return customers; }
     
+    /**
+     * @brief 按用户名分页查询顾客
+     * 
+     * 游标为上一页最后一个用户名，每页代价为O(log N + limit)
+     * 
+     * @param cursor 上一页返回的游标（空字符串表示第一页）
+     * @param descending 是否按用户名降序
+     * @param limit 每页数量
+     * @return 分页结果
+     */
+    ListPage<CustomerRow> queryCustomerPage(const std::string& cursor, bool descending, size_t limit) const;
+    
     /**
      * @brief 析构函数
      */
@@ -6,6 +6,7 @@
  */
 
 #include "Config.h"
+#include "Log/Logger.h"
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -24,9 +25,36 @@ Config::Config()
       shoppingCartFilePath("res/data/shopping_cart.csv"),
       ordersFilePath("res/data/orders.csv"),
       promotionsFilePath("res/data/promotions.csv"),
+      ordersArchiveFilePath("res/data/orders.arc"),
+      inventoryLedgerFilePath("res/data/inventory.ledger"),
+      couponCampaignsFilePath("res/data/coupon_campaigns.csv"),
+      couponCodesFilePath("res/data/coupon_codes.bin"),
+      couponRedemptionsFilePath("res/data/coupon_redemptions.log"),
+      promotionUsageFilePath("res/data/promotion_usage.log"),
+      waitlistFilePath("res/data/waitlist.log"),
+      logFilePath("res/logs/system.log"),
+      logLevel("info"),
       autoUpdateEnabled(true),
       pendingToShippedSeconds(10),
-      shippedToDeliveredSeconds(20) {
+      shippedToDeliveredSeconds(20),
+      idempotencyTtlSeconds(30),
+      idempotencyCapacity(100000),
+      lowStockThreshold(10),
+      ledgerCheckpointInterval(1000),
+      flashSaleShards(0),
+      leaderboardTopK(10),
+      leaderboardSketchEnabled(false),
+      sketchWidth(4096),
+      sketchDepth(4),
+      stackingPolicy("stack_all"),
+      maxStackedReductions(2),
+      searchConcurrency(2),
+      searchQueue(8),
+      listingConcurrency(4),
+      listingQueue(16),
+      reportConcurrency(1),
+      reportQueue(4),
+      admissionWaitMs(200) {
     // 设置默认值
 }
 
@@ -62,7 +90,7 @@ std::string Config::trim(const std::string& str) {
 bool Config::parseConfigFile(const std::string& filename) {
     std::ifstream file(filename);
     if (!file.is_open()) {
-        std::cerr << "无法打开配置文件: " << filename << std::endl;
+        Logger::getInstance()->error("Config", "无法打开配置文件", {{"path", filename}});
         return false;
     }
     
@@ -116,6 +144,26 @@ bool Config::parseConfigFile(const std::string& filename) {
                     ordersFilePath = value;
                 } else if (key == "promotions") {
                     promotionsFilePath = value;
+                } else if (key == "orders_archive") {
+                    ordersArchiveFilePath = value;
+                } else if (key == "inventory_ledger") {
+                    inventoryLedgerFilePath = value;
+                } else if (key == "coupon_campaigns") {
+                    couponCampaignsFilePath = value;
+                } else if (key == "coupon_codes") {
+                    couponCodesFilePath = value;
+                } else if (key == "coupon_redemptions") {
+                    couponRedemptionsFilePath = value;
+                } else if (key == "promotion_usage") {
+                    promotionUsageFilePath = value;
+                } else if (key == "waitlist") {
+                    waitlistFilePath = value;
+                }
+            } else if (currentSection == "log_settings") {
+                if (key == "file") {
+                    logFilePath = value;
+                } else if (key == "level") {
+                    logLevel = value;
                 }
             } else if (currentSection == "order_settings") {
                 if (key == "auto_update") {
@@ -128,13 +176,92 @@ bool Config::parseConfigFile(const std::string& filename) {
                     try {
                         pendingToShippedSeconds = std::stoi(value);
                     } catch (...) {
-                        std::cerr << "警告：解析 pending_to_shipped_seconds 失败，使用默认值。" << std::endl;
+                        Logger::getInstance()->warn("Config", "解析配置失败，使用默认值", {{"key", key}, {"value", value}});
                     }
                 } else if (key == "shipped_to_delivered_seconds") {
                     try {
                         shippedToDeliveredSeconds = std::stoi(value);
                     } catch (...) {
-                        std::cerr << "警告：解析 shipped_to_delivered_seconds 失败，使用默认值。" << std::endl;
+                        Logger::getInstance()->warn("Config", "解析配置失败，使用默认值", {{"key", key}, {"value", value}});
+                    }
+                } else if (key == "idempotency_ttl_seconds") {
+                    try {
+                        idempotencyTtlSeconds = std::stoi(value);
+                    } catch (...) {
+                        Logger::getInstance()->warn("Config", "解析配置失败，使用默认值", {{"key", key}, {"value", value}});
+                    }
+                } else if (key == "idempotency_capacity") {
+                    try {
+                        idempotencyCapacity = std::stoi(value);
+                    } catch (...) {
+                        Logger::getInstance()->warn("Config", "解析配置失败，使用默认值", {{"key", key}, {"value", value}});
+                    }
+                }
+            } else if (currentSection == "inventory_settings") {
+                if (key == "low_stock_threshold") {
+                    try {
+                        lowStockThreshold = std::stoi(value);
+                    } catch (...) {
+                        Logger::getInstance()->warn("Config", "解析配置失败，使用默认值", {{"key", key}, {"value", value}});
+                    }
+                } else if (key == "ledger_checkpoint_interval") {
+                    try {
+                        ledgerCheckpointInterval = std::stoi(value);
+                    } catch (...) {
+                        Logger::getInstance()->warn("Config", "解析配置失败，使用默认值", {{"key", key}, {"value", value}});
+                    }
+                } else if (key == "flash_sale_shards") {
+                    try {
+                        flashSaleShards = std::stoi(value);
+                    } catch (...) {
+                        Logger::getInstance()->warn("Config", "解析配置失败，使用默认值", {{"key", key}, {"value", value}});
+                    }
+                }
+            } else if (currentSection == "leaderboard_settings") {
+                if (key == "top_k") {
+                    try {
+                        leaderboardTopK = std::stoi(value);
+                    } catch (...) {
+                        Logger::getInstance()->warn("Config", "解析配置失败，使用默认值", {{"key", key}, {"value", value}});
+                    }
+                } else if (key == "use_sketch") {
+                    leaderboardSketchEnabled = (value == "true" || value == "True" || value == "TRUE");
+                } else if (key == "sketch_width") {
+                    try {
+                        sketchWidth = std::stoi(value);
+                    } catch (...) {
+                        Logger::getInstance()->warn("Config", "解析配置失败，使用默认值", {{"key", key}, {"value", value}});
+                    }
+                } else if (key == "sketch_depth") {
+                    try {
+                        sketchDepth = std::stoi(value);
+                    } catch (...) {
+                        Logger::getInstance()->warn("Config", "解析配置失败，使用默认值", {{"key", key}, {"value", value}});
+                    }
+                }
+            } else if (currentSection == "promotion_settings") {
+                if (key == "stacking_policy") {
+                    stackingPolicy = value;
+                } else if (key == "max_stacked") {
+                    try {
+                        maxStackedReductions = std::stoi(value);
+                    } catch (...) {
+                        Logger::getInstance()->warn("Config", "解析配置失败，使用默认值", {{"key", key}, {"value", value}});
+                    }
+                }
+            } else if (currentSection == "admission_settings") {
+                std::map<std::string, int*> fields = {
+                    {"search_concurrency", &searchConcurrency}, {"search_queue", &searchQueue},
+                    {"listing_concurrency", &listingConcurrency}, {"listing_queue", &listingQueue},
+                    {"report_concurrency", &reportConcurrency}, {"report_queue", &reportQueue},
+                    {"queue_wait_ms", &admissionWaitMs}
+                };
+                auto field = fields.find(key);
+                if (field != fields.end()) {
+                    try {
+                        *field->second = std::stoi(value);
+                    } catch (...) {
+                        Logger::getInstance()->warn("Config", "解析配置失败，使用默认值", {{"key", key}, {"value", value}});
                     }
                 }
             }
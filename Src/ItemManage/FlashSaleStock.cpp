@@ -0,0 +1,260 @@
+/**
+ * @file FlashSaleStock.cpp
+ * @brief 秒杀库存的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "ItemManage/FlashSaleStock.h"
+#include "Log/Logger.h"
+#include <algorithm>
+#include <thread>
+#include <mutex>
+
+namespace {
+
+const int STEAL_ROUNDS = 3;     // 剩余总量足够但被其他线程抢先时的最多窃取轮数
+
+std::atomic<size_t> nextThreadSlot(0);
+
+/**
+ * @brief 当前线程的编号（首次调用时分配，之后不变）
+ */
+size_t threadSlot() {
+    thread_local size_t slot = nextThreadSlot.fetch_add(1);
+    return slot;
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数实现
+ *
+ * 总库存平均分配，余数分给前几个分片
+ */
+ShardedStockCounter::ShardedStockCounter(int64_t total, size_t shardCount)
+    : shardCount(shardCount > 0 ? shardCount : std::max(1u, std::thread::hardware_concurrency())) {
+    shards.reset(new Shard[this->shardCount]);
+    int64_t count = static_cast<int64_t>(this->shardCount);
+    int64_t base = std::max<int64_t>(0, total) / count;
+    int64_t extra = std::max<int64_t>(0, total) % count;
+    for (int64_t i = 0; i < count; ++i) {
+        shards[i].units.store(base + (i < extra ? 1 : 0));
+    }
+}
+
+/**
+ * @brief 当前线程对应的分片下标
+ */
+size_t ShardedStockCounter::homeShard() const {
+    return threadSlot() % shardCount;
+}
+
+/**
+ * @brief 从分片中最多取走want个单位
+ */
+int64_t ShardedStockCounter::grab(Shard& shard, int64_t need, int64_t want) {
+    int64_t available = shard.units.load(std::memory_order_relaxed);
+    while (available >= need && available > 0) {
+        int64_t amount = std::min(available, std::max(need, want));
+        if (shard.units.compare_exchange_weak(available, available - amount, std::memory_order_acq_rel)) {
+            return amount;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief 扣减库存
+ *
+ * 先从本地分片整笔扣减；不足时从本地开始依次收集各分片的库存，
+ * 从其他分片每次取走其剩余量的一半，凑够后多余部分存入本地分片
+ */
+bool ShardedStockCounter::take(int64_t quantity) {
+    if (quantity <= 0) {
+        return true;
+    }
+    size_t home = homeShard();
+    Shard& local = shards[home];
+    if (grab(local, quantity, quantity) > 0) {
+        return true;
+    }
+
+    for (int round = 0; round < STEAL_ROUNDS; ++round) {
+        // 售罄后的请求只读取各分片，不做写操作
+        if (remaining() < quantity) {
+            return false;
+        }
+        int64_t gathered = 0;
+        for (size_t k = 0; k < shardCount && gathered < quantity; ++k) {
+            Shard& victim = shards[(home + k) % shardCount];
+            int64_t need = quantity - gathered;
+            int64_t half = (victim.units.load(std::memory_order_relaxed) + 1) / 2;
+            gathered += grab(victim, 1, k == 0 ? need : std::max(need, half));
+        }
+        if (gathered >= quantity) {
+            if (gathered > quantity) {
+                local.units.fetch_add(gathered - quantity, std::memory_order_acq_rel);
+            }
+            return true;
+        }
+        // 凑不够：放回已取走的部分
+        if (gathered > 0) {
+            local.units.fetch_add(gathered, std::memory_order_acq_rel);
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 归还库存
+ */
+void ShardedStockCounter::give(int64_t quantity) {
+    if (quantity > 0) {
+        shards[homeShard()].units.fetch_add(quantity, std::memory_order_acq_rel);
+    }
+}
+
+/**
+ * @brief 剩余库存
+ */
+int64_t ShardedStockCounter::remaining() const {
+    int64_t total = 0;
+    for (size_t i = 0; i < shardCount; ++i) {
+        total += shards[i].units.load(std::memory_order_acquire);
+    }
+    return total;
+}
+
+/**
+ * @brief 构造函数实现
+ */
+FlashSaleStock::FlashSaleStock(size_t shardCount) : shardCount(shardCount) {
+}
+
+/**
+ * @brief 查找秒杀商品
+ */
+std::shared_ptr<FlashSaleStock::Entry> FlashSaleStock::find(const std::string& itemId) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = entries.find(itemId);
+    return it != entries.end() ? it->second : nullptr;
+}
+
+/**
+ * @brief 生成状态快照
+ */
+FlashSaleStatus FlashSaleStock::snapshot(const std::string& itemId, const Entry& entry) {
+    FlashSaleStatus status;
+    status.itemId = itemId;
+    status.allotment = entry.allotment;
+    status.remaining = entry.counter.remaining();
+    status.inFlight = entry.inFlight.load();
+    status.committed = entry.committed.load();
+    status.shards = entry.counter.getShardCount();
+    return status;
+}
+
+/**
+ * @brief 开启秒杀
+ */
+bool FlashSaleStock::enable(const std::string& itemId, int64_t allotment) {
+    if (allotment <= 0) {
+        return false;
+    }
+    size_t shards;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        if (entries.count(itemId) > 0) {
+            return false;
+        }
+        auto entry = std::make_shared<Entry>(allotment, shardCount);
+        shards = entry->counter.getShardCount();
+        entries.emplace(itemId, std::move(entry));
+    }
+    Logger::getInstance()->info("FlashSaleStock", "秒杀已开启",
+                                {{"item", itemId}, {"allotment", std::to_string(allotment)},
+                                 {"shards", std::to_string(shards)}});
+    return true;
+}
+
+/**
+ * @brief 关闭秒杀
+ */
+bool FlashSaleStock::disable(const std::string& itemId, FlashSaleStatus* finalStatus) {
+    FlashSaleStatus status;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto it = entries.find(itemId);
+        if (it == entries.end()) {
+            return false;
+        }
+        status = snapshot(itemId, *it->second);
+        entries.erase(it);
+    }
+    if (finalStatus) {
+        *finalStatus = status;
+    }
+    Logger::getInstance()->info("FlashSaleStock", "秒杀已关闭",
+                                {{"item", itemId}, {"committed", std::to_string(status.committed)},
+                                 {"remaining", std::to_string(status.remaining)}});
+    return true;
+}
+
+/**
+ * @brief 商品是否在秒杀中
+ */
+bool FlashSaleStock::isEnabled(const std::string& itemId) const {
+    return find(itemId) != nullptr;
+}
+
+/**
+ * @brief 抢购配额
+ */
+bool FlashSaleStock::claim(const std::string& itemId, int quantity) {
+    auto entry = find(itemId);
+    if (!entry || !entry->counter.take(quantity)) {
+        return false;
+    }
+    entry->inFlight += quantity;
+    return true;
+}
+
+/**
+ * @brief 归还配额
+ */
+void FlashSaleStock::release(const std::string& itemId, int quantity) {
+    auto entry = find(itemId);
+    if (entry) {
+        entry->counter.give(quantity);
+        entry->inFlight -= quantity;
+    }
+}
+
+/**
+ * @brief 记录成单
+ */
+void FlashSaleStock::commit(const std::string& itemId, int quantity) {
+    auto entry = find(itemId);
+    if (entry) {
+        entry->inFlight -= quantity;
+        entry->committed += quantity;
+    }
+}
+
+/**
+ * @brief 获取全部秒杀商品的状态
+ */
+std::vector<FlashSaleStatus> FlashSaleStock::getStatus() const {
+    std::vector<FlashSaleStatus> result;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        for (const auto& entry : entries) {
+            result.push_back(snapshot(entry.first, *entry.second));
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const FlashSaleStatus& a, const FlashSaleStatus& b) {
+        return a.itemId < b.itemId;
+    });
+    return result;
+}
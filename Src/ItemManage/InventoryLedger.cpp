@@ -0,0 +1,492 @@
+/**
+ * @file InventoryLedger.cpp
+ * @brief 库存流水账的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "ItemManage/InventoryLedger.h"
+#include "Order/Order.h"
+#include "Log/Logger.h"
+#include <algorithm>
+#include <filesystem>
+#include <future>
+#include <thread>
+#include <cstring>
+
+namespace {
+
+const char LEDGER_MAGIC[8] = {'I', 'N', 'V', 'L', 'D', 'G', 'R', '1'};   // 文件头魔数
+const size_t ITEM_ID_OFFSET = 20;           // 商品ID字段偏移
+const size_t ITEM_ID_SIZE = 20;             // 商品ID字段长度
+const size_t REFERENCE_OFFSET = 40;         // 关联单号字段偏移
+const size_t REFERENCE_SIZE = 24;           // 关联单号字段长度
+const uint64_t SCAN_BATCH = 1024;           // 顺序扫描时每批读取的记录数
+
+/**
+ * @brief 按小端序写入整数
+ */
+void putLE(char* buf, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        buf[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+/**
+ * @brief 按小端序读取整数
+ */
+uint64_t getLE(const char* buf, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(buf[i])) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief 写入定长字符串字段（不足补0，超长截断）
+ */
+void putFixedString(char* buf, const std::string& str, size_t size) {
+    std::memset(buf, 0, size);
+    std::memcpy(buf, str.data(), std::min(str.size(), size));
+}
+
+/**
+ * @brief 读取定长字符串字段
+ */
+std::string getFixedString(const char* buf, size_t size) {
+    size_t length = 0;
+    while (length < size && buf[length] != '\0') {
+        ++length;
+    }
+    return std::string(buf, length);
+}
+
+/**
+ * @brief 编码一条记录
+ */
+void encodeRecord(const LedgerRecord& record, char* buf) {
+    std::memset(buf, 0, InventoryLedger::RECORD_SIZE);
+    putLE(buf, static_cast<uint64_t>(static_cast<int64_t>(record.time)), 8);
+    putLE(buf + 8, static_cast<uint32_t>(record.delta), 4);
+    putLE(buf + 12, static_cast<uint32_t>(record.stockAfter), 4);
+    buf[16] = static_cast<char>(record.reason);
+    putFixedString(buf + ITEM_ID_OFFSET, record.itemId, ITEM_ID_SIZE);
+    putFixedString(buf + REFERENCE_OFFSET, record.reference, REFERENCE_SIZE);
+}
+
+/**
+ * @brief 解码一条记录
+ */
+void decodeRecord(const char* buf, LedgerRecord& record) {
+    record.time = static_cast<time_t>(static_cast<int64_t>(getLE(buf, 8)));
+    record.delta = static_cast<int32_t>(static_cast<uint32_t>(getLE(buf + 8, 4)));
+    record.stockAfter = static_cast<int32_t>(static_cast<uint32_t>(getLE(buf + 12, 4)));
+    record.reason = static_cast<StockMovementReason>(static_cast<uint8_t>(buf[16]));
+    record.itemId = getFixedString(buf + ITEM_ID_OFFSET, ITEM_ID_SIZE);
+    record.reference = getFixedString(buf + REFERENCE_OFFSET, REFERENCE_SIZE);
+}
+
+/**
+ * @brief 获取第index条记录在文件中的偏移
+ */
+std::streamoff recordOffset(uint64_t index) {
+    return static_cast<std::streamoff>(InventoryLedger::HEADER_SIZE + index * InventoryLedger::RECORD_SIZE);
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数实现
+ */
+InventoryLedger::InventoryLedger(const std::string& filePath, size_t checkpointInterval)
+    : filePath(filePath), checkpointInterval(checkpointInterval > 0 ? checkpointInterval : 1),
+      recordCount(0), lastTime(0) {
+}
+
+/**
+ * @brief 应用一条记录到内存状态
+ */
+void InventoryLedger::applyLocked(const LedgerRecord& record) {
+    latestStock[record.itemId] = record.stockAfter;
+    pendingChanges[record.itemId] = record.stockAfter;
+    ++recordCount;
+    lastTime = record.time;
+    if (recordCount % checkpointInterval == 0) {
+        checkpoints.push_back(Checkpoint{recordCount, lastTime, std::move(pendingChanges)});
+        pendingChanges.clear();
+    }
+}
+
+/**
+ * @brief 追加一条记录
+ */
+bool InventoryLedger::appendLocked(LedgerRecord record) {
+    if (!writer.is_open()) {
+        return false;
+    }
+
+    // 保证记录时间单调不减（系统时间回拨时沿用上一条记录的时间）
+    record.time = std::max(std::time(nullptr), lastTime);
+
+    char buf[RECORD_SIZE];
+    encodeRecord(record, buf);
+    writer.write(buf, RECORD_SIZE);
+    writer.flush();
+    if (!writer) {
+        Logger::getInstance()->error("InventoryLedger", "写入库存流水失败",
+                                     {{"path", filePath}, {"item", record.itemId}});
+        return false;
+    }
+
+    applyLocked(record);
+    return true;
+}
+
+/**
+ * @brief 读取第index条记录
+ */
+bool InventoryLedger::readRecord(std::ifstream& in, uint64_t index, LedgerRecord& record) const {
+    char buf[RECORD_SIZE];
+    in.clear();
+    in.seekg(recordOffset(index));
+    if (!in.read(buf, RECORD_SIZE)) {
+        return false;
+    }
+    decodeRecord(buf, record);
+    return true;
+}
+
+/**
+ * @brief 按顺序读取[begin, end)范围内的记录
+ */
+template <typename Visitor>
+bool InventoryLedger::scan(std::ifstream& in, uint64_t begin, uint64_t end, Visitor visitor) const {
+    std::vector<char> buf;
+    LedgerRecord record;
+    in.clear();
+    in.seekg(recordOffset(begin));
+    for (uint64_t batchStart = begin; batchStart < end; batchStart += SCAN_BATCH) {
+        uint64_t batchCount = std::min(SCAN_BATCH, end - batchStart);
+        buf.resize(static_cast<size_t>(batchCount * RECORD_SIZE));
+        if (!in.read(buf.data(), static_cast<std::streamsize>(buf.size()))) {
+            return false;
+        }
+        for (uint64_t i = 0; i < batchCount; ++i) {
+            decodeRecord(buf.data() + i * RECORD_SIZE, record);
+            visitor(record);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 计算时间不晚于at的记录条数
+ */
+bool InventoryLedger::countUntil(std::ifstream& in, time_t at, uint64_t& count) const {
+    uint64_t low = 0;
+    uint64_t high = recordCount;
+    LedgerRecord record;
+    while (low < high) {
+        uint64_t mid = low + (high - low) / 2;
+        if (!readRecord(in, mid, record)) {
+            return false;
+        }
+        if (record.time <= at) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    count = low;
+    return true;
+}
+
+/**
+ * @brief 打开流水账
+ */
+bool InventoryLedger::open(const std::vector<std::shared_ptr<Item>>& items) {
+    std::lock_guard<std::mutex> lock(mutex);
+    writer.close();
+    recordCount = 0;
+    lastTime = 0;
+    latestStock.clear();
+    pendingChanges.clear();
+    checkpoints.clear();
+    checkpoints.push_back(Checkpoint{0, 0, {}});
+
+    std::error_code ec;
+    uintmax_t fileSize = std::filesystem::exists(filePath, ec) ? std::filesystem::file_size(filePath, ec) : 0;
+
+    if (fileSize < HEADER_SIZE) {
+        // 新建文件
+        std::ofstream create(filePath, std::ios::binary | std::ios::trunc);
+        if (!create.is_open()) {
+            Logger::getInstance()->error("InventoryLedger", "无法创建库存流水文件", {{"path", filePath}});
+            return false;
+        }
+        create.write(LEDGER_MAGIC, HEADER_SIZE);
+    } else {
+        std::ifstream in(filePath, std::ios::binary);
+        char magic[HEADER_SIZE];
+        if (!in.read(magic, HEADER_SIZE) || std::memcmp(magic, LEDGER_MAGIC, HEADER_SIZE) != 0) {
+            Logger::getInstance()->error("InventoryLedger", "库存流水文件格式错误", {{"path", filePath}});
+            return false;
+        }
+
+        // 丢弃写入中断留下的不完整记录，保证后续追加按记录对齐
+        uint64_t completeRecords = (fileSize - HEADER_SIZE) / RECORD_SIZE;
+        uintmax_t alignedSize = HEADER_SIZE + completeRecords * RECORD_SIZE;
+        if (alignedSize != fileSize) {
+            in.close();
+            std::filesystem::resize_file(filePath, alignedSize, ec);
+            Logger::getInstance()->warn("InventoryLedger", "截断不完整的库存流水记录",
+                                        {{"path", filePath}, {"bytes", std::to_string(fileSize - alignedSize)}});
+            in.open(filePath, std::ios::binary);
+        }
+
+        if (!scan(in, 0, completeRecords, [this](const LedgerRecord& record) { applyLocked(record); })) {
+            Logger::getInstance()->error("InventoryLedger", "读取库存流水失败", {{"path", filePath}});
+            return false;
+        }
+    }
+
+    writer.open(filePath, std::ios::binary | std::ios::app);
+    if (!writer.is_open()) {
+        Logger::getInstance()->error("InventoryLedger", "无法打开库存流水文件", {{"path", filePath}});
+        return false;
+    }
+
+    // 与当前库存对齐
+    size_t synced = 0;
+    for (const auto& item : items) {
+        auto it = latestStock.find(item->getItemId());
+        if (it == latestStock.end()) {
+            appendLocked(LedgerRecord{0, item->getItemId(), item->getStock(), item->getStock(),
+                                      StockMovementReason::OPENING, "opening"});
+            ++synced;
+        } else if (it->second != item->getStock()) {
+            appendLocked(LedgerRecord{0, item->getItemId(), item->getStock() - it->second, item->getStock(),
+                                      StockMovementReason::ADJUSTMENT, "resync"});
+            ++synced;
+        }
+    }
+
+    Logger::getInstance()->info("InventoryLedger", "库存流水已加载",
+                                {{"records", std::to_string(recordCount)},
+                                 {"checkpoints", std::to_string(checkpoints.size())},
+                                 {"synced", std::to_string(synced)}});
+    return true;
+}
+
+/**
+ * @brief 记录一次库存变动
+ */
+bool InventoryLedger::record(const std::string& itemId, int delta, int stockAfter,
+                             StockMovementReason reason, const std::string& reference) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return appendLocked(LedgerRecord{0, itemId, delta, stockAfter, reason, reference});
+}
+
+/**
+ * @brief 查询某一时刻的商品库存
+ *
+ * 先二分查找时刻对应的记录位置，再从不晚于该位置的最近检查点开始向后扫描；
+ * 这段记录中没有该商品时，从该检查点向前找最近一次记录了它的检查点
+ */
+bool InventoryLedger::stockAt(const std::string& itemId, time_t at, int& stock, bool& found) const {
+    found = false;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ifstream in(filePath, std::ios::binary);
+    uint64_t end;
+    if (!in.is_open() || !countUntil(in, at, end)) {
+        Logger::getInstance()->error("InventoryLedger", "读取库存流水失败", {{"path", filePath}});
+        return false;
+    }
+
+    auto cp = std::upper_bound(checkpoints.begin(), checkpoints.end(), end,
+                               [](uint64_t count, const Checkpoint& c) { return count < c.recordCount; });
+    --cp;   // 第一个检查点的记录数为0，一定存在
+
+    bool scanned = scan(in, cp->recordCount, end, [&](const LedgerRecord& record) {
+        if (record.itemId == itemId) {
+            stock = record.stockAfter;
+            found = true;
+        }
+    });
+    if (!scanned) {
+        Logger::getInstance()->error("InventoryLedger", "读取库存流水失败", {{"path", filePath}});
+        found = false;
+        return false;
+    }
+    if (found) {
+        return true;
+    }
+
+    while (true) {
+        auto it = cp->changed.find(itemId);
+        if (it != cp->changed.end()) {
+            stock = it->second;
+            found = true;
+            return true;
+        }
+        if (cp == checkpoints.begin()) {
+            return true;
+        }
+        --cp;
+    }
+}
+
+/**
+ * @brief 获取商品在时间范围内的变动记录
+ */
+bool InventoryLedger::history(const std::string& itemId, time_t from, time_t to,
+                              std::vector<LedgerRecord>& records) const {
+    records.clear();
+    if (from > to) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ifstream in(filePath, std::ios::binary);
+    uint64_t begin;
+    uint64_t end;
+    bool ok = in.is_open() && countUntil(in, from - 1, begin) && countUntil(in, to, end) &&
+              scan(in, begin, end, [&](const LedgerRecord& record) {
+                  if (record.itemId == itemId) {
+                      records.push_back(record);
+                  }
+              });
+    if (!ok) {
+        Logger::getInstance()->error("InventoryLedger", "读取库存流水失败", {{"path", filePath}});
+        records.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 与订单对账
+ */
+bool InventoryLedger::reconcile(const std::vector<std::shared_ptr<Order>>& orders,
+                                std::vector<ReconcileEntry>& mismatches, size_t threadCount) const {
+    using Totals = std::unordered_map<std::string, long long>;
+
+    mismatches.clear();
+    uint64_t count;
+    time_t startTime = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        count = recordCount;
+        if (count == 0) {
+            return true;
+        }
+        std::ifstream in(filePath, std::ios::binary);
+        LedgerRecord first;
+        if (!readRecord(in, 0, first)) {
+            Logger::getInstance()->error("InventoryLedger", "读取库存流水失败", {{"path", filePath}});
+            return false;
+        }
+        startTime = first.time;
+    }
+
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // 订单分块并行汇总（只统计流水账开始之后的订单）
+    std::vector<std::future<Totals>> orderWorkers;
+    size_t orderChunk = (orders.size() + threadCount - 1) / threadCount;
+    for (size_t begin = 0; begin < orders.size(); begin += orderChunk) {
+        size_t end = std::min(orders.size(), begin + orderChunk);
+        orderWorkers.push_back(std::async(std::launch::async, [&orders, begin, end, startTime]() {
+            Totals totals;
+            for (size_t i = begin; i < end; ++i) {
+                if (orders[i]->getOrderTime() < startTime) {
+                    continue;
+                }
+                for (const auto& orderItem : orders[i]->getItems()) {
+                    totals[orderItem.itemId] += orderItem.quantity;
+                }
+            }
+            return totals;
+        }));
+    }
+
+    // 流水记录分块并行汇总，每个线程使用独立的文件流（只读取对账开始时已有的记录）
+    std::vector<std::future<std::pair<Totals, bool>>> ledgerWorkers;
+    uint64_t ledgerChunk = (count + threadCount - 1) / threadCount;
+    for (uint64_t begin = 0; begin < count; begin += ledgerChunk) {
+        uint64_t end = std::min(count, begin + ledgerChunk);
+        ledgerWorkers.push_back(std::async(std::launch::async, [this, begin, end]() {
+            Totals totals;
+            std::ifstream in(filePath, std::ios::binary);
+            bool ok = scan(in, begin, end, [&totals](const LedgerRecord& record) {
+                if (record.reason == StockMovementReason::SALE ||
+                    record.reason == StockMovementReason::ROLLBACK) {
+                    totals[record.itemId] -= record.delta;
+                }
+            });
+            return std::make_pair(std::move(totals), ok);
+        }));
+    }
+
+    Totals ordered;
+    for (auto& worker : orderWorkers) {
+        for (const auto& entry : worker.get()) {
+            ordered[entry.first] += entry.second;
+        }
+    }
+    Totals sold;
+    bool scanned = true;
+    for (auto& worker : ledgerWorkers) {
+        auto result = worker.get();
+        scanned = scanned && result.second;
+        for (const auto& entry : result.first) {
+            sold[entry.first] += entry.second;
+        }
+    }
+    if (!scanned) {
+        Logger::getInstance()->error("InventoryLedger", "读取库存流水失败", {{"path", filePath}});
+        return false;
+    }
+
+    for (const auto& entry : ordered) {
+        auto it = sold.find(entry.first);
+        long long ledgerQuantity = it == sold.end() ? 0 : it->second;
+        if (ledgerQuantity != entry.second) {
+            mismatches.push_back(ReconcileEntry{entry.first, entry.second, ledgerQuantity});
+        }
+    }
+    for (const auto& entry : sold) {
+        if (entry.second != 0 && ordered.find(entry.first) == ordered.end()) {
+            mismatches.push_back(ReconcileEntry{entry.first, 0, entry.second});
+        }
+    }
+    std::sort(mismatches.begin(), mismatches.end(),
+              [](const ReconcileEntry& a, const ReconcileEntry& b) { return a.itemId < b.itemId; });
+    return true;
+}
+
+/**
+ * @brief 获取记录总数
+ */
+uint64_t InventoryLedger::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return recordCount;
+}
+
+/**
+ * @brief 获取变动原因的显示字符串
+ */
+std::string InventoryLedger::reasonToString(StockMovementReason reason) {
+    switch (reason) {
+        case StockMovementReason::OPENING:    return "期初";
+        case StockMovementReason::SALE:       return "销售";
+        case StockMovementReason::ROLLBACK:   return "回滚";
+        case StockMovementReason::RESTOCK:    return "补货";
+        case StockMovementReason::ADJUSTMENT: return "调整";
+        case StockMovementReason::IMPORT:     return "导入";
+    }
+    return "未知";
+}
@@ -7,17 +7,28 @@
 
 #include "ItemManage/ItemManager.h"
 #include "Promotion/PromotionManager.h"
+#include "Log/Logger.h"
+#include "Services/ListingRenderer.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <algorithm>
 #include <iomanip>
+#include <thread>
+#include <future>
+#include <atomic>
+#include <chrono>
+#include <unordered_map>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <filesystem>
 
 /**
  * @brief 构造函数实现
  */
 ItemManager::ItemManager(const std::string& filePath)
-    : filePath(filePath) {
+    : maxNumericItemId(0), filePath(filePath) {
 }
 
 /**
@@ -52,9 +63,10 @@ std::vector<std::string> ItemManager::parseCSVLine(const std::string& line) {
  * @brief 从CSV文件加载商品数据
  */
 bool ItemManager::loadFromFile() {
+    std::unique_lock<std::shared_mutex> lock(mutex);
     std::ifstream file(filePath);
     if (!file.is_open()) {
-        std::cout << "商品数据文件不存在，将创建新文件。" << std::endl;
+        Logger::getInstance()->info("ItemManager", "商品数据文件不存在，将创建新文件", {{"path", filePath}});
         return true;
     }
     
@@ -63,7 +75,6 @@ bool ItemManager::loadFromFile() {
     
     // 清空现有数据
     items.clear();
-    categoryIndex.clear();
     headers.clear();
     
     // 逐行读取文件
@@ -100,27 +111,42 @@ bool ItemManager::loadFromFile() {
     
     file.close();
     
-    // 重建类别索引
-    rebuildCategoryIndex();
+    // 重建全部索引
+    rebuildIndexes();
     
-    std::cout << "成功加载 " << items.size() << " 个商品数据。" << std::endl;
+    Logger::getInstance()->info("ItemManager", "成功加载商品数据",
+                                {{"count", std::to_string(items.size())}, {"path", filePath}});
     return true;
 }
 
 /**
  * @brief 保存商品数据到CSV文件
+ *
+ * 持有读锁写文件，保存期间下单线程仍可查询商品
  */
 bool ItemManager::saveToFile() {
-    std::ofstream file(filePath);
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return writeFile();
+}
+
+/**
+ * @brief 写入商品数据文件
+ *
+ * 先写临时文件再替换原文件，写到一半中断时原文件保持完整
+ */
+bool ItemManager::writeFile() {
+    std::lock_guard<std::mutex> fileLock(fileMutex);
+    std::string tempPath = filePath + ".tmp";
+    std::ofstream file(tempPath, std::ios::trunc);
     if (!file.is_open()) {
-        std::cerr << "无法打开文件进行写入: " << filePath << std::endl;
+        Logger::getInstance()->error("ItemManager", "无法打开文件进行写入", {{"path", tempPath}});
         return false;
     }
     
     // 写入表头
     if (headers.empty()) {
         // 默认表头
-        file << "item_id,item_name,category,price,description,stock" << std::endl;
+        file << "item_id,item_name,category,price,description,stock" << '\n';
     } else {
         for (size_t i = 0; i < headers.size(); ++i) {
             file << headers[i];
@@ -128,7 +154,7 @@ bool ItemManager::saveToFile() {
                 file << ",";
             }
         }
-        file << std::endl;
+        file << '\n';
     }
     
     // 写入每个商品的数据
@@ -140,10 +166,22 @@ bool ItemManager::saveToFile() {
              << item->getDescription() << ","
              << item->getStock();
         
-        file << std::endl;
+        file << '\n';
     }
     
     file.close();
+    if (file.fail()) {
+        Logger::getInstance()->error("ItemManager", "写入商品临时文件失败", {{"path", tempPath}});
+        return false;
+    }
+    
+    std::error_code ec;
+    std::filesystem::rename(tempPath, filePath, ec);
+    if (ec) {
+        Logger::getInstance()->error("ItemManager", "替换商品数据文件失败",
+                                     {{"path", filePath}, {"error", ec.message()}});
+        return false;
+    }
     return true;
 }
 
@@ -152,87 +190,727 @@ bool ItemManager::saveToFile() {
  */
 void ItemManager::rebuildCategoryIndex() {
     categoryIndex.clear();
+    indexedCategory.clear();
     
     for (const auto& item : items) {
         categoryIndex[item->getCategory()].push_back(item);
+        indexedCategory[item->getItemId()] = item->getCategory();
     }
 }
 
 /**
- * @brief 生成新的商品ID
+ * @brief 重建全部索引
  */
-std::string ItemManager::generateNewItemId() {
-    int maxId = 0;
+void ItemManager::rebuildIndexes() {
+    itemById.clear();
+    priceIndex.clear();
+    nameIndex.clear();
+    stockIndex.clear();
+    stockWatch.clear();
+    maxNumericItemId = 0;
     
-    // 找到当前最大的ID
     for (const auto& item : items) {
-        try {
-            int id = std::stoi(item->getItemId());
-            if (id > maxId) {
-                maxId = id;
+        indexItem(item);
+        noteItemId(item->getItemId());
+    }
+    rebuildCategoryIndex();
+}
+
+/**
+ * @brief 将商品写入ID索引和排序索引
+ */
+void ItemManager::indexItem(const std::shared_ptr<Item>& item) {
+    const std::string& itemId = item->getItemId();
+    itemById[itemId] = item;
+    priceIndex.upsert(itemId, item->getPrice());
+    nameIndex.upsert(itemId, item->getItemName());
+    stockIndex.upsert(itemId, item->getStock());
+    stockWatch.update(itemId, item->getStock());
+}
+
+/**
+ * @brief 从所有索引中移除商品
+ */
+void ItemManager::unindexItem(const std::shared_ptr<Item>& item) {
+    const std::string& itemId = item->getItemId();
+    itemById.erase(itemId);
+    priceIndex.erase(itemId);
+    nameIndex.erase(itemId);
+    stockIndex.erase(itemId);
+    stockWatch.remove(itemId);
+    
+    auto catIt = indexedCategory.find(itemId);
+    if (catIt != indexedCategory.end()) {
+        auto bucketIt = categoryIndex.find(catIt->second);
+        if (bucketIt != categoryIndex.end()) {
+            auto& bucket = bucketIt->second;
+            bucket.erase(std::remove(bucket.begin(), bucket.end(), item), bucket.end());
+            if (bucket.empty()) {
+                categoryIndex.erase(bucketIt);
             }
-        } catch (...) {
-            // 忽略非数字ID
         }
+        indexedCategory.erase(catIt);
+    }
+}
+
+/**
+ * @brief 按商品当前值刷新索引
+ * 
+ * 排序索引按新值重新定位；类别变化时把商品移动到新类别下
+ */
+std::vector<ItemChangeKind> ItemManager::reindexItem(const std::shared_ptr<Item>& item) {
+    std::vector<ItemChangeKind> kinds;
+    const std::string& itemId = item->getItemId();
+    
+    double oldPrice = 0.0;
+    int oldStock = 0;
+    std::string oldName;
+    if (priceIndex.getKey(itemId, oldPrice) && oldPrice != item->getPrice()) {
+        kinds.push_back(ItemChangeKind::PRICE);
+    }
+    if (stockIndex.getKey(itemId, oldStock) && oldStock != item->getStock()) {
+        kinds.push_back(ItemChangeKind::STOCK);
+    }
+    bool detailsChanged = nameIndex.getKey(itemId, oldName) && oldName != item->getItemName();
+    
+    priceIndex.upsert(itemId, item->getPrice());
+    nameIndex.upsert(itemId, item->getItemName());
+    stockIndex.upsert(itemId, item->getStock());
+    stockWatch.update(itemId, item->getStock());
+    
+    auto catIt = indexedCategory.find(itemId);
+    if (catIt != indexedCategory.end() && catIt->second != item->getCategory()) {
+        auto& oldBucket = categoryIndex[catIt->second];
+        oldBucket.erase(std::remove(oldBucket.begin(), oldBucket.end(), item), oldBucket.end());
+        if (oldBucket.empty()) {
+            categoryIndex.erase(catIt->second);
+        }
+        categoryIndex[item->getCategory()].push_back(item);
+        catIt->second = item->getCategory();
+        detailsChanged = true;
+    }
+    
+    if (detailsChanged) {
+        kinds.push_back(ItemChangeKind::DETAILS);
+    }
+    return kinds;
+}
+
+/**
+ * @brief 刷新单个商品的索引并通知监听者
+ */
+void ItemManager::refreshItemIndexes(const std::string& itemId) {
+    std::vector<ItemChangeKind> kinds;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto it = itemById.find(itemId);
+        if (it == itemById.end()) {
+            return;
+        }
+        kinds = reindexItem(it->second);
     }
     
-    // 返回下一个ID
-    return std::to_string(maxId + 1);
+    std::vector<std::string> ids{itemId};
+    for (ItemChangeKind kind : kinds) {
+        notifyItemsChanged(ids, kind);
+    }
+}
+
+/**
+ * @brief 注册商品变更监听者
+ */
+void ItemManager::addChangeListener(IItemChangeListener* listener) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (listener != nullptr &&
+        std::find(changeListeners.begin(), changeListeners.end(), listener) == changeListeners.end()) {
+        changeListeners.push_back(listener);
+    }
+}
+
+/**
+ * @brief 注销商品变更监听者
+ */
+void ItemManager::removeChangeListener(IItemChangeListener* listener) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    changeListeners.erase(std::remove(changeListeners.begin(), changeListeners.end(), listener),
+                          changeListeners.end());
+}
+
+/**
+ * @brief 通知所有监听者
+ */
+void ItemManager::notifyItemsChanged(const std::vector<std::string>& itemIds, ItemChangeKind kind) {
+    if (itemIds.empty()) {
+        return;
+    }
+    std::vector<IItemChangeListener*> listeners;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        listeners = changeListeners;
+    }
+    for (auto* listener : listeners) {
+        listener->onItemsChanged(itemIds, kind);
+    }
+}
+
+/**
+ * @brief 库存已被直接修改后写入流水记录
+ */
+void ItemManager::recordStockChange(const std::shared_ptr<Item>& item, int oldStock,
+                                    StockMovementReason reason, const std::string& reference) {
+    if (ledger && item->getStock() != oldStock) {
+        ledger->record(item->getItemId(), item->getStock() - oldStock, item->getStock(), reason, reference);
+    }
+}
+
+/**
+ * @brief 调整商品库存并写入流水记录
+ */
+bool ItemManager::adjustStock(const std::string& itemId, int delta, StockMovementReason reason,
+                              const std::string& reference) {
+    std::vector<ItemChangeKind> kinds;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto it = itemById.find(itemId);
+        if (it == itemById.end()) {
+            return false;
+        }
+        const auto& item = it->second;
+        
+        int oldStock = item->getStock();
+        long long newStock = static_cast<long long>(oldStock) + delta;
+        if (newStock < 0 || newStock > std::numeric_limits<int>::max()) {
+            return false;
+        }
+        
+        item->setStock(static_cast<int>(newStock));
+        kinds = reindexItem(item);
+        recordStockChange(item, oldStock, reason, reference);
+    }
+    
+    std::vector<std::string> ids{itemId};
+    for (ItemChangeKind kind : kinds) {
+        notifyItemsChanged(ids, kind);
+    }
+    return true;
+}
+
+/**
+ * @brief 启用库存流水账
+ */
+bool ItemManager::enableLedger(const std::string& ledgerPath, size_t checkpointInterval) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto newLedger = std::make_unique<InventoryLedger>(ledgerPath, checkpointInterval);
+    if (!newLedger->open(items)) {
+        return false;
+    }
+    ledger = std::move(newLedger);
+    return true;
+}
+
+/**
+ * @brief 更新当前最大的数字商品ID
+ */
+void ItemManager::noteItemId(const std::string& itemId) {
+    if (itemId.empty() || itemId.size() > 18) {
+        return;
+    }
+    for (char c : itemId) {
+        if (c < '0' || c > '9') {
+            return;     // 忽略非数字ID
+        }
+    }
+    long long id = std::stoll(itemId);
+    if (id > maxNumericItemId) {
+        maxNumericItemId = id;
+    }
+}
+
+/**
+ * @brief 生成新的商品ID
+ */
+std::string ItemManager::generateNewItemId() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return std::to_string(maxNumericItemId + 1);
 }
 
 /**
  * @brief 添加新商品
  */
 bool ItemManager::addItem(std::shared_ptr<Item> item) {
-    // 检查ID是否已存在
-    if (isItemIdExists(item->getItemId())) {
+    bool saved;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        // 检查ID是否已存在
+        if (itemById.count(item->getItemId()) > 0) {
+            return false;
+        }
+        
+        // 添加到列表
+        items.push_back(item);
+        
+        // 更新索引
+        indexItem(item);
+        noteItemId(item->getItemId());
+        categoryIndex[item->getCategory()].push_back(item);
+        indexedCategory[item->getItemId()] = item->getCategory();
+        recordStockChange(item, 0, StockMovementReason::OPENING, "add");
+        
+        // 保存到文件
+        saved = writeFile();
+    }
+    notifyItemsChanged({item->getItemId()}, ItemChangeKind::ADDED);
+    return saved;
+}
+
+namespace {
+
+/**
+ * @struct ParsedItemRow
+ * @brief 批量导入时解析出的一行商品数据
+ */
+struct ParsedItemRow {
+    size_t lineNo;              // 行号（用于按原始顺序去重）
+    std::string itemId;         // 商品ID（为空时自动分配）
+    std::string itemName;       // 商品名称
+    std::string category;       // 商品类别
+    double price;               // 价格
+    std::string description;    // 描述
+    int stock;                  // 库存
+};
+
+/**
+ * @brief 解析并校验一行商品数据（不抛异常）
+ * @return 合法返回true
+ */
+bool parseImportLine(const std::string& line, size_t lineNo, ParsedItemRow& row) {
+    std::vector<std::string> fields;
+    size_t start = 0;
+    while (true) {
+        size_t comma = line.find(',', start);
+        std::string field = line.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        size_t first = field.find_first_not_of(" \t\r\n");
+        size_t last = field.find_last_not_of(" \t\r\n");
+        fields.push_back(first == std::string::npos ? "" : field.substr(first, last - first + 1));
+        if (comma == std::string::npos) {
+            break;
+        }
+        start = comma + 1;
+    }
+    
+    if (fields.size() < 6 || fields[1].empty()) {
+        return false;
+    }
+    
+    char* end = nullptr;
+    double price = std::strtod(fields[3].c_str(), &end);
+    if (fields[3].empty() || *end != '\0' || price < 0) {
+        return false;
+    }
+    long stock = std::strtol(fields[5].c_str(), &end, 10);
+    if (fields[5].empty() || *end != '\0' || stock < 0 || stock > std::numeric_limits<int>::max()) {
         return false;
     }
     
-    // 添加到列表
-    items.push_back(item);
+    row = ParsedItemRow{lineNo, fields[0], fields[1], fields[2], price, fields[4], static_cast<int>(stock)};
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief 从CSV流批量导入商品
+ */
+ItemImportStats ItemManager::bulkUpsertFromCSV(std::istream& in, const ImportProgressCallback& progress,
+                                               size_t threadCount) {
+    auto startTime = std::chrono::steady_clock::now();
+    ItemImportStats stats;
     
-    // 更新类别索引
-    categoryIndex[item->getCategory()].push_back(item);
+    // 读取所有数据行
+    std::vector<std::string> lines;
+    std::string line;
+    bool firstLine = true;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+        if (firstLine) {
+            firstLine = false;
+            if (line.compare(0, 7, "item_id") == 0) {
+                continue;   // 跳过表头
+            }
+        }
+        lines.push_back(std::move(line));
+    }
+    stats.totalRows = lines.size();
     
-    // 保存到文件
-    return saveToFile();
+    // 分块并行解析
+    if (threadCount == 0) {
+        threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    threadCount = std::max<size_t>(1, std::min(threadCount, lines.size() / 1024 + 1));
+    
+    std::atomic<size_t> processed(0);
+    std::vector<std::future<std::pair<std::vector<ParsedItemRow>, size_t>>> workers;
+    size_t chunkSize = (lines.size() + threadCount - 1) / threadCount;
+    
+    for (size_t t = 0; t < threadCount; ++t) {
+        size_t begin = t * chunkSize;
+        size_t end = std::min(lines.size(), begin + chunkSize);
+        if (begin >= end) {
+            break;
+        }
+        workers.push_back(std::async(std::launch::async, [&lines, &processed, begin, end]() {
+            std::vector<ParsedItemRow> parsed;
+            parsed.reserve(end - begin);
+            size_t invalid = 0;
+            for (size_t i = begin; i < end; ++i) {
+                ParsedItemRow row;
+                if (parseImportLine(lines[i], i, row)) {
+                    parsed.push_back(std::move(row));
+                } else {
+                    ++invalid;
+                }
+                if ((i - begin) % 4096 == 4095) {
+                    processed.fetch_add(4096, std::memory_order_relaxed);
+                }
+            }
+            processed.fetch_add((end - begin) % 4096, std::memory_order_relaxed);
+            return std::make_pair(std::move(parsed), invalid);
+        }));
+    }
+    
+    // 在调用线程中汇报进度，并按分块顺序收集结果（保持原始行顺序）
+    std::vector<ParsedItemRow> rows;
+    rows.reserve(lines.size());
+    for (auto& worker : workers) {
+        while (worker.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready) {
+            if (progress) {
+                progress(processed.load(std::memory_order_relaxed), stats.totalRows);
+            }
+        }
+        auto result = worker.get();
+        stats.invalidRows += result.second;
+        for (auto& row : result.first) {
+            rows.push_back(std::move(row));
+        }
+    }
+    if (progress) {
+        progress(stats.totalRows, stats.totalRows);
+    }
+    lines.clear();
+    lines.shrink_to_fit();
+    
+    // 按商品ID去重，同一ID以最后出现的行为准
+    std::unordered_map<std::string, size_t> lastRowOfId;
+    lastRowOfId.reserve(rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (rows[i].itemId.empty()) {
+            continue;
+        }
+        auto inserted = lastRowOfId.emplace(rows[i].itemId, i);
+        if (!inserted.second) {
+            ++stats.duplicateRows;
+            inserted.first->second = i;
+        }
+    }
+    
+    // 应用阶段持有写锁，解析阶段不阻塞查询
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    
+    // 先登记所有显式ID，保证自动分配的ID不会与本批次中的显式ID冲突
+    for (const auto& entry : lastRowOfId) {
+        noteItemId(entry.first);
+    }
+    
+    // 一次性应用到商品列表和索引
+    std::vector<std::string> insertedIds;
+    std::vector<std::string> updatedIds;
+    std::vector<std::string> priceChangedIds;
+    std::vector<std::string> stockChangedIds;
+    items.reserve(items.size() + rows.size());
+    itemById.reserve(items.size() + rows.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        auto& row = rows[i];
+        if (!row.itemId.empty() && lastRowOfId[row.itemId] != i) {
+            continue;   // 被后续同ID行覆盖
+        }
+        
+        auto existing = row.itemId.empty() ? itemById.end() : itemById.find(row.itemId);
+        if (existing != itemById.end()) {
+            const auto& item = existing->second;
+            int oldStock = item->getStock();
+            item->setItemName(row.itemName);
+            item->setCategory(row.category);
+            item->setPrice(row.price);
+            item->setDescription(row.description);
+            item->setStock(row.stock);
+            for (ItemChangeKind kind : reindexItem(item)) {
+                if (kind == ItemChangeKind::PRICE) {
+                    priceChangedIds.push_back(row.itemId);
+                } else if (kind == ItemChangeKind::STOCK) {
+                    stockChangedIds.push_back(row.itemId);
+                }
+            }
+            recordStockChange(item, oldStock, StockMovementReason::IMPORT, "import");
+            updatedIds.push_back(row.itemId);
+            ++stats.updated;
+            continue;
+        }
+        
+        if (row.itemId.empty()) {
+            row.itemId = std::to_string(++maxNumericItemId);
+        }
+        auto item = std::make_shared<Item>(row.itemId, row.itemName, row.category,
+                                           row.price, row.description, row.stock);
+        items.push_back(item);
+        indexItem(item);
+        noteItemId(row.itemId);
+        categoryIndex[item->getCategory()].push_back(item);
+        indexedCategory[item->getItemId()] = item->getCategory();
+        recordStockChange(item, 0, StockMovementReason::IMPORT, "import");
+        insertedIds.push_back(row.itemId);
+        ++stats.inserted;
+    }
+    
+    // 只保存一次，每类变更只通知一次
+    if (stats.inserted > 0 || stats.updated > 0) {
+        stats.saved = writeFile();
+    }
+    lock.unlock();
+    notifyItemsChanged(insertedIds, ItemChangeKind::ADDED);
+    notifyItemsChanged(updatedIds, ItemChangeKind::DETAILS);
+    notifyItemsChanged(priceChangedIds, ItemChangeKind::PRICE);
+    notifyItemsChanged(stockChangedIds, ItemChangeKind::STOCK);
+    
+    if (!stats.saved) {
+        Logger::getInstance()->error("ItemManager", "批量导入后保存商品数据失败", {{"path", filePath}});
+    }
+    
+    stats.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    stats.rowsPerSecond = stats.elapsedSeconds > 0 ? stats.totalRows / stats.elapsedSeconds : 0.0;
+    
+    Logger::getInstance()->info("ItemManager", "批量导入商品完成",
+                                {{"rows", std::to_string(stats.totalRows)},
+                                 {"inserted", std::to_string(stats.inserted)},
+                                 {"updated", std::to_string(stats.updated)},
+                                 {"invalid", std::to_string(stats.invalidRows)},
+                                 {"duplicates", std::to_string(stats.duplicateRows)},
+                                 {"seconds", std::to_string(stats.elapsedSeconds)}});
+    return stats;
+}
+
+/**
+ * @brief 从CSV文件批量导入商品
+ */
+bool ItemManager::bulkUpsertFromFile(const std::string& importPath, ItemImportStats& stats,
+                                     const ImportProgressCallback& progress) {
+    std::ifstream file(importPath);
+    if (!file.is_open()) {
+        Logger::getInstance()->warn("ItemManager", "无法打开导入文件", {{"path", importPath}});
+        return false;
+    }
+    
+    stats = bulkUpsertFromCSV(file, progress);
+    return true;
+}
+
+namespace {
+
+/**
+ * @brief 对连续数组执行 v = max(v * scale + offset, floor)
+ * 
+ * 循环体无分支、无函数调用，开启优化后可被编译器自动向量化
+ */
+void applyAffine(double* values, size_t count, double scale, double offset, double floor) {
+    for (size_t i = 0; i < count; ++i) {
+        double v = values[i] * scale + offset;
+        values[i] = v < floor ? floor : v;
+    }
+}
+
+/**
+ * @brief 把连续数组中的值按1/factor的精度四舍五入
+ */
+void roundTo(double* values, size_t count, double factor) {
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = std::nearbyint(values[i] * factor) / factor;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 收集满足筛选条件的商品
+ * 
+ * 优先用ID列表、类别索引或价格索引缩小候选集，再逐个检查其余条件
+ */
+std::vector<std::shared_ptr<Item>> ItemManager::collectMatching(const ItemFilter& filter) const {
+    std::vector<std::shared_ptr<Item>> candidates;
+    if (!filter.itemIds.empty()) {
+        std::unordered_map<std::string, bool> seen;
+        for (const auto& id : filter.itemIds) {
+            auto it = itemById.find(id);
+            if (it != itemById.end() && seen.emplace(id, true).second) {
+                candidates.push_back(it->second);
+            }
+        }
+    } else if (!filter.category.empty()) {
+        auto it = categoryIndex.find(filter.category);
+        if (it != categoryIndex.end()) {
+            candidates = it->second;
+        }
+    } else if (filter.hasPriceRange) {
+        for (const auto& id : priceIndex.rangeIds(filter.minPrice, filter.maxPrice)) {
+            candidates.push_back(itemById.at(id));
+        }
+    } else {
+        candidates = items;
+    }
+    
+    std::vector<std::shared_ptr<Item>> matched;
+    matched.reserve(candidates.size());
+    for (const auto& item : candidates) {
+        if (!filter.category.empty() && item->getCategory() != filter.category) {
+            continue;
+        }
+        if (filter.hasPriceRange &&
+            (item->getPrice() < filter.minPrice || item->getPrice() > filter.maxPrice)) {
+            continue;
+        }
+        if (filter.predicate && !filter.predicate(*item)) {
+            continue;
+        }
+        matched.push_back(item);
+    }
+    return matched;
+}
+
+/**
+ * @brief 按筛选条件批量调整价格或库存
+ */
+BulkUpdateStats ItemManager::bulkUpdate(const ItemFilter& filter, BulkUpdateField field, BulkUpdateOp op,
+                                        double operand) {
+    BulkUpdateStats stats;
+    auto startTime = std::chrono::steady_clock::now();
+    
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    std::vector<std::shared_ptr<Item>> matched = collectMatching(filter);
+    stats.matched = matched.size();
+    
+    // 收集到连续数组
+    const size_t count = matched.size();
+    std::vector<double> values(count);
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = field == BulkUpdateField::PRICE ? matched[i]->getPrice()
+                                                    : static_cast<double>(matched[i]->getStock());
+    }
+    std::vector<double> original(values);
+    
+    // 统一为仿射变换 v = v * scale + offset
+    double scale = 1.0;
+    double offset = 0.0;
+    switch (op) {
+        case BulkUpdateOp::SET:   scale = 0.0;     offset = operand; break;
+        case BulkUpdateOp::SCALE: scale = operand; offset = 0.0;     break;
+        case BulkUpdateOp::ADD:   scale = 1.0;     offset = operand; break;
+    }
+    applyAffine(values.data(), count, scale, offset, 0.0);
+    roundTo(values.data(), count, field == BulkUpdateField::PRICE ? 100.0 : 1.0);
+    
+    // 溢出为inf或nan的结果不写入，商品保持原值；库存另按int上限截断
+    const double maxStock = static_cast<double>(std::numeric_limits<int>::max());
+    for (size_t i = 0; i < count; ++i) {
+        if (!std::isfinite(values[i])) {
+            values[i] = original[i];
+            ++stats.rejected;
+        } else if (field == BulkUpdateField::STOCK && values[i] > maxStock) {
+            values[i] = maxStock;
+            ++stats.clamped;
+        }
+    }
+    
+    // 写回并刷新索引
+    std::vector<std::string> changedIds;
+    for (size_t i = 0; i < count; ++i) {
+        if (values[i] == original[i]) {
+            continue;
+        }
+        const auto& item = matched[i];
+        if (field == BulkUpdateField::PRICE) {
+            item->setPrice(values[i]);
+        } else {
+            item->setStock(static_cast<int>(values[i]));
+            recordStockChange(item, static_cast<int>(original[i]),
+                              values[i] > original[i] ? StockMovementReason::RESTOCK
+                                                      : StockMovementReason::ADJUSTMENT, "bulk");
+        }
+        reindexItem(item);
+        changedIds.push_back(item->getItemId());
+    }
+    stats.changed = changedIds.size();
+    
+    // 只保存一次、只通知一次
+    if (!changedIds.empty()) {
+        stats.saved = writeFile();
+        lock.unlock();
+        notifyItemsChanged(changedIds, field == BulkUpdateField::PRICE ? ItemChangeKind::PRICE
+                                                                       : ItemChangeKind::STOCK);
+    }
+    
+    stats.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    
+    Logger::getInstance()->info("ItemManager", "批量调整商品完成",
+                                {{"field", field == BulkUpdateField::PRICE ? "price" : "stock"},
+                                 {"matched", std::to_string(stats.matched)},
+                                 {"changed", std::to_string(stats.changed)},
+                                 {"clamped", std::to_string(stats.clamped)},
+                                 {"rejected", std::to_string(stats.rejected)},
+                                 {"saved", stats.saved ? "true" : "false"},
+                                 {"seconds", std::to_string(stats.elapsedSeconds)}});
+    return stats;
 }
 
 /**
  * @brief 根据ID删除商品
  */
 bool ItemManager::deleteItem(const std::string& itemId) {
-    // 查找并删除商品
-    auto it = std::find_if(items.begin(), items.end(),
-        [&itemId](const std::shared_ptr<Item>& item) {
-            return item->getItemId() == itemId;
-        });
-    
-    if (it != items.end()) {
-        items.erase(it);
+    bool saved;
+    {
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        auto indexIt = itemById.find(itemId);
+        if (indexIt == itemById.end()) {
+            return false;
+        }
         
-        // 重建类别索引
-        rebuildCategoryIndex();
+        // 查找并删除商品
+        std::shared_ptr<Item> item = indexIt->second;
+        items.erase(std::remove(items.begin(), items.end(), item), items.end());
+        
+        // 更新索引
+        unindexItem(item);
+        if (ledger && item->getStock() != 0) {
+            ledger->record(itemId, -item->getStock(), 0, StockMovementReason::ADJUSTMENT, "delete");
+        }
         
         // 保存到文件
-        return saveToFile();
+        saved = writeFile();
     }
-    
-    return false;
+    notifyItemsChanged({itemId}, ItemChangeKind::REMOVED);
+    return saved;
 }
 
 /**
  * @brief 根据ID查找商品
  */
 std::shared_ptr<Item> ItemManager::findItemById(const std::string& itemId) {
-    auto it = std::find_if(items.begin(), items.end(),
-        [&itemId](const std::shared_ptr<Item>& item) {
-            return item->getItemId() == itemId;
-        });
-    
-    if (it != items.end()) {
-        return *it;
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = itemById.find(itemId);
+    if (it != itemById.end()) {
+        return it->second;
     }
     
     return nullptr;
@@ -242,6 +920,7 @@ std::shared_ptr<Item> ItemManager::findItemById(const std::string& itemId) {
  * @brief 根据类别获取商品列表
  */
 std::vector<std::shared_ptr<Item>> ItemManager::getItemsByCategory(const std::string& category) {
+    std::shared_lock<std::shared_mutex> lock(mutex);
     auto it = categoryIndex.find(category);
     if (it != categoryIndex.end()) {
         return it->second;
@@ -249,10 +928,19 @@ std::vector<std::shared_ptr<Item>> ItemManager::getItemsByCategory(const std::st
     return std::vector<std::shared_ptr<Item>>();
 }
 
+/**
+ * @brief 获取所有商品列表
+ */
+std::vector<std::shared_ptr<Item>> ItemManager::getAllItems() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return items;
+}
+
 /**
  * @brief 获取所有类别
  */
 std::vector<std::string> ItemManager::getAllCategories() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
     std::vector<std::string> categories;
     for (const auto& pair : categoryIndex) {
         categories.push_back(pair.first);
@@ -261,74 +949,104 @@ std::vector<std::string> ItemManager::getAllCategories() const {
 }
 
 /**
- * @brief 显示所有商品信息（表格形式）
- * 
- * 如果提供了 PromotionManager，会在商品名称后显示促销标签
+ * @brief 查询所有商品
  */
-void ItemManager::displayAllItems(PromotionManager* promotionManager) const {
-    if (items.empty()) {
-        std::cout << "暂无商品信息。" << std::endl;
-        return;
-    }
-    
-    std::cout << "\n========== 商品列表 ==========" << std::endl;
-    std::cout << std::left
-              << std::setw(8) << "ID"
-              << std::setw(25) << "名称"
-              << std::setw(12) << "类别"
-              << std::setw(10) << "价格"
-              << std::setw(30) << "描述"
-              << std::setw(8) << "库存"
-              << std::endl;
-    std::cout << "-------------------------------------------------------------------------------------" << std::endl;
+ItemListing ItemManager::queryItems(PromotionManager* promotionManager) const {
+    ItemListing listing;
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    listing.rows.reserve(items.size());
     
     for (const auto& item : items) {
-        // 构建商品名称（包含促销标签）
-        std::string itemNameWithTag = item->getItemName();
+        ItemRow row{item->getItemId(), item->getItemName(), item->getCategory(),
+                    item->getPrice(), item->getDescription(), item->getStock(), ""};
         
         // 如果提供了促销管理器，检查是否有促销活动
         if (promotionManager != nullptr) {
             auto discount = promotionManager->getActiveDiscountForItem(item->getItemId());
             if (discount != nullptr) {
-                itemNameWithTag += " [" + discount->getDisplayTag() + "]";
+                row.promotionTag = discount->getDisplayTag();
             }
         }
-        
-        std::cout << std::left
-                  << std::setw(8) << item->getItemId()
-                  << std::setw(25) << itemNameWithTag
-                  << std::setw(12) << item->getCategory()
-                  << std::setw(10) << std::fixed << std::setprecision(2) << item->getPrice()
-                  << std::setw(30) << item->getDescription()
-                  << std::setw(8) << item->getStock()
-                  << std::endl;
+        listing.rows.push_back(std::move(row));
     }
     
-    std::cout << "=============================" << std::endl;
-    std::cout << "共 " << items.size() << " 件商品。" << std::endl;
+    lock.unlock();
     
-    // 显示当前有效的满减活动
     if (promotionManager != nullptr) {
-        auto fullReductions = promotionManager->getActiveFullReductions();
-        if (!fullReductions.empty()) {
-            std::cout << "\n【当前满减活动】：";
-            for (size_t i = 0; i < fullReductions.size(); ++i) {
-                if (i > 0) std::cout << "、";
-                std::cout << fullReductions[i]->getDisplayTag();
+        for (const auto& promotion : promotionManager->getActiveFullReductions()) {
+            listing.fullReductionTags.push_back(promotion->getDisplayTag());
+        }
+    }
+    
+    return listing;
+}
+
+/**
+ * @brief 按排序字段分页查询商品
+ */
+ListPage<ItemRow> ItemManager::queryItemPage(ItemSortKey sortKey, bool descending, const std::string& cursor,
+                                             size_t limit, PromotionManager* promotionManager) const {
+    ListPage<ItemRow> page;
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    page.totalCount = items.size();
+    
+    std::vector<std::string> ids;
+    switch (sortKey) {
+        case ItemSortKey::PRICE:
+            page.invalidCursor = !priceIndex.page(cursor, descending, limit, ids, page.nextCursor);
+            break;
+        case ItemSortKey::NAME:
+            page.invalidCursor = !nameIndex.page(cursor, descending, limit, ids, page.nextCursor);
+            break;
+        case ItemSortKey::STOCK:
+            page.invalidCursor = !stockIndex.page(cursor, descending, limit, ids, page.nextCursor);
+            break;
+    }
+    
+    page.rows.reserve(ids.size());
+    for (const auto& itemId : ids) {
+        const auto& item = itemById.at(itemId);
+        ItemRow row{item->getItemId(), item->getItemName(), item->getCategory(),
+                    item->getPrice(), item->getDescription(), item->getStock(), ""};
+        if (promotionManager != nullptr) {
+            auto discount = promotionManager->getActiveDiscountForItem(itemId);
+            if (discount != nullptr) {
+                row.promotionTag = discount->getDisplayTag();
             }
-            std::cout << std::endl;
         }
+        page.rows.push_back(std::move(row));
     }
+    
+    return page;
+}
+
+/**
+ * @brief 查询低库存商品
+ */
+std::vector<ItemRow> ItemManager::queryLowStock(int limit) const {
+    std::vector<ItemRow> rows;
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    for (const auto& entry : stockWatch.below(limit < 0 ? stockWatch.getThreshold() : limit)) {
+        const auto& item = itemById.at(entry.second);
+        rows.push_back(ItemRow{item->getItemId(), item->getItemName(), item->getCategory(),
+                               item->getPrice(), item->getDescription(), item->getStock(), ""});
+    }
+    return rows;
+}
+
+/**
+ * @brief 显示所有商品信息
+ */
+void ItemManager::displayAllItems(PromotionManager* promotionManager) const {
+    ListingRenderer::renderItems(queryItems(promotionManager), RenderFormat::CONSOLE, std::cout);
 }
 
 /**
  * @brief 检查商品ID是否存在
  */
 bool ItemManager::isItemIdExists(const std::string& itemId) const {
-    return std::find_if(items.begin(), items.end(),
-        [&itemId](const std::shared_ptr<Item>& item) {
-            return item->getItemId() == itemId;
-        }) != items.end();
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return itemById.find(itemId) != itemById.end();
 }
 
 /**
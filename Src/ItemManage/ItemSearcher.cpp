@@ -6,6 +6,8 @@
  */
 
 #include "ItemManage/ItemSearcher.h"
+#include "Log/Logger.h"
+#include "Services/ListingRenderer.h"
 #include <algorithm>
 #include <cctype>
 #include <iostream>
@@ -15,7 +17,7 @@
  * @brief 构造函数实现
  */
 ItemSearcher::ItemSearcher(IItemRepository* itemManager)
-    : itemManager(itemManager) {
+    : itemManager(itemManager), admission(nullptr) {
 }
 
 /**
@@ -96,10 +98,11 @@ double ItemSearcher::calculateSimilarity(const std::string& s1, const std::strin
  */
 std::vector<std::shared_ptr<Item>> ItemSearcher::searchByNameExact(const std::string& name) {
     std::vector<std::shared_ptr<Item>> results;
+    std::string lowerName = toLowerCase(name);
     
     for (const auto& item : itemManager->getAllItems()) {
         // 不区分大小写的比较
-        if (toLowerCase(item->getItemName()) == toLowerCase(name)) {
+        if (item->getItemName().size() == lowerName.size() && toLowerCase(item->getItemName()) == lowerName) {
             results.push_back(item);
         }
     }
@@ -167,20 +170,20 @@ std::vector<SearchResult> ItemSearcher::fuzzySearchByName(const std::string& key
 }
 
 /**
- * @brief 综合搜索（先精确后模糊）
+ * @brief 综合查询（先精确后模糊）
  */
-std::vector<SearchResult> ItemSearcher::search(const std::string& keyword, SearchType searchType) {
-    std::vector<SearchResult> results;
+SearchOutcome ItemSearcher::query(const std::string& keyword, SearchType searchType) {
+    SearchOutcome outcome{SearchMatchKind::FUZZY, {}, 0.0, 0.0};
     
     if (searchType == SearchType::BY_NAME || searchType == SearchType::ALL) {
         // 先尝试精确搜索
         auto exactResults = searchByNameExact(keyword);
         if (!exactResults.empty()) {
-            std::cout << "找到 " << exactResults.size() << " 个精确匹配结果（按名称）。" << std::endl;
+            outcome.kind = SearchMatchKind::EXACT_NAME;
             for (const auto& item : exactResults) {
-                results.push_back(SearchResult(item, 1.0));  // 精确匹配相似度为1.0
+                outcome.results.push_back(SearchResult(item, 1.0));  // 精确匹配相似度为1.0
             }
-            return results;
+            return outcome;
         }
     }
     
@@ -188,105 +191,70 @@ std::vector<SearchResult> ItemSearcher::search(const std::string& keyword, Searc
         // 尝试按类别搜索
         auto categoryResults = searchByCategoryExact(keyword);
         if (!categoryResults.empty()) {
-            std::cout << "找到 " << categoryResults.size() << " 个类别匹配结果。" << std::endl;
+            outcome.kind = SearchMatchKind::CATEGORY;
             for (const auto& item : categoryResults) {
-                results.push_back(SearchResult(item, 1.0));
+                outcome.results.push_back(SearchResult(item, 1.0));
             }
-            return results;
+            return outcome;
         }
     }
 
     if (searchType == SearchType::BY_PRICE) {
         // 尝试按价格区间搜索
         // 期望格式: "最小价格-最大价格" 例如: "1000-5000"
+        size_t dashPos = keyword.find('-');
+        if (dashPos == std::string::npos) {
+            outcome.kind = SearchMatchKind::INVALID_PRICE_FORMAT;
+            return outcome;
+        }
+        
         try {
-            size_t dashPos = keyword.find('-');
-            if (dashPos != std::string::npos) {
-                std::string minPriceStr = keyword.substr(0, dashPos);
-                std::string maxPriceStr = keyword.substr(dashPos + 1);
-                
-                double minPrice = std::stod(minPriceStr);
-                double maxPrice = std::stod(maxPriceStr);
-                
-                auto priceResults = searchByPriceRange(minPrice, maxPrice);
-                if (!priceResults.empty()) {
-                    std::cout << "找到 " << priceResults.size() << " 个价格区间匹配结果（" 
-                              << minPrice << " - " << maxPrice << "元）。" << std::endl;
-                    for (const auto& item : priceResults) {
-                        results.push_back(SearchResult(item, 1.0));
-                    }
-                    return results;
-                } else {
-                    std::cout << "在价格区间 " << minPrice << " - " << maxPrice 
-                              << " 元内未找到商品。" << std::endl;
-                    return results;
-                }
-            } else {
-                std::cout << "价格区间格式错误！请使用格式：最小价格-最大价格（例如：1000-5000）" << std::endl;
-                return results;
-            }
+            outcome.minPrice = std::stod(keyword.substr(0, dashPos));
+            outcome.maxPrice = std::stod(keyword.substr(dashPos + 1));
         } catch (const std::exception& e) {
-            std::cout << "价格解析失败！请输入有效的数字。" << std::endl;
-            return results;
+            outcome.kind = SearchMatchKind::INVALID_PRICE_VALUE;
+            return outcome;
+        }
+        
+        outcome.kind = SearchMatchKind::PRICE_RANGE;
+        for (const auto& item : searchByPriceRange(outcome.minPrice, outcome.maxPrice)) {
+            outcome.results.push_back(SearchResult(item, 1.0));
         }
+        return outcome;
     }
     
-    // 如果精确搜索无结果，进行模糊搜索
-    std::cout << "精确搜索无结果，正在进行模糊搜索..." << std::endl;
-    results = fuzzySearchByName(keyword, 0.4);  // 降低阈值以获得更多结果
-    
-    if (!results.empty()) {
-        std::cout << "找到 " << results.size() << " 个模糊匹配结果。" << std::endl;
-    } else {
-        std::cout << "未找到相关商品。" << std::endl;
+    // 如果精确搜索无结果，进行模糊搜索；未获准入时降级，只返回精确搜索的（空）结果
+    AdmissionController::Permit permit;
+    if (admission) {
+        permit = admission->admit(OperationClass::SEARCH);
+        if (!permit) {
+            outcome.kind = SearchMatchKind::DEGRADED;
+            Logger::getInstance()->debug("ItemSearcher", "模糊搜索未获准入，降级为精确搜索", {{"keyword", keyword}});
+            return outcome;
+        }
     }
+    Logger::getInstance()->debug("ItemSearcher", "精确搜索无结果，进行模糊搜索", {{"keyword", keyword}});
+    outcome.results = fuzzySearchByName(keyword, 0.4);  // 降低阈值以获得更多结果
+    Logger::getInstance()->debug("ItemSearcher", "模糊搜索完成",
+                                 {{"keyword", keyword}, {"count", std::to_string(outcome.results.size())}});
     
-    return results;
+    return outcome;
+}
+
+/**
+ * @brief 综合搜索（先精确后模糊），并输出匹配摘要
+ */
+std::vector<SearchResult> ItemSearcher::search(const std::string& keyword, SearchType searchType) {
+    SearchOutcome outcome = query(keyword, searchType);
+    ListingRenderer::renderSearchSummary(outcome, std::cout);
+    return std::move(outcome.results);
 }
 
 /**
  * @brief 显示搜索结果
  */
 void ItemSearcher::displaySearchResults(const std::vector<SearchResult>& results, bool showSimilarity) {
-    if (results.empty()) {
-        std::cout << "没有找到相关商品。" << std::endl;
-        return;
-    }
-    
-    std::cout << "\n========== 搜索结果 ==========" << std::endl;
-    std::cout << std::left
-              << std::setw(8) << "ID"
-              << std::setw(20) << "名称"
-              << std::setw(12) << "类别"
-              << std::setw(10) << "价格"
-              << std::setw(8) << "库存";
-    
-    if (showSimilarity) {
-        std::cout << std::setw(10) << "相似度";
-    }
-    
-    std::cout << std::endl;
-    std::cout << "-------------------------------------------------------------------------------------" << std::endl;
-    
-    for (const auto& result : results) {
-        const auto& item = result.item;
-        std::cout << std::left
-                  << std::setw(8) << item->getItemId()
-                  << std::setw(20) << item->getItemName()
-                  << std::setw(12) << item->getCategory()
-                  << std::setw(10) << std::fixed << std::setprecision(2) << item->getPrice()
-                  << std::setw(8) << item->getStock();
-        
-        if (showSimilarity) {
-            std::cout << std::setw(10) << std::fixed << std::setprecision(2) 
-                      << (result.similarityScore * 100) << "%";
-        }
-        
-        std::cout << std::endl;
-    }
-    
-    std::cout << "=============================" << std::endl;
-    std::cout << "共找到 " << results.size() << " 件商品。" << std::endl;
+    ListingRenderer::renderSearchResults(results, showSimilarity, RenderFormat::CONSOLE, std::cout);
 }
 
 /**
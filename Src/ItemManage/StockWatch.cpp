@@ -0,0 +1,211 @@
+/**
+ * @file StockWatch.cpp
+ * @brief 低库存监视器的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "ItemManage/StockWatch.h"
+#include <algorithm>
+
+/**
+ * @brief 构造函数实现
+ */
+StockWatch::StockWatch(int threshold) : threshold(threshold) {
+}
+
+/**
+ * @brief 交换堆中两个位置
+ */
+void StockWatch::swapAt(size_t a, size_t b) {
+    std::swap(heap[a], heap[b]);
+    position[heap[a].second] = a;
+    position[heap[b].second] = b;
+}
+
+/**
+ * @brief 上浮
+ */
+size_t StockWatch::siftUp(size_t index) {
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!(heap[index] < heap[parent])) {
+            break;
+        }
+        swapAt(index, parent);
+        index = parent;
+    }
+    return index;
+}
+
+/**
+ * @brief 下沉
+ */
+void StockWatch::siftDown(size_t index) {
+    const size_t count = heap.size();
+    while (true) {
+        size_t smallest = index;
+        size_t left = index * 2 + 1;
+        size_t right = left + 1;
+        if (left < count && heap[left] < heap[smallest]) {
+            smallest = left;
+        }
+        if (right < count && heap[right] < heap[smallest]) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            return;
+        }
+        swapAt(index, smallest);
+        index = smallest;
+    }
+}
+
+/**
+ * @brief 插入或更新商品库存
+ */
+void StockWatch::update(const std::string& itemId, int stock) {
+    bool alert = false;
+    LowStockCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = position.find(itemId);
+        if (it == position.end()) {
+            heap.emplace_back(stock, itemId);
+            position[itemId] = heap.size() - 1;
+            siftUp(heap.size() - 1);
+            return;
+        }
+
+        size_t index = it->second;
+        int oldStock = heap[index].first;
+        if (oldStock == stock) {
+            return;
+        }
+        heap[index].first = stock;
+        if (stock < oldStock) {
+            siftUp(index);
+        } else {
+            siftDown(index);
+        }
+
+        // 跨过阈值或售罄时预警
+        alert = (oldStock >= threshold && stock < threshold) || (oldStock > 0 && stock <= 0);
+        if (alert) {
+            callback = alertCallback;
+        }
+    }
+
+    if (alert && callback) {
+        callback(itemId, stock);
+    }
+}
+
+/**
+ * @brief 移除商品
+ */
+void StockWatch::remove(const std::string& itemId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = position.find(itemId);
+    if (it == position.end()) {
+        return;
+    }
+
+    size_t index = it->second;
+    size_t last = heap.size() - 1;
+    if (index != last) {
+        swapAt(index, last);
+    }
+    heap.pop_back();
+    position.erase(itemId);
+
+    if (index < heap.size()) {
+        siftDown(siftUp(index));
+    }
+}
+
+/**
+ * @brief 清空
+ */
+void StockWatch::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    heap.clear();
+    position.clear();
+}
+
+/**
+ * @brief 设置低库存阈值
+ */
+void StockWatch::setThreshold(int value) {
+    std::lock_guard<std::mutex> lock(mutex);
+    threshold = value;
+}
+
+/**
+ * @brief 获取低库存阈值
+ */
+int StockWatch::getThreshold() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return threshold;
+}
+
+/**
+ * @brief 设置预警回调
+ */
+void StockWatch::setAlertCallback(LowStockCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+    alertCallback = std::move(callback);
+}
+
+/**
+ * @brief 获取库存低于阈值的商品
+ *
+ * 从堆顶深度优先遍历，子节点不小于父节点，因此父节点不低于阈值时整棵子树都可跳过
+ */
+std::vector<StockWatch::Entry> StockWatch::below(int limit) const {
+    std::vector<Entry> result;
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<size_t> pending;
+    if (!heap.empty()) {
+        pending.push_back(0);
+    }
+    while (!pending.empty()) {
+        size_t index = pending.back();
+        pending.pop_back();
+        if (heap[index].first >= limit) {
+            continue;
+        }
+        result.push_back(heap[index]);
+        size_t left = index * 2 + 1;
+        if (left < heap.size()) {
+            pending.push_back(left);
+        }
+        if (left + 1 < heap.size()) {
+            pending.push_back(left + 1);
+        }
+    }
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+/**
+ * @brief 获取库存最低的商品
+ */
+bool StockWatch::lowest(Entry& entry) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (heap.empty()) {
+        return false;
+    }
+    entry = heap.front();
+    return true;
+}
+
+/**
+ * @brief 获取监视的商品数
+ */
+size_t StockWatch::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return heap.size();
+}
@@ -0,0 +1,299 @@
+/**
+ * @file Logger.cpp
+ * @brief 异步结构化日志器的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Log/Logger.h"
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief 私有构造函数的实现
+ */
+Logger::Logger()
+    : capacity(0), mask(0), enqueuePos(0), dequeuePos(0),
+      running(false), sinkStopping(false), activeProducers(0), minLevel(static_cast<int>(LogLevel::INFO)), droppedCount(0) {
+}
+
+/**
+ * @brief 获取单例实例
+ *
+ * 局部静态变量的初始化由编译器保证线程安全
+ */
+Logger* Logger::getInstance() {
+    static Logger instance;
+    return &instance;
+}
+
+/**
+ * @brief 启动后台输出线程
+ */
+bool Logger::start(const std::string& logFilePath, LogLevel level, size_t bufferCapacity) {
+    if (running) {
+        return true;
+    }
+
+    try {
+        fs::path parent = fs::path(logFilePath).parent_path();
+        if (!parent.empty() && !fs::exists(parent)) {
+            fs::create_directories(parent);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "无法创建日志目录: " << e.what() << std::endl;
+    }
+
+    sinkFile.open(logFilePath, std::ios::app);
+    if (!sinkFile.is_open()) {
+        std::cerr << "无法打开日志文件: " << logFilePath << std::endl;
+        return false;
+    }
+
+    // 容量取不小于bufferCapacity的2的幂，便于用掩码取下标
+    capacity = 2;
+    while (capacity < bufferCapacity) {
+        capacity <<= 1;
+    }
+    mask = capacity - 1;
+    ring.reset(new Slot[capacity]);
+    for (size_t i = 0; i < capacity; ++i) {
+        ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    enqueuePos.store(0, std::memory_order_relaxed);
+    dequeuePos = 0;
+
+    setLevel(level);
+    sinkStopping = false;
+    running = true;
+    sinkThread = std::thread(&Logger::sinkLoop, this);
+    return true;
+}
+
+/**
+ * @brief 停止后台线程
+ *
+ * 先拒绝新的写入，等正在写入的调用方全部完成后再通知后台线程，
+ * 保证后台线程最后一次取空缓冲区时不会再有记录写入
+ */
+void Logger::stop() {
+    if (!running) {
+        return;
+    }
+
+    running = false;
+    while (activeProducers.load() > 0) {
+        std::this_thread::yield();
+    }
+
+    sinkStopping = true;
+    if (sinkThread.joinable()) {
+        sinkThread.join();
+    }
+
+    if (droppedCount > 0) {
+        sinkFile << "日志缓冲区溢出，共丢弃 " << droppedCount.load() << " 条记录\n";
+    }
+    sinkFile.close();
+}
+
+/**
+ * @brief 尝试将记录写入环形缓冲区
+ *
+ * 多个生产者通过CAS竞争写入位置，槽位的sequence等于写入位置时表示可写
+ */
+bool Logger::tryPush(LogRecord&& record) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+
+    while (true) {
+        slot = &ring[pos & mask];
+        size_t seq = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;   // 缓冲区已满
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->record = std::move(record);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief 尝试从环形缓冲区取出一条记录
+ */
+bool Logger::tryPop(LogRecord& record) {
+    Slot& slot = ring[dequeuePos & mask];
+    size_t seq = slot.sequence.load(std::memory_order_acquire);
+
+    if (seq != dequeuePos + 1) {
+        return false;   // 缓冲区为空或生产者尚未写完
+    }
+
+    record = std::move(slot.record);
+    slot.sequence.store(dequeuePos + capacity, std::memory_order_release);
+    ++dequeuePos;
+    return true;
+}
+
+/**
+ * @brief 后台输出线程函数
+ *
+ * 每次尽量取出所有可用记录后只刷新一次文件；
+ * 缓冲区为空时短暂休眠，停止时先把剩余记录写完再退出
+ */
+void Logger::sinkLoop() {
+    LogRecord record;
+
+    while (true) {
+        bool stopping = sinkStopping;
+        size_t written = 0;
+
+        while (tryPop(record)) {
+            sinkFile << formatRecord(record) << '\n';
+            ++written;
+        }
+
+        if (written > 0) {
+            sinkFile.flush();
+        } else if (stopping) {
+            break;
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+}
+
+/**
+ * @brief 写出一个字段值
+ *
+ * 值为空或含空格、引号、等号、反斜杠、控制字符时加引号，并转义引号、反斜杠和换行，
+ * 保证每条记录占一行且可被切分回key=value
+ */
+void Logger::appendValue(std::ostream& out, const std::string& value) {
+    bool needsQuote = value.empty() ||
+        value.find_first_of(" \"=\\\n\r\t") != std::string::npos;
+    if (!needsQuote) {
+        out << value;
+        return;
+    }
+
+    out << '"';
+    for (char c : value) {
+        switch (c) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\r': out << "\\r"; break;
+            case '\t': out << "\\t"; break;
+            default:   out << c; break;
+        }
+    }
+    out << '"';
+}
+
+/**
+ * @brief 将日志记录格式化为一行文本
+ *
+ * 格式：2026-10-18 11:33:21.123 INFO  [OrderManager] 消息 key=value key=value
+ */
+std::string Logger::formatRecord(const LogRecord& record) {
+    std::ostringstream oss;
+
+    time_t seconds = std::chrono::system_clock::to_time_t(record.timestamp);
+    auto millis = std::chrono::duration_cast<std::chrono::milliseconds>(
+        record.timestamp.time_since_epoch()).count() % 1000;
+    struct tm* timeinfo = std::localtime(&seconds);
+    char timeBuffer[20];
+    std::strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%d %H:%M:%S", timeinfo);
+
+    oss << timeBuffer << "." << std::setfill('0') << std::setw(3) << millis << std::setfill(' ')
+        << " " << std::left << std::setw(5) << levelToString(record.level)
+        << " [" << (record.component ? record.component : "-") << "] "
+        << record.message;
+
+    for (const auto& field : record.fields) {
+        oss << " " << field.key << "=";
+        appendValue(oss, field.value);
+    }
+
+    return oss.str();
+}
+
+/**
+ * @brief 写入一条日志
+ */
+void Logger::log(LogLevel level, const char* component, std::string message,
+                 std::initializer_list<LogField> fields) {
+    if (!isEnabled(level)) {
+        return;
+    }
+
+    LogRecord record{level, std::chrono::system_clock::now(), component, std::move(message),
+                     std::vector<LogField>(fields)};
+
+    // 先登记再检查running，与stop()中先清running再等待登记数归零配对
+    activeProducers.fetch_add(1);
+    if (!running) {
+        activeProducers.fetch_sub(1);
+        // 后台线程未启动（如启动前加载配置）或已停止，只同步输出警告和错误
+        if (level >= LogLevel::WARN) {
+            std::clog << formatRecord(record) << '\n';
+        }
+        return;
+    }
+
+    if (!tryPush(std::move(record))) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    activeProducers.fetch_sub(1);
+}
+
+/**
+ * @brief 将字符串转换为日志级别
+ */
+LogLevel Logger::parseLevel(const std::string& levelStr) {
+    std::string lower = levelStr;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+        [](unsigned char c) { return std::tolower(c); });
+
+    if (lower == "debug") return LogLevel::DEBUG;
+    if (lower == "warn" || lower == "warning") return LogLevel::WARN;
+    if (lower == "error") return LogLevel::ERROR;
+    return LogLevel::INFO;
+}
+
+/**
+ * @brief 获取日志级别的字符串表示
+ */
+const char* Logger::levelToString(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO:  return "INFO";
+        case LogLevel::WARN:  return "WARN";
+        case LogLevel::ERROR: return "ERROR";
+        default:              return "INFO";
+    }
+}
+
+/**
+ * @brief 析构函数
+ */
+Logger::~Logger() {
+    stop();
+}
@@ -12,19 +12,40 @@
 #include "ItemManage/Item.h"
 #include "ItemManage/ItemManager.h"
 #include "ItemManage/ItemSearcher.h"
+#include "ItemManage/FlashSaleStock.h"
 #include "ShoppingCart/ShoppingCart.h"
 #include "ShoppingCart/ShoppingCartManager.h"
 #include "Order/Order.h"
 #include "Order/OrderManager.h"
+#include "Order/CheckoutPipeline.h"
+#include "Order/WaitlistManager.h"
 #include "Promotion/Promotion.h"
 #include "Promotion/PromotionManager.h"
+#include "Promotion/CouponManager.h"
+#include "Promotion/PromotionSimulator.h"
+#include "Promotion/PromotionScheduler.h"
 #include "Services/CustomerReportService.h"
+#include "Services/ListingRenderer.h"
+#include "Services/CoPurchaseEngine.h"
+#include "Services/PersonalRecommender.h"
+#include "Services/TopSellerLeaderboard.h"
+#include "Services/AdmissionController.h"
+#include "Log/Logger.h"
 #include <iostream>
 #include <string>
 #include <limits>
 #include <fstream>
 #include <sstream>
 #include <iomanip>
+#include <cstdlib>
+#include <functional>
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <mutex>
 
 /**
  * @brief 清空输入缓冲区
@@ -34,6 +55,28 @@ void clearInputBuffer() {
     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 }
 
+/**
+ * @brief 解析"YYYY-MM-DD"格式的日期
+ * @param dateStr 日期字符串
+ * @param endOfDay 为true时返回当天23:59:59，否则返回当天00:00:00
+ * @param result 解析得到的时间戳（输出参数）
+ * @return 解析成功返回true，否则返回false
+ */
+bool parseDateInput(const std::string& dateStr, bool endOfDay, time_t& result) {
+    std::tm tm = {};
+    std::istringstream ss(dateStr);
+    ss >> std::get_time(&tm, "%Y-%m-%d");
+    if (ss.fail()) {
+        return false;
+    }
+    tm.tm_hour = endOfDay ? 23 : 0;
+    tm.tm_min = endOfDay ? 59 : 0;
+    tm.tm_sec = endOfDay ? 59 : 0;
+    tm.tm_isdst = -1;
+    result = std::mktime(&tm);
+    return result != static_cast<time_t>(-1);
+}
+
 /**
  * @brief 显示主菜单
  */
@@ -69,8 +112,8 @@ void showCustomerMenu() {
  */
 void showAdminMenu() {
     std::cout << "\n===== 管理员菜单 =====" << std::endl;
-    std::cout << "1. 查看所有顾客信息" << std::endl;
-    std::cout << "2. 查看所有商品信息" << std::endl;
+    std::cout << "1. 查看所有顾客信息（分页）" << std::endl;
+    std::cout << "2. 查看所有商品信息（排序分页/库存报表）" << std::endl;
     std::cout << "3. 添加商品" << std::endl;
     std::cout << "4. 修改商品" << std::endl;
     std::cout << "5. 删除商品" << std::endl;
@@ -86,19 +129,33 @@ void showAdminMenu() {
  * @brief 展示订单促销预览并确认
  * @param items 商品列表
  * @param promotionManager 促销管理器
+ * @param couponCode 输出的优惠券码（为空时不询问优惠券；券码不可用时置空）
+ * @param username 用户名（按每人限用次数计算优惠，为空时不检查）
  * @return 用户是否确认下单
  */
 bool confirmOrderWithPromotion(
     const std::vector<std::pair<std::shared_ptr<Item>, int>>& items,
-    PromotionManager* promotionManager
+    PromotionManager* promotionManager,
+    std::string* couponCode = nullptr,
+    const std::string& username = ""
 ) {
     if (!promotionManager) {
         // 如果没有促销管理器，直接返回确认
         return true;
     }
     
+    // 询问优惠券
+    std::string code;
+    if (couponCode && promotionManager->getCouponManager()) {
+        std::cout << "请输入优惠券码（没有请输入0）: ";
+        std::cin >> code;
+        if (code == "0") {
+            code.clear();
+        }
+    }
+    
     // 计算促销结果
-    PromotionResult result = promotionManager->calculatePromotionResult(items);
+    PromotionResult result = promotionManager->calculatePromotionResult(items, code, username);
     
     // 展示订单预览
     std::cout << "\n========== 订单预览 ==========" << std::endl;
@@ -108,10 +165,18 @@ bool confirmOrderWithPromotion(
                   << " = ¥" << std::fixed << std::setprecision(2) 
                   << (item->getPrice() * quantity);
         
-        // 检查是否有折扣
+        // 检查是否有折扣（放弃折扣能凑到更高的满减，或已用尽每人限用次数时，折扣不使用）
         auto discount = promotionManager->getActiveDiscountForItem(item->getItemId());
         if (discount) {
-            std::cout << " [" << discount->getDisplayTag() << "]";
+            bool applied = std::any_of(result.itemDiscounts.begin(), result.itemDiscounts.end(),
+                                       [&item](const std::pair<std::string, double>& entry) {
+                                           return entry.first == item->getItemName();
+                                       });
+            std::cout << " [" << discount->getDisplayTag();
+            if (!applied) {
+                std::cout << (discount->getPerUserLimit() > 0 ? "，未使用" : "，未使用：满减更优惠");
+            }
+            std::cout << "]";
         }
         std::cout << std::endl;
     }
@@ -154,6 +219,20 @@ bool confirmOrderWithPromotion(
         std::cout << "）" << std::endl;
     }
     
+    // 显示优惠券
+    if (!code.empty()) {
+        if (result.couponStatus == CouponStatus::OK) {
+            std::cout << "优惠券抵扣：-¥" << std::fixed << std::setprecision(2)
+                      << result.couponDiscount << "（" << result.couponName << "）" << std::endl;
+        } else {
+            std::cout << "优惠券不可用：" << CouponManager::statusToString(result.couponStatus) << std::endl;
+            code.clear();
+        }
+    }
+    if (couponCode) {
+        *couponCode = code;
+    }
+    
     std::cout << "==============================" << std::endl;
     std::cout << "实付金额：¥" << std::fixed << std::setprecision(2) 
               << result.finalTotal;
@@ -173,14 +252,129 @@ bool confirmOrderWithPromotion(
     return (confirm == 'y' || confirm == 'Y');
 }
 
+/**
+ * @brief 为一次结算生成请求键
+ *
+ * 每次确认订单时生成一个新键（进程随机前缀 + 序号），只有重试同一次结算时才复用，
+ * 因此顾客有意再次购买相同商品不会被当作重复提交
+ * @return 请求键
+ */
+std::string newCheckoutRequestKey() {
+    static const uint64_t session = (static_cast<uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}();
+    static std::atomic<uint64_t> sequence(0);
+    std::ostringstream key;
+    key << std::hex << session << '-' << ++sequence;
+    return key.str();
+}
+
+/**
+ * @brief 库存不足时询问是否加入到货候补
+ * @param waitlist 到货候补管理器
+ * @param username 用户名
+ * @param item 商品
+ * @param quantity 数量
+ * @param address 收货地址（为空时询问）
+ */
+void offerWaitlist(WaitlistManager* waitlist, const std::string& username,
+                   const std::shared_ptr<Item>& item, int quantity, std::string address) {
+    std::cout << "是否加入「" << item->getItemName() << "」的到货候补，补货后按排队顺序自动下单？(y/n): ";
+    std::string answer;
+    std::cin >> answer;
+    if (answer != "y" && answer != "Y") {
+        return;
+    }
+    if (address.empty()) {
+        std::cout << "请输入收货地址: ";
+        std::cin.ignore();
+        std::getline(std::cin, address);
+    }
+    
+    size_t position = 0;
+    switch (waitlist->join(username, item->getItemId(), quantity, address, &position)) {
+        case WaitlistJoinStatus::JOINED:
+            std::cout << "已加入到货候补，当前排在第 " << position << " 位。" << std::endl;
+            break;
+        case WaitlistJoinStatus::ALREADY_WAITING:
+            if (position > 0) {
+                std::cout << "您已在该商品的候补队列中（第 " << position << " 位）。" << std::endl;
+            } else {
+                std::cout << "您的候补正在分配库存，请稍后查看订单。" << std::endl;
+            }
+            break;
+        case WaitlistJoinStatus::INVALID:
+            std::cout << "收货地址不能为空！" << std::endl;
+            break;
+        case WaitlistJoinStatus::WRITE_FAILED:
+            std::cout << "加入候补失败，请稍后再试。" << std::endl;
+            break;
+    }
+}
+
+/**
+ * @brief 通过下单流水线提交订单并等待结果
+ * @param checkoutPipeline 下单流水线
+ * @param username 用户名
+ * @param items 商品列表
+ * @param address 收货地址
+ * @param couponCode 优惠券码（可为空）
+ * @param requestKey 本次结算的请求键（由newCheckoutRequestKey生成，保存失败后重试时复用）
+ * @param waitlist 到货候补管理器（可选，库存不足时询问是否候补缺货的商品）
+ * @return 创建（或重复提交对应）的订单，失败返回nullptr
+ */
+std::shared_ptr<Order> placeOrder(CheckoutPipeline* checkoutPipeline, const std::string& username,
+                                  const std::vector<std::pair<std::shared_ptr<Item>, int>>& items,
+                                  const std::string& address, const std::string& couponCode,
+                                  const std::string& requestKey, WaitlistManager* waitlist = nullptr) {
+    CheckoutOutcome outcome;
+    while (true) {
+        CheckoutRequest request;
+        request.userId = username;
+        request.items = items;
+        request.shippingAddress = address;
+        request.couponCode = couponCode;
+        request.requestKey = requestKey;
+        
+        outcome = checkoutPipeline->submit(std::move(request)).get();
+        if (outcome.status != CheckoutStatus::PERSIST_FAILED) {
+            break;
+        }
+        std::cout << "\n订单保存失败，是否重试本次下单？(y/n): ";
+        std::string answer;
+        std::cin >> answer;
+        if (answer != "y" && answer != "Y") {
+            break;
+        }
+    }
+    
+    switch (outcome.status) {
+        case CheckoutStatus::CREATED:
+            std::cout << "\n订单创建成功！订单编号：" << outcome.order->getOrderId() << '\n';
+            return outcome.order;
+        case CheckoutStatus::DUPLICATE:
+            std::cout << "检测到重复提交，订单已创建：" << outcome.order->getOrderId() << std::endl;
+            return outcome.order;
+        default:
+            std::cout << "\n创建订单失败：" << outcome.message << '\n';
+            if (waitlist && outcome.status == CheckoutStatus::OUT_OF_STOCK) {
+                for (const auto& line : items) {
+                    if (line.second > line.first->getStock()) {
+                        offerWaitlist(waitlist, username, line.first, line.second, address);
+                    }
+                }
+            }
+            return nullptr;
+    }
+}
+
 /**
  * @brief 处理购买输入的辅助函数
  * @param itemManager 商品管理器
- * @param orderManager 订单管理器
+ * @param checkoutPipeline 下单流水线
  * @param loginSystem 登录系统
  * @param promotionManager 促销管理器（可选）
+ * @param waitlist 到货候补管理器（可选）
  */
-void processPurchaseInput(ItemManager* itemManager, OrderManager* orderManager, LoginSystem* loginSystem, PromotionManager* promotionManager = nullptr) {
+void processPurchaseInput(ItemManager* itemManager, CheckoutPipeline* checkoutPipeline, LoginSystem* loginSystem, PromotionManager* promotionManager = nullptr, WaitlistManager* waitlist = nullptr) {
     std::vector<std::pair<std::shared_ptr<Item>, int>> itemsToBuy;
 
     while (true) {
@@ -223,6 +417,9 @@ void processPurchaseInput(ItemManager* itemManager, OrderManager* orderManager,
 
         if (item->getStock() < quantity) {
             std::cout << "库存不足！当前库存: " << item->getStock() << std::endl;
+            if (waitlist) {
+                offerWaitlist(waitlist, loginSystem->getCurrentUser()->getUsername(), item, quantity, "");
+            }
             continue;
         }
 
@@ -231,22 +428,21 @@ void processPurchaseInput(ItemManager* itemManager, OrderManager* orderManager,
     }
     
     // 展示促销预览并确认订单
-    if (!confirmOrderWithPromotion(itemsToBuy, promotionManager)) {
+    std::string couponCode;
+    auto user = loginSystem->getCurrentUser();
+    if (!confirmOrderWithPromotion(itemsToBuy, promotionManager, &couponCode, user->getUsername())) {
         std::cout << "已取消下单。" << std::endl;
         return;
     }
 
+    std::string requestKey = newCheckoutRequestKey();
+
     std::cout << "请输入收货地址: ";
     std::string address;
     std::cin.ignore();
     std::getline(std::cin, address);
 
-    auto user = loginSystem->getCurrentUser();
-    auto order = orderManager->createOrder(user->getUsername(), itemsToBuy, address);
-
-    if (order) {
-        orderManager->saveToFile();
-    } else {
+    if (!placeOrder(checkoutPipeline, user->getUsername(), itemsToBuy, address, couponCode, requestKey, waitlist)) {
         std::cout << "订单创建失败！" << std::endl;
     }
 }
@@ -254,14 +450,25 @@ void processPurchaseInput(ItemManager* itemManager, OrderManager* orderManager,
 /**
  * @brief 查看商品信息（使用ItemManager）
  * @param itemManager 商品管理器
- * @param orderManager 订单管理器（可选）
+ * @param checkoutPipeline 下单流水线（可选）
  * @param loginSystem 登录系统（可选）
  * @param promotionManager 促销管理器（可选）
+ * @param admission 准入控制器（可选，未获准入时不显示列表，仍可按商品ID购买）
+ * @param waitlist 到货候补管理器（可选）
  */
-void viewItems(ItemManager* itemManager, OrderManager* orderManager = nullptr, LoginSystem* loginSystem = nullptr, PromotionManager* promotionManager = nullptr) {
-    itemManager->displayAllItems(promotionManager);
-    if (orderManager && loginSystem) {
-        processPurchaseInput(itemManager, orderManager, loginSystem, promotionManager);
+void viewItems(ItemManager* itemManager, CheckoutPipeline* checkoutPipeline = nullptr, LoginSystem* loginSystem = nullptr, PromotionManager* promotionManager = nullptr, AdmissionController* admission = nullptr, WaitlistManager* waitlist = nullptr) {
+    AdmissionController::Permit permit;
+    if (admission) {
+        permit = admission->admit(OperationClass::LISTING);
+    }
+    if (!admission || permit) {
+        itemManager->displayAllItems(promotionManager);
+    } else {
+        std::cout << "系统繁忙，商品列表暂不可用，请稍后再试或使用搜索。" << std::endl;
+    }
+    permit.reset();
+    if (checkoutPipeline && loginSystem) {
+        processPurchaseInput(itemManager, checkoutPipeline, loginSystem, promotionManager, waitlist);
     }
 }
 
@@ -270,20 +477,637 @@ void viewItems(ItemManager* itemManager, OrderManager* orderManager = nullptr, L
  * @param userManager 用户管理器
  */
 void viewAllCustomers(UserManager* userManager) {
-    const auto& customers = userManager->getCustomers();
+    auto page = userManager->queryCustomerPage("", false, userManager->getCustomers().size());
+    ListingRenderer::renderCustomers(page.rows, RenderFormat::CONSOLE, std::cout);
+}
+
+/**
+ * @brief 分页浏览的通用流程
+ * @param fetchPage 输出一页的函数，参数为当前游标，返回下一页游标（为空表示没有更多数据）
+ */
+void browsePages(const std::function<std::string(const std::string&)>& fetchPage) {
+    std::string cursor;
+    while (true) {
+        cursor = fetchPage(cursor);
+        if (cursor.empty()) {
+            std::cout << "已到最后一页。" << std::endl;
+            break;
+        }
+        
+        std::cout << "输入 n 查看下一页，其他任意键返回: ";
+        std::string input;
+        std::cin >> input;
+        if (input != "n" && input != "N") {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 读取排序方向和每页数量
+ * @param descending 输出是否降序
+ * @param pageSize 输出每页数量
+ * @return 输入有效返回true
+ */
+bool readPagingOptions(bool& descending, size_t& pageSize) {
+    std::cout << "排序方向（1. 升序  2. 降序）: ";
+    int direction;
+    std::cin >> direction;
+    std::cout << "每页显示数量: ";
+    int size;
+    std::cin >> size;
+    
+    if (std::cin.fail() || (direction != 1 && direction != 2) || size <= 0) {
+        clearInputBuffer();
+        std::cout << "无效输入！" << std::endl;
+        return false;
+    }
+    
+    descending = (direction == 2);
+    pageSize = static_cast<size_t>(size);
+    return true;
+}
+
+/**
+ * @brief 分页浏览顾客（管理员功能，按用户名排序）
+ * @param userManager 用户管理器
+ */
+void browseCustomersProcess(UserManager* userManager) {
+    bool descending;
+    size_t pageSize;
+    if (!readPagingOptions(descending, pageSize)) {
+        return;
+    }
+    
+    browsePages([&](const std::string& cursor) {
+        auto page = userManager->queryCustomerPage(cursor, descending, pageSize);
+        ListingRenderer::renderCustomers(page.rows, RenderFormat::CONSOLE, std::cout);
+        std::cout << "（全部共 " << page.totalCount << " 个顾客）" << std::endl;
+        return page.nextCursor;
+    });
+}
+
+/**
+ * @brief 分页浏览商品（按价格、名称或库存排序）
+ * @param itemManager 商品管理器
+ * @param promotionManager 促销管理器（可选）
+ * @param admission 准入控制器（可选，每页申请一次准入）
+ */
+void browseItemsProcess(ItemManager* itemManager, PromotionManager* promotionManager = nullptr, AdmissionController* admission = nullptr) {
+    std::cout << "排序字段（1. 价格  2. 名称  3. 库存）: ";
+    int keyChoice;
+    std::cin >> keyChoice;
+    if (std::cin.fail() || keyChoice < 1 || keyChoice > 3) {
+        clearInputBuffer();
+        std::cout << "无效输入！" << std::endl;
+        return;
+    }
+    ItemSortKey sortKey = (keyChoice == 1) ? ItemSortKey::PRICE
+                        : (keyChoice == 2) ? ItemSortKey::NAME : ItemSortKey::STOCK;
+    
+    bool descending;
+    size_t pageSize;
+    if (!readPagingOptions(descending, pageSize)) {
+        return;
+    }
+    
+    AdmissionController::Permit firstPage;
+    if (admission && !(firstPage = admission->admit(OperationClass::LISTING))) {
+        std::cout << "系统繁忙，商品列表暂不可用，请稍后再试。" << std::endl;
+        return;
+    }
+    browsePages([&](const std::string& cursor) {
+        AdmissionController::Permit permit = std::move(firstPage);
+        if (admission && !permit && !(permit = admission->admit(OperationClass::LISTING))) {
+            std::cout << "系统繁忙，本页暂不可用，请稍后输入 n 重试。" << std::endl;
+            return cursor;
+        }
+        auto page = itemManager->queryItemPage(sortKey, descending, cursor, pageSize, promotionManager);
+        if (page.invalidCursor) {
+            std::cout << "翻页位置无效，请重新浏览。" << std::endl;
+            return std::string();
+        }
+        ListingRenderer::renderItems(ItemListing{page.rows, {}}, RenderFormat::CONSOLE, std::cout);
+        std::cout << "（全部共 " << page.totalCount << " 件商品）" << std::endl;
+        return page.nextCursor;
+    });
+}
+
+/**
+ * @brief 低库存报表（管理员功能）
+ * @param itemManager 商品管理器
+ */
+void lowStockReportProcess(ItemManager* itemManager) {
+    std::cout << "库存阈值（当前 " << itemManager->getLowStockThreshold() << "，输入0使用当前值）: ";
+    int limit;
+    std::cin >> limit;
+    if (std::cin.fail() || limit < 0) {
+        clearInputBuffer();
+        std::cout << "无效输入！" << std::endl;
+        return;
+    }
     
-    std::cout << "\n===== 所有顾客信息 =====" << std::endl;
-    std::cout << "用户名\t\t密码\t\t手机号" << std::endl;
-    std::cout << "----------------------------------------" << std::endl;
+    auto rows = itemManager->queryLowStock(limit == 0 ? -1 : limit);
+    if (rows.empty()) {
+        std::cout << "没有低库存商品。" << std::endl;
+        return;
+    }
+    ListingRenderer::renderItems(ItemListing{rows, {}}, RenderFormat::CONSOLE, std::cout);
+    std::cout << "（共 " << rows.size() << " 件低库存商品）" << std::endl;
+}
+
+/**
+ * @brief 库存流水查询与对账（管理员功能）
+ * @param itemManager 商品管理器
+ * @param orderManager 订单管理器
+ */
+void inventoryLedgerProcess(ItemManager* itemManager, OrderManager* orderManager) {
+    const InventoryLedger* ledger = itemManager->getLedger();
+    if (ledger == nullptr) {
+        std::cout << "库存流水账未启用！" << std::endl;
+        return;
+    }
     
-    for (const auto& customer : customers) {
-        std::cout << customer->getUsername() << "\t\t"
-                  << customer->getPassword() << "\t\t"
-                  << customer->getPhone() << std::endl;
+    std::cout << "共 " << ledger->size() << " 条库存流水。" << std::endl;
+    std::cout << "1. 查询某日结束时的库存  2. 与订单对账: ";
+    int choice;
+    std::cin >> choice;
+    if (std::cin.fail()) {
+        clearInputBuffer();
+        std::cout << "无效输入！" << std::endl;
+        return;
     }
     
-    std::cout << "========================" << std::endl;
-    std::cout << "共 " << customers.size() << " 个顾客。" << std::endl;
+    if (choice == 1) {
+        std::string itemId, dateStr;
+        std::cout << "请输入商品ID: ";
+        std::cin >> itemId;
+        std::cout << "请输入日期(YYYY-MM-DD): ";
+        std::cin >> dateStr;
+        time_t dayStart, dayEnd;
+        if (!parseDateInput(dateStr, false, dayStart) || !parseDateInput(dateStr, true, dayEnd)) {
+            std::cout << "日期格式错误！" << std::endl;
+            return;
+        }
+        
+        int stock = 0;
+        bool found = false;
+        if (!ledger->stockAt(itemId, dayEnd, stock, found)) {
+            std::cout << "读取库存流水失败！" << std::endl;
+            return;
+        }
+        if (!found) {
+            std::cout << "该日期之前没有此商品的库存记录。" << std::endl;
+            return;
+        }
+        std::cout << "商品 " << itemId << " 在 " << dateStr << " 结束时的库存: " << stock << std::endl;
+        
+        std::vector<LedgerRecord> movements;
+        if (!ledger->history(itemId, dayStart, dayEnd, movements)) {
+            std::cout << "读取当日变动失败！" << std::endl;
+        } else if (!movements.empty()) {
+            std::cout << "当日变动：" << std::endl;
+            for (const auto& record : movements) {
+                char timeStr[32];
+                std::strftime(timeStr, sizeof(timeStr), "%H:%M:%S", std::localtime(&record.time));
+                std::cout << "  " << timeStr << "  " << InventoryLedger::reasonToString(record.reason)
+                          << "  " << (record.delta > 0 ? "+" : "") << record.delta
+                          << "  -> " << record.stockAfter << "  " << record.reference << std::endl;
+            }
+        }
+    } else if (choice == 2) {
+        std::vector<ReconcileEntry> mismatches;
+        if (!ledger->reconcile(orderManager->getAllOrders(), mismatches)) {
+            std::cout << "读取库存流水失败，无法对账！" << std::endl;
+            return;
+        }
+        if (mismatches.empty()) {
+            std::cout << "对账一致：流水账中的销售数量与订单相符。" << std::endl;
+            return;
+        }
+        std::cout << "发现 " << mismatches.size() << " 个商品不一致：" << std::endl;
+        for (const auto& entry : mismatches) {
+            std::cout << "  商品 " << entry.itemId << "：订单销售 " << entry.orderedQuantity
+                      << "，流水净销售 " << entry.ledgerQuantity << std::endl;
+        }
+    } else {
+        std::cout << "无效选择！" << std::endl;
+    }
+}
+
+/**
+ * @brief 查询商品的加购人数（管理员功能）
+ * @param itemManager 商品管理器
+ * @param cartManager 购物车管理器
+ */
+void cartDemandProcess(ItemManager* itemManager, ShoppingCartManager* cartManager) {
+    std::cout << "请输入商品ID: ";
+    std::string itemId;
+    std::cin >> itemId;
+    
+    auto item = itemManager->findItemById(itemId);
+    if (item == nullptr) {
+        std::cout << "商品不存在！" << std::endl;
+        return;
+    }
+    
+    auto usernames = cartManager->getCartsContaining(itemId);
+    std::cout << "商品 \"" << item->getItemName() << "\" 在 " << usernames.size()
+              << " 位顾客的购物车中（当前库存 " << item->getStock() << "）。" << std::endl;
+    for (const auto& username : usernames) {
+        std::cout << "  " << username << std::endl;
+    }
+}
+
+/**
+ * @brief 查看热销排行（管理员功能）
+ * @param leaderboard 热销排行榜
+ * @param itemManager 商品管理器
+ */
+void leaderboardProcess(TopSellerLeaderboard* leaderboard, ItemManager* itemManager) {
+    std::cout << "时间窗口（1. 最近一小时  2. 最近一天  3. 最近一周）: ";
+    int windowChoice;
+    std::cin >> windowChoice;
+    if (std::cin.fail() || windowChoice < 1 || windowChoice > 3) {
+        clearInputBuffer();
+        std::cout << "无效输入！" << std::endl;
+        return;
+    }
+    LeaderboardWindow window = static_cast<LeaderboardWindow>(windowChoice - 1);
+
+    clearInputBuffer();
+    std::cout << "类别（直接回车表示全部商品）: ";
+    std::string category;
+    std::getline(std::cin, category);
+
+    auto entries = leaderboard->top(window, category, 10);
+    std::cout << "\n===== " << TopSellerLeaderboard::windowToString(window) << "热销排行"
+              << (category.empty() ? "" : "（" + category + "）")
+              << (leaderboard->isApproximate() ? " [近似]" : "") << " =====" << std::endl;
+    if (entries.empty()) {
+        std::cout << "该时间窗口内没有销量。" << std::endl;
+        return;
+    }
+    int rank = 1;
+    for (const auto& entry : entries) {
+        auto item = itemManager->findItemById(entry.itemId);
+        std::cout << std::left << std::setw(4) << rank++
+                  << std::setw(10) << entry.itemId
+                  << std::setw(20) << (item ? item->getItemName() : "（已下架）")
+                  << "销量 " << entry.quantity << std::endl;
+    }
+}
+
+/**
+ * @brief 秒杀库存压测
+ *
+ * 10000名虚拟买家抢购同一商品（每人1件），分别用互斥锁计数、单个原子计数和分片计数扣减库存，
+ * 每种方式重复多轮取总耗时，并核对每轮售出数量恰好等于库存（不超卖）
+ * @param shardCount 分片数（0表示按CPU核数）
+ */
+void flashSaleBenchmarkProcess(size_t shardCount) {
+    std::cout << "请输入秒杀库存（默认1000）: ";
+    int stock;
+    std::cin >> stock;
+    if (std::cin.fail() || stock <= 0) {
+        clearInputBuffer();
+        stock = 1000;
+    }
+    const int BUYERS = 10000;
+    const int ROUNDS = 20;
+
+    struct MutexCounter {
+        std::mutex mutex;
+        int64_t units;
+        explicit MutexCounter(int64_t total) : units(total) {}
+        bool take() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (units <= 0) {
+                return false;
+            }
+            --units;
+            return true;
+        }
+    };
+    struct AtomicCounter {
+        std::atomic<int64_t> units;
+        explicit AtomicCounter(int64_t total) : units(total) {}
+        bool take() {
+            int64_t available = units.load(std::memory_order_relaxed);
+            while (available > 0) {
+                if (units.compare_exchange_weak(available, available - 1, std::memory_order_acq_rel)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    // 买家平均分给各线程，每轮返回售出数量
+    auto runRound = [&](int threads, const std::function<bool()>& take) {
+        std::atomic<int64_t> sold(0);
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t]() {
+                int64_t local = 0;
+                for (int buyer = t; buyer < BUYERS; buyer += threads) {
+                    if (take()) {
+                        ++local;
+                    }
+                }
+                sold += local;
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        return sold.load();
+    };
+
+    int64_t expected = std::min(stock, BUYERS);
+    std::cout << "\n" << BUYERS << "名买家抢购库存" << stock << "的商品，每种方式" << ROUNDS << "轮" << std::endl;
+    std::cout << std::left << std::setw(8) << "线程" << std::setw(14) << "计数方式"
+              << std::right << std::setw(12) << "耗时(ms)" << std::setw(16) << "请求(万次/秒)"
+              << std::setw(10) << "售出偏差" << std::endl;
+
+    unsigned maxThreads = std::max(4u, std::thread::hardware_concurrency());
+    for (int threads = 1; threads <= static_cast<int>(maxThreads); threads *= 2) {
+        for (int mode = 0; mode < 3; ++mode) {
+            int64_t deviation = 0;
+            double elapsed = 0.0;
+            for (int round = 0; round < ROUNDS; ++round) {
+                MutexCounter mutexCounter(stock);
+                AtomicCounter atomicCounter(stock);
+                ShardedStockCounter shardedCounter(stock, shardCount);
+                std::function<bool()> take;
+                if (mode == 0) {
+                    take = [&mutexCounter]() { return mutexCounter.take(); };
+                } else if (mode == 1) {
+                    take = [&atomicCounter]() { return atomicCounter.take(); };
+                } else {
+                    take = [&shardedCounter]() { return shardedCounter.take(1); };
+                }
+                auto startTime = std::chrono::steady_clock::now();
+                int64_t sold = runRound(threads, take);
+                elapsed += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+                if (sold != expected || (mode == 2 && shardedCounter.remaining() != stock - sold)) {
+                    deviation += sold - expected;
+                    std::cout << "  第" << round + 1 << "轮售出" << sold << "件，应为" << expected << "件！" << std::endl;
+                }
+            }
+            static const char* names[] = {"互斥锁", "单个原子", "分片计数"};
+            std::cout << std::left << std::setw(8) << threads << std::setw(14) << names[mode]
+                      << std::right << std::fixed << std::setprecision(2)
+                      << std::setw(12) << elapsed
+                      << std::setw(16) << (elapsed > 0 ? BUYERS * ROUNDS / elapsed / 10.0 : 0.0)
+                      << std::setw(10) << deviation << std::endl;
+        }
+    }
+}
+
+/**
+ * @brief 秒杀设置流程（管理员功能）
+ * @param flashSale 秒杀库存
+ * @param itemManager 商品管理器
+ * @param shardCount 压测使用的分片数
+ */
+void flashSaleProcess(FlashSaleStock* flashSale, ItemManager* itemManager, size_t shardCount) {
+    std::cout << "1. 开启秒杀  2. 关闭秒杀  3. 秒杀状态  4. 秒杀库存压测  0. 返回: ";
+    int choice;
+    std::cin >> choice;
+    if (std::cin.fail()) {
+        clearInputBuffer();
+        std::cout << "无效输入！" << std::endl;
+        return;
+    }
+
+    if (choice == 1) {
+        std::cout << "请输入商品ID: ";
+        std::string itemId;
+        std::cin >> itemId;
+        auto item = itemManager->findItemById(itemId);
+        if (item == nullptr) {
+            std::cout << "商品不存在！" << std::endl;
+            return;
+        }
+        std::cout << "请输入秒杀配额（0表示全部库存 " << item->getStock() << "）: ";
+        int64_t allotment;
+        std::cin >> allotment;
+        if (std::cin.fail() || allotment < 0) {
+            clearInputBuffer();
+            std::cout << "无效输入！" << std::endl;
+            return;
+        }
+        if (allotment == 0 || allotment > item->getStock()) {
+            allotment = item->getStock();
+        }
+        if (flashSale->enable(itemId, allotment)) {
+            std::cout << "已开启秒杀：" << item->getItemName() << "，配额 " << allotment << std::endl;
+        } else {
+            std::cout << "开启失败：商品已在秒杀中或库存为0！" << std::endl;
+        }
+    } else if (choice == 2) {
+        std::cout << "请输入商品ID: ";
+        std::string itemId;
+        std::cin >> itemId;
+        FlashSaleStatus status;
+        if (flashSale->disable(itemId, &status)) {
+            auto item = itemManager->findItemById(itemId);
+            std::cout << "已关闭秒杀：成单 " << status.committed << " 件，处理中 " << status.inFlight
+                      << " 件，未售出 " << status.remaining << " 件，当前库存 "
+                      << (item ? item->getStock() : 0) << std::endl;
+        } else {
+            std::cout << "该商品不在秒杀中！" << std::endl;
+        }
+    } else if (choice == 3) {
+        auto statuses = flashSale->getStatus();
+        if (statuses.empty()) {
+            std::cout << "当前没有秒杀商品。" << std::endl;
+            return;
+        }
+        std::cout << std::left << std::setw(10) << "商品ID" << std::setw(20) << "名称"
+                  << std::right << std::setw(8) << "配额" << std::setw(8) << "剩余" << std::setw(8) << "处理中"
+                  << std::setw(8) << "成单" << std::setw(8) << "库存" << std::setw(8) << "分片" << std::endl;
+        for (const auto& status : statuses) {
+            auto item = itemManager->findItemById(status.itemId);
+            std::cout << std::left << std::setw(10) << status.itemId
+                      << std::setw(20) << (item ? item->getItemName() : "（已下架）")
+                      << std::right << std::setw(8) << status.allotment << std::setw(8) << status.remaining
+                      << std::setw(8) << status.inFlight << std::setw(8) << status.committed
+                      << std::setw(8) << (item ? item->getStock() : 0) << std::setw(8) << status.shards << std::endl;
+        }
+    } else if (choice == 4) {
+        flashSaleBenchmarkProcess(shardCount);
+    }
+}
+
+/**
+ * @brief 补货后为商品的到货候补分配库存并显示结果
+ * @param waitlist 到货候补管理器
+ * @param itemManager 商品管理器
+ * @param checkoutPipeline 下单流水线
+ * @param itemId 商品ID
+ * @return 本次分配结果
+ */
+WaitlistServeResult serveWaitlistProcess(WaitlistManager* waitlist, ItemManager* itemManager,
+                                         CheckoutPipeline* checkoutPipeline, const std::string& itemId) {
+    WaitlistServeResult result = waitlist->serve(itemId, itemManager, checkoutPipeline);
+    if (result.served > 0 || result.requeued > 0) {
+        std::cout << "到货候补（" << itemId << "）：已为 " << result.served << " 位顾客自动下单，分配 "
+                  << result.allocatedUnits << " 件";
+        if (result.requeued > 0) {
+            std::cout << "，" << result.requeued << " 位下单失败，已放回队首";
+        }
+        std::cout << "。" << std::endl;
+    }
+    return result;
+}
+
+/**
+ * @brief 到货候补查看流程（管理员功能）
+ * @param waitlist 到货候补管理器
+ * @param itemManager 商品管理器
+ * @param checkoutPipeline 下单流水线
+ */
+void waitlistAdminProcess(WaitlistManager* waitlist, ItemManager* itemManager, CheckoutPipeline* checkoutPipeline) {
+    auto summaries = waitlist->getSummary();
+    if (summaries.empty()) {
+        std::cout << "当前没有到货候补。" << std::endl;
+        return;
+    }
+    std::cout << std::left << std::setw(10) << "商品ID" << std::setw(20) << "名称"
+              << std::right << std::setw(8) << "候补数" << std::setw(10) << "候补件数" << std::setw(8) << "库存" << std::endl;
+    for (const auto& summary : summaries) {
+        auto item = itemManager->findItemById(summary.itemId);
+        std::cout << std::left << std::setw(10) << summary.itemId
+                  << std::setw(20) << (item ? item->getItemName() : "（已下架）")
+                  << std::right << std::setw(8) << summary.entries << std::setw(10) << summary.units
+                  << std::setw(8) << (item ? item->getStock() : 0) << std::endl;
+    }
+    
+    std::cout << "1. 查看商品候补队列  2. 按当前库存分配  0. 返回: ";
+    int choice;
+    std::cin >> choice;
+    if (std::cin.fail()) {
+        clearInputBuffer();
+        std::cout << "无效输入！" << std::endl;
+        return;
+    }
+    if (choice != 1 && choice != 2) {
+        return;
+    }
+    std::cout << "请输入商品ID: ";
+    std::string itemId;
+    std::cin >> itemId;
+    
+    if (choice == 2) {
+        WaitlistServeResult result = serveWaitlistProcess(waitlist, itemManager, checkoutPipeline, itemId);
+        if (result.served == 0 && result.requeued == 0) {
+            std::cout << "没有可分配的候补（队列为空或库存不足以满足队首顾客）。" << std::endl;
+        }
+        return;
+    }
+    
+    auto entries = waitlist->getItemWaitlist(itemId);
+    if (entries.empty()) {
+        std::cout << "该商品没有候补。" << std::endl;
+        return;
+    }
+    std::cout << std::left << std::setw(6) << "排位" << std::setw(16) << "用户名"
+              << std::right << std::setw(8) << "数量" << "  " << std::left << std::setw(18) << "加入时间"
+              << "收货地址" << std::endl;
+    for (const auto& entry : entries) {
+        char timeStr[32];
+        std::strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M", std::localtime(&entry.joinedAt));
+        std::cout << std::left << std::setw(6) << entry.position << std::setw(16) << entry.userId
+                  << std::right << std::setw(8) << entry.quantity << "  " << std::left << std::setw(18) << timeStr
+                  << entry.shippingAddress << std::endl;
+    }
+}
+
+/**
+ * @brief 我的到货候补流程（顾客功能）
+ * @param waitlist 到货候补管理器
+ * @param itemManager 商品管理器
+ * @param username 用户名
+ */
+void myWaitlistProcess(WaitlistManager* waitlist, ItemManager* itemManager, const std::string& username) {
+    auto entries = waitlist->getUserWaitlist(username);
+    if (entries.empty()) {
+        std::cout << "您没有到货候补。" << std::endl;
+        return;
+    }
+    std::cout << std::left << std::setw(10) << "商品ID" << std::setw(20) << "名称"
+              << std::right << std::setw(8) << "数量" << std::setw(8) << "排位" << "  加入时间" << std::endl;
+    for (const auto& entry : entries) {
+        auto item = itemManager->findItemById(entry.itemId);
+        char timeStr[32];
+        std::strftime(timeStr, sizeof(timeStr), "%Y-%m-%d %H:%M", std::localtime(&entry.joinedAt));
+        std::cout << std::left << std::setw(10) << entry.itemId
+                  << std::setw(20) << (item ? item->getItemName() : "（已下架）")
+                  << std::right << std::setw(8) << entry.quantity << std::setw(8) << entry.position
+                  << "  " << timeStr << std::endl;
+    }
+    
+    std::cout << "请输入要取消候补的商品ID（0返回）: ";
+    std::string itemId;
+    std::cin >> itemId;
+    if (itemId == "0") {
+        return;
+    }
+    if (waitlist->cancel(username, itemId)) {
+        std::cout << "已取消候补。" << std::endl;
+    } else {
+        std::cout << "未找到该商品的候补！" << std::endl;
+    }
+}
+
+/**
+ * @brief 显示并确认到货通知（顾客登录时调用）
+ * @param waitlist 到货候补管理器
+ * @param itemManager 商品管理器
+ * @param username 用户名
+ */
+void showWaitlistNotices(WaitlistManager* waitlist, ItemManager* itemManager, const std::string& username) {
+    for (const auto& notice : waitlist->takeNotices(username)) {
+        auto item = itemManager->findItemById(notice.itemId);
+        std::cout << "到货通知：您候补的「" << (item ? item->getItemName() : notice.itemId) << "」x "
+                  << notice.quantity << " 已自动下单，订单编号：" << notice.orderId << std::endl;
+    }
+}
+
+/**
+ * @brief 分页浏览订单（按时间、金额或状态排序）
+ * @param orderManager 订单管理器
+ */
+void browseOrdersProcess(OrderManager* orderManager) {
+    std::cout << "排序字段（1. 下单时间  2. 订单总额  3. 订单状态）: ";
+    int keyChoice;
+    std::cin >> keyChoice;
+    if (std::cin.fail() || keyChoice < 1 || keyChoice > 3) {
+        clearInputBuffer();
+        std::cout << "无效输入！" << std::endl;
+        return;
+    }
+    OrderSortKey sortKey = (keyChoice == 1) ? OrderSortKey::TIME
+                         : (keyChoice == 2) ? OrderSortKey::AMOUNT : OrderSortKey::STATUS;
+    
+    bool descending;
+    size_t pageSize;
+    if (!readPagingOptions(descending, pageSize)) {
+        return;
+    }
+    
+    browsePages([&](const std::string& cursor) {
+        auto page = orderManager->queryOrderPage(sortKey, descending, cursor, pageSize);
+        if (page.invalidCursor) {
+            std::cout << "翻页位置无效，请重新浏览。" << std::endl;
+            return std::string();
+        }
+        ListingRenderer::renderOrders(page.rows, true, RenderFormat::CONSOLE, std::cout);
+        std::cout << "（全部共 " << page.totalCount << " 个订单）" << std::endl;
+        return page.nextCursor;
+    });
 }
 
 /**
@@ -372,14 +1196,7 @@ void addItemProcess(ItemManager* itemManager) {
     
     if (itemId.empty()) {
         // 自动生成ID逻辑在ItemManager中
-        int maxId = 0;
-        for (const auto& item : itemManager->getAllItems()) {
-            try {
-                int id = std::stoi(item->getItemId());
-                if (id > maxId) maxId = id;
-            } catch (...) {}
-        }
-        itemId = std::to_string(maxId + 1);
+        itemId = itemManager->generateNewItemId();
         std::cout << "自动生成ID: " << itemId << std::endl;
     }
     
@@ -432,11 +1249,144 @@ void addItemProcess(ItemManager* itemManager) {
     }
 }
 
+/**
+ * @brief 从CSV文件批量导入商品流程（管理员功能）
+ * @param itemManager 商品管理器
+ */
+void importItemsProcess(ItemManager* itemManager) {
+    std::cout << "\n===== 批量导入商品 =====" << std::endl;
+    std::cout << "CSV格式：item_id,item_name,category,price,description,stock（item_id留空则自动生成）" << std::endl;
+    std::cout << "请输入CSV文件路径: ";
+    std::string importPath;
+    std::cin >> importPath;
+    
+    ItemImportStats stats;
+    bool ok = itemManager->bulkUpsertFromFile(importPath, stats, [](size_t processed, size_t total) {
+        std::cout << "\r解析进度: " << processed << " / " << total << std::flush;
+    });
+    std::cout << std::endl;
+    
+    if (!ok) {
+        std::cout << "无法打开导入文件！" << std::endl;
+        return;
+    }
+    
+    std::cout << "导入完成：共 " << stats.totalRows << " 行，新增 " << stats.inserted
+              << " 件，更新 " << stats.updated << " 件，格式错误 " << stats.invalidRows
+              << " 行，重复 " << stats.duplicateRows << " 行。" << std::endl;
+    std::cout << "耗时 " << std::fixed << std::setprecision(3) << stats.elapsedSeconds << " 秒，"
+              << std::setprecision(0) << stats.rowsPerSecond << " 行/秒。" << std::endl;
+    std::cout << std::setprecision(2);    if (!stats.saved) {
+        std::cout << "警告：商品数据保存失败，导入结果仅在本次运行中有效！" << std::endl;
+    }
+}
+
+/**
+ * @brief 批量调整商品价格或库存流程（管理员功能）
+ * @param itemManager 商品管理器
+ * @param waitlist 到货候补管理器（可选，库存调整后为有候补的商品分配库存）
+ * @param checkoutPipeline 下单流水线（与waitlist同时提供）
+ */
+void bulkUpdateItemsProcess(ItemManager* itemManager, WaitlistManager* waitlist = nullptr,
+                            CheckoutPipeline* checkoutPipeline = nullptr) {
+    std::cout << "\n===== 批量调整商品 =====" << std::endl;
+    std::cout << "筛选方式：1. 按类别  2. 按价格区间  3. 按商品ID列表  4. 全部商品" << std::endl;
+    std::cout << "请选择: ";
+    int filterChoice;
+    std::cin >> filterChoice;
+    if (std::cin.fail()) {
+        clearInputBuffer();
+        std::cout << "无效输入！" << std::endl;
+        return;
+    }
+    
+    ItemFilter filter;
+    if (filterChoice == 1) {
+        auto categories = itemManager->getAllCategories();
+        std::cout << "现有类别：";
+        for (const auto& category : categories) {
+            std::cout << category << " ";
+        }
+        std::cout << "\n请输入类别: ";
+        std::cin >> filter.category;
+    } else if (filterChoice == 2) {
+        std::cout << "请输入最低价格和最高价格: ";
+        std::cin >> filter.minPrice >> filter.maxPrice;
+        if (std::cin.fail() || filter.minPrice > filter.maxPrice) {
+            clearInputBuffer();
+            std::cout << "价格区间无效！" << std::endl;
+            return;
+        }
+        filter.hasPriceRange = true;
+    } else if (filterChoice == 3) {
+        std::cout << "请输入商品ID（用逗号分隔）: ";
+        std::string line;
+        std::cin >> line;
+        std::stringstream ss(line);
+        std::string id;
+        while (std::getline(ss, id, ',')) {
+            if (!id.empty()) {
+                filter.itemIds.push_back(id);
+            }
+        }
+        if (filter.itemIds.empty()) {
+            std::cout << "未输入商品ID！" << std::endl;
+            return;
+        }
+    } else if (filterChoice != 4) {
+        std::cout << "无效选择！" << std::endl;
+        return;
+    }
+    
+    std::cout << "调整字段：1. 价格  2. 库存: ";
+    int fieldChoice;
+    std::cin >> fieldChoice;
+    std::cout << "运算：1. 设为定值  2. 乘以系数  3. 加上增量（可为负）: ";
+    int opChoice;
+    std::cin >> opChoice;
+    std::cout << "请输入数值: ";
+    double operand;
+    std::cin >> operand;
+    if (std::cin.fail() || fieldChoice < 1 || fieldChoice > 2 || opChoice < 1 || opChoice > 3) {
+        clearInputBuffer();
+        std::cout << "输入无效！" << std::endl;
+        return;
+    }
+    
+    BulkUpdateField field = fieldChoice == 1 ? BulkUpdateField::PRICE : BulkUpdateField::STOCK;
+    BulkUpdateOp op = opChoice == 1 ? BulkUpdateOp::SET
+                    : opChoice == 2 ? BulkUpdateOp::SCALE : BulkUpdateOp::ADD;
+    BulkUpdateStats stats = itemManager->bulkUpdate(filter, field, op, operand);
+    
+    std::cout << "调整完成：命中 " << stats.matched << " 件商品，实际变化 " << stats.changed
+              << " 件，耗时 " << std::fixed << std::setprecision(3) << stats.elapsedSeconds << " 秒。" << std::endl;
+    std::cout << std::setprecision(2);
+    if (stats.clamped > 0) {
+        std::cout << "其中 " << stats.clamped << " 件商品的库存超出上限，已设为 "
+                  << std::numeric_limits<int>::max() << "。" << std::endl;
+    }
+    if (stats.rejected > 0) {
+        std::cout << "其中 " << stats.rejected << " 件商品的计算结果溢出，已保持原值。" << std::endl;
+    }
+    if (!stats.saved) {
+        std::cout << "警告：商品数据保存失败，调整结果仅在本次运行中有效！" << std::endl;
+    }
+    
+    if (waitlist && checkoutPipeline && field == BulkUpdateField::STOCK && stats.changed > 0) {
+        for (const auto& summary : waitlist->getSummary()) {
+            serveWaitlistProcess(waitlist, itemManager, checkoutPipeline, summary.itemId);
+        }
+    }
+}
+
 /**
  * @brief 修改商品流程（管理员功能）
  * @param itemManager 商品管理器
+ * @param waitlist 到货候补管理器（可选，补货后按排队顺序为候补顾客下单）
+ * @param checkoutPipeline 下单流水线（与waitlist同时提供）
  */
-void modifyItemProcess(ItemManager* itemManager) {
+void modifyItemProcess(ItemManager* itemManager, WaitlistManager* waitlist = nullptr,
+                       CheckoutPipeline* checkoutPipeline = nullptr) {
     std::string itemId;
     
     std::cout << "\n===== 修改商品 =====" << std::endl;
@@ -472,6 +1422,7 @@ void modifyItemProcess(ItemManager* itemManager) {
     std::cout << "5. 库存" << std::endl;
     std::cout << "0. 完成修改" << std::endl;
     
+    bool restocked = false;
     bool modifying = true;
     while (modifying) {
         std::cout << "\n请选择: ";
@@ -531,8 +1482,15 @@ void modifyItemProcess(ItemManager* itemManager) {
                 std::cout << "请输入新库存: ";
                 std::cin >> newStock;
                 if (!std::cin.fail()) {
-                    item->setStock(newStock);
-                    std::cout << "库存已更新。" << std::endl;
+                    int delta = newStock - item->getStock();
+                    StockMovementReason reason = delta > 0 ? StockMovementReason::RESTOCK
+                                                           : StockMovementReason::ADJUSTMENT;
+                    if (itemManager->adjustStock(itemId, delta, reason, "admin")) {
+                        std::cout << "库存已更新。" << std::endl;
+                        restocked = restocked || delta > 0;
+                    } else {
+                        std::cout << "库存不能为负数！" << std::endl;
+                    }
                 } else {
                     std::cin.clear();
                     std::cout << "库存输入无效！" << std::endl;
@@ -540,76 +1498,376 @@ void modifyItemProcess(ItemManager* itemManager) {
                 std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                 break;
             }
-            case 0:
-                modifying = false;
-                break;
-            default:
-                std::cout << "无效选择！" << std::endl;
-                break;
+            case 0:
+                modifying = false;
+                break;
+            default:
+                std::cout << "无效选择！" << std::endl;
+                break;
+        }
+    }
+    
+    // 同步索引并保存更改
+    itemManager->refreshItemIndexes(itemId);
+    if (itemManager->saveToFile()) {
+        std::cout << "\n商品修改成功！" << std::endl;
+        // 补货后先满足候补顾客，再显示剩余库存
+        if (restocked && waitlist && checkoutPipeline) {
+            serveWaitlistProcess(waitlist, itemManager, checkoutPipeline, itemId);
+        }
+        // 显示所有商品
+        itemManager->displayAllItems();
+    } else {
+        std::cout << "保存失败！" << std::endl;
+    }
+}
+
+/**
+ * @brief 删除商品流程（管理员功能）
+ * @param itemManager 商品管理器
+ * @param cartManager 购物车管理器（可选，用于提示受影响的购物车数量）
+ */
+void deleteItemProcess(ItemManager* itemManager, ShoppingCartManager* cartManager = nullptr) {
+    std::string itemId;
+    
+    std::cout << "\n===== 删除商品 =====" << std::endl;
+    
+    // 先显示所有商品
+    itemManager->displayAllItems();
+    
+    std::cout << "\n请输入要删除的商品ID: ";
+    std::cin >> itemId;
+    
+    // 查找商品
+    auto item = itemManager->findItemById(itemId);
+    if (item == nullptr) {
+        std::cout << "商品不存在！" << std::endl;
+        return;
+    }
+    
+    // 提示受影响的购物车，删除后会自动从这些购物车中移除该商品
+    if (cartManager != nullptr) {
+        size_t cartCount = cartManager->countCartsContaining(itemId);
+        if (cartCount > 0) {
+            std::cout << "注意：有 " << cartCount << " 位顾客的购物车中有该商品，删除后将从其购物车中移除。" << std::endl;
+        }
+    }
+    
+    // 确认删除
+    std::cout << "确认删除商品 \"" << item->getItemName() << "\" (ID: " << itemId << ")? (y/n): ";
+    char confirm;
+    std::cin >> confirm;
+    
+    if (confirm == 'y' || confirm == 'Y') {
+        if (itemManager->deleteItem(itemId)) {
+            std::cout << "商品删除成功！" << std::endl;
+            // 显示所有商品
+            itemManager->displayAllItems();
+        } else {
+            std::cout << "商品删除失败！" << std::endl;
+        }
+    } else {
+        std::cout << "已取消删除。" << std::endl;
+    }
+}
+
+/**
+ * @brief 下单流水线压测流程（管理员功能）
+ *
+ * 在临时目录中生成独立的商品和订单文件，不影响真实数据；每档并发重新生成数据并持续固定时间，
+ * 分别以逐单写入和批量写入两种方式测量吞吐量和延迟
+ */
+void checkoutBenchmarkProcess() {
+    std::cout << "请输入每档持续秒数（默认2）: ";
+    int durationSeconds;
+    std::cin >> durationSeconds;
+    if (std::cin.fail() || durationSeconds <= 0) {
+        clearInputBuffer();
+        durationSeconds = 2;
+    }
+    
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::path dir = fs::temp_directory_path(ec) / "shopping_checkout_bench";
+    fs::create_directories(dir, ec);
+    std::string itemsPath = (dir / "items.csv").string();
+    std::string ordersPath = (dir / "orders.csv").string();
+    const int ITEM_COUNT = 200;
+    
+    std::cout << "\n" << std::left << std::setw(8) << "并发" << std::setw(12) << "写入方式"
+              << std::right << std::setw(14) << "吞吐(单/秒)" << std::setw(12) << "平均(ms)"
+              << std::setw(12) << "P50(ms)" << std::setw(12) << "P99(ms)" << std::setw(10) << "平均批量" << std::endl;
+    
+    for (size_t maxBatch : {static_cast<size_t>(1), static_cast<size_t>(256)}) {
+        for (int shoppers : {1, 2, 4, 8, 16, 32, 64}) {
+            {
+                std::ofstream out(itemsPath);
+                out << "item_id,item_name,category,price,description,stock\n";
+                for (int i = 1; i <= ITEM_COUNT; ++i) {
+                    out << i << ",压测商品" << i << ",压测," << (10 + i % 90) << ",压测用商品,100000000\n";
+                }
+            }
+            fs::remove(ordersPath, ec);
+            
+            auto benchItems = std::make_shared<ItemManager>(itemsPath);
+            benchItems->loadFromFile();
+            std::vector<std::shared_ptr<Item>> catalog = benchItems->getAllItems();
+            if (catalog.empty()) {
+                std::cout << "压测数据生成失败！" << std::endl;
+                return;
+            }
+            OrderManager benchOrders(ordersPath, benchItems);
+            CheckoutPipeline pipeline(&benchOrders, benchItems.get(), nullptr, 1024, maxBatch);
+            pipeline.start();
+            
+            // 每位顾客同步下单：提交后等待确认再提交下一单，直到时间用完
+            std::vector<std::vector<double>> shopperLatencies(shoppers);
+            auto startTime = std::chrono::steady_clock::now();
+            auto deadline = startTime + std::chrono::seconds(durationSeconds);
+            auto shopper = [&](int index) {
+                std::mt19937 rng(static_cast<unsigned>(index + 1));
+                while (std::chrono::steady_clock::now() < deadline) {
+                    CheckoutRequest request;
+                    request.userId = "bench" + std::to_string(index);
+                    request.shippingAddress = "压测地址";
+                    int lines = 1 + static_cast<int>(rng() % 3);
+                    for (int k = 0; k < lines; ++k) {
+                        request.items.push_back({catalog[rng() % catalog.size()], 1});
+                    }
+                    shopperLatencies[index].push_back(pipeline.submit(std::move(request)).get().latencyMs);
+                }
+            };
+            
+            std::vector<std::thread> threads;
+            for (int k = 0; k < shoppers; ++k) {
+                threads.emplace_back(shopper, k);
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+            pipeline.stop();
+            CheckoutStats stats = pipeline.getStats();
+            
+            std::vector<double> latencies;
+            for (const auto& part : shopperLatencies) {
+                latencies.insert(latencies.end(), part.begin(), part.end());
+            }
+            std::sort(latencies.begin(), latencies.end());
+            size_t total = latencies.size();
+            if (total == 0) {
+                continue;
+            }
+            double sum = 0.0;
+            for (double latency : latencies) {
+                sum += latency;
+            }
+            std::cout << std::left << std::setw(8) << shoppers
+                      << std::setw(12) << (maxBatch == 1 ? "逐单" : "批量")
+                      << std::right << std::fixed << std::setprecision(0)
+                      << std::setw(14) << (seconds > 0 ? total / seconds : 0.0)
+                      << std::setprecision(2)
+                      << std::setw(12) << sum / total
+                      << std::setw(12) << latencies[total / 2]
+                      << std::setw(12) << latencies[std::min(total - 1, total * 99 / 100)]
+                      << std::setprecision(1) << std::setw(10) << stats.averageBatch() << std::endl;
+        }
+    }
+    fs::remove_all(dir, ec);
+}
+
+/**
+ * @brief 搜索风暴压测
+ *
+ * 在临时目录中生成3000件商品，4名顾客持续下单，同时16个客户端持续发起必然落到模糊搜索的查询；
+ * 分别测量无搜索、搜索不限制、搜索受准入控制三种情况下的下单延迟
+ * @param searchLimits 准入控制情况下模糊搜索的限制
+ */
+void searchStormBenchmarkProcess(const AdmissionLimits& searchLimits) {
+    std::cout << "请输入每种情况持续秒数（默认3）: ";
+    int durationSeconds;
+    std::cin >> durationSeconds;
+    if (std::cin.fail() || durationSeconds <= 0) {
+        clearInputBuffer();
+        durationSeconds = 3;
+    }
+    
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    fs::path dir = fs::temp_directory_path(ec) / "shopping_admission_bench";
+    fs::create_directories(dir, ec);
+    std::string itemsPath = (dir / "items.csv").string();
+    std::string ordersPath = (dir / "orders.csv").string();
+    const int ITEM_COUNT = 3000;
+    const int SHOPPERS = 4;
+    const int SEARCH_CLIENTS = 16;
+    
+    std::cout << "\n" << std::left << std::setw(16) << "情况" << std::right << std::setw(14) << "吞吐(单/秒)"
+              << std::setw(12) << "P50(ms)" << std::setw(12) << "P99(ms)"
+              << std::setw(12) << "模糊搜索" << std::setw(10) << "降级" << std::endl;
+    
+    for (int scenario = 0; scenario < 3; ++scenario) {
+        {
+            std::ofstream out(itemsPath);
+            out << "item_id,item_name,category,price,description,stock\n";
+            for (int i = 1; i <= ITEM_COUNT; ++i) {
+                out << i << ",压测商品" << i << ",压测," << (10 + i % 90) << ",压测用商品,100000000\n";
+            }
+        }
+        fs::remove(ordersPath, ec);
+        
+        auto benchItems = std::make_shared<ItemManager>(itemsPath);
+        benchItems->loadFromFile();
+        std::vector<std::shared_ptr<Item>> catalog = benchItems->getAllItems();
+        if (catalog.empty()) {
+            std::cout << "压测数据生成失败！" << std::endl;
+            return;
+        }
+        OrderManager benchOrders(ordersPath, benchItems);
+        CheckoutPipeline pipeline(&benchOrders, benchItems.get(), nullptr);
+        pipeline.start();
+        
+        AdmissionController benchAdmission;
+        benchAdmission.configure(OperationClass::SEARCH, searchLimits);
+        ItemSearcher searcher(benchItems.get());
+        if (scenario == 2) {
+            searcher.setAdmissionController(&benchAdmission);
+        }
+        
+        std::vector<std::vector<double>> shopperLatencies(SHOPPERS);
+        std::atomic<uint64_t> fuzzyCount(0);
+        std::atomic<uint64_t> degradedCount(0);
+        auto startTime = std::chrono::steady_clock::now();
+        auto deadline = startTime + std::chrono::seconds(durationSeconds);
+        auto shopper = [&](int index) {
+            std::mt19937 rng(static_cast<unsigned>(index + 1));
+            while (std::chrono::steady_clock::now() < deadline) {
+                CheckoutRequest request;
+                request.userId = "bench" + std::to_string(index);
+                request.shippingAddress = "压测地址";
+                request.items.push_back({catalog[rng() % catalog.size()], 1});
+                shopperLatencies[index].push_back(pipeline.submit(std::move(request)).get().latencyMs);
+            }
+        };
+        // 每个搜索客户端收到结果后稍作停顿再发起下一次查询
+        auto searchClient = [&](int index) {
+            while (std::chrono::steady_clock::now() < deadline) {
+                SearchOutcome outcome = searcher.query("压测商品" + std::to_string(index) + "号", SearchType::BY_NAME);
+                if (outcome.kind == SearchMatchKind::DEGRADED) {
+                    ++degradedCount;
+                } else {
+                    ++fuzzyCount;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        };
+        
+        std::vector<std::thread> threads;
+        for (int k = 0; k < SHOPPERS; ++k) {
+            threads.emplace_back(shopper, k);
         }
+        for (int k = 0; scenario > 0 && k < SEARCH_CLIENTS; ++k) {
+            threads.emplace_back(searchClient, k);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+        pipeline.stop();
+        
+        std::vector<double> latencies;
+        for (const auto& part : shopperLatencies) {
+            latencies.insert(latencies.end(), part.begin(), part.end());
+        }
+        std::sort(latencies.begin(), latencies.end());
+        size_t total = latencies.size();
+        if (total == 0) {
+            continue;
+        }
+        static const char* names[] = {"无搜索", "搜索不限制", "搜索准入控制"};
+        std::cout << std::left << std::setw(16) << names[scenario]
+                  << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(14) << (seconds > 0 ? total / seconds : 0.0)
+                  << std::setprecision(2)
+                  << std::setw(12) << latencies[total / 2]
+                  << std::setw(12) << latencies[std::min(total - 1, total * 99 / 100)]
+                  << std::setw(12) << fuzzyCount.load()
+                  << std::setw(10) << degradedCount.load() << std::endl;
     }
-    
-    // 保存更改
-    if (itemManager->saveToFile()) {
-        std::cout << "\n商品修改成功！" << std::endl;
-        // 显示所有商品
-        itemManager->displayAllItems();
-    } else {
-        std::cout << "保存失败！" << std::endl;
-    }
+    fs::remove_all(dir, ec);
 }
 
 /**
- * @brief 删除商品流程（管理员功能）
- * @param itemManager 商品管理器
+ * @brief 负载保护流程（管理员功能）：查看准入统计，运行搜索风暴压测
+ * @param admission 准入控制器
  */
-void deleteItemProcess(ItemManager* itemManager) {
-    std::string itemId;
-    
-    std::cout << "\n===== 删除商品 =====" << std::endl;
-    
-    // 先显示所有商品
-    itemManager->displayAllItems();
-    
-    std::cout << "\n请输入要删除的商品ID: ";
-    std::cin >> itemId;
+void admissionProcess(AdmissionController* admission) {
+    auto statsList = admission->getStats();
+    std::cout << "\n===== 负载保护 =====" << std::endl;
+    std::cout << std::left << std::setw(14) << "操作" << std::right << std::setw(10) << "并发上限"
+              << std::setw(10) << "排队上限" << std::setw(8) << "执行中" << std::setw(8) << "排队"
+              << std::setw(10) << "排队峰值" << std::setw(10) << "准入" << std::setw(8) << "拒绝"
+              << std::setw(8) << "超时" << std::setw(14) << "平均等待(ms)" << std::setw(14) << "最长等待(ms)" << std::endl;
+    for (const auto& stats : statsList) {
+        std::cout << std::left << std::setw(14) << AdmissionController::classToString(stats.operationClass)
+                  << std::right << std::setw(10)
+                  << (stats.limits.maxConcurrent == 0 ? std::string("不限") : std::to_string(stats.limits.maxConcurrent))
+                  << std::setw(10) << stats.limits.maxQueued << std::setw(8) << stats.running
+                  << std::setw(8) << stats.queued << std::setw(10) << stats.peakQueued
+                  << std::setw(10) << stats.admitted << std::setw(8) << stats.rejected
+                  << std::setw(8) << stats.timedOut << std::fixed << std::setprecision(2)
+                  << std::setw(14) << stats.averageWaitMs() << std::setw(14) << stats.maxWaitMs << std::endl;
+    }
     
-    // 查找商品
-    auto item = itemManager->findItemById(itemId);
-    if (item == nullptr) {
-        std::cout << "商品不存在！" << std::endl;
+    std::cout << "1. 搜索风暴压测  0. 返回: ";
+    int choice;
+    std::cin >> choice;
+    if (std::cin.fail()) {
+        clearInputBuffer();
         return;
     }
-    
-    // 确认删除
-    std::cout << "确认删除商品 \"" << item->getItemName() << "\" (ID: " << itemId << ")? (y/n): ";
-    char confirm;
-    std::cin >> confirm;
-    
-    if (confirm == 'y' || confirm == 'Y') {
-        if (itemManager->deleteItem(itemId)) {
-            std::cout << "商品删除成功！" << std::endl;
-            // 显示所有商品
-            itemManager->displayAllItems();
-        } else {
-            std::cout << "商品删除失败！" << std::endl;
+    if (choice == 1) {
+        AdmissionLimits searchLimits = statsList[static_cast<size_t>(OperationClass::SEARCH)].limits;
+        if (searchLimits.maxConcurrent == 0) {
+            searchLimits = AdmissionLimits{1, 4, 50};
+            std::cout << "当前未限制模糊搜索，压测使用并发1、排队4、等待50毫秒。" << std::endl;
         }
-    } else {
-        std::cout << "已取消删除。" << std::endl;
+        searchStormBenchmarkProcess(searchLimits);
     }
 }
 
 /**
  * @brief 管理订单流程（管理员功能）
  * @param orderManager 订单管理器
+ * @param archivePath 订单归档文件路径
+ * @param admission 准入控制器（可选）
  */
-void manageOrdersProcess(OrderManager* orderManager) {
+void manageOrdersProcess(OrderManager* orderManager, const std::string& archivePath, AdmissionController* admission = nullptr) {
     while (true) {
         std::cout << "\n===== 订单管理 =====" << std::endl;
         orderManager->displayAllOrders();
         
+        // 履约看板：各状态订单数（O(1)读取）
+        std::cout << "待发货: " << orderManager->countOrdersByStatus(OrderStatus::PENDING)
+                  << "  已发货: " << orderManager->countOrdersByStatus(OrderStatus::SHIPPED)
+                  << "  已签收: " << orderManager->countOrdersByStatus(OrderStatus::DELIVERED)
+                  << std::endl;
+        IdempotencyStats dedupe = orderManager->getIdempotencyStats();
+        std::cout << "重复提交拦截: " << dedupe.hits << "/" << dedupe.requests
+                  << "  去重记录: " << dedupe.entries << std::endl;
+        
         std::cout << "\n请选择操作：" << std::endl;
         std::cout << "1. 修改订单状态" << std::endl;
+        std::cout << "2. 导出订单归档" << std::endl;
+        std::cout << "3. 按日期查询归档订单" << std::endl;
+        std::cout << "4. 导出订单列表（CSV/JSON）" << std::endl;
+        std::cout << "5. 排序分页浏览订单" << std::endl;
+        std::cout << "6. 按状态查看订单" << std::endl;
+        std::cout << "7. 按日期范围查询订单" << std::endl;
+        std::cout << "8. 下单流水线压测" << std::endl;
+        if (admission) {
+            std::cout << "9. 负载保护（准入统计/搜索风暴压测）" << std::endl;
+        }
         std::cout << "0. 返回上级菜单" << std::endl;
         std::cout << "请选择: ";
         
@@ -666,17 +1924,378 @@ void manageOrdersProcess(OrderManager* orderManager) {
             } else {
                 std::cout << "状态更新失败！" << std::endl;
             }
+        } else if (choice == 2) {
+            if (orderManager->exportToArchive(archivePath)) {
+                std::cout << "订单归档导出成功：" << archivePath << std::endl;
+            } else {
+                std::cout << "订单归档导出失败！" << std::endl;
+            }
+        } else if (choice == 3) {
+            std::cout << "请输入开始日期(YYYY-MM-DD): ";
+            std::string fromStr;
+            std::cin >> fromStr;
+            std::cout << "请输入结束日期(YYYY-MM-DD): ";
+            std::string toStr;
+            std::cin >> toStr;
+            
+            time_t from, to;
+            if (!parseDateInput(fromStr, false, from) || !parseDateInput(toStr, true, to)) {
+                std::cout << "日期格式错误！" << std::endl;
+                continue;
+            }
+            
+            std::vector<std::shared_ptr<Order>> archived;
+            if (!orderManager->scanArchiveByTime(archivePath, from, to, archived)) {
+                std::cout << "订单归档读取失败（文件不存在或已损坏）！" << std::endl;
+                continue;
+            }
+            std::cout << "归档中共有 " << archived.size() << " 个订单在该日期范围内。" << std::endl;
+            for (const auto& order : archived) {
+                order->displayOrderInfo();
+            }
+        } else if (choice == 4) {
+            std::cout << "请输入导出格式(csv/json): ";
+            std::string formatStr;
+            std::cin >> formatStr;
+            
+            RenderFormat format;
+            if (!ListingRenderer::parseFormat(formatStr, format) || format == RenderFormat::CONSOLE) {
+                std::cout << "不支持的导出格式！" << std::endl;
+                continue;
+            }
+            
+            std::cout << "请输入导出文件路径: ";
+            std::string exportPath;
+            std::cin >> exportPath;
+            
+            std::ofstream exportFile(exportPath);
+            if (!exportFile.is_open()) {
+                std::cout << "无法创建导出文件！" << std::endl;
+                continue;
+            }
+            
+            auto rows = orderManager->queryAllOrders();
+            ListingRenderer::renderOrders(rows, true, format, exportFile);
+            std::cout << "已导出 " << rows.size() << " 个订单到 " << exportPath << std::endl;
+        } else if (choice == 5) {
+            browseOrdersProcess(orderManager);
+        } else if (choice == 6) {
+            std::cout << "请选择状态（1. 待发货  2. 已发货  3. 已签收）: ";
+            int statusChoice;
+            std::cin >> statusChoice;
+            if (std::cin.fail() || statusChoice < 1 || statusChoice > 3) {
+                clearInputBuffer();
+                std::cout << "无效选择！" << std::endl;
+                continue;
+            }
+            
+            OrderStatus status = static_cast<OrderStatus>(statusChoice - 1);
+            ListingRenderer::renderOrders(orderManager->queryOrdersByStatus(status), true,
+                                          RenderFormat::CONSOLE, std::cout);
+        } else if (choice == 7) {
+            std::cout << "请输入开始日期(YYYY-MM-DD): ";
+            std::string fromStr;
+            std::cin >> fromStr;
+            std::cout << "请输入结束日期(YYYY-MM-DD): ";
+            std::string toStr;
+            std::cin >> toStr;
+            
+            time_t from, to;
+            if (!parseDateInput(fromStr, false, from) || !parseDateInput(toStr, true, to)) {
+                std::cout << "日期格式错误！" << std::endl;
+                continue;
+            }
+            
+            std::cout << "按用户筛选（输入用户名，输入 - 表示全部用户）: ";
+            std::string userFilter;
+            std::cin >> userFilter;
+            std::cout << "按状态筛选（0. 全部  1. 待发货  2. 已发货  3. 已签收）: ";
+            int statusChoice;
+            std::cin >> statusChoice;
+            if (std::cin.fail() || statusChoice < 0 || statusChoice > 3) {
+                clearInputBuffer();
+                std::cout << "无效选择！" << std::endl;
+                continue;
+            }
+            
+            std::vector<std::shared_ptr<Order>> matched;
+            if (userFilter != "-") {
+                matched = orderManager->getUserOrdersInTimeRange(userFilter, from, to);
+                if (statusChoice != 0) {
+                    OrderStatus status = static_cast<OrderStatus>(statusChoice - 1);
+                    matched.erase(std::remove_if(matched.begin(), matched.end(),
+                        [status](const std::shared_ptr<Order>& order) { return order->getStatus() != status; }),
+                        matched.end());
+                }
+            } else if (statusChoice != 0) {
+                matched = orderManager->getOrdersInTimeRangeByStatus(from, to,
+                                                                     static_cast<OrderStatus>(statusChoice - 1));
+            } else {
+                matched = orderManager->getOrdersInTimeRange(from, to);
+            }
+            
+            std::vector<OrderRow> rows;
+            rows.reserve(matched.size());
+            for (const auto& order : matched) {
+                rows.push_back(OrderManager::toOrderRow(*order));
+            }
+            ListingRenderer::renderOrders(rows, true, RenderFormat::CONSOLE, std::cout);
+        } else if (choice == 8) {
+            checkoutBenchmarkProcess();
+        } else if (choice == 9 && admission) {
+            admissionProcess(admission);
         } else {
             std::cout << "无效选择！" << std::endl;
         }
     }
 }
 
+/**
+ * @brief 检查折扣促销的目标范围是否有效
+ *
+ * 单品和集合范围要求所有商品都存在，类别范围要求类别下至少有一件商品
+ *
+ * @param itemManager 商品管理器
+ * @param target 目标范围字符串
+ * @return 有效返回true，否则输出提示并返回false
+ */
+bool validatePromotionTarget(ItemManager* itemManager, const std::string& target) {
+    Promotion probe("", "", false, 0, 0, target, 1.0);
+    switch (probe.getScope()) {
+        case PromotionScope::ALL:
+            return true;
+        case PromotionScope::CATEGORY:
+            if (probe.getTargetCategory().empty() || itemManager->getItemsByCategory(probe.getTargetCategory()).empty()) {
+                std::cout << "该类别下没有商品！" << std::endl;
+                return false;
+            }
+            return true;
+        default:
+            if (probe.getTargetItemIds().empty()) {
+                std::cout << "商品集合不能为空！" << std::endl;
+                return false;
+            }
+            for (const auto& itemId : probe.getTargetItemIds()) {
+                if (!itemManager->findItemById(itemId)) {
+                    std::cout << "商品ID不存在：" << itemId << std::endl;
+                    return false;
+                }
+            }
+            return true;
+    }
+}
+
+/**
+ * @brief 优惠券活动管理流程（管理员功能）
+ * @param couponManager 优惠券管理器
+ */
+void manageCouponsProcess(CouponManager* couponManager) {
+    std::cout << "\n===== 优惠券活动管理 =====" << std::endl;
+    std::cout << "1. 查看优惠券活动" << std::endl;
+    std::cout << "2. 创建优惠券活动并生成券码" << std::endl;
+    std::cout << "3. 查询券码状态" << std::endl;
+    std::cout << "请选择: ";
+    
+    int choice;
+    std::cin >> choice;
+    if (std::cin.fail()) {
+        clearInputBuffer();
+        std::cout << "无效输入！" << std::endl;
+        return;
+    }
+    
+    if (choice == 1) {
+        auto campaigns = couponManager->getCampaignSummaries();
+        if (campaigns.empty()) {
+            std::cout << "暂无优惠券活动。" << std::endl;
+            return;
+        }
+        std::cout << std::left << std::setw(6) << "ID" << std::setw(24) << "活动名称"
+                  << std::setw(10) << "面额" << std::setw(10) << "门槛" << std::setw(14) << "截止日期"
+                  << std::setw(12) << "券码数" << "已核销" << std::endl;
+        for (const auto& campaign : campaigns) {
+            char dateStr[16];
+            std::strftime(dateStr, sizeof(dateStr), "%Y-%m-%d", std::localtime(&campaign.endTime));
+            std::cout << std::left << std::setw(6) << campaign.campaignId << std::setw(24) << campaign.name
+                      << std::setw(10) << std::fixed << std::setprecision(2) << campaign.amountOff
+                      << std::setw(10) << campaign.minSpend << std::setw(14) << dateStr
+                      << std::setw(12) << campaign.codeCount << campaign.redeemedCount << std::endl;
+        }
+    } else if (choice == 2) {
+        std::cout << "请输入活动名称: ";
+        std::string name;
+        std::cin.ignore();
+        std::getline(std::cin, name);
+        
+        std::cout << "请输入面额: ";
+        double amountOff;
+        std::cin >> amountOff;
+        std::cout << "请输入使用门槛（0表示无门槛）: ";
+        double minSpend;
+        std::cin >> minSpend;
+        std::cout << "请输入有效天数: ";
+        int days;
+        std::cin >> days;
+        std::cout << "请输入券码数量: ";
+        long long count;
+        std::cin >> count;
+        
+        if (std::cin.fail() || amountOff <= 0 || minSpend < 0 || days <= 0 || count <= 0) {
+            clearInputBuffer();
+            std::cout << "输入无效！" << std::endl;
+            return;
+        }
+        
+        std::cout << "请输入券码导出文件路径: ";
+        std::string exportPath;
+        std::cin >> exportPath;
+        
+        time_t now = time(nullptr);
+        uint32_t campaignId = couponManager->createCampaign(name, amountOff, minSpend, now,
+                                                            now + static_cast<time_t>(days) * 24 * 60 * 60,
+                                                            static_cast<size_t>(count), exportPath);
+        if (campaignId > 0) {
+            std::cout << "优惠券活动创建成功！活动ID: " << campaignId
+                      << "，券码已导出到 " << exportPath << std::endl;
+        } else {
+            std::cout << "优惠券活动创建失败！" << std::endl;
+        }
+    } else if (choice == 3) {
+        std::cout << "请输入券码: ";
+        std::string code;
+        std::cin >> code;
+        CouponCheck check = couponManager->check(code, std::numeric_limits<double>::max(), time(nullptr));
+        std::cout << "券码状态：" << CouponManager::statusToString(check.status);
+        if (check.campaignId > 0) {
+            std::cout << "（活动" << check.campaignId << " " << check.campaignName
+                      << "，面额¥" << std::fixed << std::setprecision(2) << check.amountOff << "）";
+        }
+        std::cout << std::endl;
+    } else {
+        std::cout << "无效选择！" << std::endl;
+    }
+}
+
+/**
+ * @brief 显示促销模拟结果
+ * @param title 标题
+ * @param report 模拟结果
+ * @param promotions 参与模拟的促销（用于显示名称）
+ */
+void printSimulationReport(const std::string& title, const SimulationReport& report,
+                           const std::vector<std::shared_ptr<Promotion>>& promotions) {
+    std::cout << "\n----- " << title << " -----" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "订单数：" << report.basketCount << "，享受优惠：" << report.affectedCount;
+    if (report.basketCount > 0) {
+        std::cout << "（" << (100.0 * report.affectedCount / report.basketCount) << "%）";
+    }
+    std::cout << std::endl;
+    std::cout << "原价总额：¥" << report.originalTotal << std::endl;
+    std::cout << "折扣成本：¥" << report.discountCost << std::endl;
+    std::cout << "满减成本：¥" << report.reductionCost << std::endl;
+    std::cout << "优惠总成本：¥" << report.totalCost() << "，优惠后总额：¥" << report.finalTotal << std::endl;
+    for (const auto& [promotionId, count] : report.promotionUsage) {
+        auto it = std::find_if(promotions.begin(), promotions.end(),
+                               [&promotionId](const std::shared_ptr<Promotion>& p) {
+                                   return p->getPromotionId() == promotionId;
+                               });
+        std::cout << "  " << promotionId;
+        if (it != promotions.end()) {
+            std::cout << " " << (*it)->getPromotionName() << " [" << (*it)->getDisplayTag() << "]";
+        }
+        std::cout << "：" << count << " 单" << std::endl;
+    }
+    std::cout << "耗时：" << std::setprecision(3) << report.elapsedSeconds << " 秒（"
+              << report.threads << " 个线程）" << std::endl;
+}
+
+/**
+ * @brief 促销成本模拟流程（管理员功能）
+ * 
+ * 候选促销忽略有效期，视为一直有效；指定候选文件时同时模拟当前促销作为对照
+ * 
+ * @param promotionManager 促销管理器
+ * @param itemManager 商品管理器
+ * @param orderManager 订单管理器
+ * @param cartManager 购物车管理器
+ */
+void simulatePromotionsProcess(PromotionManager* promotionManager, ItemManager* itemManager,
+                               OrderManager* orderManager, ShoppingCartManager* cartManager) {
+    std::cout << "\n===== 促销成本模拟 =====" << std::endl;
+    std::cout << "请输入候选促销文件路径（与促销数据文件格式相同，输入0使用当前促销）: ";
+    std::string candidatePath;
+    std::cin >> candidatePath;
+    
+    std::vector<std::shared_ptr<Promotion>> candidates = promotionManager->getAllPromotions();
+    if (candidatePath != "0") {
+        PromotionManager candidateSet(candidatePath);
+        if (!candidateSet.loadFromFile()) {
+            std::cout << "无法读取候选促销文件！" << std::endl;
+            return;
+        }
+        candidates = candidateSet.getAllPromotions();
+    }
+    
+    std::cout << "数据来源：1. 全部历史订单  2. 指定日期范围的历史订单  3. 当前购物车" << std::endl;
+    std::cout << "请选择: ";
+    int source;
+    std::cin >> source;
+    if (std::cin.fail() || source < 1 || source > 3) {
+        clearInputBuffer();
+        std::cout << "无效选择！" << std::endl;
+        return;
+    }
+    
+    time_t from = 0;
+    time_t to = std::numeric_limits<time_t>::max();
+    if (source == 2) {
+        std::cout << "请输入开始日期(YYYY-MM-DD): ";
+        std::string fromStr;
+        std::cin >> fromStr;
+        std::cout << "请输入结束日期(YYYY-MM-DD): ";
+        std::string toStr;
+        std::cin >> toStr;
+        if (!parseDateInput(fromStr, false, from) || !parseDateInput(toStr, true, to)) {
+            std::cout << "日期格式错误！" << std::endl;
+            return;
+        }
+    }
+    
+    std::vector<std::shared_ptr<Order>> orders;
+    std::vector<std::shared_ptr<ShoppingCart>> carts;
+    if (source == 3) {
+        carts = cartManager->getAllCarts();
+    } else {
+        orders = orderManager->getOrdersInTimeRange(from, to);
+    }
+    
+    auto simulate = [&](const std::vector<std::shared_ptr<Promotion>>& promotions, bool ignoreSchedule) {
+        PromotionSimulator simulator(promotions, itemManager, promotionManager->getStackingPolicy(),
+                                     promotionManager->getMaxStacked(), ignoreSchedule);
+        return source == 3 ? simulator.replayCarts(carts) : simulator.replayOrders(orders);
+    };
+    
+    SimulationReport candidateReport = simulate(candidates, true);
+    printSimulationReport(candidatePath == "0" ? "当前促销（忽略有效期）" : "候选促销", candidateReport, candidates);
+    
+    if (candidatePath != "0") {
+        SimulationReport baseline = simulate(promotionManager->getAllPromotions(), false);
+        printSimulationReport("当前有效促销（对照）", baseline, promotionManager->getAllPromotions());
+        std::cout << "\n候选促销比当前多出的优惠成本：¥" << std::fixed << std::setprecision(2)
+                  << (candidateReport.totalCost() - baseline.totalCost()) << std::endl;
+    }
+}
+
 /**
  * @brief 促销管理流程（管理员功能）
  * @param promotionManager 促销管理器
+ * @param itemManager 商品管理器
+ * @param orderManager 订单管理器
+ * @param cartManager 购物车管理器
  */
-void managePromotionsProcess(PromotionManager* promotionManager, ItemManager* itemManager) {
+void managePromotionsProcess(PromotionManager* promotionManager, ItemManager* itemManager,
+                             OrderManager* orderManager, ShoppingCartManager* cartManager) {
     while (true) {
         std::cout << "\n===== 促销管理 =====" << std::endl;
         std::cout << "1. 查看所有促销活动" << std::endl;
@@ -686,6 +2305,8 @@ void managePromotionsProcess(PromotionManager* promotionManager, ItemManager* it
         std::cout << "5. 修改促销信息" << std::endl;
         std::cout << "6. 启用/禁用促销" << std::endl;
         std::cout << "7. 删除促销活动" << std::endl;
+        std::cout << "8. 优惠券活动管理" << std::endl;
+        std::cout << "9. 促销成本模拟" << std::endl;
         std::cout << "0. 返回上级菜单" << std::endl;
         std::cout << "======================" << std::endl;
         std::cout << "请选择: ";
@@ -715,7 +2336,7 @@ void managePromotionsProcess(PromotionManager* promotionManager, ItemManager* it
             std::cin.ignore();
             std::getline(std::cin, name);
             
-            std::cout << "请输入目标商品ID（输入-1表示全场折扣）: ";
+            std::cout << "请输入目标范围（商品ID；-1表示全场；cat:类别；set:ID1|ID2|...）: ";
             std::string itemId;
             std::getline(std::cin, itemId);
             
@@ -724,9 +2345,7 @@ void managePromotionsProcess(PromotionManager* promotionManager, ItemManager* it
                 itemId = "-1";
             }
             
-            // 如果不是全场促销，检查商品是否存在
-            if (itemId != "-1" && !itemManager->findItemById(itemId)) {
-                std::cout << "商品ID不存在！" << std::endl;
+            if (!validatePromotionTarget(itemManager, itemId)) {
                 continue;
             }
             
@@ -750,6 +2369,16 @@ void managePromotionsProcess(PromotionManager* promotionManager, ItemManager* it
                 continue;
             }
             
+            std::cout << "请输入每人限用次数（0表示不限）: ";
+            int perUserLimit;
+            std::cin >> perUserLimit;
+            
+            if (std::cin.fail() || perUserLimit < 0) {
+                clearInputBuffer();
+                std::cout << "无效的次数！" << std::endl;
+                continue;
+            }
+            
             time_t now = time(nullptr);
             time_t endTime = now + (days * 24 * 60 * 60);
             
@@ -757,6 +2386,7 @@ void managePromotionsProcess(PromotionManager* promotionManager, ItemManager* it
             auto promotion = std::make_shared<Promotion>(
                 promotionId, name, true, now, endTime, itemId, rate
             );
+            promotion->setPerUserLimit(perUserLimit);
             
             if (promotionManager->addPromotion(promotion)) {
                 std::cout << "折扣促销添加成功！促销ID: " << promotionId << std::endl;
@@ -771,6 +2401,14 @@ void managePromotionsProcess(PromotionManager* promotionManager, ItemManager* it
             std::cin.ignore();
             std::getline(std::cin, name);
             
+            std::cout << "请输入互斥组（同组满减只取一个，直接回车表示不分组）: ";
+            std::string stackGroup;
+            std::getline(std::cin, stackGroup);
+            if (stackGroup.find(',') != std::string::npos || stackGroup == "_") {
+                std::cout << "互斥组名不能包含逗号或为“_”！" << std::endl;
+                continue;
+            }
+            
             std::cout << "请输入满减门槛金额: ";
             double threshold;
             std::cin >> threshold;
@@ -801,6 +2439,16 @@ void managePromotionsProcess(PromotionManager* promotionManager, ItemManager* it
                 continue;
             }
             
+            std::cout << "请输入每人限用次数（0表示不限）: ";
+            int perUserLimit;
+            std::cin >> perUserLimit;
+            
+            if (std::cin.fail() || perUserLimit < 0) {
+                clearInputBuffer();
+                std::cout << "无效的次数！" << std::endl;
+                continue;
+            }
+            
             time_t now = time(nullptr);
             time_t endTime = now + (days * 24 * 60 * 60);
             
@@ -808,6 +2456,8 @@ void managePromotionsProcess(PromotionManager* promotionManager, ItemManager* it
             auto promotion = std::make_shared<Promotion>(
                 promotionId, name, true, now, endTime, threshold, reduction
             );
+            promotion->setStackGroup(stackGroup);
+            promotion->setPerUserLimit(perUserLimit);
             
             if (promotionManager->addPromotion(promotion)) {
                 std::cout << "满减促销添加成功！促销ID: " << promotionId << std::endl;
@@ -835,12 +2485,15 @@ void managePromotionsProcess(PromotionManager* promotionManager, ItemManager* it
             std::cout << "状态: " << (promotion->getIsActive() ? "启用" : "禁用") << std::endl;
             
             if (promotion->getPromotionType() == PromotionType::DISCOUNT) {
-                std::cout << "目标商品: " << (promotion->getTargetItemId() == "-1" ? "全场" : promotion->getTargetItemId()) << std::endl;
+                std::cout << "适用范围: " << promotion->getScopeDescription() << std::endl;
                 std::cout << "折扣率: " << promotion->getDiscountRate() << " (" << promotion->getDisplayTag() << ")" << std::endl;
             } else {
                 std::cout << "门槛金额: " << promotion->getThresholdAmount() << std::endl;
                 std::cout << "减免金额: " << promotion->getReductionAmount() << std::endl;
             }
+            if (promotion->getPerUserLimit() > 0) {
+                std::cout << "每人限用: " << promotion->getPerUserLimit() << "次" << std::endl;
+            }
             
             // 修改菜单
             bool modifying = true;
@@ -850,7 +2503,7 @@ void managePromotionsProcess(PromotionManager* promotionManager, ItemManager* it
                 std::cout << "2. 修改有效期" << std::endl;
                 if (promotion->getPromotionType() == PromotionType::DISCOUNT) {
                     std::cout << "3. 修改折扣率" << std::endl;
-                    std::cout << "4. 修改目标商品" << std::endl;
+                    std::cout << "4. 修改适用范围" << std::endl;
                 } else {
                     std::cout << "3. 修改门槛金额" << std::endl;
                     std::cout << "4. 修改减免金额" << std::endl;
@@ -941,7 +2594,7 @@ void managePromotionsProcess(PromotionManager* promotionManager, ItemManager* it
                 } else if (modChoice == 4) {
                     if (promotion->getPromotionType() == PromotionType::DISCOUNT) {
                         // 修改目标商品
-                        std::cout << "请输入新的目标商品ID（输入-1表示全场）: ";
+                        std::cout << "请输入新的目标范围（商品ID；-1表示全场；cat:类别；set:ID1|ID2|...）: ";
                         std::string newItemId;
                         std::cin.ignore();
                         std::getline(std::cin, newItemId);
@@ -951,16 +2604,14 @@ void managePromotionsProcess(PromotionManager* promotionManager, ItemManager* it
                             newItemId = "-1";
                         }
                         
-                        // 如果不是全场促销，检查商品是否存在
-                        if (newItemId != "-1" && !itemManager->findItemById(newItemId)) {
-                            std::cout << "商品ID不存在！" << std::endl;
+                        if (!validatePromotionTarget(itemManager, newItemId)) {
                             continue;
                         }
                         
                         if (promotionManager->updateDiscountTargetItem(promotionId, newItemId)) {
-                            std::cout << "目标商品修改成功！" << std::endl;
+                            std::cout << "适用范围修改成功！" << std::endl;
                         } else {
-                            std::cout << "目标商品修改失败！" << std::endl;
+                            std::cout << "适用范围修改失败！" << std::endl;
                         }
                     } else {
                         // 修改减免金额
@@ -1024,6 +2675,16 @@ void managePromotionsProcess(PromotionManager* promotionManager, ItemManager* it
             } else {
                 std::cout << "已取消操作。" << std::endl;
             }
+        } else if (choice == 8) {
+            // 优惠券活动管理
+            if (promotionManager->getCouponManager()) {
+                manageCouponsProcess(promotionManager->getCouponManager());
+            } else {
+                std::cout << "优惠券功能不可用！" << std::endl;
+            }
+        } else if (choice == 9) {
+            // 促销成本模拟
+            simulatePromotionsProcess(promotionManager, itemManager, orderManager, cartManager);
         } else {
             std::cout << "无效选择！" << std::endl;
         }
@@ -1046,21 +2707,83 @@ void showShoppingCartMenu() {
     std::cout << "请选择: ";
 }
 
+/**
+ * @brief 显示与购物车商品经常一起购买的商品
+ * @param coPurchaseEngine 共现推荐引擎
+ * @param itemManager 商品管理器
+ * @param cart 购物车
+ */
+void showFrequentlyBoughtTogether(const CoPurchaseEngine* coPurchaseEngine,
+                                  ItemManager* itemManager,
+                                  const std::shared_ptr<ShoppingCart>& cart) {
+    std::vector<std::string> cartItemIds;
+    for (const auto& cartItem : cart->getCartItems()) {
+        cartItemIds.push_back(cartItem.first->getItemId());
+    }
+
+    bool printedHeader = false;
+    for (const auto& related : coPurchaseEngine->relatedToCart(cartItemIds, 10)) {
+        auto item = itemManager->findItemById(related.itemId);
+        if (!item || item->getStock() <= 0) {
+            continue;   // 已下架或售罄的商品不推荐
+        }
+        if (!printedHeader) {
+            std::cout << "\n----- 经常一起购买 -----" << std::endl;
+            printedHeader = true;
+        }
+        std::cout << std::left << std::setw(10) << item->getItemId()
+                  << std::setw(20) << item->getItemName()
+                  << "¥" << std::fixed << std::setprecision(2) << item->getPrice()
+                  << "  (共同购买" << related.score << "次)" << std::endl;
+    }
+}
+
+/**
+ * @brief 显示顾客的个性化推荐（登录时调用）
+ * @param recommender 个性化推荐服务
+ * @param itemManager 商品管理器
+ * @param username 用户名
+ */
+void showPersonalRecommendations(PersonalRecommender* recommender,
+                                 ItemManager* itemManager,
+                                 const std::string& username) {
+    auto recommendations = recommender->recommend(username, 5);
+    if (recommendations.empty()) {
+        return;
+    }
+
+    std::cout << "\n----- 为您推荐 -----" << std::endl;
+    for (const auto& recommendation : recommendations) {
+        auto item = itemManager->findItemById(recommendation.itemId);
+        if (!item) {
+            continue;
+        }
+        std::cout << std::left << std::setw(10) << item->getItemId()
+                  << std::setw(20) << item->getItemName()
+                  << std::setw(14) << item->getCategory()
+                  << "¥" << std::fixed << std::setprecision(2) << item->getPrice() << std::endl;
+    }
+}
+
 /**
  * @brief 购物车管理流程
  * @param cartManager 购物车管理器
  * @param itemManager 商品管理器
- * @param orderManager 订单管理器
+ * @param checkoutPipeline 下单流水线
  * @param username 当前用户名
  * @param customer 当前用户对象
  * @param promotionManager 促销管理器（可选）
+ * @param coPurchaseEngine 共现推荐引擎（可选）
+ * @param waitlist 到货候补管理器（可选）
  */
 void shoppingCartProcess(ShoppingCartManager* cartManager, 
                          ItemManager* itemManager,
-                         OrderManager* orderManager,
+                         CheckoutPipeline* checkoutPipeline,
                          const std::string& username,
                          std::shared_ptr<Customer> customer,
-                         PromotionManager* promotionManager = nullptr) {
+                         PromotionManager* promotionManager = nullptr,
+                         const CoPurchaseEngine* coPurchaseEngine = nullptr,
+                         WaitlistManager* waitlist = nullptr) {
     // 获取用户的购物车
     auto cart = cartManager->getCart(username, customer);
     
@@ -1113,6 +2836,9 @@ void shoppingCartProcess(ShoppingCartManager* cartManager,
             case 2: {
                 // 查看购物车
                 cart->displayCart();
+                if (coPurchaseEngine && !cart->isEmpty()) {
+                    showFrequentlyBoughtTogether(coPurchaseEngine, itemManager, cart);
+                }
                 break;
             }
             
@@ -1221,21 +2947,23 @@ void shoppingCartProcess(ShoppingCartManager* cartManager,
                 }
                 
                 // 展示促销预览并确认订单
-                if (!confirmOrderWithPromotion(cart->getCartItems(), promotionManager)) {
+                std::string couponCode;
+                if (!confirmOrderWithPromotion(cart->getCartItems(), promotionManager, &couponCode, username)) {
                     std::cout << "已取消结算。" << std::endl;
                     break;
                 }
+                std::string requestKey = newCheckoutRequestKey();
                 
                 std::cout << "请输入收货地址: ";
                 std::string address;
                 std::cin.ignore();
                 std::getline(std::cin, address);
 
-                auto order = orderManager->createOrder(username, cart->getCartItems(), address);
+                auto order = placeOrder(checkoutPipeline, username, cart->getCartItems(), address, couponCode,
+                                        requestKey, waitlist);
                 if (order) {
                     cart->clear();
                     cartManager->saveToFile();
-                    orderManager->saveToFile();
                 } else {
                     std::cout << "订单创建失败！" << std::endl;
                 }
@@ -1258,11 +2986,12 @@ void shoppingCartProcess(ShoppingCartManager* cartManager,
  * @brief 搜索商品流程（顾客功能）
  * @param itemSearcher 商品搜索器
  * @param itemManager 商品管理器（可选）
- * @param orderManager 订单管理器（可选）
+ * @param checkoutPipeline 下单流水线（可选）
  * @param loginSystem 登录系统（可选）
  * @param promotionManager 促销管理器（可选）
+ * @param waitlist 到货候补管理器（可选）
  */
-void searchItemProcess(ItemSearcher* itemSearcher, ItemManager* itemManager = nullptr, OrderManager* orderManager = nullptr, LoginSystem* loginSystem = nullptr, PromotionManager* promotionManager = nullptr) {
+void searchItemProcess(ItemSearcher* itemSearcher, ItemManager* itemManager = nullptr, CheckoutPipeline* checkoutPipeline = nullptr, LoginSystem* loginSystem = nullptr, PromotionManager* promotionManager = nullptr, WaitlistManager* waitlist = nullptr) {
     std::string keyword;
     
     std::cout << "\n===== 搜索商品 =====" << std::endl;
@@ -1326,21 +3055,23 @@ void searchItemProcess(ItemSearcher* itemSearcher, ItemManager* itemManager = nu
     }
 
     // 执行搜索（先精确后模糊）
-    auto results = itemSearcher->search(keyword, searchType);
+    SearchOutcome outcome = itemSearcher->query(keyword, searchType);
     
     // 显示搜索结果
-    itemSearcher->displaySearchResults(results, true);  // 显示相似度
+    ListingRenderer::renderSearchSummary(outcome, std::cout);
+    ListingRenderer::renderSearchResults(outcome.results, true, RenderFormat::CONSOLE, std::cout);  // 显示相似度
 
-    if (itemManager && orderManager && loginSystem) {
-        processPurchaseInput(itemManager, orderManager, loginSystem, promotionManager);
+    if (itemManager && checkoutPipeline && loginSystem) {
+        processPurchaseInput(itemManager, checkoutPipeline, loginSystem, promotionManager, waitlist);
     }
 }
 
 /**
  * @brief 用户数据分析模块
+ * @param admission 准入控制器（可选，报表生成需先获得准入）
  */
 
-void userDataAnalysis(UserManager* userManager, OrderManager* orderManager, ItemManager* itemManager) {
+void userDataAnalysis(UserManager* userManager, OrderManager* orderManager, ItemManager* itemManager, AdmissionController* admission = nullptr) {
     std::cout << std::endl;
     viewAllCustomers(userManager);
     std::cout << "请输入要查询的用户ID：";
@@ -1356,6 +3087,11 @@ void userDataAnalysis(UserManager* userManager, OrderManager* orderManager, Item
     std::cout << "请选择：";
     int choice;
     std::cin >> choice;
+    AdmissionController::Permit permit;
+    if (admission && (choice == 1 || choice == 2) && !(permit = admission->admit(OperationClass::REPORT))) {
+        std::cout << "系统繁忙，报表暂时无法生成，请稍后再试。" << std::endl;
+        return;
+    }
     if (choice == 1) {
         CustomerReportService::GenerateReportFromCustomer(*(userManager->findCustomer(idToSearch)), *orderManager, itemManager);
     } else if (choice == 2) {
@@ -1373,6 +3109,13 @@ int main() {
         std::cerr << "配置文件加载失败，使用默认配置。" << std::endl;
     }
     
+    // 启动日志系统，程序退出时输出剩余日志
+    Logger* logger = Logger::getInstance();
+    if (logger->start(config->getLogFilePath(), Logger::parseLevel(config->getLogLevel()))) {
+        std::atexit([] { Logger::getInstance()->stop(); });
+    }
+    logger->info("Main", "系统启动", {{"log_level", config->getLogLevel()}});
+    
     // 初始化用户管理器
     UserManager userManager(config->getUsersFilePath());
     userManager.loadFromFile();
@@ -1380,12 +3123,33 @@ int main() {
     // 初始化商品管理器（使用shared_ptr以便在购物车管理器中共享）
     auto itemManagerPtr = std::make_shared<ItemManager>(config->getItemsFilePath());
     itemManagerPtr->loadFromFile();
+    itemManagerPtr->enableLedger(config->getInventoryLedgerFilePath(), config->getLedgerCheckpointInterval());
+    itemManagerPtr->setLowStockThreshold(config->getLowStockThreshold());
+    itemManagerPtr->setLowStockAlert([](const std::string& itemId, int stock) {
+        Logger::getInstance()->warn("StockWatch", stock <= 0 ? "商品已售罄" : "商品库存不足",
+                                    {{"item", itemId}, {"stock", std::to_string(stock)}});
+    });
     
     // 为了兼容性，创建一个引用
     ItemManager& itemManager = *itemManagerPtr;
     
+    // 初始化准入控制器：限制模糊搜索、商品列表和报表生成的并发，过载时拒绝或降级，避免拖慢下单
+    AdmissionController admissionController;
+    int admissionWaitMs = config->getAdmissionWaitMs();
+    auto admissionLimits = [admissionWaitMs](int concurrency, int queue) {
+        return AdmissionLimits{static_cast<size_t>(std::max(0, concurrency)),
+                               static_cast<size_t>(std::max(0, queue)), admissionWaitMs};
+    };
+    admissionController.configure(OperationClass::SEARCH,
+                                  admissionLimits(config->getSearchConcurrency(), config->getSearchQueue()));
+    admissionController.configure(OperationClass::LISTING,
+                                  admissionLimits(config->getListingConcurrency(), config->getListingQueue()));
+    admissionController.configure(OperationClass::REPORT,
+                                  admissionLimits(config->getReportConcurrency(), config->getReportQueue()));
+    
     // 初始化商品搜索器
     ItemSearcher itemSearcher(itemManagerPtr.get());
+    itemSearcher.setAdmissionController(&admissionController);
     
     // 初始化购物车管理器
     ShoppingCartManager cartManager(config->getShoppingCartFilePath(), itemManagerPtr);
@@ -1397,10 +3161,60 @@ int main() {
     if (config->isAutoUpdateEnabled()) {
         orderManager.enableAutoUpdate(config->getPendingToShippedSeconds(), config->getShippedToDeliveredSeconds());
     }
+    orderManager.setIdempotencyPolicy(static_cast<size_t>(std::max(1, config->getIdempotencyCapacity())),
+                                      config->getIdempotencyTtlSeconds());
+
+    // 初始化“经常一起购买”推荐引擎：用历史订单构建，新订单增量更新
+    CoPurchaseEngine coPurchaseEngine;
+    coPurchaseEngine.rebuild(orderManager.getAllOrders());
+    orderManager.addOrderObserver(&coPurchaseEngine);
+
+    // 初始化个性化推荐服务：按类别偏好推荐，结果按顾客缓存，新订单使缓存失效
+    PersonalRecommender personalRecommender(&orderManager, &itemManager);
+    personalRecommender.rebuild();
+    orderManager.addOrderObserver(&personalRecommender);
+
+    // 初始化热销排行榜：用最近一周的订单预热，之后由新订单驱动
+    TopSellerLeaderboard leaderboard(&itemManager, config->getLeaderboardTopK(), config->isLeaderboardSketchEnabled(),
+                                     config->getSketchWidth(), config->getSketchDepth());
+    leaderboard.seed(orderManager.getAllOrders());
+    orderManager.addOrderObserver(&leaderboard);
     
     // 初始化促销管理器
     PromotionManager promotionManager(config->getPromotionsFilePath());
     promotionManager.loadFromFile();
+    promotionManager.setItemRepository(&itemManager);
+    promotionManager.setStackingPolicy(ReductionLadder::parsePolicy(config->getStackingPolicy()),
+                                       static_cast<size_t>(std::max(1, config->getMaxStackedReductions())));
+    
+    // 初始化优惠券管理器：加载活动和券码，重放核销日志
+    CouponManager couponManager(config->getCouponCampaignsFilePath(), config->getCouponCodesFilePath(),
+                                config->getCouponRedemptionsFilePath());
+    if (couponManager.loadFromFile()) {
+        promotionManager.setCouponManager(&couponManager);
+    }
+    
+    // 初始化促销每人使用次数计数器：重放使用次数日志
+    PromotionUsageTracker usageTracker(config->getPromotionUsageFilePath());
+    if (usageTracker.loadFromFile()) {
+        promotionManager.setUsageTracker(&usageTracker);
+    }
+    
+    // 启动促销定时器：到达促销开始或结束时间时替换定价表
+    PromotionScheduler promotionScheduler(&promotionManager);
+    promotionScheduler.start();
+    
+    // 启动下单流水线：校验、计价、预留、持久化、确认分阶段处理，订单批量写入
+    // 秒杀商品在提交时先抢购分片库存配额，售罄后直接拒绝
+    size_t flashSaleShards = static_cast<size_t>(std::max(0, config->getFlashSaleShards()));
+    FlashSaleStock flashSale(flashSaleShards);
+    CheckoutPipeline checkoutPipeline(&orderManager, itemManagerPtr.get(), &promotionManager);
+    checkoutPipeline.setFlashSale(&flashSale);
+    checkoutPipeline.start();
+    
+    // 初始化到货候补：重放候补日志，补货时按排队顺序通过下单流水线批量下单
+    WaitlistManager waitlistManager(config->getWaitlistFilePath());
+    waitlistManager.loadFromFile();
     
     // 初始化登录系统
     LoginSystem loginSystem(&userManager, config);
@@ -1431,6 +3245,12 @@ int main() {
                 case 2:
                     // 顾客登录
                     loginProcess(&loginSystem, false);
+                    if (loginSystem.getCurrentUserRole() == UserRole::CUSTOMER && loginSystem.getCurrentUser()) {
+                        showPersonalRecommendations(&personalRecommender, &itemManager,
+                                                    loginSystem.getCurrentUser()->getUsername());
+                        showWaitlistNotices(&waitlistManager, &itemManager,
+                                            loginSystem.getCurrentUser()->getUsername());
+                    }
                     break;
                     
                 case 3:
@@ -1440,11 +3260,11 @@ int main() {
                     
                 case 4:
                     // 搜索商品
-                    searchItemProcess(&itemSearcher, &itemManager, &orderManager, &loginSystem, &promotionManager);
+                    searchItemProcess(&itemSearcher, &itemManager, &checkoutPipeline, &loginSystem, &promotionManager, &waitlistManager);
                     break;
                 case 5:
                     // 查看所有商品
-                    viewItems(&itemManager, &orderManager, &loginSystem, &promotionManager);
+                    viewItems(&itemManager, &checkoutPipeline, &loginSystem, &promotionManager, &admissionController, &waitlistManager);
                     break;
                     
                 case 0:
@@ -1472,12 +3292,12 @@ int main() {
             switch (choice) {
                 case 1:
                     // 查看商品信息
-                    viewItems(&itemManager, &orderManager, &loginSystem, &promotionManager);
+                    viewItems(&itemManager, &checkoutPipeline, &loginSystem, &promotionManager, &admissionController, &waitlistManager);
                     break;
                     
                 case 2:
                     // 搜索商品
-                    searchItemProcess(&itemSearcher, &itemManager, &orderManager, &loginSystem, &promotionManager);
+                    searchItemProcess(&itemSearcher, &itemManager, &checkoutPipeline, &loginSystem, &promotionManager, &waitlistManager);
                     break;
                     
                 case 3: {
@@ -1486,7 +3306,7 @@ int main() {
                     if (user) {
                         std::string username = user->getUsername();
                         auto customer = std::dynamic_pointer_cast<Customer>(user);
-                        shoppingCartProcess(&cartManager, &itemManager, &orderManager, username, customer, &promotionManager);
+                        shoppingCartProcess(&cartManager, &itemManager, &checkoutPipeline, username, customer, &promotionManager, &coPurchaseEngine, &waitlistManager);
                     }
                     break;
                 }
@@ -1500,6 +3320,7 @@ int main() {
                         
                         while (true) {
                             std::cout << "\n1. 查看订单详情" << std::endl;
+                            std::cout << "2. 我的到货候补" << std::endl;
                             std::cout << "0. 返回" << std::endl;
                             std::cout << "请选择: ";
                             
@@ -1525,6 +3346,8 @@ int main() {
                                 } else {
                                     std::cout << "未找到该订单或无权查看！" << std::endl;
                                 }
+                            } else if (detailChoice == 2) {
+                                myWaitlistProcess(&waitlistManager, &itemManager, username);
                             } else {
                                 std::cout << "无效选择！" << std::endl;
                             }
@@ -1561,43 +3384,86 @@ int main() {
             
             switch (choice) {
                 case 1:
-                    // 查看所有顾客信息
-                    viewAllCustomers(&userManager);
+                    // 查看所有顾客信息（按用户名分页）
+                    browseCustomersProcess(&userManager);
                     break;
                     
-                case 2:
-                    // 查看所有商品信息
-                    viewItems(&itemManager, nullptr, nullptr, &promotionManager);
+                case 2: {
+                    // 查看所有商品信息（排序分页、低库存报表、库存流水、加购人数、热销排行、秒杀设置或到货候补）
+                    std::cout << "1. 排序分页浏览  2. 低库存报表  3. 库存流水（时点查询/对账）  4. 商品加购人数  5. 热销排行  6. 秒杀设置  7. 到货候补: ";
+                    int viewChoice;
+                    std::cin >> viewChoice;
+                    if (std::cin.fail()) {
+                        clearInputBuffer();
+                        std::cout << "无效输入！" << std::endl;
+                    } else if (viewChoice == 2) {
+                        lowStockReportProcess(&itemManager);
+                    } else if (viewChoice == 3) {
+                        inventoryLedgerProcess(&itemManager, &orderManager);
+                    } else if (viewChoice == 4) {
+                        cartDemandProcess(&itemManager, &cartManager);
+                    } else if (viewChoice == 5) {
+                        leaderboardProcess(&leaderboard, &itemManager);
+                    } else if (viewChoice == 6) {
+                        flashSaleProcess(&flashSale, &itemManager, flashSaleShards);
+                    } else if (viewChoice == 7) {
+                        waitlistAdminProcess(&waitlistManager, &itemManager, &checkoutPipeline);
+                    } else {
+                        browseItemsProcess(&itemManager, &promotionManager, &admissionController);
+                    }
                     break;
+                }
                     
-                case 3:
-                    // 添加商品
-                    addItemProcess(&itemManager);
+                case 3: {
+                    // 添加商品（单个添加或批量导入）
+                    std::cout << "1. 单个添加  2. 从CSV批量导入: ";
+                    int addChoice;
+                    std::cin >> addChoice;
+                    if (std::cin.fail()) {
+                        clearInputBuffer();
+                        std::cout << "无效输入！" << std::endl;
+                    } else if (addChoice == 2) {
+                        importItemsProcess(&itemManager);
+                    } else {
+                        addItemProcess(&itemManager);
+                    }
                     break;
+                }
                     
-                case 4:
-                    // 修改商品
-                    modifyItemProcess(&itemManager);
+                case 4: {
+                    // 修改商品（单个修改或批量调整）
+                    std::cout << "1. 单个修改  2. 批量调整价格/库存: ";
+                    int modifyChoice;
+                    std::cin >> modifyChoice;
+                    if (std::cin.fail()) {
+                        clearInputBuffer();
+                        std::cout << "无效输入！" << std::endl;
+                    } else if (modifyChoice == 2) {
+                        bulkUpdateItemsProcess(&itemManager, &waitlistManager, &checkoutPipeline);
+                    } else {
+                        modifyItemProcess(&itemManager, &waitlistManager, &checkoutPipeline);
+                    }
                     break;
+                }
                     
                 case 5:
                     // 删除商品
-                    deleteItemProcess(&itemManager);
+                    deleteItemProcess(&itemManager, &cartManager);
                     break;
 
                 case 6:
                     // 订单管理
-                    manageOrdersProcess(&orderManager);
+                    manageOrdersProcess(&orderManager, config->getOrdersArchiveFilePath(), &admissionController);
                     break;
                     
                 case 7:
                     // 促销管理
-                    managePromotionsProcess(&promotionManager, &itemManager);
+                    managePromotionsProcess(&promotionManager, &itemManager, &orderManager, &cartManager);
                     break;
 
                 case 8:
                     // 用户数据分析
-                    userDataAnalysis(&userManager, &orderManager, &itemManager);
+                    userDataAnalysis(&userManager, &orderManager, &itemManager, &admissionController);
                     break;
                     
                 case 9:
@@ -0,0 +1,417 @@
+/**
+ * @file CheckoutPipeline.cpp
+ * @brief 分阶段下单流水线的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Order/CheckoutPipeline.h"
+#include "Order/OrderException.h"
+#include "Promotion/CouponManager.h"
+#include "Log/Logger.h"
+#include <algorithm>
+#include <ctime>
+
+/**
+ * @brief 构造函数实现
+ */
+CheckoutPipeline::CheckoutPipeline(OrderManager* orderManager, IItemRepository* itemRepository,
+                                   PromotionManager* promotionManager,
+                                   size_t queueCapacity, size_t maxBatch)
+    : orderManager(orderManager), itemRepository(itemRepository), promotionManager(promotionManager),
+      flashSale(nullptr), maxBatch(maxBatch > 0 ? maxBatch : 1),
+      validateQueue(queueCapacity), priceQueue(queueCapacity), reserveQueue(queueCapacity),
+      persistQueue(queueCapacity), ackQueue(queueCapacity),
+      running(false),
+      submittedCount(0), createdCount(0), rejectedCount(0), duplicateCount(0),
+      batchCount(0), maxBatchSeen(0) {
+}
+
+/**
+ * @brief 析构函数
+ */
+CheckoutPipeline::~CheckoutPipeline() {
+    stop();
+}
+
+/**
+ * @brief 启动各阶段线程
+ */
+void CheckoutPipeline::start() {
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    if (running || !stages.empty()) {
+        return;
+    }
+    running = true;
+    stages.emplace_back(&CheckoutPipeline::validateStage, this);
+    stages.emplace_back(&CheckoutPipeline::priceStage, this);
+    stages.emplace_back(&CheckoutPipeline::reserveStage, this);
+    stages.emplace_back(&CheckoutPipeline::persistStage, this);
+    stages.emplace_back(&CheckoutPipeline::ackStage, this);
+
+    Logger::getInstance()->info("CheckoutPipeline", "下单流水线已启动",
+                                {{"max_batch", std::to_string(maxBatch)}});
+}
+
+/**
+ * @brief 停止流水线
+ *
+ * 关闭入口队列后，各阶段处理完剩余任务再关闭下一阶段的队列，依次退出
+ */
+void CheckoutPipeline::stop() {
+    std::lock_guard<std::mutex> lock(lifecycleMutex);
+    if (!running) {
+        return;
+    }
+    running = false;
+    validateQueue.close();
+    for (auto& stage : stages) {
+        stage.join();
+    }
+
+    CheckoutStats stats = getStats();
+    Logger::getInstance()->info("CheckoutPipeline", "下单流水线已停止",
+                                {{"created", std::to_string(stats.created)},
+                                 {"rejected", std::to_string(stats.rejected)},
+                                 {"batches", std::to_string(stats.batches)}});
+}
+
+/**
+ * @brief 提交下单请求
+ */
+std::future<CheckoutOutcome> CheckoutPipeline::submit(CheckoutRequest request) {
+    auto job = std::make_unique<Job>();
+    job->request = std::move(request);
+    job->submitted = Clock::now();
+    std::future<CheckoutOutcome> future = job->promise.get_future();
+    ++submittedCount;
+
+    auto finishNow = [this](Job& finished) {
+        finished.outcome.latencyMs =
+            std::chrono::duration<double, std::milli>(Clock::now() - finished.submitted).count();
+        finished.promise.set_value(std::move(finished.outcome));
+    };
+
+    if (!running) {
+        fail(*job, CheckoutStatus::INVALID, "下单服务未启动");
+        ++rejectedCount;
+        finishNow(*job);
+        return future;
+    }
+
+    const CheckoutRequest& r = job->request;
+    if (!r.requestKey.empty()) {
+        std::shared_ptr<Order> existing;
+        if (!orderManager->beginRequest(r.userId, r.requestKey, existing)) {
+            job->outcome.status = CheckoutStatus::DUPLICATE;
+            job->outcome.order = existing;
+            ++duplicateCount;
+            finishNow(*job);
+            return future;
+        }
+    }
+
+    if (flashSale) {
+        for (const auto& line : r.items) {
+            if (!line.first || !flashSale->isEnabled(line.first->getItemId())) {
+                continue;
+            }
+            if (!flashSale->claim(line.first->getItemId(), line.second)) {
+                fail(*job, CheckoutStatus::OUT_OF_STOCK, "商品已抢完：" + line.first->getItemName());
+                break;
+            }
+            job->flashClaims.emplace_back(line.first->getItemId(), line.second);
+        }
+        if (job->failed) {
+            settleFlashClaims(*job);
+            if (!r.requestKey.empty()) {
+                orderManager->finishRequest(r.userId, r.requestKey, nullptr);
+            }
+            ++rejectedCount;
+            finishNow(*job);
+            return future;
+        }
+    }
+
+    if (!validateQueue.push(std::move(job))) {
+        // 提交期间流水线被停止
+        fail(*job, CheckoutStatus::INVALID, "下单服务未启动");
+        settleFlashClaims(*job);
+        if (!job->request.requestKey.empty()) {
+            orderManager->finishRequest(job->request.userId, job->request.requestKey, nullptr);
+        }
+        ++rejectedCount;
+        finishNow(*job);
+    }
+    return future;
+}
+
+/**
+ * @brief 获取统计
+ */
+CheckoutStats CheckoutPipeline::getStats() const {
+    CheckoutStats stats;
+    stats.submitted = submittedCount.load();
+    stats.created = createdCount.load();
+    stats.rejected = rejectedCount.load();
+    stats.duplicates = duplicateCount.load();
+    stats.batches = batchCount.load();
+    stats.maxBatch = maxBatchSeen.load();
+    return stats;
+}
+
+/**
+ * @brief 标记任务失败
+ */
+void CheckoutPipeline::fail(Job& job, CheckoutStatus status, const std::string& message) {
+    job.failed = true;
+    job.outcome.status = status;
+    job.outcome.message = message;
+}
+
+/**
+ * @brief 把任务交给下一阶段
+ */
+void CheckoutPipeline::forward(JobPtr job, StageQueue<JobPtr>& next) {
+    if (job->failed) {
+        ackQueue.push(std::move(job));
+    } else {
+        next.push(std::move(job));
+    }
+}
+
+/**
+ * @brief 结算秒杀配额
+ */
+void CheckoutPipeline::settleFlashClaims(Job& job) {
+    for (const auto& claim : job.flashClaims) {
+        if (job.failed) {
+            flashSale->release(claim.first, claim.second);
+        } else {
+            flashSale->commit(claim.first, claim.second);
+        }
+    }
+    job.flashClaims.clear();
+}
+
+/**
+ * @brief 撤销已完成预留的任务
+ */
+void CheckoutPipeline::releaseReservation(Job& job) {
+    const CheckoutRequest& r = job.request;
+    const std::string& orderId = job.outcome.order->getOrderId();
+    for (const auto& line : r.items) {
+        itemRepository->adjustStock(line.first->getItemId(), line.second, StockMovementReason::ROLLBACK, orderId);
+    }
+    if (promotionManager) {
+        promotionManager->releaseUsage(job.outcome.pricing, r.userId);
+        if (!r.couponCode.empty() && promotionManager->getCouponManager()) {
+            promotionManager->getCouponManager()->release(r.couponCode, orderId);
+        }
+    }
+    job.outcome.order.reset();
+}
+
+/**
+ * @brief 校验阶段
+ */
+void CheckoutPipeline::validateStage() {
+    JobPtr job;
+    while (validateQueue.pop(job)) {
+        const CheckoutRequest& r = job->request;
+        if (r.userId.empty()) {
+            fail(*job, CheckoutStatus::INVALID, "用户为空");
+        } else if (r.items.empty()) {
+            fail(*job, CheckoutStatus::INVALID, "没有要购买的商品");
+        } else if (r.shippingAddress.empty()) {
+            fail(*job, CheckoutStatus::INVALID, "收货地址为空");
+        } else {
+            for (const auto& line : r.items) {
+                if (!line.first || line.second <= 0) {
+                    fail(*job, CheckoutStatus::INVALID, "商品数量无效");
+                    break;
+                }
+                if (!itemRepository->findItemById(line.first->getItemId())) {
+                    fail(*job, CheckoutStatus::INVALID, "商品已下架：" + line.first->getItemName());
+                    break;
+                }
+            }
+        }
+        forward(std::move(job), priceQueue);
+    }
+    priceQueue.close();
+}
+
+/**
+ * @brief 计价阶段
+ */
+void CheckoutPipeline::priceStage() {
+    JobPtr job;
+    while (priceQueue.pop(job)) {
+        if (!job->failed) {
+            const CheckoutRequest& r = job->request;
+            PromotionResult& pricing = job->outcome.pricing;
+            if (promotionManager) {
+                pricing = promotionManager->calculatePromotionResult(r.items, r.couponCode, r.userId);
+                if (!r.couponCode.empty() && pricing.couponStatus != CouponStatus::OK) {
+                    fail(*job, CheckoutStatus::COUPON_REJECTED,
+                         "优惠券不可用：" + CouponManager::statusToString(pricing.couponStatus));
+                }
+            } else {
+                double total = 0.0;
+                for (const auto& line : r.items) {
+                    total += line.first->getPrice() * line.second;
+                }
+                pricing.originalTotal = total;
+                pricing.afterDiscountTotal = total;
+                pricing.finalTotal = total;
+            }
+        }
+        forward(std::move(job), reserveQueue);
+    }
+    reserveQueue.close();
+}
+
+/**
+ * @brief 预留阶段
+ *
+ * 逐个扣减库存（检查和扣减在商品仓库的写锁内完成），
+ * 扣减、占用促销或核销优惠券失败时按相反顺序回滚
+ */
+void CheckoutPipeline::reserveStage() {
+    JobPtr job;
+    while (reserveQueue.pop(job)) {
+        if (job->failed) {
+            forward(std::move(job), persistQueue);
+            continue;
+        }
+
+        const CheckoutRequest& r = job->request;
+        time_t now = std::time(nullptr);
+        std::string orderId = orderManager->allocateOrderId(r.userId, now);
+
+        size_t deducted = 0;
+        auto rollbackStock = [&]() {
+            for (size_t j = 0; j < deducted; ++j) {
+                itemRepository->adjustStock(r.items[j].first->getItemId(), r.items[j].second,
+                                            StockMovementReason::ROLLBACK, orderId);
+            }
+        };
+
+        for (; !job->failed && deducted < r.items.size(); ++deducted) {
+            const auto& line = r.items[deducted];
+            if (!itemRepository->adjustStock(line.first->getItemId(), -line.second, StockMovementReason::SALE, orderId)) {
+                rollbackStock();
+                fail(*job, CheckoutStatus::OUT_OF_STOCK,
+                     InsufficientStockException(line.first->getItemName(), line.second, line.first->getStock()).what());
+            }
+        }
+
+        if (!job->failed && promotionManager) {
+            if (!promotionManager->reserveUsage(job->outcome.pricing, r.userId)) {
+                rollbackStock();
+                fail(*job, CheckoutStatus::PROMOTION_EXHAUSTED, "部分促销已达到每人限用次数，请重新结算");
+            } else if (!r.couponCode.empty()) {
+                CouponStatus status = promotionManager->redeemCoupon(r.items, r.couponCode, orderId, r.userId);
+                if (status != CouponStatus::OK) {
+                    promotionManager->releaseUsage(job->outcome.pricing, r.userId);
+                    rollbackStock();
+                    fail(*job, CheckoutStatus::COUPON_REJECTED,
+                         "优惠券核销失败：" + CouponManager::statusToString(status));
+                }
+            }
+        }
+
+        if (!job->failed) {
+            std::vector<OrderItem> orderItems;
+            double total = 0.0;
+            for (const auto& line : r.items) {
+                orderItems.emplace_back(line.first->getItemId(), line.first->getItemName(),
+                                        line.first->getPrice(), line.second);
+                total += line.first->getPrice() * line.second;
+            }
+            job->outcome.order = std::make_shared<Order>(orderId, r.userId, orderItems, now, total,
+                                                         r.shippingAddress, OrderStatus::PENDING, now);
+        }
+        forward(std::move(job), persistQueue);
+    }
+    persistQueue.close();
+}
+
+/**
+ * @brief 持久化阶段
+ *
+ * 上一批写文件期间到达的订单一起组成下一批。先写商品文件再提交订单，
+ * 任一步失败时整批撤销预留并恢复商品文件，订单不会在未写入时被确认
+ */
+void CheckoutPipeline::persistStage() {
+    std::vector<JobPtr> batch;
+    std::vector<std::shared_ptr<Order>> orders;
+    while (persistQueue.popAll(batch, maxBatch) > 0) {
+        orders.clear();
+        for (const auto& job : batch) {
+            orders.push_back(job->outcome.order);
+        }
+        bool itemsSaved = itemRepository->saveToFile();
+        if (!itemsSaved || !orderManager->commitOrders(orders)) {
+            Logger::getInstance()->error("CheckoutPipeline", "订单批次写入文件失败，已撤销预留",
+                                         {{"count", std::to_string(orders.size())}});
+            for (auto& job : batch) {
+                releaseReservation(*job);
+                fail(*job, CheckoutStatus::PERSIST_FAILED, "订单保存失败，请稍后重试");
+            }
+            if (itemsSaved) {
+                itemRepository->saveToFile();
+            }
+        }
+        ++batchCount;
+        if (orders.size() > maxBatchSeen.load()) {
+            maxBatchSeen = orders.size();
+        }
+
+        for (auto& job : batch) {
+            ackQueue.push(std::move(job));
+        }
+        batch.clear();
+    }
+    ackQueue.close();
+}
+
+/**
+ * @brief 确认阶段
+ */
+void CheckoutPipeline::ackStage() {
+    JobPtr job;
+    while (ackQueue.pop(job)) {
+        CheckoutOutcome& outcome = job->outcome;
+        if (job->failed) {
+            ++rejectedCount;
+        } else {
+            outcome.status = CheckoutStatus::CREATED;
+            ++createdCount;
+        }
+        settleFlashClaims(*job);
+        if (!job->request.requestKey.empty()) {
+            orderManager->finishRequest(job->request.userId, job->request.requestKey,
+                                        job->failed ? nullptr : outcome.order);
+        }
+        outcome.latencyMs = std::chrono::duration<double, std::milli>(Clock::now() - job->submitted).count();
+        job->promise.set_value(std::move(outcome));
+    }
+}
+
+/**
+ * @brief 获取下单结果的显示字符串
+ */
+std::string CheckoutPipeline::statusToString(CheckoutStatus status) {
+    switch (status) {
+        case CheckoutStatus::CREATED:               return "下单成功";
+        case CheckoutStatus::DUPLICATE:             return "重复提交";
+        case CheckoutStatus::INVALID:               return "请求无效";
+        case CheckoutStatus::OUT_OF_STOCK:          return "库存不足";
+        case CheckoutStatus::PROMOTION_EXHAUSTED:   return "促销次数已用尽";
+        case CheckoutStatus::COUPON_REJECTED:       return "优惠券不可用";
+        case CheckoutStatus::PERSIST_FAILED:        return "订单保存失败";
+    }
+    return "未知";
+}
@@ -0,0 +1,138 @@
+/**
+ * @file IdempotencyTable.cpp
+ * @brief 下单幂等表的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Order/IdempotencyTable.h"
+#include <algorithm>
+#include <functional>
+
+/**
+ * @brief 构造函数实现
+ */
+IdempotencyTable::IdempotencyTable(size_t capacity, int ttlSeconds)
+    : shardCapacity(1), ttl(std::chrono::seconds(1)), nextSequence(1),
+      requestCount(0), hitCount(0), waitCount(0), expiredCount(0), evictedCount(0) {
+    configure(capacity, ttlSeconds);
+}
+
+/**
+ * @brief 修改容量和存活时间
+ *
+ * 持有全部段锁修改参数；进行中的记录和等待它的重复请求不受影响
+ */
+void IdempotencyTable::configure(size_t capacity, int ttlSeconds) {
+    std::unique_lock<std::mutex> locks[SHARD_COUNT];
+    for (size_t i = 0; i < SHARD_COUNT; ++i) {
+        locks[i] = std::unique_lock<std::mutex>(shards[i].mutex);
+    }
+    shardCapacity = std::max<size_t>(1, capacity / SHARD_COUNT);
+    ttl = std::chrono::seconds(std::max(1, ttlSeconds));
+}
+
+/**
+ * @brief 键所在的段
+ */
+IdempotencyTable::Shard& IdempotencyTable::shardOf(const std::string& key) const {
+    return shards[std::hash<std::string>()(key) & (SHARD_COUNT - 1)];
+}
+
+/**
+ * @brief 清除到期记录并按容量淘汰
+ *
+ * 队列中只有已完成的记录；键已删除或已被新记录替换的项直接丢弃
+ */
+void IdempotencyTable::prune(Shard& shard, Clock::time_point now) {
+    while (!shard.fifo.empty()) {
+        const auto& front = shard.fifo.front();
+        auto it = shard.entries.find(front.second.first);
+        if (it == shard.entries.end() || it->second.sequence != front.second.second) {
+            shard.fifo.pop_front();
+            continue;
+        }
+
+        bool expired = now - front.first >= ttl;
+        bool full = shard.entries.size() >= shardCapacity;
+        if (!expired && !full) {
+            break;
+        }
+        shard.entries.erase(it);
+        shard.fifo.pop_front();
+        ++(expired ? expiredCount : evictedCount);
+    }
+}
+
+/**
+ * @brief 开始一个请求
+ */
+bool IdempotencyTable::begin(const std::string& key, std::shared_ptr<Order>& existing) {
+    ++requestCount;
+    Shard& shard = shardOf(key);
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    bool waited = false;
+    while (true) {
+        Clock::time_point now = Clock::now();
+        prune(shard, now);
+
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end()) {
+            Entry entry;
+            entry.sequence = nextSequence++;
+            shard.entries.emplace(key, std::move(entry));
+            return true;
+        }
+        if (it->second.done) {
+            existing = it->second.order;
+            ++hitCount;
+            if (waited) {
+                ++waitCount;
+            }
+            return false;
+        }
+
+        // 首个请求仍在处理，等待其完成或失败
+        waited = true;
+        shard.settled.wait(lock);
+    }
+}
+
+/**
+ * @brief 结束一个请求
+ */
+void IdempotencyTable::finish(const std::string& key, const std::shared_ptr<Order>& order) {
+    Shard& shard = shardOf(key);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end() && !it->second.done) {
+            if (order) {
+                it->second.order = order;
+                it->second.done = true;
+                // 存活时间从完成时算起
+                shard.fifo.push_back({Clock::now(), {key, it->second.sequence}});
+            } else {
+                shard.entries.erase(it);
+            }
+        }
+    }
+    shard.settled.notify_all();
+}
+
+/**
+ * @brief 获取统计
+ */
+IdempotencyStats IdempotencyTable::getStats() const {
+    IdempotencyStats stats;
+    stats.requests = requestCount.load();
+    stats.hits = hitCount.load();
+    stats.waits = waitCount.load();
+    stats.expired = expiredCount.load();
+    stats.evicted = evictedCount.load();
+    for (auto& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.entries += shard.entries.size();
+    }
+    return stats;
+}
@@ -6,8 +6,6 @@
  */
 
 #include "Order/Order.h"
-#include "Order/OrderException.h"
-#include "Interfaces/DependencyInterfaces.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -21,57 +19,6 @@ Order::Order()
       shippingAddress(""), status(OrderStatus::PENDING), statusChangeTime(0) {
 }
 
-/**
- * @brief 构造函数实现
- * 
- * 创建新订单时：
- * 1. 生成订单编号
- * 2. 计算订单总额
- * 3. 验证并更新商品库存
- * 4. 记录订单时间
- */
-Order::Order(const std::string& userId, 
-             const std::vector<std::pair<std::shared_ptr<Item>, int>>& cartItems,
-             const std::string& shippingAddress,
-             IItemRepository* itemManager)
-    : userId(userId), totalAmount(0.0), shippingAddress(shippingAddress), 
-      status(OrderStatus::PENDING) {
-    
-    // 获取当前时间
-    orderTime = std::time(nullptr);
-    statusChangeTime = orderTime;
-    
-    // 生成订单编号
-    orderId = generateOrderId(userId, orderTime);
-    
-    // 处理订单中的每个商品
-    for (const auto& pair : cartItems) {
-        std::shared_ptr<Item> item = pair.first;
-        int quantity = pair.second;
-        
-        // 检查库存是否充足
-        if (quantity > item->getStock()) {
-            throw InsufficientStockException(item->getItemName(), quantity, item->getStock());
-        }
-        
-        // 添加商品到订单
-        OrderItem orderItem(item->getItemId(), item->getItemName(), 
-                           item->getPrice(), quantity);
-        items.push_back(orderItem);
-        
-        // 计算总额
-        totalAmount += item->getPrice() * quantity;
-        
-        // 更新商品库存
-        item->setStock(item->getStock() - quantity);
-    }
-    
-    // 保存更新后的商品数据
-    if (itemManager) {
-        itemManager->saveToFile();
-    }
-}
-
 /**
  * @brief 从CSV数据构造订单（用于数据加载）
  */
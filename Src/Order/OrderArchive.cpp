@@ -0,0 +1,461 @@
+/**
+ * @file OrderArchive.cpp
+ * @brief 订单归档类的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Order/OrderArchive.h"
+#include "Log/Logger.h"
+#include <fstream>
+#include <algorithm>
+#include <unordered_map>
+#include <map>
+#include <limits>
+#include <cmath>
+
+namespace {
+
+const char FILE_MAGIC[8] = {'O', 'R', 'D', 'A', 'R', 'C', 'H', '1'};  // 文件头魔数
+const uint32_t BLOCK_MAGIC = 0x314B4C42;    // 块头魔数（"BLK1"）
+const size_t BLOCK_HEADER_SIZE = 32;        // 块头固定字节数
+
+const uint64_t ORDER_ID_RAW = 0;            // 订单编号按原始字符串保存
+const uint64_t ORDER_ID_NUMERIC = 1;        // 订单编号为"ORD"+数字，按整数保存
+
+/**
+ * @brief 追加无符号变长整数（每字节7位，最高位表示后续还有字节）
+ */
+void putVarint(std::string& buf, uint64_t value) {
+    while (value >= 0x80) {
+        buf.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    buf.push_back(static_cast<char>(value));
+}
+
+/**
+ * @brief 读取无符号变长整数
+ */
+bool getVarint(const std::string& buf, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (pos >= buf.size()) {
+            return false;
+        }
+        uint8_t byte = static_cast<uint8_t>(buf[pos++]);
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 有符号整数的ZigZag编码（使小的负数也只占少量字节）
+ */
+uint64_t zigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+/**
+ * @brief ZigZag解码
+ */
+int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * @brief 追加带长度前缀的字符串
+ */
+void putString(std::string& buf, const std::string& str) {
+    putVarint(buf, str.size());
+    buf.append(str);
+}
+
+/**
+ * @brief 读取带长度前缀的字符串
+ */
+bool getString(const std::string& buf, size_t& pos, std::string& str) {
+    uint64_t len;
+    if (!getVarint(buf, pos, len) || len > buf.size() - pos) {
+        return false;
+    }
+    str.assign(buf, pos, static_cast<size_t>(len));
+    pos += static_cast<size_t>(len);
+    return true;
+}
+
+/**
+ * @brief 追加小端定长整数
+ */
+void putFixed(std::string& buf, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        buf.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+/**
+ * @brief 读取小端定长整数
+ */
+uint64_t getFixed(const char* data, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief 计算FNV-1a校验和
+ */
+uint32_t fnv1a(const std::string& data) {
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/**
+ * @brief 金额转换为以“分”为单位的定点整数
+ */
+int64_t toCents(double amount) {
+    return static_cast<int64_t>(std::llround(amount * 100.0));
+}
+
+/**
+ * @brief 判断订单编号是否为"ORD"+数字的形式，并解析出数字部分
+ */
+bool parseNumericOrderId(const std::string& orderId, uint64_t& number, size_t& width) {
+    // 最多19位数字，保证不会溢出uint64
+    if (orderId.size() <= 3 || orderId.size() > 3 + 19 || orderId.compare(0, 3, "ORD") != 0) {
+        return false;
+    }
+    number = 0;
+    for (size_t i = 3; i < orderId.size(); ++i) {
+        char c = orderId[i];
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        number = number * 10 + static_cast<uint64_t>(c - '0');
+    }
+    width = orderId.size() - 3;
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数实现
+ */
+OrderArchive::OrderArchive(const std::string& filePath, size_t ordersPerBlock)
+    : filePath(filePath), ordersPerBlock(ordersPerBlock == 0 ? 4096 : ordersPerBlock) {
+}
+
+/**
+ * @brief 将一组订单编码为一个数据块的数据区
+ *
+ * 数据区布局：
+ * 字符串字典 | 商品字典（商品ID下标, 名称下标） | 订单记录
+ */
+std::string OrderArchive::encodeBlock(const std::vector<std::shared_ptr<Order>>& orders,
+                                      size_t begin, size_t end, ArchiveBlockInfo& info) const {
+    std::vector<std::string> strings;                       // 字符串字典
+    std::unordered_map<std::string, uint64_t> stringIndex;  // 字符串到下标
+    std::vector<std::pair<uint64_t, uint64_t>> itemDict;    // 商品字典
+    std::map<std::pair<uint64_t, uint64_t>, uint64_t> itemIndex;
+
+    auto internString = [&](const std::string& str) -> uint64_t {
+        auto it = stringIndex.find(str);
+        if (it != stringIndex.end()) {
+            return it->second;
+        }
+        uint64_t idx = strings.size();
+        strings.push_back(str);
+        stringIndex.emplace(str, idx);
+        return idx;
+    };
+
+    auto internItem = [&](const OrderItem& item) -> uint64_t {
+        auto key = std::make_pair(internString(item.itemId), internString(item.itemName));
+        auto it = itemIndex.find(key);
+        if (it != itemIndex.end()) {
+            return it->second;
+        }
+        uint64_t idx = itemDict.size();
+        itemDict.push_back(key);
+        itemIndex.emplace(key, idx);
+        return idx;
+    };
+
+    info.orderCount = static_cast<uint32_t>(end - begin);
+    info.minTime = orders[begin]->getOrderTime();
+    info.maxTime = orders[end - 1]->getOrderTime();
+
+    // 先编码订单记录，同时建立字典
+    std::string records;
+    time_t prevTime = info.minTime;
+    for (size_t i = begin; i < end; ++i) {
+        const auto& order = orders[i];
+
+        uint64_t number;
+        size_t width;
+        if (parseNumericOrderId(order->getOrderId(), number, width)) {
+            putVarint(records, ORDER_ID_NUMERIC);
+            putVarint(records, width);
+            putVarint(records, number);
+        } else {
+            putVarint(records, ORDER_ID_RAW);
+            putString(records, order->getOrderId());
+        }
+
+        putVarint(records, internString(order->getUserId()));
+        putVarint(records, zigzagEncode(static_cast<int64_t>(order->getOrderTime() - prevTime)));
+        putVarint(records, zigzagEncode(static_cast<int64_t>(order->getStatusChangeTime() - order->getOrderTime())));
+        putVarint(records, static_cast<uint64_t>(order->getStatus()));
+        putVarint(records, internString(order->getShippingAddress()));
+        putVarint(records, zigzagEncode(toCents(order->getTotalAmount())));
+
+        const auto& items = order->getItems();
+        putVarint(records, items.size());
+        for (const auto& item : items) {
+            putVarint(records, internItem(item));
+            putVarint(records, zigzagEncode(toCents(item.price)));
+            putVarint(records, zigzagEncode(item.quantity));
+        }
+
+        prevTime = order->getOrderTime();
+    }
+
+    // 拼接字典与订单记录
+    std::string payload;
+    putVarint(payload, strings.size());
+    for (const auto& str : strings) {
+        putString(payload, str);
+    }
+    putVarint(payload, itemDict.size());
+    for (const auto& entry : itemDict) {
+        putVarint(payload, entry.first);
+        putVarint(payload, entry.second);
+    }
+    payload.append(records);
+
+    info.payloadSize = static_cast<uint32_t>(payload.size());
+    info.checksum = fnv1a(payload);
+    return payload;
+}
+
+/**
+ * @brief 解码一个数据块的数据区
+ */
+bool OrderArchive::decodeBlock(const std::string& payload, const ArchiveBlockInfo& info,
+                               time_t from, time_t to,
+                               std::vector<std::shared_ptr<Order>>& out) const {
+    size_t pos = 0;
+    uint64_t count;
+
+    // 读取字符串字典
+    if (!getVarint(payload, pos, count)) return false;
+    std::vector<std::string> strings(static_cast<size_t>(count));
+    for (auto& str : strings) {
+        if (!getString(payload, pos, str)) return false;
+    }
+
+    // 读取商品字典
+    if (!getVarint(payload, pos, count)) return false;
+    std::vector<std::pair<uint64_t, uint64_t>> itemDict(static_cast<size_t>(count));
+    for (auto& entry : itemDict) {
+        if (!getVarint(payload, pos, entry.first) || !getVarint(payload, pos, entry.second) ||
+            entry.first >= strings.size() || entry.second >= strings.size()) {
+            return false;
+        }
+    }
+
+    // 读取订单记录
+    time_t prevTime = info.minTime;
+    for (uint32_t n = 0; n < info.orderCount; ++n) {
+        uint64_t tag;
+        std::string orderId;
+        if (!getVarint(payload, pos, tag)) return false;
+        if (tag == ORDER_ID_NUMERIC) {
+            uint64_t width, number;
+            if (!getVarint(payload, pos, width) || !getVarint(payload, pos, number)) return false;
+            std::string digits = std::to_string(number);
+            if (digits.size() < width) {
+                digits.insert(0, static_cast<size_t>(width) - digits.size(), '0');
+            }
+            orderId = "ORD" + digits;
+        } else if (!getString(payload, pos, orderId)) {
+            return false;
+        }
+
+        uint64_t userIdx, timeDelta, statusDelta, status, addressIdx, totalCents, itemCount;
+        if (!getVarint(payload, pos, userIdx) || userIdx >= strings.size()) return false;
+        if (!getVarint(payload, pos, timeDelta)) return false;
+        if (!getVarint(payload, pos, statusDelta)) return false;
+        if (!getVarint(payload, pos, status) || status > static_cast<uint64_t>(OrderStatus::DELIVERED)) return false;
+        if (!getVarint(payload, pos, addressIdx) || addressIdx >= strings.size()) return false;
+        if (!getVarint(payload, pos, totalCents)) return false;
+        if (!getVarint(payload, pos, itemCount)) return false;
+
+        time_t orderTime = prevTime + static_cast<time_t>(zigzagDecode(timeDelta));
+        time_t statusChangeTime = orderTime + static_cast<time_t>(zigzagDecode(statusDelta));
+        prevTime = orderTime;
+
+        std::vector<OrderItem> items;
+        items.reserve(static_cast<size_t>(itemCount));
+        for (uint64_t i = 0; i < itemCount; ++i) {
+            uint64_t itemIdx, priceCents, quantity;
+            if (!getVarint(payload, pos, itemIdx) || itemIdx >= itemDict.size()) return false;
+            if (!getVarint(payload, pos, priceCents)) return false;
+            if (!getVarint(payload, pos, quantity)) return false;
+            const auto& entry = itemDict[static_cast<size_t>(itemIdx)];
+            items.emplace_back(strings[static_cast<size_t>(entry.first)],
+                               strings[static_cast<size_t>(entry.second)],
+                               zigzagDecode(priceCents) / 100.0,
+                               static_cast<int>(zigzagDecode(quantity)));
+        }
+
+        // 只保留时间范围内的订单
+        if (orderTime < from || orderTime > to) {
+            continue;
+        }
+
+        out.push_back(std::make_shared<Order>(orderId,
+                                              strings[static_cast<size_t>(userIdx)],
+                                              items,
+                                              orderTime,
+                                              zigzagDecode(totalCents) / 100.0,
+                                              strings[static_cast<size_t>(addressIdx)],
+                                              static_cast<OrderStatus>(status),
+                                              statusChangeTime));
+    }
+
+    return pos == payload.size();
+}
+
+/**
+ * @brief 将订单写入归档文件
+ */
+bool OrderArchive::write(const std::vector<std::shared_ptr<Order>>& orders) const {
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        Logger::getInstance()->error("OrderArchive", "无法打开归档文件进行写入", {{"path", filePath}});
+        return false;
+    }
+
+    // 按时间排序，使块的时间范围紧凑
+    std::vector<std::shared_ptr<Order>> sorted(orders);
+    std::stable_sort(sorted.begin(), sorted.end(),
+        [](const std::shared_ptr<Order>& a, const std::shared_ptr<Order>& b) {
+            return a->getOrderTime() < b->getOrderTime();
+        });
+
+    file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+
+    for (size_t begin = 0; begin < sorted.size(); begin += ordersPerBlock) {
+        size_t end = std::min(begin + ordersPerBlock, sorted.size());
+
+        ArchiveBlockInfo info;
+        std::string payload = encodeBlock(sorted, begin, end, info);
+
+        std::string header;
+        putFixed(header, BLOCK_MAGIC, 4);
+        putFixed(header, info.orderCount, 4);
+        putFixed(header, static_cast<uint64_t>(static_cast<int64_t>(info.minTime)), 8);
+        putFixed(header, static_cast<uint64_t>(static_cast<int64_t>(info.maxTime)), 8);
+        putFixed(header, info.payloadSize, 4);
+        putFixed(header, info.checksum, 4);
+
+        file.write(header.data(), static_cast<std::streamsize>(header.size()));
+        file.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    }
+
+    file.close();
+    return file.good();
+}
+
+/**
+ * @brief 读取归档文件并解码时间范围内的所有块
+ *
+ * 块头不完整或跳过的块超出文件末尾时视为文件被截断，返回false
+ */
+bool OrderArchive::readRange(time_t from, time_t to, std::vector<std::shared_ptr<Order>>& out) const {
+    std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        Logger::getInstance()->error("OrderArchive", "无法打开归档文件", {{"path", filePath}});
+        return false;
+    }
+    std::streamoff fileSize = file.tellg();
+    file.seekg(0);
+
+    char magic[sizeof(FILE_MAGIC)];
+    if (!file.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), FILE_MAGIC)) {
+        Logger::getInstance()->error("OrderArchive", "归档文件格式错误", {{"path", filePath}});
+        return false;
+    }
+
+    char header[BLOCK_HEADER_SIZE];
+    std::string payload;
+    while (file.read(header, BLOCK_HEADER_SIZE)) {
+        if (getFixed(header, 4) != BLOCK_MAGIC) {
+            Logger::getInstance()->error("OrderArchive", "归档数据块损坏", {{"path", filePath}});
+            return false;
+        }
+
+        ArchiveBlockInfo info;
+        info.orderCount = static_cast<uint32_t>(getFixed(header + 4, 4));
+        info.minTime = static_cast<time_t>(static_cast<int64_t>(getFixed(header + 8, 8)));
+        info.maxTime = static_cast<time_t>(static_cast<int64_t>(getFixed(header + 16, 8)));
+        info.payloadSize = static_cast<uint32_t>(getFixed(header + 24, 4));
+        info.checksum = static_cast<uint32_t>(getFixed(header + 28, 4));
+
+        // 时间范围不相交的块直接跳过
+        if (info.maxTime < from || info.minTime > to) {
+            std::streamoff payloadEnd = static_cast<std::streamoff>(file.tellg()) + info.payloadSize;
+            if (payloadEnd > fileSize || !file.seekg(info.payloadSize, std::ios::cur)) {
+                Logger::getInstance()->error("OrderArchive", "归档文件不完整", {{"path", filePath}});
+                return false;
+            }
+            continue;
+        }
+
+        payload.resize(info.payloadSize);
+        if (!file.read(&payload[0], info.payloadSize) || fnv1a(payload) != info.checksum) {
+            Logger::getInstance()->error("OrderArchive", "归档数据块校验失败", {{"path", filePath}});
+            return false;
+        }
+
+        if (!decodeBlock(payload, info, from, to, out)) {
+            Logger::getInstance()->error("OrderArchive", "归档数据块解码失败", {{"path", filePath}});
+            return false;
+        }
+    }
+
+    // 循环因读不满块头而结束：读到0字节为正常结尾，否则块头被截断
+    if (file.gcount() != 0) {
+        Logger::getInstance()->error("OrderArchive", "归档文件不完整", {{"path", filePath}});
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 读取归档中的全部订单
+ */
+bool OrderArchive::readAll(std::vector<std::shared_ptr<Order>>& out) const {
+    return readRange(std::numeric_limits<time_t>::min(), std::numeric_limits<time_t>::max(), out);
+}
+
+/**
+ * @brief 按时间范围扫描归档
+ */
+bool OrderArchive::scanTimeRange(time_t from, time_t to, std::vector<std::shared_ptr<Order>>& out) const {
+    if (from > to) {
+        return true;
+    }
+    return readRange(from, to, out);
+}
@@ -6,20 +6,117 @@
  */
 
 #include "Order/OrderManager.h"
-#include "Order/OrderException.h"
+#include "Order/OrderArchive.h"
+#include "Log/Logger.h"
+#include "Services/ListingRenderer.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
 #include <chrono>
+#include <iterator>
+#include <unordered_set>
+#include <filesystem>
 
 /**
  * @brief 构造函数实现
  */
 OrderManager::OrderManager(const std::string& filePath, std::shared_ptr<IItemRepository> itemManager)
-    : filePath(filePath), itemManager(itemManager), autoUpdateEnabled(false),
-      pendingToShippedSeconds(10), shippedToDeliveredSeconds(20) {
+    : filePath(filePath), itemManager(itemManager), idempotency(100000, 30), autoUpdateEnabled(false),
+      pendingToShippedSeconds(10), shippedToDeliveredSeconds(20), orderSequence(0) {
+    for (auto& count : statusCounts) {
+        count.store(0);
+    }
+}
+
+/**
+ * @brief 将订单加入所有索引
+ */
+void OrderManager::indexOrder(const std::shared_ptr<Order>& order) {
+    const std::string& orderId = order->getOrderId();
+    orderById[orderId] = order;
+    timeIndex.upsert(orderId, order->getOrderTime());
+    amountIndex.upsert(orderId, order->getTotalAmount());
+    statusIndex.upsert(orderId, static_cast<int>(order->getStatus()));
+    
+    size_t bucket = static_cast<size_t>(order->getStatus());
+    if (statusMembers[bucket].emplace(orderId, order).second) {
+        statusCounts[bucket].fetch_add(1);
+    }
+    
+    timeline.insert(order);
+    userTimelines[order->getUserId()].insert(order);
+}
+
+/**
+ * @brief 生成一个未被占用的订单编号
+ *
+ * 序号保证本进程内不重复，与已有订单核对可避开历史订单和哈希碰撞
+ */
+std::string OrderManager::nextOrderId(const std::string& userId, time_t timestamp) {
+    std::string orderId;
+    do {
+        orderId = Order::generateOrderId(userId + "#" + std::to_string(++orderSequence), timestamp);
+    } while (orderById.count(orderId) > 0);
+    return orderId;
+}
+
+/**
+ * @brief 重建所有索引
+ */
+size_t OrderManager::rebuildIndexes() {
+    orderById.clear();
+    timeIndex.clear();
+    amountIndex.clear();
+    statusIndex.clear();
+    for (size_t i = 0; i < STATUS_COUNT; ++i) {
+        statusMembers[i].clear();
+        statusCounts[i].store(0);
+    }
+    timeline.clear();
+    userTimelines.clear();
+    
+    // 先按时间排序，使时间索引的插入全部走追加路径
+    std::vector<std::shared_ptr<Order>> byTime(orders);
+    std::stable_sort(byTime.begin(), byTime.end(),
+        [](const std::shared_ptr<Order>& a, const std::shared_ptr<Order>& b) {
+            return a->getOrderTime() < b->getOrderTime();
+        });
+    size_t renumbered = 0;
+    for (const auto& order : byTime) {
+        if (orderById.count(order->getOrderId()) > 0) {
+            std::string oldId = order->getOrderId();
+            order->setOrderId(nextOrderId(order->getUserId(), order->getOrderTime()));
+            Logger::getInstance()->warn("OrderManager", "订单编号重复，已重新编号",
+                                        {{"old_id", oldId}, {"new_id", order->getOrderId()},
+                                         {"user", order->getUserId()}});
+            ++renumbered;
+        }
+        indexOrder(order);
+    }
+    return renumbered;
+}
+
+/**
+ * @brief 修改订单状态并同步状态索引
+ */
+void OrderManager::applyStatus(const std::shared_ptr<Order>& order, OrderStatus newStatus) {
+    size_t oldBucket = static_cast<size_t>(order->getStatus());
+    size_t newBucket = static_cast<size_t>(newStatus);
+    const std::string orderId = order->getOrderId();
+    
+    order->setStatus(newStatus);
+    statusIndex.upsert(orderId, static_cast<int>(newStatus));
+    
+    if (oldBucket != newBucket) {
+        if (statusMembers[oldBucket].erase(orderId) > 0) {
+            statusCounts[oldBucket].fetch_sub(1);
+        }
+        if (statusMembers[newBucket].emplace(orderId, order).second) {
+            statusCounts[newBucket].fetch_add(1);
+        }
+    }
 }
 
 /**
@@ -80,7 +177,7 @@ std::vector<OrderItem> OrderManager::parseOrderItems(const std::string& itemsStr
             items.push_back(OrderItem(itemId, name, price, quantity));
         } catch (...) {
             // 忽略解析错误的商品
-            std::cerr << "警告：解析订单商品失败: " << itemStr << std::endl;
+            Logger::getInstance()->warn("OrderManager", "解析订单商品失败", {{"item", itemStr}});
         }
     }
     
@@ -114,7 +211,7 @@ std::string OrderManager::orderItemsToString(const std::vector<OrderItem>& items
 bool OrderManager::loadFromFile() {
     std::ifstream file(filePath);
     if (!file.is_open()) {
-        std::cout << "订单数据文件不存在，将创建新文件。" << std::endl;
+        Logger::getInstance()->info("OrderManager", "订单数据文件不存在，将创建新文件", {{"path", filePath}});
         return true;
     }
     
@@ -122,7 +219,7 @@ bool OrderManager::loadFromFile() {
     bool isFirstLine = true;
     
     // 清空现有数据
-    std::lock_guard<std::mutex> lock(ordersMutex);
+    std::unique_lock<std::mutex> lock(ordersMutex);
     orders.clear();
     
     // 逐行读取文件
@@ -157,31 +254,46 @@ bool OrderManager::loadFromFile() {
                                                      status, statusChangeTime);
                 orders.push_back(order);
             } catch (const std::exception& e) {
-                std::cerr << "警告：解析订单数据失败: " << e.what() << std::endl;
+                Logger::getInstance()->warn("OrderManager", "解析订单数据失败", {{"error", e.what()}});
             }
         }
     }
     
     file.close();
-    std::cout << "成功加载 " << orders.size() << " 个订单数据。" << std::endl;
+    size_t renumbered = rebuildIndexes();
+    size_t count = orders.size();
+    lock.unlock();
+    
+    Logger::getInstance()->info("OrderManager", "成功加载订单数据",
+                                {{"count", std::to_string(count)}, {"path", filePath}});
+    
+    // 重新编号的订单立即写回，保证下次加载时编号不变
+    if (renumbered > 0 && !saveToFile()) {
+        Logger::getInstance()->warn("OrderManager", "重新编号后的订单保存失败",
+                                    {{"count", std::to_string(renumbered)}, {"path", filePath}});
+    }
     return true;
 }
 
 /**
  * @brief 保存订单数据到CSV文件
+ *
+ * 先写临时文件再替换原文件，写到一半中断时原文件保持完整
  */
 bool OrderManager::saveToFile() {
-    std::ofstream file(filePath);
+    // 打开文件前加锁，多个线程保存时不会交错写入同一文件
+    std::lock_guard<std::mutex> lock(ordersMutex);
+    std::string tempPath = filePath + ".tmp";
+    std::ofstream file(tempPath, std::ios::trunc);
     if (!file.is_open()) {
-        std::cerr << "无法打开文件进行写入: " << filePath << std::endl;
+        Logger::getInstance()->error("OrderManager", "无法打开文件进行写入", {{"path", tempPath}});
         return false;
     }
     
     // 写入标题行
-    file << "order_id,user_id,items,order_time,total_amount,shipping_address,status,status_change_time" << std::endl;
+    file << "order_id,user_id,items,order_time,total_amount,shipping_address,status,status_change_time" << '\n';
     
-    // 写入每个订单的数据
-    std::lock_guard<std::mutex> lock(ordersMutex);
+    // 写入每个订单的数据（逐行不刷新，关闭时一次写出）
     for (const auto& order : orders) {
         file << order->getOrderId() << ","
              << order->getUserId() << ","
@@ -190,45 +302,135 @@ bool OrderManager::saveToFile() {
              << order->getTotalAmount() << ","
              << order->getShippingAddress() << ","
              << order->getStatusString() << ","
-             << order->getStatusChangeTime() << std::endl;
+             << order->getStatusChangeTime() << '\n';
     }
     
     file.close();
+    if (file.fail()) {
+        Logger::getInstance()->error("OrderManager", "写入订单临时文件失败", {{"path", tempPath}});
+        return false;
+    }
+    
+    std::error_code ec;
+    std::filesystem::rename(tempPath, filePath, ec);
+    if (ec) {
+        Logger::getInstance()->error("OrderManager", "替换订单数据文件失败",
+                                     {{"path", filePath}, {"error", ec.message()}});
+        return false;
+    }
     return true;
 }
 
 /**
- * @brief 创建新订单
+ * @brief 将全部订单导出为压缩归档文件
  */
-std::shared_ptr<Order> OrderManager::createOrder(
-    const std::string& userId,
-    const std::vector<std::pair<std::shared_ptr<Item>, int>>& cartItems,
-    const std::string& shippingAddress) {
+bool OrderManager::exportToArchive(const std::string& archivePath) const {
+    std::vector<std::shared_ptr<Order>> snapshot;
+    {
+        std::lock_guard<std::mutex> lock(ordersMutex);
+        snapshot = orders;
+    }
     
-    try {
-        // 创建新订单（订单构造函数中会检查库存并更新）
-        auto order = std::make_shared<Order>(userId, cartItems, shippingAddress, itemManager.get());
-        
-        // 添加到订单列表
+    OrderArchive archive(archivePath);
+    if (!archive.write(snapshot)) {
+        return false;
+    }
+    
+    Logger::getInstance()->info("OrderManager", "订单已导出到归档",
+                                {{"count", std::to_string(snapshot.size())}, {"path", archivePath}});
+    return true;
+}
+
+/**
+ * @brief 从压缩归档文件加载订单数据
+ */
+bool OrderManager::loadFromArchive(const std::string& archivePath) {
+    std::vector<std::shared_ptr<Order>> loaded;
+    OrderArchive archive(archivePath);
+    if (!archive.readAll(loaded)) {
+        return false;
+    }
+    
+    size_t count;
+    {
+        std::lock_guard<std::mutex> lock(ordersMutex);
+        orders.swap(loaded);
+        rebuildIndexes();
+        count = orders.size();
+    }
+    
+    Logger::getInstance()->info("OrderManager", "成功从归档加载订单数据",
+                                {{"count", std::to_string(count)}, {"path", archivePath}});
+    return true;
+}
+
+/**
+ * @brief 按时间范围扫描归档文件
+ */
+bool OrderManager::scanArchiveByTime(const std::string& archivePath, time_t from, time_t to,
+                                     std::vector<std::shared_ptr<Order>>& result) const {
+    result.clear();
+    OrderArchive archive(archivePath);
+    if (!archive.scanTimeRange(from, to, result)) {
+        result.clear();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 分配订单编号
+ */
+std::string OrderManager::allocateOrderId(const std::string& userId, time_t timestamp) {
+    std::lock_guard<std::mutex> lock(ordersMutex);
+    return nextOrderId(userId, timestamp);
+}
+
+/**
+ * @brief 批量提交订单
+ */
+bool OrderManager::commitOrders(const std::vector<std::shared_ptr<Order>>& batch) {
+    if (batch.empty()) {
+        return true;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(ordersMutex);
+        for (const auto& order : batch) {
+            orders.push_back(order);
+            indexOrder(order);
+        }
+    }
+    
+    if (!saveToFile()) {
+        std::unordered_set<const Order*> failed;
+        for (const auto& order : batch) {
+            failed.insert(order.get());
+        }
         {
             std::lock_guard<std::mutex> lock(ordersMutex);
-            orders.push_back(order);
+            orders.erase(std::remove_if(orders.begin(), orders.end(),
+                                        [&failed](const std::shared_ptr<Order>& order) {
+                                            return failed.count(order.get()) > 0;
+                                        }),
+                         orders.end());
+            rebuildIndexes();
         }
-        
-        // 保存到文件
-        saveToFile();
-        
-        std::cout << "\n订单创建成功！订单编号：" << order->getOrderId() << std::endl;
-        return order;
-        
-    } catch (const InsufficientStockException& e) {
-        // 捕获库存不足异常
-        std::cerr << "\n创建订单失败：" << e.what() << std::endl;
-        return nullptr;
-    } catch (const std::exception& e) {
-        std::cerr << "\n创建订单失败：" << e.what() << std::endl;
-        return nullptr;
+        Logger::getInstance()->error("OrderManager", "批量提交订单失败，已撤销本批订单",
+                                     {{"count", std::to_string(batch.size())}, {"path", filePath}});
+        return false;
     }
+    
+    for (const auto& order : batch) {
+        for (auto* observer : orderObservers) {
+            observer->onOrderCreated(*order);
+        }
+        Logger::getInstance()->debug("OrderManager", "订单创建成功",
+                                     {{"order_id", order->getOrderId()}, {"user", order->getUserId()},
+                                      {"items", std::to_string(order->getItems().size())}});
+    }
+    Logger::getInstance()->info("OrderManager", "批量提交订单", {{"count", std::to_string(batch.size())}});
+    return true;
 }
 
 /**
@@ -237,13 +439,9 @@ std::shared_ptr<Order> OrderManager::createOrder(
 std::shared_ptr<Order> OrderManager::findOrderById(const std::string& orderId) {
     std::lock_guard<std::mutex> lock(ordersMutex);
     
-    auto it = std::find_if(orders.begin(), orders.end(),
-        [&orderId](const std::shared_ptr<Order>& order) {
-            return order->getOrderId() == orderId;
-        });
-    
-    if (it != orders.end()) {
-        return *it;
+    auto it = orderById.find(orderId);
+    if (it != orderById.end()) {
+        return it->second;
     }
     
     return nullptr;
@@ -257,9 +455,11 @@ std::vector<std::shared_ptr<Order>> OrderManager::getOrdersByUserId(const std::s
     
     std::lock_guard<std::mutex> lock(ordersMutex);
     
-    for (const auto& order : orders) {
-        if (order->getUserId() == userId) {
-            userOrders.push_back(order);
+    auto it = userTimelines.find(userId);
+    if (it != userTimelines.end()) {
+        userOrders.reserve(it->second.size());
+        for (const auto& entry : it->second.getEntries()) {
+            userOrders.push_back(entry.second);
         }
     }
     
@@ -270,105 +470,205 @@ std::vector<std::shared_ptr<Order>> OrderManager::getOrdersByUserId(const std::s
  * @brief 更新订单状态
  */
 bool OrderManager::updateOrderStatus(const std::string& orderId, OrderStatus newStatus) {
-    auto order = findOrderById(orderId);
+    std::shared_ptr<Order> order;
+    {
+        std::lock_guard<std::mutex> lock(ordersMutex);
+        auto it = orderById.find(orderId);
+        if (it != orderById.end()) {
+            order = it->second;
+            applyStatus(order, newStatus);
+        }
+    }
     
     if (order == nullptr) {
-        std::cout << "错误：订单不存在！" << std::endl;
+        Logger::getInstance()->warn("OrderManager", "更新状态失败：订单不存在", {{"order_id", orderId}});
         return false;
     }
     
-    order->setStatus(newStatus);
     saveToFile();
     
-    std::cout << "订单状态已更新为：" << order->getStatusString() << std::endl;
+    Logger::getInstance()->info("OrderManager", "订单状态已更新",
+                                {{"order_id", orderId}, {"status", order->getStatusString()}});
     return true;
 }
 
 /**
- * @brief 显示所有订单信息（表格形式）
+ * @brief 将订单转换为订单行快照
  */
-void OrderManager::displayAllOrders() const {
+OrderRow OrderManager::toOrderRow(const Order& order) {
+    return OrderRow{order.getOrderId(), order.getUserId(), order.getOrderTime(),
+                    order.getTotalAmount(), order.getStatusString()};
+}
+
+/**
+ * @brief 查询所有订单
+ */
+std::vector<OrderRow> OrderManager::queryAllOrders() const {
     std::lock_guard<std::mutex> lock(ordersMutex);
     
-    if (orders.empty()) {
-        std::cout << "暂无订单信息。" << std::endl;
-        return;
+    std::vector<OrderRow> rows;
+    rows.reserve(orders.size());
+    for (const auto& order : orders) {
+        rows.push_back(toOrderRow(*order));
     }
+    return rows;
+}
+
+/**
+ * @brief 查询某个用户的订单
+ */
+std::vector<OrderRow> OrderManager::queryUserOrders(const std::string& userId) const {
+    std::lock_guard<std::mutex> lock(ordersMutex);
     
-    std::cout << "\n========== 订单列表 ==========" << std::endl;
-    std::cout << std::left
-              << std::setw(20) << "订单编号"
-              << std::setw(15) << "用户ID"
-              << std::setw(20) << "订单时间"
-              << std::setw(12) << "订单总额"
-              << std::setw(12) << "订单状态"
-              << std::endl;
-    std::cout << "-------------------------------------------------------------------------------" << std::endl;
+    std::vector<OrderRow> rows;
+    auto it = userTimelines.find(userId);
+    if (it != userTimelines.end()) {
+        rows.reserve(it->second.size());
+        for (const auto& entry : it->second.getEntries()) {
+            rows.push_back(toOrderRow(*entry.second));
+        }
+    }
+    return rows;
+}
+
+/**
+ * @brief 按排序字段分页查询订单
+ */
+ListPage<OrderRow> OrderManager::queryOrderPage(OrderSortKey sortKey, bool descending,
+                                                const std::string& cursor, size_t limit) const {
+    std::lock_guard<std::mutex> lock(ordersMutex);
     
-    for (const auto& order : orders) {
-        // 格式化订单时间
-        char timeBuffer[20];
-        time_t orderTime = order->getOrderTime();
-        struct tm* timeinfo = std::localtime(&orderTime);
-        std::strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%d %H:%M:%S", timeinfo);
-        
-        std::cout << std::left
-                  << std::setw(20) << order->getOrderId()
-                  << std::setw(15) << order->getUserId()
-                  << std::setw(20) << timeBuffer
-                  << std::setw(12) << std::fixed << std::setprecision(2) << order->getTotalAmount()
-                  << std::setw(12) << order->getStatusString()
-                  << std::endl;
+    ListPage<OrderRow> page;
+    page.totalCount = orders.size();
+    
+    std::vector<std::string> ids;
+    switch (sortKey) {
+        case OrderSortKey::TIME:
+            page.invalidCursor = !timeIndex.page(cursor, descending, limit, ids, page.nextCursor);
+            break;
+        case OrderSortKey::AMOUNT:
+            page.invalidCursor = !amountIndex.page(cursor, descending, limit, ids, page.nextCursor);
+            break;
+        case OrderSortKey::STATUS:
+            page.invalidCursor = !statusIndex.page(cursor, descending, limit, ids, page.nextCursor);
+            break;
     }
     
-    std::cout << "===============================================================================" << std::endl;
-    std::cout << "共 " << orders.size() << " 个订单。" << std::endl;
+    page.rows.reserve(ids.size());
+    for (const auto& orderId : ids) {
+        page.rows.push_back(toOrderRow(*orderById.at(orderId)));
+    }
+    return page;
 }
 
 /**
- * @brief 显示用户的订单信息
+ * @brief 获取某个状态的订单数量
  */
-void OrderManager::displayUserOrders(const std::string& userId) const {
+size_t OrderManager::countOrdersByStatus(OrderStatus status) const {
+    return statusCounts[static_cast<size_t>(status)].load();
+}
+
+/**
+ * @brief 获取某个状态的全部订单
+ */
+std::vector<std::shared_ptr<Order>> OrderManager::getOrdersByStatus(OrderStatus status) const {
     std::lock_guard<std::mutex> lock(ordersMutex);
     
-    std::vector<std::shared_ptr<Order>> userOrders;
-    for (const auto& order : orders) {
-        if (order->getUserId() == userId) {
-            userOrders.push_back(order);
+    const auto& members = statusMembers[static_cast<size_t>(status)];
+    std::vector<std::shared_ptr<Order>> result;
+    result.reserve(members.size());
+    for (const auto& entry : members) {
+        result.push_back(entry.second);
+    }
+    return result;
+}
+
+/**
+ * @brief 查询某个状态的全部订单
+ */
+std::vector<OrderRow> OrderManager::queryOrdersByStatus(OrderStatus status) const {
+    std::vector<OrderRow> rows;
+    {
+        std::lock_guard<std::mutex> lock(ordersMutex);
+        const auto& members = statusMembers[static_cast<size_t>(status)];
+        rows.reserve(members.size());
+        for (const auto& entry : members) {
+            rows.push_back(toOrderRow(*entry.second));
         }
     }
     
-    if (userOrders.empty()) {
-        std::cout << "\n您还没有订单。" << std::endl;
-        return;
+    std::sort(rows.begin(), rows.end(), [](const OrderRow& a, const OrderRow& b) {
+        return a.orderTime != b.orderTime ? a.orderTime < b.orderTime : a.orderId < b.orderId;
+    });
+    return rows;
+}
+
+/**
+ * @brief 获取时间范围内的订单
+ */
+std::vector<std::shared_ptr<Order>> OrderManager::getOrdersInTimeRange(time_t from, time_t to) const {
+    std::lock_guard<std::mutex> lock(ordersMutex);
+    
+    auto bounds = timeline.range(from, to);
+    std::vector<std::shared_ptr<Order>> result;
+    result.reserve(std::distance(bounds.first, bounds.second));
+    for (auto it = bounds.first; it != bounds.second; ++it) {
+        result.push_back(it->second);
     }
+    return result;
+}
+
+/**
+ * @brief 获取某个用户在时间范围内的订单
+ */
+std::vector<std::shared_ptr<Order>> OrderManager::getUserOrdersInTimeRange(const std::string& userId,
+                                                                           time_t from, time_t to) const {
+    std::lock_guard<std::mutex> lock(ordersMutex);
     
-    std::cout << "\n========== 我的订单 ==========" << std::endl;
-    std::cout << std::left
-              << std::setw(20) << "订单编号"
-              << std::setw(20) << "订单时间"
-              << std::setw(12) << "订单总额"
-              << std::setw(12) << "订单状态"
-              << std::endl;
-    std::cout << "------------------------------------------------------------" << std::endl;
-    
-    for (const auto& order : userOrders) {
-        // 格式化订单时间
-        char timeBuffer[20];
-        time_t orderTime = order->getOrderTime();
-        struct tm* timeinfo = std::localtime(&orderTime);
-        std::strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%d %H:%M:%S", timeinfo);
-        
-        std::cout << std::left
-                  << std::setw(20) << order->getOrderId()
-                  << std::setw(20) << timeBuffer
-                  << std::setw(12) << std::fixed << std::setprecision(2) << order->getTotalAmount()
-                  << std::setw(12) << order->getStatusString()
-                  << std::endl;
+    std::vector<std::shared_ptr<Order>> result;
+    auto userIt = userTimelines.find(userId);
+    if (userIt == userTimelines.end()) {
+        return result;
     }
     
-    std::cout << "============================================================" << std::endl;
-    std::cout << "共 " << userOrders.size() << " 个订单。" << std::endl;
+    auto bounds = userIt->second.range(from, to);
+    for (auto it = bounds.first; it != bounds.second; ++it) {
+        result.push_back(it->second);
+    }
+    return result;
+}
+
+/**
+ * @brief 获取时间范围内处于某个状态的订单
+ * 
+ * 状态集合无序，因此以时间范围为主扫描，再按状态过滤
+ */
+std::vector<std::shared_ptr<Order>> OrderManager::getOrdersInTimeRangeByStatus(time_t from, time_t to,
+                                                                               OrderStatus status) const {
+    std::lock_guard<std::mutex> lock(ordersMutex);
+    
+    auto bounds = timeline.range(from, to);
+    std::vector<std::shared_ptr<Order>> result;
+    for (auto it = bounds.first; it != bounds.second; ++it) {
+        if (it->second->getStatus() == status) {
+            result.push_back(it->second);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 显示所有订单信息
+ */
+void OrderManager::displayAllOrders() const {
+    ListingRenderer::renderOrders(queryAllOrders(), true, RenderFormat::CONSOLE, std::cout);
+}
+
+/**
+ * @brief 显示用户的订单信息
+ */
+void OrderManager::displayUserOrders(const std::string& userId) const {
+    ListingRenderer::renderOrders(queryUserOrders(userId), false, RenderFormat::CONSOLE, std::cout);
 }
 
 /**
@@ -385,26 +685,31 @@ void OrderManager::autoUpdateOrderStatus() {
         {
             std::lock_guard<std::mutex> lock(ordersMutex);
             
-            for (auto& order : orders) {
-                time_t timeSinceStatusChange = currentTime - order->getStatusChangeTime();
-                
+            // 只遍历待发货和已发货的订单，已签收订单不再参与检查
+            std::vector<std::shared_ptr<Order>> toShip;
+            std::vector<std::shared_ptr<Order>> toDeliver;
+            
+            for (const auto& entry : statusMembers[static_cast<size_t>(OrderStatus::PENDING)]) {
                 // 待发货 -> 已发货
-                if (order->getStatus() == OrderStatus::PENDING && 
-                    timeSinceStatusChange >= pendingToShippedSeconds) {
-                    order->setStatus(OrderStatus::SHIPPED);
-                    needSave = true;
-                    // std::cout << "\n[自动更新] 订单 " << order->getOrderId() 
-                    //           << " 状态已更新为：已发货" << std::endl;
+                if (currentTime - entry.second->getStatusChangeTime() >= pendingToShippedSeconds) {
+                    toShip.push_back(entry.second);
                 }
+            }
+            for (const auto& entry : statusMembers[static_cast<size_t>(OrderStatus::SHIPPED)]) {
                 // 已发货 -> 已签收
-                else if (order->getStatus() == OrderStatus::SHIPPED && 
-                         timeSinceStatusChange >= shippedToDeliveredSeconds) {
-                    order->setStatus(OrderStatus::DELIVERED);
-                    needSave = true;
-                    // std::cout << "\n[自动更新] 订单 " << order->getOrderId() 
-                    //           << " 状态已更新为：已签收" << std::endl;
+                if (currentTime - entry.second->getStatusChangeTime() >= shippedToDeliveredSeconds) {
+                    toDeliver.push_back(entry.second);
                 }
             }
+            
+            // 先收集再修改，避免在遍历集合时修改集合
+            for (const auto& order : toDeliver) {
+                applyStatus(order, OrderStatus::DELIVERED);
+            }
+            for (const auto& order : toShip) {
+                applyStatus(order, OrderStatus::SHIPPED);
+            }
+            needSave = !toShip.empty() || !toDeliver.empty();
         }
         
         if (needSave) {
@@ -413,12 +718,30 @@ void OrderManager::autoUpdateOrderStatus() {
     }
 }
 
+/**
+ * @brief 注册订单观察者
+ */
+void OrderManager::addOrderObserver(IOrderObserver* observer) {
+    if (observer != nullptr &&
+        std::find(orderObservers.begin(), orderObservers.end(), observer) == orderObservers.end()) {
+        orderObservers.push_back(observer);
+    }
+}
+
+/**
+ * @brief 注销订单观察者
+ */
+void OrderManager::removeOrderObserver(IOrderObserver* observer) {
+    orderObservers.erase(std::remove(orderObservers.begin(), orderObservers.end(), observer),
+                         orderObservers.end());
+}
+
 /**
  * @brief 启用自动状态更新
  */
 void OrderManager::enableAutoUpdate(int pendingToShipped, int shippedToDelivered) {
     if (autoUpdateEnabled) {
-        std::cout << "自动状态更新已经启用。" << std::endl;
+        Logger::getInstance()->debug("OrderManager", "自动状态更新已经启用");
         return;
     }
     
@@ -429,9 +752,9 @@ void OrderManager::enableAutoUpdate(int pendingToShipped, int shippedToDelivered
     // 启动自动更新线程
     autoUpdateThread = std::thread(&OrderManager::autoUpdateOrderStatus, this);
     
-    std::cout << "自动状态更新已启用。" << std::endl;
-    std::cout << "待发货->已发货: " << pendingToShipped << "秒" << std::endl;
-    std::cout << "已发货->已签收: " << shippedToDelivered << "秒" << std::endl;
+    Logger::getInstance()->info("OrderManager", "自动状态更新已启用",
+                                {{"pending_to_shipped_seconds", std::to_string(pendingToShipped)},
+                                 {"shipped_to_delivered_seconds", std::to_string(shippedToDelivered)}});
 }
 
 /**
@@ -449,7 +772,7 @@ void OrderManager::disableAutoUpdate() {
         autoUpdateThread.join();
     }
     
-    std::cout << "自动状态更新已禁用。" << std::endl;
+    Logger::getInstance()->info("OrderManager", "自动状态更新已禁用");
 }
 
 /**
@@ -0,0 +1,53 @@
+/**
+ * @file OrderTimeline.cpp
+ * @brief 订单时间索引的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Order/OrderTimeline.h"
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief 按时间比较条目（只比较时间）
+ */
+bool entryBefore(const OrderTimeline::Entry& a, const OrderTimeline::Entry& b) {
+    return a.first < b.first;
+}
+
+} // namespace
+
+/**
+ * @brief 插入一个订单
+ */
+void OrderTimeline::insert(const std::shared_ptr<Order>& order) {
+    Entry entry(order->getOrderTime(), order);
+
+    // 快速路径：按时间顺序到达的订单直接追加
+    if (entries.empty() || entries.back().first <= entry.first) {
+        entries.push_back(std::move(entry));
+        return;
+    }
+
+    // 乱序到达：插入到相同时间的订单之后，保持稳定顺序
+    auto pos = std::upper_bound(entries.begin(), entries.end(), entry, entryBefore);
+    entries.insert(pos, std::move(entry));
+}
+
+/**
+ * @brief 定位时间范围对应的区间
+ */
+std::pair<std::vector<OrderTimeline::Entry>::const_iterator, std::vector<OrderTimeline::Entry>::const_iterator>
+OrderTimeline::range(time_t from, time_t to) const {
+    if (from > to) {
+        return {entries.end(), entries.end()};
+    }
+
+    auto first = std::lower_bound(entries.begin(), entries.end(), from,
+        [](const Entry& entry, time_t time) { return entry.first < time; });
+    auto last = std::upper_bound(first, entries.end(), to,
+        [](time_t time, const Entry& entry) { return time < entry.first; });
+    return {first, last};
+}
@@ -0,0 +1,572 @@
+/**
+ * @file WaitlistManager.cpp
+ * @brief 到货候补队列的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Order/WaitlistManager.h"
+#include "Log/Logger.h"
+#include <algorithm>
+#include <filesystem>
+#include <future>
+#include <cstring>
+
+namespace {
+
+const char WAITLIST_MAGIC[8] = {'W', 'A', 'I', 'T', 'L', 'S', 'T', '1'};  // 日志魔数
+const size_t HEADER_SIZE = 8;               // 文件头字节数
+const size_t RECORD_HEADER_SIZE = 27;       // 记录头部字节数
+const size_t MAX_FIELD_LENGTH = 0xFFFF;     // 字符串字段的最大长度
+const uint64_t COMPACT_MIN_RECORDS = 1024;  // 日志至少有这么多条记录才考虑压缩
+
+const uint8_t RECORD_JOIN = 1;              // 加入候补
+const uint8_t RECORD_CANCEL = 2;            // 取消候补
+const uint8_t RECORD_SERVED = 3;            // 已自动下单
+const uint8_t RECORD_NOTIFIED = 4;          // 顾客已查看到货通知
+
+/**
+ * @brief 按小端序写入整数
+ */
+void putLE(char* buf, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        buf[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+/**
+ * @brief 按小端序读取整数
+ */
+uint64_t getLE(const char* buf, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(buf[i])) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief 编码一条日志记录
+ */
+std::string encodeRecord(uint8_t type, uint64_t ticket, int64_t time, int32_t quantity,
+                         const std::string& itemId, const std::string& userId, const std::string& text) {
+    std::string record(RECORD_HEADER_SIZE, '\0');
+    record[0] = static_cast<char>(type);
+    putLE(&record[1], ticket, 8);
+    putLE(&record[9], static_cast<uint64_t>(time), 8);
+    putLE(&record[17], static_cast<uint32_t>(quantity), 4);
+    putLE(&record[21], itemId.size(), 2);
+    putLE(&record[23], userId.size(), 2);
+    putLE(&record[25], text.size(), 2);
+    record += itemId;
+    record += userId;
+    record += text;
+    return record;
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数实现
+ */
+WaitlistManager::WaitlistManager(const std::string& filePath)
+    : filePath(filePath), nextTicket(1), recordCount(0) {
+}
+
+/**
+ * @brief 获取字符串编号
+ */
+uint32_t WaitlistManager::intern(const std::string& value) {
+    auto it = stringIds.find(value);
+    if (it != stringIds.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(strings.size());
+    strings.push_back(value);
+    stringIds.emplace(value, id);
+    return id;
+}
+
+/**
+ * @brief 生成用户名+商品ID的去重键
+ */
+std::string WaitlistManager::waitingKey(const std::string& userId, const std::string& itemId) {
+    return userId + '\x1f' + itemId;
+}
+
+/**
+ * @brief 在队列中移除指定编号的候补
+ */
+bool WaitlistManager::removeTicket(const std::string& itemId, uint64_t ticket, Entry* removed) {
+    auto queue = queues.find(itemId);
+    if (queue == queues.end()) {
+        return false;
+    }
+    auto& entries = queue->second;
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [ticket](const Entry& entry) { return entry.ticket == ticket; });
+    if (it == entries.end()) {
+        return false;
+    }
+    if (removed) {
+        *removed = *it;
+    }
+    entries.erase(it);
+    if (entries.empty()) {
+        queues.erase(queue);
+    }
+    return true;
+}
+
+/**
+ * @brief 生成候补记录的展示结构
+ */
+WaitlistEntryView WaitlistManager::view(const std::string& itemId, const Entry& entry, size_t position) const {
+    WaitlistEntryView result;
+    result.ticket = entry.ticket;
+    result.itemId = itemId;
+    result.userId = strings[entry.user];
+    result.quantity = entry.quantity;
+    result.shippingAddress = strings[entry.address];
+    result.joinedAt = static_cast<time_t>(entry.joinedAt);
+    result.position = position;
+    return result;
+}
+
+/**
+ * @brief 追加一条日志记录
+ */
+bool WaitlistManager::appendLog(uint8_t type, uint64_t ticket, int64_t time, int32_t quantity,
+                                const std::string& itemId, const std::string& userId, const std::string& text) {
+    if (!writer.is_open()) {
+        return false;
+    }
+    std::string record = encodeRecord(type, ticket, time, quantity, itemId, userId, text);
+    writer.write(record.data(), static_cast<std::streamsize>(record.size()));
+    writer.flush();
+    if (!writer) {
+        writer.clear();
+        Logger::getInstance()->error("WaitlistManager", "写入候补记录失败",
+                                     {{"path", filePath}, {"item", itemId}, {"user", userId}});
+        return false;
+    }
+    ++recordCount;
+    return true;
+}
+
+/**
+ * @brief 有效记录数
+ */
+size_t WaitlistManager::liveRecords() const {
+    size_t count = 0;
+    for (const auto& queue : queues) {
+        count += queue.second.size();
+    }
+    for (const auto& list : notices) {
+        count += list.second.size();
+    }
+    return count;
+}
+
+/**
+ * @brief 加载日志
+ *
+ * 顺序重放全部记录，末尾不完整的记录（写入中断）被截断
+ */
+bool WaitlistManager::loadFromFile() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::error_code ec;
+    uintmax_t fileSize = std::filesystem::exists(filePath, ec) ? std::filesystem::file_size(filePath, ec) : 0;
+    queues.clear();
+    waitingKeys.clear();
+    notices.clear();
+    recordCount = 0;
+
+    if (fileSize < HEADER_SIZE) {
+        std::ofstream create(filePath, std::ios::binary | std::ios::trunc);
+        if (!create.is_open()) {
+            Logger::getInstance()->error("WaitlistManager", "无法创建候补记录文件", {{"path", filePath}});
+            return false;
+        }
+        create.write(WAITLIST_MAGIC, HEADER_SIZE);
+    } else {
+        std::ifstream in(filePath, std::ios::binary);
+        std::vector<char> data(static_cast<size_t>(fileSize));
+        if (!in.read(data.data(), static_cast<std::streamsize>(data.size())) ||
+            std::memcmp(data.data(), WAITLIST_MAGIC, HEADER_SIZE) != 0) {
+            Logger::getInstance()->error("WaitlistManager", "候补记录文件格式错误", {{"path", filePath}});
+            return false;
+        }
+        in.close();
+
+        size_t offset = HEADER_SIZE;
+        while (offset + RECORD_HEADER_SIZE <= data.size()) {
+            const char* head = data.data() + offset;
+            uint8_t type = static_cast<uint8_t>(head[0]);
+            uint64_t ticket = getLE(head + 1, 8);
+            int64_t time = static_cast<int64_t>(getLE(head + 9, 8));
+            int32_t quantity = static_cast<int32_t>(static_cast<uint32_t>(getLE(head + 17, 4)));
+            size_t itemLength = static_cast<size_t>(getLE(head + 21, 2));
+            size_t userLength = static_cast<size_t>(getLE(head + 23, 2));
+            size_t textLength = static_cast<size_t>(getLE(head + 25, 2));
+            size_t end = offset + RECORD_HEADER_SIZE + itemLength + userLength + textLength;
+            if (end > data.size()) {
+                break;
+            }
+            const char* body = head + RECORD_HEADER_SIZE;
+            std::string itemId(body, itemLength);
+            std::string userId(body + itemLength, userLength);
+            std::string text(body + itemLength + userLength, textLength);
+
+            if (type == RECORD_JOIN) {
+                Entry entry{ticket, time, intern(userId), intern(text), quantity};
+                queues[itemId].push_back(entry);
+                waitingKeys[waitingKey(userId, itemId)] = ticket;
+            } else if (type == RECORD_CANCEL || type == RECORD_SERVED) {
+                removeTicket(itemId, ticket, nullptr);
+                waitingKeys.erase(waitingKey(userId, itemId));
+                if (type == RECORD_SERVED) {
+                    notices[userId].push_back(WaitlistNotice{ticket, itemId, userId, quantity, text,
+                                                             static_cast<time_t>(time)});
+                }
+            } else if (type == RECORD_NOTIFIED) {
+                auto list = notices.find(userId);
+                if (list != notices.end()) {
+                    auto& items = list->second;
+                    items.erase(std::remove_if(items.begin(), items.end(),
+                                               [ticket](const WaitlistNotice& n) { return n.ticket == ticket; }),
+                                items.end());
+                    if (items.empty()) {
+                        notices.erase(list);
+                    }
+                }
+            }
+            nextTicket = std::max(nextTicket, ticket + 1);
+            ++recordCount;
+            offset = end;
+        }
+
+        if (offset != data.size()) {
+            std::filesystem::resize_file(filePath, offset, ec);
+            Logger::getInstance()->warn("WaitlistManager", "截断不完整的候补记录",
+                                        {{"path", filePath}, {"bytes", std::to_string(data.size() - offset)}});
+        }
+    }
+
+    writer.close();
+    writer.open(filePath, std::ios::binary | std::ios::app);
+    if (!writer.is_open()) {
+        Logger::getInstance()->error("WaitlistManager", "无法打开候补记录文件", {{"path", filePath}});
+        return false;
+    }
+
+    size_t live = liveRecords();
+    if (recordCount >= COMPACT_MIN_RECORDS && recordCount > 2 * live) {
+        compact();
+    }
+
+    Logger::getInstance()->info("WaitlistManager", "候补记录已加载",
+                                {{"records", std::to_string(recordCount)}, {"live", std::to_string(live)}});
+    return true;
+}
+
+/**
+ * @brief 把当前队列和通知重写为紧凑日志
+ *
+ * 先写临时文件再替换，替换失败时保留原日志；队列按原编号和时间重写，排队顺序不变
+ */
+bool WaitlistManager::compact() {
+    std::string tempPath = filePath + ".tmp";
+    uint64_t written = 0;
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(WAITLIST_MAGIC, HEADER_SIZE);
+        for (const auto& queue : queues) {
+            for (const auto& entry : queue.second) {
+                std::string record = encodeRecord(RECORD_JOIN, entry.ticket, entry.joinedAt, entry.quantity,
+                                                  queue.first, strings[entry.user], strings[entry.address]);
+                out.write(record.data(), static_cast<std::streamsize>(record.size()));
+                ++written;
+            }
+        }
+        for (const auto& list : notices) {
+            for (const auto& notice : list.second) {
+                std::string record = encodeRecord(RECORD_SERVED, notice.ticket, notice.servedAt, notice.quantity,
+                                                  notice.itemId, notice.userId, notice.orderId);
+                out.write(record.data(), static_cast<std::streamsize>(record.size()));
+                ++written;
+            }
+        }
+        out.flush();
+        if (!out) {
+            Logger::getInstance()->warn("WaitlistManager", "压缩候补记录失败", {{"path", tempPath}});
+            return false;
+        }
+    }
+
+    writer.close();
+    std::error_code ec;
+    std::filesystem::rename(tempPath, filePath, ec);
+    writer.open(filePath, std::ios::binary | std::ios::app);
+    if (ec) {
+        Logger::getInstance()->warn("WaitlistManager", "替换候补记录失败", {{"path", filePath}});
+        return false;
+    }
+
+    Logger::getInstance()->info("WaitlistManager", "候补记录已压缩",
+                                {{"before", std::to_string(recordCount)}, {"after", std::to_string(written)}});
+    recordCount = written;
+    return true;
+}
+
+/**
+ * @brief 加入候补
+ */
+WaitlistJoinStatus WaitlistManager::join(const std::string& userId, const std::string& itemId, int quantity,
+                                         const std::string& shippingAddress, size_t* position) {
+    if (quantity <= 0 || userId.empty() || itemId.empty() || shippingAddress.empty() ||
+        userId.size() > MAX_FIELD_LENGTH || itemId.size() > MAX_FIELD_LENGTH ||
+        shippingAddress.size() > MAX_FIELD_LENGTH) {
+        return WaitlistJoinStatus::INVALID;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto existing = waitingKeys.find(waitingKey(userId, itemId));
+    if (existing != waitingKeys.end()) {
+        if (position) {
+            *position = 0;
+            auto queue = queues.find(itemId);
+            if (queue != queues.end()) {
+                for (size_t i = 0; i < queue->second.size(); ++i) {
+                    if (queue->second[i].ticket == existing->second) {
+                        *position = i + 1;
+                        break;
+                    }
+                }
+            }
+        }
+        return WaitlistJoinStatus::ALREADY_WAITING;
+    }
+
+    uint64_t ticket = nextTicket;
+    int64_t now = static_cast<int64_t>(std::time(nullptr));
+    if (!appendLog(RECORD_JOIN, ticket, now, quantity, itemId, userId, shippingAddress)) {
+        return WaitlistJoinStatus::WRITE_FAILED;
+    }
+    ++nextTicket;
+    auto& queue = queues[itemId];
+    queue.push_back(Entry{ticket, now, intern(userId), intern(shippingAddress), quantity});
+    waitingKeys.emplace(waitingKey(userId, itemId), ticket);
+    if (position) {
+        *position = queue.size();
+    }
+
+    Logger::getInstance()->info("WaitlistManager", "加入到货候补",
+                                {{"item", itemId}, {"user", userId}, {"quantity", std::to_string(quantity)},
+                                 {"position", std::to_string(queue.size())}});
+    return WaitlistJoinStatus::JOINED;
+}
+
+/**
+ * @brief 取消候补
+ *
+ * 正在分配中的候补已离开队列，此时取消失败
+ */
+bool WaitlistManager::cancel(const std::string& userId, const std::string& itemId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string key = waitingKey(userId, itemId);
+    auto existing = waitingKeys.find(key);
+    if (existing == waitingKeys.end()) {
+        return false;
+    }
+    Entry removed{};
+    if (!removeTicket(itemId, existing->second, &removed)) {
+        return false;
+    }
+    waitingKeys.erase(existing);
+    appendLog(RECORD_CANCEL, removed.ticket, static_cast<int64_t>(std::time(nullptr)), removed.quantity,
+              itemId, userId, "");
+    Logger::getInstance()->info("WaitlistManager", "取消到货候补", {{"item", itemId}, {"user", userId}});
+    return true;
+}
+
+/**
+ * @brief 获取商品的候补队列
+ */
+std::vector<WaitlistEntryView> WaitlistManager::getItemWaitlist(const std::string& itemId) const {
+    std::vector<WaitlistEntryView> result;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto queue = queues.find(itemId);
+    if (queue != queues.end()) {
+        for (size_t i = 0; i < queue->second.size(); ++i) {
+            result.push_back(view(itemId, queue->second[i], i + 1));
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief 获取顾客的全部候补
+ */
+std::vector<WaitlistEntryView> WaitlistManager::getUserWaitlist(const std::string& userId) const {
+    std::vector<WaitlistEntryView> result;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto user = stringIds.find(userId);
+    if (user == stringIds.end()) {
+        return result;
+    }
+    for (const auto& queue : queues) {
+        for (size_t i = 0; i < queue.second.size(); ++i) {
+            if (queue.second[i].user == user->second) {
+                result.push_back(view(queue.first, queue.second[i], i + 1));
+            }
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const WaitlistEntryView& a, const WaitlistEntryView& b) {
+        return a.ticket < b.ticket;
+    });
+    return result;
+}
+
+/**
+ * @brief 获取各商品的候补汇总
+ */
+std::vector<WaitlistSummary> WaitlistManager::getSummary() const {
+    std::vector<WaitlistSummary> result;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto& queue : queues) {
+            WaitlistSummary summary;
+            summary.itemId = queue.first;
+            summary.entries = queue.second.size();
+            for (const auto& entry : queue.second) {
+                summary.units += entry.quantity;
+            }
+            result.push_back(summary);
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const WaitlistSummary& a, const WaitlistSummary& b) {
+        return a.itemId < b.itemId;
+    });
+    return result;
+}
+
+/**
+ * @brief 按当前库存为商品的候补分配库存并批量下单
+ *
+ * 先在锁内从队首取出库存足够的候补，再在锁外一次性提交给流水线并等待全部结果，
+ * 流水线的持久化阶段把这些订单作为一批写入。请求键取候补编号，同一候补不会重复下单
+ */
+WaitlistServeResult WaitlistManager::serve(const std::string& itemId, IItemRepository* itemRepository,
+                                           CheckoutPipeline* checkoutPipeline) {
+    WaitlistServeResult result;
+    auto item = itemRepository->findItemById(itemId);
+    if (!item) {
+        return result;
+    }
+
+    std::vector<Entry> batch;
+    std::vector<CheckoutRequest> requests;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto queue = queues.find(itemId);
+        if (queue == queues.end()) {
+            return result;
+        }
+        long long available = item->getStock();
+        auto& entries = queue->second;
+        while (!entries.empty() && entries.front().quantity <= available) {
+            const Entry& entry = entries.front();
+            available -= entry.quantity;
+            CheckoutRequest request;
+            request.userId = strings[entry.user];
+            request.items.push_back({item, entry.quantity});
+            request.shippingAddress = strings[entry.address];
+            request.requestKey = "waitlist#" + std::to_string(entry.ticket);
+            requests.push_back(std::move(request));
+            batch.push_back(entry);
+            entries.pop_front();
+        }
+        if (entries.empty()) {
+            queues.erase(queue);
+        }
+    }
+    if (batch.empty()) {
+        return result;
+    }
+
+    std::vector<std::future<CheckoutOutcome>> futures;
+    for (auto& request : requests) {
+        futures.push_back(checkoutPipeline->submit(std::move(request)));
+    }
+    std::vector<CheckoutOutcome> outcomes;
+    for (auto& future : futures) {
+        outcomes.push_back(future.get());
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<Entry> failed;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const Entry& entry = batch[i];
+        const CheckoutOutcome& outcome = outcomes[i];
+        const std::string& userId = strings[entry.user];
+        bool created = (outcome.status == CheckoutStatus::CREATED || outcome.status == CheckoutStatus::DUPLICATE) &&
+                       outcome.order;
+        if (!created) {
+            failed.push_back(entry);
+            Logger::getInstance()->warn("WaitlistManager", "候补自动下单失败，放回队首",
+                                        {{"item", itemId}, {"user", userId}, {"reason", outcome.message}});
+            continue;
+        }
+        int64_t now = static_cast<int64_t>(std::time(nullptr));
+        appendLog(RECORD_SERVED, entry.ticket, now, entry.quantity, itemId, userId, outcome.order->getOrderId());
+        waitingKeys.erase(waitingKey(userId, itemId));
+        WaitlistNotice notice{entry.ticket, itemId, userId, entry.quantity, outcome.order->getOrderId(),
+                              static_cast<time_t>(now)};
+        notices[userId].push_back(notice);
+        result.notices.push_back(notice);
+        ++result.served;
+        result.allocatedUnits += entry.quantity;
+    }
+    if (!failed.empty()) {
+        auto& entries = queues[itemId];
+        entries.insert(entries.begin(), failed.begin(), failed.end());
+        result.requeued = failed.size();
+    }
+
+    Logger::getInstance()->info("WaitlistManager", "补货分配完成",
+                                {{"item", itemId}, {"served", std::to_string(result.served)},
+                                 {"units", std::to_string(result.allocatedUnits)},
+                                 {"requeued", std::to_string(result.requeued)}});
+    return result;
+}
+
+/**
+ * @brief 取出顾客未查看的到货通知
+ */
+std::vector<WaitlistNotice> WaitlistManager::takeNotices(const std::string& userId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto list = notices.find(userId);
+    if (list == notices.end()) {
+        return {};
+    }
+    std::vector<WaitlistNotice> result = std::move(list->second);
+    notices.erase(list);
+    int64_t now = static_cast<int64_t>(std::time(nullptr));
+    for (const auto& notice : result) {
+        appendLog(RECORD_NOTIFIED, notice.ticket, now, notice.quantity, notice.itemId, userId, "");
+    }
+    return result;
+}
+
+/**
+ * @brief 获取候补总数
+ */
+size_t WaitlistManager::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t count = 0;
+    for (const auto& queue : queues) {
+        count += queue.second.size();
+    }
+    return count;
+}
@@ -0,0 +1,803 @@
+/**
+ * @file CouponManager.cpp
+ * @brief 大规模一次性优惠券码管理器的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Promotion/CouponManager.h"
+#include "Log/Logger.h"
+#include <algorithm>
+#include <filesystem>
+#include <sstream>
+#include <random>
+#include <cstring>
+
+namespace {
+
+const char CODES_MAGIC[8] = {'C', 'P', 'N', 'C', 'O', 'D', 'E', '1'};  // 券码库魔数
+const char LOG_MAGIC[8] = {'C', 'P', 'N', 'R', 'L', 'O', 'G', '1'};    // 核销日志魔数
+const size_t HEADER_SIZE = 8;               // 文件头字节数
+const size_t CODE_RECORD_SIZE = 12;         // 券码库记录字节数
+const size_t LOG_RECORD_SIZE = 48;          // 核销日志记录字节数
+const size_t REFERENCE_OFFSET = 24;         // 关联单号字段偏移
+const size_t REFERENCE_SIZE = 24;           // 关联单号字段长度
+const size_t BATCH_RECORDS = 4096;          // 顺序读写时每批的记录数
+const uint8_t LOG_REDEEM = 1;               // 核销记录
+const uint8_t LOG_RELEASE = 2;              // 退回记录
+
+const char ALPHABET[] = "23456789ABCDEFGHJKLMNPQRSTUVWXYZ";   // Base32字母表（无I、O、0、1）
+const unsigned CODE_BITS = 60;              // 券码位数（12个字符 × 5位）
+const uint64_t CODE_MASK = (1ULL << CODE_BITS) - 1;
+const size_t BLOOM_BITS_PER_CODE = 10;      // Bloom过滤器每个券码的位数
+const unsigned BLOOM_HASHES = 7;            // Bloom过滤器哈希次数
+const size_t CODES_PER_BUCKET = 4;          // 目录每格的平均券码数
+
+/**
+ * @brief 按小端序写入整数
+ */
+void putLE(char* buf, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        buf[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+/**
+ * @brief 按小端序读取整数
+ */
+uint64_t getLE(const char* buf, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(buf[i])) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief 64位整数混洗（SplitMix64的终结步骤），作为Bloom过滤器的哈希
+ */
+uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * @brief 第i个Bloom哈希位置（双重哈希）
+ */
+uint64_t bloomPosition(uint64_t hash, unsigned i, uint64_t mask) {
+    uint64_t h1 = hash;
+    uint64_t h2 = (hash >> 32) | (hash << 32) | 1ULL;
+    return (h1 + i * h2) & mask;
+}
+
+/**
+ * @brief 字符 -> 5位数值，不在字母表中返回-1
+ */
+int symbolValue(char c) {
+    if (c >= 'a' && c <= 'z') {
+        c = static_cast<char>(c - 'a' + 'A');
+    }
+    const char* pos = std::strchr(ALPHABET, c);
+    return (c != '\0' && pos) ? static_cast<int>(pos - ALPHABET) : -1;
+}
+
+/**
+ * @brief 检查文件头，不存在或为空时创建，并截断末尾不完整的记录
+ * @param path 文件路径
+ * @param magic 魔数
+ * @param recordSize 记录字节数
+ * @param recordCount 输出的完整记录数
+ * @return 成功返回true
+ */
+bool prepareFile(const std::string& path, const char* magic, size_t recordSize, uint64_t& recordCount) {
+    std::error_code ec;
+    uintmax_t fileSize = std::filesystem::exists(path, ec) ? std::filesystem::file_size(path, ec) : 0;
+    recordCount = 0;
+
+    if (fileSize < HEADER_SIZE) {
+        std::ofstream create(path, std::ios::binary | std::ios::trunc);
+        if (!create.is_open()) {
+            Logger::getInstance()->error("CouponManager", "无法创建文件", {{"path", path}});
+            return false;
+        }
+        create.write(magic, HEADER_SIZE);
+        return static_cast<bool>(create);
+    }
+
+    std::ifstream in(path, std::ios::binary);
+    char header[HEADER_SIZE];
+    if (!in.read(header, HEADER_SIZE) || std::memcmp(header, magic, HEADER_SIZE) != 0) {
+        Logger::getInstance()->error("CouponManager", "文件格式错误", {{"path", path}});
+        return false;
+    }
+    in.close();
+
+    recordCount = (fileSize - HEADER_SIZE) / recordSize;
+    uintmax_t alignedSize = HEADER_SIZE + recordCount * recordSize;
+    if (alignedSize != fileSize) {
+        std::filesystem::resize_file(path, alignedSize, ec);
+        Logger::getInstance()->warn("CouponManager", "截断不完整的记录",
+                                    {{"path", path}, {"bytes", std::to_string(fileSize - alignedSize)}});
+    }
+    return true;
+}
+
+/**
+ * @brief 分批顺序读取文件中的全部定长记录
+ */
+template <typename Visitor>
+bool scanRecords(const std::string& path, size_t recordSize, uint64_t recordCount, Visitor visitor) {
+    std::ifstream in(path, std::ios::binary);
+    in.seekg(static_cast<std::streamoff>(HEADER_SIZE));
+    std::vector<char> buf;
+    for (uint64_t start = 0; start < recordCount; start += BATCH_RECORDS) {
+        uint64_t batch = std::min<uint64_t>(BATCH_RECORDS, recordCount - start);
+        buf.resize(static_cast<size_t>(batch * recordSize));
+        if (!in.read(buf.data(), static_cast<std::streamsize>(buf.size()))) {
+            return false;
+        }
+        for (uint64_t i = 0; i < batch; ++i) {
+            visitor(buf.data() + i * recordSize);
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 去除字符串首尾空格
+ */
+std::string trim(const std::string& str) {
+    size_t first = str.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) return "";
+    size_t last = str.find_last_not_of(" \t\r\n");
+    return str.substr(first, (last - first + 1));
+}
+
+/**
+ * @brief 从操作系统的密码学安全随机源取count个随机券码
+ *
+ * 优先批量读取/dev/urandom；不可用时逐次读取std::random_device（同样取自系统随机源）。
+ * 每个券码独立取自系统随机源，泄露部分券码无法推算出其他券码
+ */
+void appendSecureCodes(std::vector<uint64_t>& out, size_t count) {
+    std::ifstream urandom("/dev/urandom", std::ios::binary);
+    std::vector<uint64_t> buf;
+    while (count > 0 && urandom) {
+        buf.resize(std::min(count, BATCH_RECORDS));
+        if (!urandom.read(reinterpret_cast<char*>(buf.data()),
+                          static_cast<std::streamsize>(buf.size() * sizeof(uint64_t)))) {
+            break;
+        }
+        for (uint64_t value : buf) {
+            out.push_back(value & CODE_MASK);
+        }
+        count -= buf.size();
+    }
+    if (count > 0) {
+        std::random_device device;
+        for (; count > 0; --count) {
+            uint64_t value = (static_cast<uint64_t>(device()) << 32) | device();
+            out.push_back(value & CODE_MASK);
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数实现
+ */
+CouponManager::CouponManager(const std::string& campaignsFilePath, const std::string& codesFilePath,
+                             const std::string& redemptionLogFilePath)
+    : campaignsFilePath(campaignsFilePath), codesFilePath(codesFilePath),
+      redemptionLogFilePath(redemptionLogFilePath), directoryShift(CODE_BITS), bloomMask(0),
+      redeemedWords(0) {
+}
+
+/**
+ * @brief 把券码解析为60位整数
+ */
+uint64_t CouponManager::encode(const std::string& code) {
+    uint64_t value = 0;
+    size_t symbols = 0;
+    for (char c : code) {
+        if (c == '-' || c == ' ') {
+            continue;
+        }
+        int v = symbolValue(c);
+        if (v < 0 || symbols == CODE_LENGTH) {
+            return INVALID_CODE;
+        }
+        value = (value << 5) | static_cast<uint64_t>(v);
+        ++symbols;
+    }
+    return symbols == CODE_LENGTH ? value : INVALID_CODE;
+}
+
+/**
+ * @brief 把60位整数格式化为XXXX-XXXX-XXXX
+ */
+std::string CouponManager::format(uint64_t value) {
+    std::string code;
+    code.reserve(CODE_LENGTH + 2);
+    for (size_t i = 0; i < CODE_LENGTH; ++i) {
+        if (i > 0 && i % 4 == 0) {
+            code.push_back('-');
+        }
+        code.push_back(ALPHABET[(value >> (5 * (CODE_LENGTH - 1 - i))) & 0x1F]);
+    }
+    return code;
+}
+
+/**
+ * @brief 获取校验结果的显示字符串
+ */
+std::string CouponManager::statusToString(CouponStatus status) {
+    switch (status) {
+        case CouponStatus::OK:               return "可用";
+        case CouponStatus::INVALID_FORMAT:   return "券码格式错误";
+        case CouponStatus::NOT_FOUND:        return "券码不存在";
+        case CouponStatus::ALREADY_REDEEMED: return "券码已被使用";
+        case CouponStatus::NOT_STARTED:      return "活动未开始";
+        case CouponStatus::EXPIRED:          return "活动已结束";
+        case CouponStatus::BELOW_MIN_SPEND:  return "未达到使用门槛";
+        case CouponStatus::STORAGE_ERROR:    return "核销记录写入失败";
+    }
+    return "未知";
+}
+
+/**
+ * @brief 在券码表中查找券码
+ *
+ * 先查Bloom过滤器，再在高位目录指向的小范围内二分查找
+ */
+size_t CouponManager::findIndex(uint64_t code) const {
+    if (codes.empty() || code > CODE_MASK) {
+        return NOT_FOUND_INDEX;
+    }
+
+    uint64_t hash = mix64(code);
+    for (unsigned i = 0; i < BLOOM_HASHES; ++i) {
+        uint64_t bit = bloomPosition(hash, i, bloomMask);
+        if ((bloom[bit >> 6] & (1ULL << (bit & 63))) == 0) {
+            return NOT_FOUND_INDEX;
+        }
+    }
+
+    size_t bucket = static_cast<size_t>(code >> directoryShift);
+    auto first = codes.begin() + directory[bucket];
+    auto last = codes.begin() + directory[bucket + 1];
+    auto it = std::lower_bound(first, last, code);
+    if (it == last || *it != code) {
+        return NOT_FOUND_INDEX;
+    }
+    return static_cast<size_t>(it - codes.begin());
+}
+
+/**
+ * @brief 查询第index个券码是否已核销
+ */
+bool CouponManager::isRedeemedAt(size_t index) const {
+    return (redeemed[index >> 6].load(std::memory_order_acquire) >> (index & 63)) & 1ULL;
+}
+
+/**
+ * @brief 由codes重建目录和Bloom过滤器
+ */
+void CouponManager::rebuildLookup() {
+    size_t n = codes.size();
+
+    // 目录格数取2的幂，使每格平均不超过CODES_PER_BUCKET个券码
+    unsigned directoryBits = 0;
+    while (directoryBits < 30 && (static_cast<size_t>(1) << directoryBits) * CODES_PER_BUCKET < n) {
+        ++directoryBits;
+    }
+    directoryShift = CODE_BITS - directoryBits;
+    size_t buckets = static_cast<size_t>(1) << directoryBits;
+    directory.assign(buckets + 1, 0);
+    for (uint64_t code : codes) {
+        ++directory[static_cast<size_t>(code >> directoryShift) + 1];
+    }
+    for (size_t b = 0; b < buckets; ++b) {
+        directory[b + 1] += directory[b];
+    }
+
+    // Bloom过滤器位数取2的幂，不少于每个券码BLOOM_BITS_PER_CODE位
+    uint64_t bloomBits = 64;
+    while (bloomBits < n * BLOOM_BITS_PER_CODE) {
+        bloomBits <<= 1;
+    }
+    bloomMask = bloomBits - 1;
+    bloom.assign(static_cast<size_t>(bloomBits / 64), 0);
+    for (uint64_t code : codes) {
+        uint64_t hash = mix64(code);
+        for (unsigned i = 0; i < BLOOM_HASHES; ++i) {
+            uint64_t bit = bloomPosition(hash, i, bloomMask);
+            bloom[bit >> 6] |= 1ULL << (bit & 63);
+        }
+    }
+}
+
+/**
+ * @brief 检查活动的有效期和门槛
+ */
+CouponCheck CouponManager::checkCampaign(uint32_t slot, double orderAmount, time_t now) const {
+    const CouponCampaign& campaign = campaigns[slot];
+    CouponCheck result;
+    result.campaignId = campaign.campaignId;
+    result.campaignName = campaign.name;
+    result.amountOff = campaign.amountOff;
+    result.minSpend = campaign.minSpend;
+
+    if (now < campaign.startTime) {
+        result.status = CouponStatus::NOT_STARTED;
+    } else if (now > campaign.endTime) {
+        result.status = CouponStatus::EXPIRED;
+    } else if (orderAmount < campaign.minSpend) {
+        result.status = CouponStatus::BELOW_MIN_SPEND;
+    } else {
+        result.status = CouponStatus::OK;
+    }
+    return result;
+}
+
+/**
+ * @brief 追加一条核销日志
+ */
+bool CouponManager::appendLog(uint64_t code, uint8_t type, const std::string& reference) {
+    char buf[LOG_RECORD_SIZE];
+    std::memset(buf, 0, LOG_RECORD_SIZE);
+    putLE(buf, code, 8);
+    putLE(buf + 8, static_cast<uint64_t>(static_cast<int64_t>(std::time(nullptr))), 8);
+    buf[16] = static_cast<char>(type);
+    std::memcpy(buf + REFERENCE_OFFSET, reference.data(), std::min(reference.size(), REFERENCE_SIZE));
+
+    std::lock_guard<std::mutex> lock(logMutex);
+    if (!logWriter.is_open()) {
+        return false;
+    }
+    logWriter.write(buf, LOG_RECORD_SIZE);
+    logWriter.flush();
+    if (!logWriter) {
+        logWriter.clear();
+        Logger::getInstance()->error("CouponManager", "写入核销日志失败",
+                                     {{"path", redemptionLogFilePath}, {"code", format(code)}});
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 读取活动列表
+ *
+ * CSV格式：campaign_id,campaign_name,amount_off,min_spend,start_time,end_time,code_count
+ */
+bool CouponManager::loadCampaigns() {
+    campaigns.clear();
+    campaignIndex.clear();
+
+    std::ifstream file(campaignsFilePath);
+    if (!file.is_open()) {
+        Logger::getInstance()->info("CouponManager", "优惠券活动文件不存在，创建空文件", {{"path", campaignsFilePath}});
+        return saveCampaigns();
+    }
+
+    std::string line;
+    std::getline(file, line);   // 跳过表头
+    while (std::getline(file, line)) {
+        if (trim(line).empty() || line[0] == '#') {
+            continue;
+        }
+        std::vector<std::string> fields;
+        std::stringstream ss(line);
+        std::string field;
+        while (std::getline(ss, field, ',')) {
+            fields.push_back(trim(field));
+        }
+        if (fields.size() < 7) {
+            Logger::getInstance()->warn("CouponManager", "优惠券活动字段不足，跳过", {{"line", line}});
+            continue;
+        }
+
+        CouponCampaign campaign;
+        try {
+            campaign.campaignId = static_cast<uint32_t>(std::stoul(fields[0]));
+            campaign.name = fields[1];
+            campaign.amountOff = std::stod(fields[2]);
+            campaign.minSpend = std::stod(fields[3]);
+            campaign.startTime = static_cast<time_t>(std::stoll(fields[4]));
+            campaign.endTime = static_cast<time_t>(std::stoll(fields[5]));
+        } catch (...) {
+            Logger::getInstance()->warn("CouponManager", "优惠券活动解析失败，跳过", {{"line", line}});
+            continue;
+        }
+        if (campaign.campaignId == 0 || campaignIndex.count(campaign.campaignId)) {
+            Logger::getInstance()->warn("CouponManager", "优惠券活动ID无效或重复，跳过", {{"line", line}});
+            continue;
+        }
+        campaigns.push_back(campaign);
+    }
+
+    std::sort(campaigns.begin(), campaigns.end(),
+              [](const CouponCampaign& a, const CouponCampaign& b) { return a.campaignId < b.campaignId; });
+    for (size_t i = 0; i < campaigns.size(); ++i) {
+        campaignIndex[campaigns[i].campaignId] = static_cast<uint32_t>(i);
+    }
+    return true;
+}
+
+/**
+ * @brief 保存活动列表
+ */
+bool CouponManager::saveCampaigns() const {
+    std::ofstream file(campaignsFilePath);
+    if (!file.is_open()) {
+        Logger::getInstance()->error("CouponManager", "无法写入优惠券活动文件", {{"path", campaignsFilePath}});
+        return false;
+    }
+    file << "campaign_id,campaign_name,amount_off,min_spend,start_time,end_time,code_count\n";
+    for (const auto& campaign : campaigns) {
+        file << campaign.campaignId << "," << campaign.name << "," << campaign.amountOff << ","
+             << campaign.minSpend << "," << campaign.startTime << "," << campaign.endTime << ","
+             << campaign.codeCount << "\n";
+    }
+    return static_cast<bool>(file);
+}
+
+/**
+ * @brief 读取券码库并构建券码表
+ *
+ * 属于未知活动的券码（创建活动时中断）跳过；活动的券码数量以券码库为准
+ */
+bool CouponManager::loadCodes() {
+    uint64_t recordCount = 0;
+    if (!prepareFile(codesFilePath, CODES_MAGIC, CODE_RECORD_SIZE, recordCount)) {
+        return false;
+    }
+
+    std::vector<std::pair<uint64_t, uint32_t>> entries;
+    entries.reserve(static_cast<size_t>(recordCount));
+    size_t orphaned = 0;
+    bool ok = scanRecords(codesFilePath, CODE_RECORD_SIZE, recordCount, [&](const char* buf) {
+        uint64_t code = getLE(buf, 8);
+        auto it = campaignIndex.find(static_cast<uint32_t>(getLE(buf + 8, 4)));
+        if (it == campaignIndex.end() || code > CODE_MASK) {
+            ++orphaned;
+            return;
+        }
+        entries.emplace_back(code, it->second);
+    });
+    if (!ok) {
+        Logger::getInstance()->error("CouponManager", "读取券码库失败", {{"path", codesFilePath}});
+        return false;
+    }
+    if (orphaned > 0) {
+        Logger::getInstance()->warn("CouponManager", "跳过不属于任何活动的券码",
+                                    {{"count", std::to_string(orphaned)}});
+    }
+
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end(),
+                              [](const std::pair<uint64_t, uint32_t>& a, const std::pair<uint64_t, uint32_t>& b) {
+                                  return a.first == b.first;
+                              }),
+                  entries.end());
+
+    for (auto& campaign : campaigns) {
+        campaign.codeCount = 0;
+    }
+    codes.resize(entries.size());
+    codeCampaigns.resize(entries.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        codes[i] = entries[i].first;
+        codeCampaigns[i] = entries[i].second;
+        ++campaigns[entries[i].second].codeCount;
+    }
+
+    redeemedWords = (codes.size() + 63) / 64;
+    redeemed.reset(new std::atomic<uint64_t>[redeemedWords]);
+    for (size_t w = 0; w < redeemedWords; ++w) {
+        redeemed[w].store(0, std::memory_order_relaxed);
+    }
+    rebuildLookup();
+    return true;
+}
+
+/**
+ * @brief 打开核销日志并重放
+ */
+bool CouponManager::openRedemptionLog() {
+    std::lock_guard<std::mutex> lock(logMutex);
+    logWriter.close();
+
+    uint64_t recordCount = 0;
+    if (!prepareFile(redemptionLogFilePath, LOG_MAGIC, LOG_RECORD_SIZE, recordCount)) {
+        return false;
+    }
+
+    bool ok = scanRecords(redemptionLogFilePath, LOG_RECORD_SIZE, recordCount, [this](const char* buf) {
+        size_t index = findIndex(getLE(buf, 8));
+        if (index == NOT_FOUND_INDEX) {
+            return;
+        }
+        uint64_t mask = 1ULL << (index & 63);
+        if (static_cast<uint8_t>(buf[16]) == LOG_REDEEM) {
+            redeemed[index >> 6].fetch_or(mask, std::memory_order_relaxed);
+        } else if (static_cast<uint8_t>(buf[16]) == LOG_RELEASE) {
+            redeemed[index >> 6].fetch_and(~mask, std::memory_order_relaxed);
+        }
+    });
+    if (!ok) {
+        Logger::getInstance()->error("CouponManager", "读取核销日志失败", {{"path", redemptionLogFilePath}});
+        return false;
+    }
+
+    logWriter.open(redemptionLogFilePath, std::ios::binary | std::ios::app);
+    if (!logWriter.is_open()) {
+        Logger::getInstance()->error("CouponManager", "无法打开核销日志", {{"path", redemptionLogFilePath}});
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 加载活动、券码和核销日志
+ */
+bool CouponManager::loadFromFile() {
+    std::unique_lock<std::shared_mutex> lock(tableMutex);
+    if (!loadCampaigns() || !loadCodes() || !openRedemptionLog()) {
+        return false;
+    }
+
+    Logger::getInstance()->info("CouponManager", "优惠券数据已加载",
+                                {{"campaigns", std::to_string(campaigns.size())},
+                                 {"codes", std::to_string(codes.size())}});
+    return true;
+}
+
+/**
+ * @brief 创建优惠券活动并生成券码
+ *
+ * 写入顺序为导出文件、券码库、活动列表：中途失败时券码库中多出的券码不属于任何活动，
+ * 下次加载时被跳过；生成的券码与已有券码合并排序，核销位随券码一起搬移
+ */
+uint32_t CouponManager::createCampaign(const std::string& name, double amountOff, double minSpend,
+                                       time_t startTime, time_t endTime, size_t count,
+                                       const std::string& exportPath) {
+    if (count == 0 || amountOff <= 0 || endTime < startTime) {
+        return 0;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(tableMutex);
+    if (codes.size() + count > 0xFFFFFFFFULL) {
+        Logger::getInstance()->warn("CouponManager", "券码总数超过上限", {{"count", std::to_string(count)}});
+        return 0;
+    }
+    uint32_t campaignId = campaigns.empty() ? 1 : campaigns.back().campaignId + 1;
+
+    // 生成不重复、且与已有券码不冲突的随机券码（取自系统随机源，不使用可由种子重现的伪随机数）
+    std::vector<uint64_t> batch;
+    batch.reserve(count);
+    while (batch.size() < count) {
+        appendSecureCodes(batch, count - batch.size());
+        std::sort(batch.begin(), batch.end());
+        batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+        batch.erase(std::remove_if(batch.begin(), batch.end(),
+                                   [this](uint64_t code) { return findIndex(code) != NOT_FOUND_INDEX; }),
+                    batch.end());
+    }
+
+    // 导出券码
+    {
+        std::ofstream out(exportPath);
+        for (uint64_t code : batch) {
+            out << format(code) << '\n';
+        }
+        if (!out) {
+            Logger::getInstance()->error("CouponManager", "导出券码失败", {{"path", exportPath}});
+            return 0;
+        }
+    }
+
+    // 追加到券码库
+    {
+        uint64_t recordCount = 0;
+        if (!prepareFile(codesFilePath, CODES_MAGIC, CODE_RECORD_SIZE, recordCount)) {
+            return 0;
+        }
+        std::ofstream out(codesFilePath, std::ios::binary | std::ios::app);
+        std::vector<char> buf;
+        for (size_t start = 0; start < batch.size() && out; start += BATCH_RECORDS) {
+            size_t n = std::min(BATCH_RECORDS, batch.size() - start);
+            buf.assign(n * CODE_RECORD_SIZE, 0);
+            for (size_t i = 0; i < n; ++i) {
+                putLE(buf.data() + i * CODE_RECORD_SIZE, batch[start + i], 8);
+                putLE(buf.data() + i * CODE_RECORD_SIZE + 8, campaignId, 4);
+            }
+            out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+        }
+        out.flush();
+        if (!out) {
+            Logger::getInstance()->error("CouponManager", "写入券码库失败", {{"path", codesFilePath}});
+            return 0;
+        }
+    }
+
+    // 登记活动
+    CouponCampaign campaign;
+    campaign.campaignId = campaignId;
+    campaign.name = name;
+    campaign.amountOff = amountOff;
+    campaign.minSpend = minSpend;
+    campaign.startTime = startTime;
+    campaign.endTime = endTime;
+    campaign.codeCount = batch.size();
+    uint32_t slot = static_cast<uint32_t>(campaigns.size());
+    campaigns.push_back(campaign);
+    campaignIndex[campaignId] = slot;
+    if (!saveCampaigns()) {
+        campaigns.pop_back();
+        campaignIndex.erase(campaignId);
+        return 0;
+    }
+
+    // 合并到券码表
+    size_t total = codes.size() + batch.size();
+    std::vector<uint64_t> mergedCodes(total);
+    std::vector<uint32_t> mergedCampaigns(total);
+    size_t mergedWords = (total + 63) / 64;
+    std::unique_ptr<std::atomic<uint64_t>[]> mergedRedeemed(new std::atomic<uint64_t>[mergedWords]);
+    for (size_t w = 0; w < mergedWords; ++w) {
+        mergedRedeemed[w].store(0, std::memory_order_relaxed);
+    }
+
+    size_t i = 0;
+    size_t j = 0;
+    for (size_t k = 0; k < total; ++k) {
+        if (j == batch.size() || (i < codes.size() && codes[i] < batch[j])) {
+            mergedCodes[k] = codes[i];
+            mergedCampaigns[k] = codeCampaigns[i];
+            if (isRedeemedAt(i)) {
+                mergedRedeemed[k >> 6].fetch_or(1ULL << (k & 63), std::memory_order_relaxed);
+            }
+            ++i;
+        } else {
+            mergedCodes[k] = batch[j];
+            mergedCampaigns[k] = slot;
+            ++j;
+        }
+    }
+
+    codes.swap(mergedCodes);
+    codeCampaigns.swap(mergedCampaigns);
+    redeemed.swap(mergedRedeemed);
+    redeemedWords = mergedWords;
+    rebuildLookup();
+
+    Logger::getInstance()->info("CouponManager", "优惠券活动已创建",
+                                {{"campaign", std::to_string(campaignId)},
+                                 {"codes", std::to_string(batch.size())},
+                                 {"export", exportPath}});
+    return campaignId;
+}
+
+/**
+ * @brief 校验券码（不核销）
+ */
+CouponCheck CouponManager::check(const std::string& code, double orderAmount, time_t now) const {
+    CouponCheck result;
+    uint64_t value = encode(code);
+    if (value == INVALID_CODE) {
+        result.status = CouponStatus::INVALID_FORMAT;
+        return result;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(tableMutex);
+    size_t index = findIndex(value);
+    if (index == NOT_FOUND_INDEX) {
+        result.status = CouponStatus::NOT_FOUND;
+        return result;
+    }
+    result = checkCampaign(codeCampaigns[index], orderAmount, now);
+    if (isRedeemedAt(index)) {
+        result.status = CouponStatus::ALREADY_REDEEMED;
+    }
+    return result;
+}
+
+/**
+ * @brief 核销券码
+ *
+ * 校验通过后用fetch_or原子置位，置位前已为1说明被其他请求抢先核销；
+ * 核销日志写入失败时撤销置位
+ */
+CouponStatus CouponManager::tryRedeem(const std::string& code, double orderAmount, const std::string& reference) {
+    uint64_t value = encode(code);
+    if (value == INVALID_CODE) {
+        return CouponStatus::INVALID_FORMAT;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(tableMutex);
+    size_t index = findIndex(value);
+    if (index == NOT_FOUND_INDEX) {
+        return CouponStatus::NOT_FOUND;
+    }
+    CouponCheck result = checkCampaign(codeCampaigns[index], orderAmount, std::time(nullptr));
+    if (result.status != CouponStatus::OK) {
+        return isRedeemedAt(index) ? CouponStatus::ALREADY_REDEEMED : result.status;
+    }
+
+    uint64_t mask = 1ULL << (index & 63);
+    if (redeemed[index >> 6].fetch_or(mask, std::memory_order_acq_rel) & mask) {
+        return CouponStatus::ALREADY_REDEEMED;
+    }
+    if (!appendLog(value, LOG_REDEEM, reference)) {
+        redeemed[index >> 6].fetch_and(~mask, std::memory_order_acq_rel);
+        return CouponStatus::STORAGE_ERROR;
+    }
+
+    Logger::getInstance()->info("CouponManager", "优惠券已核销",
+                                {{"code", format(value)}, {"reference", reference}});
+    return CouponStatus::OK;
+}
+
+/**
+ * @brief 退回已核销的券码
+ */
+bool CouponManager::release(const std::string& code, const std::string& reference) {
+    uint64_t value = encode(code);
+    if (value == INVALID_CODE) {
+        return false;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(tableMutex);
+    size_t index = findIndex(value);
+    if (index == NOT_FOUND_INDEX) {
+        return false;
+    }
+
+    uint64_t mask = 1ULL << (index & 63);
+    if ((redeemed[index >> 6].fetch_and(~mask, std::memory_order_acq_rel) & mask) == 0) {
+        return false;
+    }
+    if (!appendLog(value, LOG_RELEASE, reference)) {
+        redeemed[index >> 6].fetch_or(mask, std::memory_order_acq_rel);
+        return false;
+    }
+
+    Logger::getInstance()->info("CouponManager", "优惠券已退回",
+                                {{"code", format(value)}, {"reference", reference}});
+    return true;
+}
+
+/**
+ * @brief 获取所有活动及其核销数量
+ */
+std::vector<CouponCampaign> CouponManager::getCampaignSummaries() const {
+    std::shared_lock<std::shared_mutex> lock(tableMutex);
+    std::vector<CouponCampaign> summaries = campaigns;
+    for (auto& summary : summaries) {
+        summary.redeemedCount = 0;
+    }
+    for (size_t w = 0; w < redeemedWords; ++w) {
+        uint64_t word = redeemed[w].load(std::memory_order_acquire);
+        for (size_t bit = 0; word != 0; ++bit, word >>= 1) {
+            if (word & 1ULL) {
+                ++summaries[codeCampaigns[w * 64 + bit]].redeemedCount;
+            }
+        }
+    }
+    return summaries;
+}
+
+/**
+ * @brief 获取券码总数
+ */
+size_t CouponManager::size() const {
+    std::shared_lock<std::shared_mutex> lock(tableMutex);
+    return codes.size();
+}
@@ -8,6 +8,14 @@
 #include "Promotion/Promotion.h"
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+
+namespace {
+
+const std::string CATEGORY_PREFIX = "cat:";     // 类别范围前缀
+const std::string ITEM_SET_PREFIX = "set:";     // 商品集合范围前缀
+
+} // namespace
 
 /**
  * @brief 默认构造函数实现
@@ -15,8 +23,8 @@
 Promotion::Promotion()
     : promotionId(""), promotionName(""), promotionType(PromotionType::DISCOUNT),
       isActive(false), startTime(0), endTime(0),
-      targetItemId(""), discountRate(1.0),
-      thresholdAmount(0.0), reductionAmount(0.0) {
+      targetItemId(""), discountRate(1.0), scope(PromotionScope::ITEM),
+      thresholdAmount(0.0), reductionAmount(0.0), perUserLimit(0) {
 }
 
 /**
@@ -32,8 +40,9 @@ Promotion::Promotion(const std::string& promotionId,
     : promotionId(promotionId), promotionName(promotionName),
       promotionType(PromotionType::DISCOUNT),
       isActive(isActive), startTime(startTime), endTime(endTime),
-      targetItemId(targetItemId), discountRate(discountRate),
-      thresholdAmount(0.0), reductionAmount(0.0) {
+      discountRate(discountRate), scope(PromotionScope::ITEM),
+      thresholdAmount(0.0), reductionAmount(0.0), perUserLimit(0) {
+    setTargetItemId(targetItemId);
 }
 
 /**
@@ -49,8 +58,8 @@ Promotion::Promotion(const std::string& promotionId,
     : promotionId(promotionId), promotionName(promotionName),
       promotionType(PromotionType::FULL_REDUCTION),
       isActive(isActive), startTime(startTime), endTime(endTime),
-      targetItemId(""), discountRate(1.0),
-      thresholdAmount(thresholdAmount), reductionAmount(reductionAmount) {
+      targetItemId(""), discountRate(1.0), scope(PromotionScope::ITEM),
+      thresholdAmount(thresholdAmount), reductionAmount(reductionAmount), perUserLimit(0) {
 }
 
 /**
@@ -75,24 +84,104 @@ bool Promotion::isValid() const {
     return currentTime >= startTime && currentTime <= endTime;
 }
 
+/**
+ * @brief 设置目标范围并解析适用范围
+ */
+void Promotion::setTargetItemId(const std::string& id) {
+    targetItemId = id;
+    targetCategory.clear();
+    targetItemIds.clear();
+
+    if (id == "-1") {
+        scope = PromotionScope::ALL;
+    } else if (id.compare(0, CATEGORY_PREFIX.size(), CATEGORY_PREFIX) == 0) {
+        scope = PromotionScope::CATEGORY;
+        targetCategory = id.substr(CATEGORY_PREFIX.size());
+    } else if (id.compare(0, ITEM_SET_PREFIX.size(), ITEM_SET_PREFIX) == 0) {
+        scope = PromotionScope::ITEM_SET;
+        std::stringstream ss(id.substr(ITEM_SET_PREFIX.size()));
+        std::string itemId;
+        while (std::getline(ss, itemId, '|')) {
+            if (!itemId.empty()) {
+                targetItemIds.push_back(itemId);
+            }
+        }
+        std::sort(targetItemIds.begin(), targetItemIds.end());
+        targetItemIds.erase(std::unique(targetItemIds.begin(), targetItemIds.end()), targetItemIds.end());
+    } else {
+        scope = PromotionScope::ITEM;
+        targetItemIds.push_back(id);
+    }
+}
+
 /**
  * @brief 检查某个商品是否适用该促销
  * 
  * 仅对折扣促销有效：
- * - 如果 targetItemId 为 "-1"，表示全场适用
- * - 否则仅对匹配的商品ID适用
+ * - 全场范围（"-1"）对所有商品适用
+ * - 类别范围按商品类别匹配
+ * - 集合范围在有序的商品ID列表中二分查找
  */
-bool Promotion::isApplicableToItem(const std::string& itemId) const {
+bool Promotion::isApplicableToItem(const std::string& itemId, const std::string& category) const {
     if (promotionType != PromotionType::DISCOUNT) {
         return false;
     }
     
-    // "-1"表示全场折扣
-    if (targetItemId == "-1") {
-        return true;
+    switch (scope) {
+        case PromotionScope::ALL:
+            return true;
+        case PromotionScope::CATEGORY:
+            return !category.empty() && category == targetCategory;
+        case PromotionScope::ITEM_SET:
+            return std::binary_search(targetItemIds.begin(), targetItemIds.end(), itemId);
+        case PromotionScope::ITEM:
+        default:
+            return targetItemId == itemId;
     }
-    
-    return targetItemId == itemId;
+}
+
+/**
+ * @brief 获取适用范围的显示文本
+ */
+std::string Promotion::getScopeDescription() const {
+    switch (scope) {
+        case PromotionScope::ALL:
+            return "全场";
+        case PromotionScope::CATEGORY:
+            return "类别: " + targetCategory;
+        case PromotionScope::ITEM_SET: {
+            std::ostringstream oss;
+            oss << "商品: ";
+            for (size_t i = 0; i < targetItemIds.size(); ++i) {
+                oss << (i > 0 ? ", " : "") << targetItemIds[i];
+            }
+            return oss.str();
+        }
+        case PromotionScope::ITEM:
+        default:
+            return "商品: " + targetItemId;
+    }
+}
+
+/**
+ * @brief 由类别名构造目标范围字符串
+ */
+std::string Promotion::categoryTarget(const std::string& category) {
+    return CATEGORY_PREFIX + category;
+}
+
+/**
+ * @brief 由商品ID列表构造目标范围字符串
+ */
+std::string Promotion::itemSetTarget(const std::vector<std::string>& itemIds) {
+    std::string target = ITEM_SET_PREFIX;
+    for (size_t i = 0; i < itemIds.size(); ++i) {
+        if (i > 0) {
+            target += "|";
+        }
+        target += itemIds[i];
+    }
+    return target;
 }
 
 /**
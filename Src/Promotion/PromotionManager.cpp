@@ -6,17 +6,107 @@
  */
 
 #include "Promotion/PromotionManager.h"
+#include "Log/Logger.h"
+#include "Services/ListingRenderer.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#include <limits>
+#include <cmath>
+
+namespace {
+
+const size_t EXACT_SUBSET_LINES = 12;       // 有折扣的商品不超过该数时精确枚举放弃哪些折扣
+const size_t MAX_THRESHOLD_CANDIDATES = 64; // 最多尝试的更高满减门槛数
+
+/**
+ * @brief 折扣选择器：在折扣节省总额不超过上限的前提下，使节省总额最大
+ *
+ * 有折扣的商品较少时预先枚举所有子集的节省总额并排序，每个上限二分查找；
+ * 较多时按节省金额降序贪心选取
+ */
+class DiscountSelector {
+private:
+    std::vector<long long> savings;                         // 各商品的节省金额（分）
+    std::vector<size_t> discounted;                         // 有折扣的商品下标
+    std::vector<std::pair<long long, uint32_t>> subsets;    // (节省总额, 子集掩码)，按总额升序
+
+public:
+    explicit DiscountSelector(const std::vector<long long>& lineSavings) : savings(lineSavings) {
+        for (size_t i = 0; i < savings.size(); ++i) {
+            if (savings[i] > 0) {
+                discounted.push_back(i);
+            }
+        }
+        if (discounted.size() <= EXACT_SUBSET_LINES) {
+            uint32_t count = 1u << discounted.size();
+            subsets.reserve(count);
+            for (uint32_t mask = 0; mask < count; ++mask) {
+                long long total = 0;
+                for (size_t b = 0; b < discounted.size(); ++b) {
+                    if (mask & (1u << b)) {
+                        total += savings[discounted[b]];
+                    }
+                }
+                subsets.emplace_back(total, mask);
+            }
+            std::sort(subsets.begin(), subsets.end());
+        } else {
+            std::sort(discounted.begin(), discounted.end(),
+                      [this](size_t a, size_t b) { return savings[a] > savings[b]; });
+        }
+    }
+
+    /**
+     * @brief 选出节省总额不超过cap的最大组合
+     * @param cap 节省总额上限（分）
+     * @param use 输出：各商品是否使用折扣
+     * @return 节省总额（分）
+     */
+    long long select(long long cap, std::vector<bool>& use) const {
+        use.assign(savings.size(), false);
+        long long total = 0;
+        if (!subsets.empty()) {
+            auto it = std::upper_bound(subsets.begin(), subsets.end(),
+                                       std::make_pair(cap, std::numeric_limits<uint32_t>::max()));
+            if (it == subsets.begin()) {
+                return 0;
+            }
+            --it;
+            for (size_t b = 0; b < discounted.size(); ++b) {
+                use[discounted[b]] = (it->second & (1u << b)) != 0;
+            }
+            return it->first;
+        }
+        for (size_t index : discounted) {
+            if (total + savings[index] <= cap) {
+                total += savings[index];
+                use[index] = true;
+            }
+        }
+        return total;
+    }
+};
+
+} // namespace
+
+/**
+ * @brief 获取有效促销的标签文本
+ */
+std::string PricingTable::tagOf(const Promotion& promotion) const {
+    auto it = displayTags.find(promotion.getPromotionId());
+    return it != displayTags.end() ? it->second : promotion.getDisplayTag();
+}
 
 /**
  * @brief 构造函数实现
  */
 PromotionManager::PromotionManager(const std::string& filePath)
-    : filePath(filePath) {
+    : filePath(filePath), itemRepository(nullptr), couponManager(nullptr), usageTracker(nullptr),
+      stackingPolicy(StackingPolicy::STACK_ALL), maxStacked(1),
+      promotionVersion(1), scheduled(false) {
 }
 
 /**
@@ -25,6 +115,196 @@ PromotionManager::PromotionManager(const std::string& filePath)
 PromotionManager::~PromotionManager() {
 }
 
+/**
+ * @brief 设置满减叠加策略
+ */
+void PromotionManager::setStackingPolicy(StackingPolicy policy, size_t newMaxStacked) {
+    {
+        std::lock_guard<std::mutex> lock(promotionsMutex);
+        stackingPolicy = policy;
+        maxStacked = newMaxStacked > 0 ? newMaxStacked : 1;
+    }
+    markChanged();
+}
+
+/**
+ * @brief 促销版本加一并通知监听者
+ */
+void PromotionManager::markChanged() {
+    ++promotionVersion;
+    if (changeListener) {
+        changeListener();
+    }
+}
+
+/**
+ * @brief 构建某个时刻的定价表
+ *
+ * 只统计此刻有效的促销：全场折扣单独保存，单品和集合范围按商品ID写入，类别范围按类别写入，
+ * 限次折扣因人而异单独保存；有效满减编译为阶梯；同时记录最近一个会改变有效集合的时间点
+ */
+std::shared_ptr<const PricingTable> PromotionManager::buildPricingTable(time_t now) const {
+    auto table = std::make_shared<PricingTable>();
+    std::lock_guard<std::mutex> lock(promotionsMutex);
+    table->version = promotionVersion.load();
+    table->builtFor = now;
+    table->validUntil = std::numeric_limits<time_t>::max();
+
+    auto offer = [](std::shared_ptr<Promotion>& best, const std::shared_ptr<Promotion>& promotion) {
+        if (!best || promotion->getDiscountRate() < best->getDiscountRate()) {
+            best = promotion;
+        }
+    };
+
+    for (const auto& p : promotions) {
+        if (!p->getIsActive()) {
+            continue;
+        }
+        if (now < p->getStartTime()) {
+            table->validUntil = std::min(table->validUntil, p->getStartTime());
+            continue;
+        }
+        if (now > p->getEndTime()) {
+            continue;
+        }
+        table->validUntil = std::min(table->validUntil, p->getEndTime() + 1);
+        table->displayTags[p->getPromotionId()] = p->getDisplayTag();
+
+        if (p->getPromotionType() == PromotionType::FULL_REDUCTION) {
+            table->activeReductions.push_back(p);
+            if (p->getPerUserLimit() > 0) {
+                table->limitedReductions.push_back(p);
+            }
+            continue;
+        }
+        if (p->getPerUserLimit() > 0) {
+            table->limitedDiscounts.push_back(p);
+            continue;
+        }
+
+        switch (p->getScope()) {
+            case PromotionScope::ALL:
+                offer(table->storeWideDiscount, p);
+                break;
+            case PromotionScope::CATEGORY:
+                offer(table->categoryDiscounts[p->getTargetCategory()], p);
+                break;
+            case PromotionScope::ITEM:
+            case PromotionScope::ITEM_SET:
+                for (const auto& itemId : p->getTargetItemIds()) {
+                    offer(table->itemDiscounts[itemId], p);
+                }
+                break;
+        }
+    }
+
+    std::sort(table->activeReductions.begin(), table->activeReductions.end(),
+        [](const std::shared_ptr<Promotion>& a, const std::shared_ptr<Promotion>& b) {
+            return a->getThresholdAmount() < b->getThresholdAmount();
+        });
+    table->ladder.compile(table->activeReductions, stackingPolicy, maxStacked);
+    return table;
+}
+
+/**
+ * @brief 原子地换上定价表
+ */
+bool PromotionManager::installPricingTable(std::shared_ptr<const PricingTable> table) {
+    if (!table || table->version != promotionVersion.load()) {
+        return false;
+    }
+    std::atomic_store(&pricingTable, std::move(table));
+    return true;
+}
+
+/**
+ * @brief 获取当前定价表
+ *
+ * 启用定时器后只比较版本号；否则还要检查是否到达下一个促销开始或结束时间
+ */
+std::shared_ptr<const PricingTable> PromotionManager::currentPricing() {
+    auto table = std::atomic_load(&pricingTable);
+    if (table && table->version == promotionVersion.load() &&
+        (scheduled.load() || time(nullptr) < table->validUntil)) {
+        return table;
+    }
+    table = buildPricingTable(time(nullptr));
+    installPricingTable(table);
+    return table;
+}
+
+/**
+ * @brief 获取某个时刻之后的促销生效和结束事件
+ */
+std::vector<PromotionEvent> PromotionManager::getUpcomingEvents(time_t now) const {
+    std::vector<PromotionEvent> events;
+    {
+        std::lock_guard<std::mutex> lock(promotionsMutex);
+        for (const auto& p : promotions) {
+            if (!p->getIsActive()) {
+                continue;
+            }
+            if (now < p->getStartTime()) {
+                events.push_back({p->getStartTime(), p->getPromotionId(), true});
+            }
+            if (now <= p->getEndTime()) {
+                events.push_back({p->getEndTime() + 1, p->getPromotionId(), false});
+            }
+        }
+    }
+    std::sort(events.begin(), events.end(), [](const PromotionEvent& a, const PromotionEvent& b) {
+        return a.time < b.time;
+    });
+    return events;
+}
+
+/**
+ * @brief 顾客是否已用尽某个限次促销
+ */
+bool PromotionManager::isExhaustedFor(const std::shared_ptr<Promotion>& promotion,
+                                      const std::string& userId) const {
+    if (userId.empty() || !usageTracker || promotion->getPerUserLimit() <= 0) {
+        return false;
+    }
+    return usageTracker->getUsage(userId, promotion->getPromotionId()) >=
+           static_cast<uint32_t>(promotion->getPerUserLimit());
+}
+
+/**
+ * @brief 在定价表中查找商品对某位顾客有效的最优折扣
+ *
+ * 依次比较全场、类别、单品或集合折扣，再与顾客尚未用尽的限次折扣比较
+ */
+std::shared_ptr<Promotion> PromotionManager::bestDiscountFor(const PricingTable& table,
+                                                             const std::string& itemId,
+                                                             const std::string& category,
+                                                             const std::string& userId) const {
+    std::shared_ptr<Promotion> bestDiscount = table.storeWideDiscount;
+    auto consider = [&bestDiscount](const std::shared_ptr<Promotion>& p) {
+        if (!bestDiscount || p->getDiscountRate() < bestDiscount->getDiscountRate()) {
+            bestDiscount = p;
+        }
+    };
+    
+    if (!category.empty()) {
+        auto it = table.categoryDiscounts.find(category);
+        if (it != table.categoryDiscounts.end()) {
+            consider(it->second);
+        }
+    }
+    auto it = table.itemDiscounts.find(itemId);
+    if (it != table.itemDiscounts.end()) {
+        consider(it->second);
+    }
+    
+    for (const auto& p : table.limitedDiscounts) {
+        if (p->isApplicableToItem(itemId, category) && !isExhaustedFor(p, userId)) {
+            consider(p);
+        }
+    }
+    return bestDiscount;
+}
+
 /**
  * @brief 去除字符串首尾空格
  */
@@ -78,16 +358,18 @@ time_t PromotionManager::stringToTime(const std::string& str) {
  * 
  * CSV格式：
  * promotion_id,promotion_name,promotion_type,is_active,start_time,end_time,
- * target_item_id,discount_rate,threshold_amount,reduction_amount
+ * target_item_id,discount_rate,threshold_amount,reduction_amount,stack_group,per_user_limit
+ * 
+ * stack_group和per_user_limit为可选列（旧文件没有这两列），“_”表示不分组或不限次数
  */
 bool PromotionManager::loadFromFile() {
     std::ifstream file(filePath);
     if (!file.is_open()) {
-        std::cerr << "警告: 无法打开促销数据文件: " << filePath << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "无法打开促销数据文件", {{"path", filePath}});
         return false;
     }
     
-    promotions.clear();
+    std::vector<std::shared_ptr<Promotion>> loaded;
     std::string line;
     
     // 跳过表头
@@ -101,7 +383,7 @@ bool PromotionManager::loadFromFile() {
         
         std::vector<std::string> fields = parseCSVLine(line);
         if (fields.size() < 10) {
-            std::cout << fields[0] << std::endl;
+            Logger::getInstance()->warn("PromotionManager", "促销数据字段不足，跳过", {{"line", line}});
             continue;
         }
         
@@ -135,28 +417,60 @@ bool PromotionManager::loadFromFile() {
         }
         
         if (promotion) {
-            promotions.push_back(promotion);
+            if (fields.size() > 10 && fields[10] != "_") {
+                promotion->setStackGroup(fields[10]);
+            }
+            if (fields.size() > 11 && fields[11] != "_") {
+                try {
+                    promotion->setPerUserLimit(std::stoi(fields[11]));
+                } catch (...) {
+                    Logger::getInstance()->warn("PromotionManager", "每人限用次数无效，视为不限",
+                                                {{"promotion_id", promotionId}});
+                }
+            }
+            loaded.push_back(promotion);
         }
     }
     
-    std::cout << "成功加载 " << promotions.size() << " 个促销信息。" << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(promotionsMutex);
+        promotions.swap(loaded);
+    }
+    markChanged();
+    
+    Logger::getInstance()->info("PromotionManager", "成功加载促销信息",
+                                {{"count", std::to_string(promotions.size())}, {"path", filePath}});
     file.close();
     return true;
 }
 
+/**
+ * @brief 替换促销列表（不写入文件）
+ */
+void PromotionManager::assignPromotions(const std::vector<std::shared_ptr<Promotion>>& list) {
+    {
+        std::lock_guard<std::mutex> lock(promotionsMutex);
+        promotions = list;
+    }
+    markChanged();
+}
+
 /**
  * @brief 保存促销数据到CSV文件
  */
 bool PromotionManager::saveToFile() {
+    // 所有修改操作都以保存结束，在此统一使定价表过时
+    markChanged();
+
     std::ofstream file(filePath);
     if (!file.is_open()) {
-        std::cerr << "错误: 无法写入促销数据文件: " << filePath << std::endl;
+        Logger::getInstance()->error("PromotionManager", "无法写入促销数据文件", {{"path", filePath}});
         return false;
     }
     
     // 写入表头
     file << "promotion_id,promotion_name,promotion_type,is_active,start_time,end_time,"
-         << "target_item_id,discount_rate,threshold_amount,reduction_amount\n";
+         << "target_item_id,discount_rate,threshold_amount,reduction_amount,stack_group,per_user_limit\n";
     
     // 写入数据
     for (const auto& promotion : promotions) {
@@ -173,14 +487,22 @@ bool PromotionManager::saveToFile() {
              << timeToString(promotion->getStartTime()) << ","
              << timeToString(promotion->getEndTime()) << ",";
         
+        // 不适用的字段写入占位符“_”
         if (promotion->getPromotionType() == PromotionType::DISCOUNT) {
             file << promotion->getTargetItemId() << ","
-                 << promotion->getDiscountRate() << "_,_,";
+                 << promotion->getDiscountRate() << ",_,_";
         } else {
-            file << ",_,_"
+            file << "_,_,"
                  << promotion->getThresholdAmount() << ","
                  << promotion->getReductionAmount();
         }
+        file << "," << (promotion->getStackGroup().empty() ? "_" : promotion->getStackGroup());
+        file << ",";
+        if (promotion->getPerUserLimit() > 0) {
+            file << promotion->getPerUserLimit();
+        } else {
+            file << "_";
+        }
         
         file << "\n";
     }
@@ -193,6 +515,7 @@ bool PromotionManager::saveToFile() {
  * @brief 添加促销活动
  */
 bool PromotionManager::addPromotion(std::shared_ptr<Promotion> promotion) {
+    std::lock_guard<std::mutex> lock(promotionsMutex);
     if (!promotion) {
         return false;
     }
@@ -200,8 +523,8 @@ bool PromotionManager::addPromotion(std::shared_ptr<Promotion> promotion) {
     // 检查ID是否已存在
     for (const auto& p : promotions) {
         if (p->getPromotionId() == promotion->getPromotionId()) {
-            std::cerr << "错误: 促销活动ID已存在: " 
-                      << promotion->getPromotionId() << std::endl;
+            Logger::getInstance()->warn("PromotionManager", "促销活动ID已存在",
+                                        {{"promotion_id", promotion->getPromotionId()}});
             return false;
         }
     }
@@ -214,13 +537,14 @@ bool PromotionManager::addPromotion(std::shared_ptr<Promotion> promotion) {
  * @brief 删除促销活动
  */
 bool PromotionManager::deletePromotion(const std::string& promotionId) {
+    std::lock_guard<std::mutex> lock(promotionsMutex);
     auto it = std::remove_if(promotions.begin(), promotions.end(),
         [&promotionId](const std::shared_ptr<Promotion>& p) {
             return p->getPromotionId() == promotionId;
         });
     
     if (it == promotions.end()) {
-        std::cerr << "错误: 未找到促销活动ID: " << promotionId << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "未找到促销活动ID", {{"promotion_id", promotionId}});
         return false;
     }
     
@@ -232,6 +556,7 @@ bool PromotionManager::deletePromotion(const std::string& promotionId) {
  * @brief 更新促销活动
  */
 bool PromotionManager::updatePromotion(std::shared_ptr<Promotion> promotion) {
+    std::lock_guard<std::mutex> lock(promotionsMutex);
     if (!promotion) {
         return false;
     }
@@ -243,8 +568,8 @@ bool PromotionManager::updatePromotion(std::shared_ptr<Promotion> promotion) {
         }
     }
     
-    std::cerr << "错误: 未找到促销活动ID: " 
-              << promotion->getPromotionId() << std::endl;
+    Logger::getInstance()->warn("PromotionManager", "未找到促销活动ID",
+                                {{"promotion_id", promotion->getPromotionId()}});
     return false;
 }
 
@@ -252,9 +577,10 @@ bool PromotionManager::updatePromotion(std::shared_ptr<Promotion> promotion) {
  * @brief 修改促销名称
  */
 bool PromotionManager::updatePromotionName(const std::string& promotionId, const std::string& newName) {
+    std::lock_guard<std::mutex> lock(promotionsMutex);
     auto promotion = findPromotionById(promotionId);
     if (!promotion) {
-        std::cerr << "错误: 未找到促销活动ID: " << promotionId << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "未找到促销活动ID", {{"promotion_id", promotionId}});
         return false;
     }
     
@@ -266,14 +592,15 @@ bool PromotionManager::updatePromotionName(const std::string& promotionId, const
  * @brief 修改促销有效期
  */
 bool PromotionManager::updatePromotionTime(const std::string& promotionId, time_t newStartTime, time_t newEndTime) {
+    std::lock_guard<std::mutex> lock(promotionsMutex);
     auto promotion = findPromotionById(promotionId);
     if (!promotion) {
-        std::cerr << "错误: 未找到促销活动ID: " << promotionId << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "未找到促销活动ID", {{"promotion_id", promotionId}});
         return false;
     }
     
     if (newEndTime <= newStartTime) {
-        std::cerr << "错误: 结束时间必须晚于开始时间！" << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "结束时间必须晚于开始时间", {{"promotion_id", promotionId}});
         return false;
     }
     
@@ -286,19 +613,20 @@ bool PromotionManager::updatePromotionTime(const std::string& promotionId, time_
  * @brief 修改折扣促销的折扣率
  */
 bool PromotionManager::updateDiscountRate(const std::string& promotionId, double newRate) {
+    std::lock_guard<std::mutex> lock(promotionsMutex);
     auto promotion = findPromotionById(promotionId);
     if (!promotion) {
-        std::cerr << "错误: 未找到促销活动ID: " << promotionId << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "未找到促销活动ID", {{"promotion_id", promotionId}});
         return false;
     }
     
     if (promotion->getPromotionType() != PromotionType::DISCOUNT) {
-        std::cerr << "错误: 该促销不是折扣促销！" << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "该促销不是折扣促销", {{"promotion_id", promotionId}});
         return false;
     }
     
     if (newRate <= 0 || newRate >= 1) {
-        std::cerr << "错误: 折扣率必须在0到1之间！" << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "折扣率必须在0到1之间", {{"promotion_id", promotionId}});
         return false;
     }
     
@@ -310,14 +638,15 @@ bool PromotionManager::updateDiscountRate(const std::string& promotionId, double
  * @brief 修改折扣促销的目标商品
  */
 bool PromotionManager::updateDiscountTargetItem(const std::string& promotionId, const std::string& newItemId) {
+    std::lock_guard<std::mutex> lock(promotionsMutex);
     auto promotion = findPromotionById(promotionId);
     if (!promotion) {
-        std::cerr << "错误: 未找到促销活动ID: " << promotionId << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "未找到促销活动ID", {{"promotion_id", promotionId}});
         return false;
     }
     
     if (promotion->getPromotionType() != PromotionType::DISCOUNT) {
-        std::cerr << "错误: 该促销不是折扣促销！" << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "该促销不是折扣促销", {{"promotion_id", promotionId}});
         return false;
     }
     
@@ -329,24 +658,25 @@ bool PromotionManager::updateDiscountTargetItem(const std::string& promotionId,
  * @brief 修改满减促销的门槛金额
  */
 bool PromotionManager::updateFullReductionThreshold(const std::string& promotionId, double newThreshold) {
+    std::lock_guard<std::mutex> lock(promotionsMutex);
     auto promotion = findPromotionById(promotionId);
     if (!promotion) {
-        std::cerr << "错误: 未找到促销活动ID: " << promotionId << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "未找到促销活动ID", {{"promotion_id", promotionId}});
         return false;
     }
     
     if (promotion->getPromotionType() != PromotionType::FULL_REDUCTION) {
-        std::cerr << "错误: 该促销不是满减促销！" << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "该促销不是满减促销", {{"promotion_id", promotionId}});
         return false;
     }
     
     if (newThreshold <= 0) {
-        std::cerr << "错误: 门槛金额必须大于0！" << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "门槛金额必须大于0", {{"promotion_id", promotionId}});
         return false;
     }
     
     if (newThreshold <= promotion->getReductionAmount()) {
-        std::cerr << "错误: 门槛金额必须大于减免金额！" << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "门槛金额必须大于减免金额", {{"promotion_id", promotionId}});
         return false;
     }
     
@@ -358,24 +688,25 @@ bool PromotionManager::updateFullReductionThreshold(const std::string& promotion
  * @brief 修改满减促销的减免金额
  */
 bool PromotionManager::updateFullReductionAmount(const std::string& promotionId, double newReduction) {
+    std::lock_guard<std::mutex> lock(promotionsMutex);
     auto promotion = findPromotionById(promotionId);
     if (!promotion) {
-        std::cerr << "错误: 未找到促销活动ID: " << promotionId << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "未找到促销活动ID", {{"promotion_id", promotionId}});
         return false;
     }
     
     if (promotion->getPromotionType() != PromotionType::FULL_REDUCTION) {
-        std::cerr << "错误: 该促销不是满减促销！" << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "该促销不是满减促销", {{"promotion_id", promotionId}});
         return false;
     }
     
     if (newReduction <= 0) {
-        std::cerr << "错误: 减免金额必须大于0！" << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "减免金额必须大于0", {{"promotion_id", promotionId}});
         return false;
     }
     
     if (newReduction >= promotion->getThresholdAmount()) {
-        std::cerr << "错误: 减免金额必须小于门槛金额！" << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "减免金额必须小于门槛金额", {{"promotion_id", promotionId}});
         return false;
     }
     
@@ -387,9 +718,10 @@ bool PromotionManager::updateFullReductionAmount(const std::string& promotionId,
  * @brief 启用或禁用促销活动
  */
 bool PromotionManager::setPromotionActive(const std::string& promotionId, bool isActive) {
+    std::lock_guard<std::mutex> lock(promotionsMutex);
     auto promotion = findPromotionById(promotionId);
     if (!promotion) {
-        std::cerr << "错误: 未找到促销活动ID: " << promotionId << std::endl;
+        Logger::getInstance()->warn("PromotionManager", "未找到促销活动ID", {{"promotion_id", promotionId}});
         return false;
     }
     
@@ -413,170 +745,246 @@ std::shared_ptr<Promotion> PromotionManager::findPromotionById(
 /**
  * @brief 获取某个商品当前有效的折扣促销
  * 
- * 如果有多个有效折扣，返回折扣率最低的（优惠最大）
+ * 如果有多个有效折扣，返回折扣率最低的（优惠最大）；
+ * 只有存在类别折扣或限次折扣时才需要通过商品仓库取得商品类别
  */
 std::shared_ptr<Promotion> PromotionManager::getActiveDiscountForItem(
     const std::string& itemId) {
-    std::shared_ptr<Promotion> bestDiscount = nullptr;
-    double bestRate = 1.0;
+    auto table = currentPricing();
     
-    for (const auto& p : promotions) {
-        if (p->getPromotionType() == PromotionType::DISCOUNT &&
-            p->isValid() &&
-            p->isApplicableToItem(itemId)) {
-            
-            if (p->getDiscountRate() < bestRate) {
-                bestRate = p->getDiscountRate();
-                bestDiscount = p;
-            }
+    std::string category;
+    if ((!table->categoryDiscounts.empty() || !table->limitedDiscounts.empty()) && itemRepository) {
+        auto item = itemRepository->findItemById(itemId);
+        if (item) {
+            category = item->getCategory();
         }
     }
-    
-    return bestDiscount;
+    return bestDiscountFor(*table, itemId, category, "");
 }
 
 /**
  * @brief 获取当前所有有效的满减促销
  */
 std::vector<std::shared_ptr<Promotion>> PromotionManager::getActiveFullReductions() {
-    std::vector<std::shared_ptr<Promotion>> reductions;
-    
-    for (const auto& p : promotions) {
-        if (p->getPromotionType() == PromotionType::FULL_REDUCTION &&
-            p->isValid()) {
-            reductions.push_back(p);
-        }
-    }
-    
-    // 按门槛金额升序排序
-    std::sort(reductions.begin(), reductions.end(),
-        [](const std::shared_ptr<Promotion>& a, const std::shared_ptr<Promotion>& b) {
-            return a->getThresholdAmount() < b->getThresholdAmount();
-        });
-    
-    return reductions;
+    // 定价表中的满减已按门槛金额升序排序
+    return currentPricing()->activeReductions;
 }
 
 /**
  * @brief 计算一组商品的促销优惠结果
  * 
  * 计算流程：
- * 1. 计算每个商品的折扣价
- * 2. 累加得到折扣后总额
- * 3. 应用满减优惠（可叠加多档）
- * 4. 返回详细结果
+ * 1. 计算每个商品的最优折扣及节省金额；顾客用尽某个限次满减时改用不含它的临时阶梯
+ * 2. 使用全部折扣时，在满减阶梯上查询折扣后金额对应的最优满减
+ * 3. 对折扣后金额与原价之间的每个满减门槛，选出凑够该门槛时节省最多的折扣组合，
+ *    若总价更低则改用该组合（金额按分计算，避免浮点误差影响门槛判断）
+ * 4. 按选中的组合生成折扣和满减明细
  */
 PromotionResult PromotionManager::calculatePromotionResult(
-    const std::vector<std::pair<std::shared_ptr<Item>, int>>& items) {
+    const std::vector<std::pair<std::shared_ptr<Item>, int>>& items,
+    const std::string& couponCode,
+    const std::string& userId) {
     
     PromotionResult result;
     result.originalTotal = 0.0;
     result.afterDiscountTotal = 0.0;
     result.totalReduction = 0.0;
+    result.couponCode = couponCode;
+    result.couponStatus = CouponStatus::NOT_FOUND;
+    result.couponDiscount = 0.0;
+    
+    auto table = currentPricing();
+    const ReductionLadder* ladder = &table->ladder;
+    ReductionLadder userLadder;
+    if (!userId.empty() && usageTracker && !table->limitedReductions.empty()) {
+        bool exhausted = std::any_of(table->limitedReductions.begin(), table->limitedReductions.end(),
+            [this, &userId](const std::shared_ptr<Promotion>& p) { return isExhaustedFor(p, userId); });
+        if (exhausted) {
+            std::vector<std::shared_ptr<Promotion>> available;
+            for (const auto& p : table->activeReductions) {
+                if (!isExhaustedFor(p, userId)) {
+                    available.push_back(p);
+                }
+            }
+            userLadder.compile(available, stackingPolicy, maxStacked);
+            ladder = &userLadder;
+        }
+    }
     
-    // 第一步：计算折扣
+    // 第一步：计算每个商品的折扣
+    std::vector<std::shared_ptr<Promotion>> discounts;
+    std::vector<long long> savings;
+    long long originalCents = 0;
+    long long allSavings = 0;
     for (const auto& [item, quantity] : items) {
-        double itemOriginalPrice = item->getPrice() * quantity;
-        result.originalTotal += itemOriginalPrice;
-        
-        // 查找商品的折扣促销
-        auto discount = getActiveDiscountForItem(item->getItemId());
+        long long lineCents = std::llround(item->getPrice() * quantity * 100.0);
+        originalCents += lineCents;
         
+        auto discount = bestDiscountFor(*table, item->getItemId(), item->getCategory(), userId);
+        long long saved = 0;
         if (discount) {
-            double discountedPrice = discount->calculateDiscountForItem(item->getPrice()) * quantity;
-            result.afterDiscountTotal += discountedPrice;
-            
-            // 记录折扣明细
-            double savingsForItem = itemOriginalPrice - discountedPrice;
-            result.itemDiscounts.push_back({item->getItemName(), savingsForItem});
-            
-            // 记录应用的促销
-            std::ostringstream oss;
-            oss << item->getItemName() << " " << discount->getDisplayTag();
-            result.appliedPromotions.push_back(oss.str());
-        } else {
-            result.afterDiscountTotal += itemOriginalPrice;
+            saved = lineCents - std::llround(discount->calculateDiscountForItem(item->getPrice()) * quantity * 100.0);
         }
+        discounts.push_back(discount);
+        savings.push_back(saved);
+        allSavings += saved;
     }
     
-    // 第二步：计算满减
-    auto fullReductions = getActiveFullReductions();
-    for (const auto& reduction : fullReductions) {
-        double reductionAmount = reduction->calculateReduction(result.afterDiscountTotal);
-        if (reductionAmount > 0) {
-            result.totalReduction += reductionAmount;
-            result.appliedPromotions.push_back(reduction->getDisplayTag());
+    // 第二步：使用全部折扣
+    std::vector<bool> use(items.size(), true);
+    long long afterCents = originalCents - allSavings;
+    double bestCost = afterCents / 100.0 - ladder->best(afterCents / 100.0).total;
+    
+    // 第三步：尝试放弃部分折扣以达到更高的满减门槛
+    if (allSavings > 0) {
+        auto thresholds = ladder->thresholdsBetween(afterCents / 100.0, originalCents / 100.0);
+        if (thresholds.size() > MAX_THRESHOLD_CANDIDATES) {
+            thresholds.resize(MAX_THRESHOLD_CANDIDATES);
+        }
+        if (!thresholds.empty()) {
+            DiscountSelector selector(savings);
+            std::vector<bool> candidate;
+            for (double threshold : thresholds) {
+                long long cap = originalCents - static_cast<long long>(std::ceil(threshold * 100.0 - 1e-6));
+                long long candidateCents = originalCents - selector.select(cap, candidate);
+                double cost = candidateCents / 100.0 - ladder->best(candidateCents / 100.0).total;
+                if (cost < bestCost - 1e-9) {
+                    bestCost = cost;
+                    afterCents = candidateCents;
+                    use = candidate;
+                }
+            }
+        }
+    }
+    
+    // 第四步：生成明细
+    result.originalTotal = originalCents / 100.0;
+    result.afterDiscountTotal = afterCents / 100.0;
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (!discounts[i] || !use[i] || savings[i] <= 0) {
+            continue;
+        }
+        const auto& item = items[i].first;
+        result.itemDiscounts.push_back({item->getItemName(), savings[i] / 100.0});
+        
+        std::ostringstream oss;
+        oss << item->getItemName() << " " << table->tagOf(*discounts[i]);
+        result.appliedPromotions.push_back(oss.str());
+        if (std::find(result.appliedPromotionIds.begin(), result.appliedPromotionIds.end(),
+                      discounts[i]->getPromotionId()) == result.appliedPromotionIds.end()) {
+            result.appliedPromotionIds.push_back(discounts[i]->getPromotionId());
+        }
+    }
+    
+    ReductionPick pick = ladder->best(result.afterDiscountTotal);
+    result.totalReduction = pick.total;
+    for (const auto& reduction : pick.promotions) {
+        result.appliedPromotions.push_back(table->tagOf(*reduction));
+        result.appliedPromotionIds.push_back(reduction->getPromotionId());
+    }
+    
+    // 第五步：校验优惠券（不核销），面额超过应付金额时只抵扣到0
+    double payable = result.afterDiscountTotal - result.totalReduction;
+    if (!couponCode.empty() && couponManager) {
+        CouponCheck check = couponManager->check(couponCode, payable, time(nullptr));
+        result.couponStatus = check.status;
+        result.couponName = check.campaignName;
+        if (check.status == CouponStatus::OK) {
+            result.couponDiscount = std::min(check.amountOff, payable);
         }
     }
     
     // 计算最终金额
-    result.finalTotal = result.afterDiscountTotal - result.totalReduction;
+    result.finalTotal = payable - result.couponDiscount;
     result.totalSavings = result.originalTotal - result.finalTotal;
     
     return result;
 }
 
 /**
- * @brief 显示所有促销活动
+ * @brief 为一组商品核销优惠券
  */
-void PromotionManager::displayAllPromotions() {
-    if (promotions.empty()) {
-        std::cout << "暂无促销活动" << std::endl;
+CouponStatus PromotionManager::redeemCoupon(
+    const std::vector<std::pair<std::shared_ptr<Item>, int>>& items,
+    const std::string& couponCode, const std::string& reference,
+    const std::string& userId) {
+    if (!couponManager) {
+        return CouponStatus::NOT_FOUND;
+    }
+    PromotionResult result = calculatePromotionResult(items, "", userId);
+    return couponManager->tryRedeem(couponCode, result.afterDiscountTotal - result.totalReduction, reference);
+}
+
+/**
+ * @brief 为订单记录限次促销的使用次数
+ */
+bool PromotionManager::reserveUsage(const PromotionResult& result, const std::string& userId) {
+    if (!usageTracker || userId.empty()) {
+        return true;
+    }
+    std::vector<std::string> reserved;
+    for (const auto& promotionId : result.appliedPromotionIds) {
+        auto promotion = findPromotionById(promotionId);
+        if (!promotion || promotion->getPerUserLimit() <= 0) {
+            continue;
+        }
+        if (!usageTracker->tryConsume(userId, promotionId, static_cast<uint32_t>(promotion->getPerUserLimit()))) {
+            Logger::getInstance()->warn("PromotionManager", "顾客已用尽促销的使用次数",
+                                        {{"user", userId}, {"promotion_id", promotionId}});
+            for (const auto& id : reserved) {
+                usageTracker->release(userId, id);
+            }
+            return false;
+        }
+        reserved.push_back(promotionId);
+    }
+    return true;
+}
+
+/**
+ * @brief 撤销订单记录的限次促销使用次数
+ */
+void PromotionManager::releaseUsage(const PromotionResult& result, const std::string& userId) {
+    if (!usageTracker || userId.empty()) {
         return;
     }
-    
-    std::cout << "\n========== 所有促销活动 ==========\n";
-    std::cout << std::left << std::setw(12) << "促销ID"
-              << std::setw(20) << "促销名称"
-              << std::setw(15) << "类型"
-              << std::setw(10) << "状态"
-              << std::setw(15) << "有效期至"
-              << std::endl;
-    std::cout << std::string(72, '-') << std::endl;
+    for (const auto& promotionId : result.appliedPromotionIds) {
+        auto promotion = findPromotionById(promotionId);
+        if (promotion && promotion->getPerUserLimit() > 0) {
+            usageTracker->release(userId, promotionId);
+        }
+    }
+}
+
+/**
+ * @brief 查询所有促销活动
+ */
+std::vector<PromotionRow> PromotionManager::queryAllPromotions() const {
+    std::vector<PromotionRow> rows;
+    rows.reserve(promotions.size());
     
     for (const auto& p : promotions) {
         std::string typeStr = (p->getPromotionType() == PromotionType::DISCOUNT) 
                               ? "折扣促销" : "满减促销";
-        std::string statusStr = p->getIsActive() ? "启用" : "禁用";
-        
-        time_t endTime = p->getEndTime();
-        struct tm* timeinfo = localtime(&endTime);
-        char buffer[20];
-        strftime(buffer, sizeof(buffer), "%Y-%m-%d", timeinfo);
-        
-        std::cout << std::left << std::setw(12) << p->getPromotionId()
-                  << std::setw(20) << p->getPromotionName()
-                  << std::setw(15) << typeStr
-                  << std::setw(10) << statusStr
-                  << std::setw(15) << buffer
-                  << std::endl;
+        rows.push_back(PromotionRow{p->getPromotionId(), p->getPromotionName(), typeStr,
+                                    p->getIsActive(), p->isValid(), p->getEndTime(),
+                                    p->getDisplayTag()});
     }
-    std::cout << "================================\n";
+    return rows;
+}
+
+/**
+ * @brief 显示所有促销活动
+ */
+void PromotionManager::displayAllPromotions() {
+    ListingRenderer::renderPromotions(queryAllPromotions(), RenderFormat::CONSOLE, std::cout);
 }
 
 /**
  * @brief 显示有效的促销活动
  */
 void PromotionManager::displayActivePromotions() {
-    std::vector<std::shared_ptr<Promotion>> activePromotions;
-    
-    for (const auto& p : promotions) {
-        if (p->isValid()) {
-            activePromotions.push_back(p);
-        }
-    }
-    
-    if (activePromotions.empty()) {
-        std::cout << "当前无有效的促销活动" << std::endl;
-        return;
-    }
-    
-    std::cout << "\n========== 当前有效促销 ==========\n";
-    for (const auto& p : activePromotions) {
-        std::cout << "• " << p->getPromotionName() 
-                  << " [" << p->getDisplayTag() << "]" << std::endl;
-    }
-    std::cout << "================================\n";
+    ListingRenderer::renderActivePromotions(queryAllPromotions(), std::cout);
 }
 
 /**
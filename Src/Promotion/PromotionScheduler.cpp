@@ -0,0 +1,148 @@
+/**
+ * @file PromotionScheduler.cpp
+ * @brief 促销定时器的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Promotion/PromotionScheduler.h"
+#include "Log/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+
+namespace {
+
+const time_t MAX_SLEEP_SECONDS = 86400;     // 单次最长睡眠时间，避免远期时间点超出时钟范围
+
+} // namespace
+
+/**
+ * @brief 构造函数实现
+ */
+PromotionScheduler::PromotionScheduler(PromotionManager* manager)
+    : manager(manager), running(false), changed(false) {
+}
+
+/**
+ * @brief 析构函数
+ */
+PromotionScheduler::~PromotionScheduler() {
+    stop();
+}
+
+/**
+ * @brief 启动定时器
+ */
+void PromotionScheduler::start() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (running || !manager) {
+            return;
+        }
+        running = true;
+        changed = true;     // 首轮构建当前定价表和事件队列
+    }
+    manager->setChangeListener([this]() { notifyChanged(); });
+    manager->setScheduled(true);
+    timerThread = std::thread(&PromotionScheduler::run, this);
+
+    Logger::getInstance()->info("PromotionScheduler", "促销定时器已启动");
+}
+
+/**
+ * @brief 停止定时器
+ */
+void PromotionScheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+    }
+    wakeup.notify_all();
+    if (timerThread.joinable()) {
+        timerThread.join();
+    }
+    manager->setScheduled(false);
+    manager->setChangeListener(nullptr);
+
+    Logger::getInstance()->info("PromotionScheduler", "促销定时器已停止");
+}
+
+/**
+ * @brief 促销被修改时的回调
+ */
+void PromotionScheduler::notifyChanged() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        changed = true;
+    }
+    wakeup.notify_all();
+}
+
+/**
+ * @brief 定时器线程主循环
+ *
+ * 每轮只做一件事，做完后重新检查标志：重建事件队列、预构建下一时刻的定价表，或等待并触发事件
+ */
+void PromotionScheduler::run() {
+    auto interrupted = [this]() { return !running || changed; };
+    std::unique_lock<std::mutex> lock(mutex);
+    while (running) {
+        if (changed) {
+            changed = false;
+            lock.unlock();
+            time_t now = time(nullptr);
+            manager->installPricingTable(manager->buildPricingTable(now));
+            std::vector<PromotionEvent> upcoming = manager->getUpcomingEvents(now);
+            lock.lock();
+
+            events = decltype(events)(LaterFirst(), std::move(upcoming));
+            prepared.reset();
+            continue;
+        }
+
+        if (events.empty()) {
+            wakeup.wait(lock, interrupted);
+            continue;
+        }
+
+        time_t next = events.top().time;
+        if (!prepared || prepared->builtFor != next) {
+            lock.unlock();
+            auto table = manager->buildPricingTable(next);
+            lock.lock();
+            prepared = std::move(table);
+            continue;
+        }
+
+        time_t now = time(nullptr);
+        if (now < next) {
+            auto deadline = std::chrono::system_clock::from_time_t(std::min(next, now + MAX_SLEEP_SECONDS));
+            wakeup.wait_until(lock, deadline, interrupted);
+            continue;
+        }
+
+        // 到点：取出同一时刻的全部事件，换上预先构建的定价表
+        std::vector<PromotionEvent> fired;
+        while (!events.empty() && events.top().time <= next) {
+            fired.push_back(events.top());
+            events.pop();
+        }
+        auto table = std::move(prepared);
+        prepared.reset();
+        lock.unlock();
+
+        if (!manager->installPricingTable(table)) {
+            // 预构建之后促销被修改过，按当前时间重建（修改通知随后也会重建事件队列）
+            manager->installPricingTable(manager->buildPricingTable(time(nullptr)));
+        }
+        for (const auto& event : fired) {
+            Logger::getInstance()->info("PromotionScheduler", event.activation ? "促销生效" : "促销结束",
+                                        {{"promotion_id", event.promotionId}});
+        }
+        lock.lock();
+    }
+}
@@ -0,0 +1,195 @@
+/**
+ * @file PromotionSimulator.cpp
+ * @brief 促销模拟器的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Promotion/PromotionSimulator.h"
+#include "Promotion/PromotionManager.h"
+#include "Log/Logger.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+const size_t CHUNK_SIZE = 256;      // 每次领取的订单数
+
+/**
+ * @struct PartialReport
+ * @brief 单个工作线程的统计（金额按分累加，合并结果与线程数无关）
+ */
+struct PartialReport {
+    size_t basketCount = 0;
+    size_t affectedCount = 0;
+    long long originalCents = 0;
+    long long discountCents = 0;
+    long long reductionCents = 0;
+    long long finalCents = 0;
+    std::unordered_map<std::string, size_t> promotionUsage;
+};
+
+} // namespace
+
+/**
+ * @brief 构造函数实现
+ *
+ * 忽略有效期时复制候选促销并把有效期放宽为一直有效，不修改调用方的促销对象
+ */
+PromotionSimulator::PromotionSimulator(const std::vector<std::shared_ptr<Promotion>>& promotions,
+                                       IItemRepository* itemRepository,
+                                       StackingPolicy stackingPolicy, size_t maxStacked,
+                                       bool ignoreSchedule, size_t threadCount)
+    : itemRepository(itemRepository), stackingPolicy(stackingPolicy),
+      maxStacked(maxStacked > 0 ? maxStacked : 1), threadCount(threadCount) {
+    if (this->threadCount == 0) {
+        this->threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (const auto& p : promotions) {
+        if (!ignoreSchedule) {
+            candidates.push_back(p);
+            continue;
+        }
+        auto copy = std::make_shared<Promotion>(*p);
+        copy->setStartTime(0);
+        copy->setEndTime(std::numeric_limits<time_t>::max() - 1);
+        candidates.push_back(copy);
+    }
+}
+
+/**
+ * @brief 并行重放count个订单
+ *
+ * 各线程的促销管理器在主线程创建，构建定价表后交给工作线程；主线程也作为一个工作线程
+ */
+SimulationReport PromotionSimulator::run(size_t count, const BasketSource& source) const {
+    auto startTime = std::chrono::steady_clock::now();
+    size_t workers = std::max<size_t>(1, std::min(threadCount, (count + CHUNK_SIZE - 1) / CHUNK_SIZE));
+
+    std::vector<std::unique_ptr<PromotionManager>> managers;
+    for (size_t w = 0; w < workers; ++w) {
+        auto manager = std::make_unique<PromotionManager>("");
+        manager->assignPromotions(candidates);
+        manager->setItemRepository(itemRepository);
+        manager->setStackingPolicy(stackingPolicy, maxStacked);
+        managers.push_back(std::move(manager));
+    }
+
+    std::vector<PartialReport> partials(workers);
+    std::atomic<size_t> cursor(0);
+    auto work = [&](size_t w) {
+        PromotionManager& manager = *managers[w];
+        PartialReport& partial = partials[w];
+        std::vector<std::pair<std::shared_ptr<Item>, int>> basket;
+        while (true) {
+            size_t begin = cursor.fetch_add(CHUNK_SIZE);
+            if (begin >= count) {
+                break;
+            }
+            size_t end = std::min(count, begin + CHUNK_SIZE);
+            for (size_t i = begin; i < end; ++i) {
+                basket.clear();
+                source(i, basket);
+                if (basket.empty()) {
+                    continue;
+                }
+                PromotionResult result = manager.calculatePromotionResult(basket);
+                long long original = std::llround(result.originalTotal * 100.0);
+                long long afterDiscount = std::llround(result.afterDiscountTotal * 100.0);
+                long long reduction = std::llround(result.totalReduction * 100.0);
+
+                ++partial.basketCount;
+                partial.originalCents += original;
+                partial.discountCents += original - afterDiscount;
+                partial.reductionCents += reduction;
+                partial.finalCents += afterDiscount - reduction;
+                if (!result.appliedPromotionIds.empty()) {
+                    ++partial.affectedCount;
+                }
+                for (const auto& promotionId : result.appliedPromotionIds) {
+                    ++partial.promotionUsage[promotionId];
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t w = 1; w < workers; ++w) {
+        threads.emplace_back(work, w);
+    }
+    work(0);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // 合并各线程的统计
+    SimulationReport report;
+    PartialReport total;
+    for (auto& partial : partials) {
+        total.basketCount += partial.basketCount;
+        total.affectedCount += partial.affectedCount;
+        total.originalCents += partial.originalCents;
+        total.discountCents += partial.discountCents;
+        total.reductionCents += partial.reductionCents;
+        total.finalCents += partial.finalCents;
+        for (const auto& entry : partial.promotionUsage) {
+            total.promotionUsage[entry.first] += entry.second;
+        }
+    }
+    report.basketCount = total.basketCount;
+    report.affectedCount = total.affectedCount;
+    report.originalTotal = total.originalCents / 100.0;
+    report.discountCost = total.discountCents / 100.0;
+    report.reductionCost = total.reductionCents / 100.0;
+    report.finalTotal = total.finalCents / 100.0;
+    report.threads = workers;
+    report.promotionUsage.assign(total.promotionUsage.begin(), total.promotionUsage.end());
+    std::sort(report.promotionUsage.begin(), report.promotionUsage.end(),
+              [](const std::pair<std::string, size_t>& a, const std::pair<std::string, size_t>& b) {
+                  return a.second != b.second ? a.second > b.second : a.first < b.first;
+              });
+    report.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    Logger::getInstance()->info("PromotionSimulator", "促销模拟完成",
+                                {{"baskets", std::to_string(report.basketCount)},
+                                 {"threads", std::to_string(report.threads)},
+                                 {"cost", std::to_string(report.totalCost())}});
+    return report;
+}
+
+/**
+ * @brief 重放历史订单
+ *
+ * 按下单时的价格重建商品，类别取自当前商品仓库
+ */
+SimulationReport PromotionSimulator::replayOrders(const std::vector<std::shared_ptr<Order>>& orders) const {
+    IItemRepository* repository = itemRepository;
+    return run(orders.size(), [&orders, repository](size_t i, std::vector<std::pair<std::shared_ptr<Item>, int>>& basket) {
+        for (const auto& line : orders[i]->getItems()) {
+            std::string category;
+            if (repository) {
+                auto current = repository->findItemById(line.itemId);
+                if (current) {
+                    category = current->getCategory();
+                }
+            }
+            basket.push_back({std::make_shared<Item>(line.itemId, line.itemName, category, line.price, "", 0),
+                              line.quantity});
+        }
+    });
+}
+
+/**
+ * @brief 重放购物车（按当前价格）
+ */
+SimulationReport PromotionSimulator::replayCarts(const std::vector<std::shared_ptr<ShoppingCart>>& carts) const {
+    return run(carts.size(), [&carts](size_t i, std::vector<std::pair<std::shared_ptr<Item>, int>>& basket) {
+        const auto& items = carts[i]->getCartItems();
+        basket.assign(items.begin(), items.end());
+    });
+}
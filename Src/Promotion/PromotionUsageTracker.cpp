@@ -0,0 +1,393 @@
+/**
+ * @file PromotionUsageTracker.cpp
+ * @brief 每位顾客的促销使用次数计数器的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Promotion/PromotionUsageTracker.h"
+#include "Log/Logger.h"
+#include <filesystem>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+const char USAGE_MAGIC[8] = {'P', 'R', 'M', 'U', 'S', 'E', 'G', '1'};   // 日志魔数
+const size_t HEADER_SIZE = 8;               // 文件头字节数
+const size_t RECORD_HEADER_SIZE = 16;       // 记录头部字节数
+const size_t MAX_FIELD_LENGTH = 0xFFFF;     // 用户名和促销ID的最大长度
+const uint64_t COMPACT_MIN_RECORDS = 1024;  // 日志至少有这么多条记录才考虑压缩
+
+/**
+ * @brief 按小端序写入整数
+ */
+void putLE(char* buf, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) {
+        buf[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+/**
+ * @brief 按小端序读取整数
+ */
+uint64_t getLE(const char* buf, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<uint8_t>(buf[i])) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief 64位整数混洗（SplitMix64的终结步骤）
+ */
+uint64_t mix64(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * @brief 编码一条日志记录
+ */
+std::string encodeRecord(const std::string& userId, const std::string& promotionId, int32_t delta) {
+    std::string record(RECORD_HEADER_SIZE, '\0');
+    putLE(&record[0], static_cast<uint64_t>(static_cast<int64_t>(std::time(nullptr))), 8);
+    putLE(&record[8], static_cast<uint32_t>(delta), 4);
+    putLE(&record[12], userId.size(), 2);
+    putLE(&record[14], promotionId.size(), 2);
+    record += userId;
+    record += promotionId;
+    return record;
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数实现
+ */
+PromotionUsageTracker::PromotionUsageTracker(const std::string& filePath)
+    : filePath(filePath), recordCount(0) {
+}
+
+/**
+ * @brief 键所在的段
+ */
+PromotionUsageTracker::Stripe& PromotionUsageTracker::stripeOf(uint64_t key) const {
+    return stripes[mix64(key) & (STRIPE_COUNT - 1)];
+}
+
+/**
+ * @brief 在段中查找键的位置
+ */
+size_t PromotionUsageTracker::probe(const Stripe& stripe, uint64_t key) {
+    size_t mask = stripe.keys.size() - 1;
+    size_t pos = static_cast<size_t>(mix64(key) >> 6) & mask;
+    while (stripe.keys[pos] != 0 && stripe.keys[pos] != key) {
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+/**
+ * @brief 获取键的计数引用，不存在时插入
+ *
+ * 装填率超过70%时容量翻倍并重新散列
+ */
+uint32_t& PromotionUsageTracker::slotFor(Stripe& stripe, uint64_t key) {
+    if (stripe.keys.empty() || (stripe.size + 1) * 10 > stripe.keys.size() * 7) {
+        std::vector<uint64_t> oldKeys;
+        std::vector<uint32_t> oldCounts;
+        oldKeys.swap(stripe.keys);
+        oldCounts.swap(stripe.counts);
+        size_t capacity = oldKeys.empty() ? 16 : oldKeys.size() * 2;
+        stripe.keys.assign(capacity, 0);
+        stripe.counts.assign(capacity, 0);
+        for (size_t i = 0; i < oldKeys.size(); ++i) {
+            if (oldKeys[i] != 0) {
+                size_t pos = probe(stripe, oldKeys[i]);
+                stripe.keys[pos] = oldKeys[i];
+                stripe.counts[pos] = oldCounts[i];
+            }
+        }
+    }
+
+    size_t pos = probe(stripe, key);
+    if (stripe.keys[pos] == 0) {
+        stripe.keys[pos] = key;
+        ++stripe.size;
+    }
+    return stripe.counts[pos];
+}
+
+/**
+ * @brief 查找已有编号
+ *
+ * 键为(用户编号 + 1) << 32 | 促销编号，保证不为0
+ */
+bool PromotionUsageTracker::lookupKey(const std::string& userId, const std::string& promotionId,
+                                      uint64_t& key) const {
+    std::shared_lock<std::shared_mutex> lock(internMutex);
+    auto user = userIds.find(userId);
+    if (user == userIds.end()) {
+        return false;
+    }
+    auto promotion = promotionIds.find(promotionId);
+    if (promotion == promotionIds.end()) {
+        return false;
+    }
+    key = (static_cast<uint64_t>(user->second) + 1) << 32 | promotion->second;
+    return true;
+}
+
+/**
+ * @brief 获取编号，不存在时分配
+ */
+uint64_t PromotionUsageTracker::internKey(const std::string& userId, const std::string& promotionId) {
+    uint64_t key = 0;
+    if (lookupKey(userId, promotionId, key)) {
+        return key;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(internMutex);
+    auto user = userIds.find(userId);
+    if (user == userIds.end()) {
+        user = userIds.emplace(userId, static_cast<uint32_t>(userNames.size())).first;
+        userNames.push_back(userId);
+    }
+    auto promotion = promotionIds.find(promotionId);
+    if (promotion == promotionIds.end()) {
+        promotion = promotionIds.emplace(promotionId, static_cast<uint32_t>(promotionNames.size())).first;
+        promotionNames.push_back(promotionId);
+    }
+    return (static_cast<uint64_t>(user->second) + 1) << 32 | promotion->second;
+}
+
+/**
+ * @brief 追加一条日志记录
+ */
+bool PromotionUsageTracker::appendLog(const std::string& userId, const std::string& promotionId, int32_t delta) {
+    std::string record = encodeRecord(userId, promotionId, delta);
+
+    std::lock_guard<std::mutex> lock(logMutex);
+    if (!writer.is_open()) {
+        return false;
+    }
+    writer.write(record.data(), static_cast<std::streamsize>(record.size()));
+    writer.flush();
+    if (!writer) {
+        writer.clear();
+        Logger::getInstance()->error("PromotionUsageTracker", "写入促销使用记录失败",
+                                     {{"path", filePath}, {"user", userId}, {"promotion", promotionId}});
+        return false;
+    }
+    ++recordCount;
+    return true;
+}
+
+/**
+ * @brief 加载日志
+ *
+ * 顺序重放全部记录，末尾不完整的记录（写入中断）被截断
+ */
+bool PromotionUsageTracker::loadFromFile() {
+    std::error_code ec;
+    uintmax_t fileSize = std::filesystem::exists(filePath, ec) ? std::filesystem::file_size(filePath, ec) : 0;
+    recordCount = 0;
+
+    if (fileSize < HEADER_SIZE) {
+        std::ofstream create(filePath, std::ios::binary | std::ios::trunc);
+        if (!create.is_open()) {
+            Logger::getInstance()->error("PromotionUsageTracker", "无法创建促销使用记录文件", {{"path", filePath}});
+            return false;
+        }
+        create.write(USAGE_MAGIC, HEADER_SIZE);
+    } else {
+        std::ifstream in(filePath, std::ios::binary);
+        std::vector<char> data(static_cast<size_t>(fileSize));
+        if (!in.read(data.data(), static_cast<std::streamsize>(data.size())) ||
+            std::memcmp(data.data(), USAGE_MAGIC, HEADER_SIZE) != 0) {
+            Logger::getInstance()->error("PromotionUsageTracker", "促销使用记录文件格式错误", {{"path", filePath}});
+            return false;
+        }
+        in.close();
+
+        size_t offset = HEADER_SIZE;
+        while (offset + RECORD_HEADER_SIZE <= data.size()) {
+            const char* head = data.data() + offset;
+            int32_t delta = static_cast<int32_t>(static_cast<uint32_t>(getLE(head + 8, 4)));
+            size_t userLength = static_cast<size_t>(getLE(head + 12, 2));
+            size_t promotionLength = static_cast<size_t>(getLE(head + 14, 2));
+            size_t end = offset + RECORD_HEADER_SIZE + userLength + promotionLength;
+            if (end > data.size()) {
+                break;
+            }
+            std::string userId(head + RECORD_HEADER_SIZE, userLength);
+            std::string promotionId(head + RECORD_HEADER_SIZE + userLength, promotionLength);
+
+            uint64_t key = internKey(userId, promotionId);
+            Stripe& stripe = stripeOf(key);
+            uint32_t& count = slotFor(stripe, key);
+            long long updated = static_cast<long long>(count) + delta;
+            count = static_cast<uint32_t>(updated < 0 ? 0 : updated);
+            ++recordCount;
+            offset = end;
+        }
+
+        if (offset != data.size()) {
+            std::filesystem::resize_file(filePath, offset, ec);
+            Logger::getInstance()->warn("PromotionUsageTracker", "截断不完整的促销使用记录",
+                                        {{"path", filePath}, {"bytes", std::to_string(data.size() - offset)}});
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(logMutex);
+        writer.close();
+        writer.open(filePath, std::ios::binary | std::ios::app);
+        if (!writer.is_open()) {
+            Logger::getInstance()->error("PromotionUsageTracker", "无法打开促销使用记录文件", {{"path", filePath}});
+            return false;
+        }
+    }
+
+    size_t entries = size();
+    if (recordCount >= COMPACT_MIN_RECORDS && recordCount > 2 * entries) {
+        compact();
+    }
+
+    Logger::getInstance()->info("PromotionUsageTracker", "促销使用记录已加载",
+                                {{"records", std::to_string(recordCount)}, {"entries", std::to_string(entries)}});
+    return true;
+}
+
+/**
+ * @brief 把当前计数重写为紧凑日志
+ *
+ * 先写临时文件再替换，替换失败时保留原日志
+ */
+bool PromotionUsageTracker::compact() {
+    std::lock_guard<std::mutex> lock(logMutex);
+    std::string tempPath = filePath + ".tmp";
+    uint64_t written = 0;
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        out.write(USAGE_MAGIC, HEADER_SIZE);
+        std::shared_lock<std::shared_mutex> internLock(internMutex);
+        for (auto& stripe : stripes) {
+            std::lock_guard<std::mutex> stripeLock(stripe.mutex);
+            for (size_t i = 0; i < stripe.keys.size(); ++i) {
+                if (stripe.keys[i] == 0 || stripe.counts[i] == 0) {
+                    continue;
+                }
+                const std::string& userId = userNames[static_cast<size_t>((stripe.keys[i] >> 32) - 1)];
+                const std::string& promotionId = promotionNames[static_cast<size_t>(stripe.keys[i] & 0xFFFFFFFFULL)];
+                std::string record = encodeRecord(userId, promotionId, static_cast<int32_t>(stripe.counts[i]));
+                out.write(record.data(), static_cast<std::streamsize>(record.size()));
+                ++written;
+            }
+        }
+        out.flush();
+        if (!out) {
+            Logger::getInstance()->warn("PromotionUsageTracker", "压缩促销使用记录失败", {{"path", tempPath}});
+            return false;
+        }
+    }
+
+    writer.close();
+    std::error_code ec;
+    std::filesystem::rename(tempPath, filePath, ec);
+    writer.open(filePath, std::ios::binary | std::ios::app);
+    if (ec) {
+        Logger::getInstance()->warn("PromotionUsageTracker", "替换促销使用记录失败", {{"path", filePath}});
+        return false;
+    }
+
+    Logger::getInstance()->info("PromotionUsageTracker", "促销使用记录已压缩",
+                                {{"before", std::to_string(recordCount)}, {"after", std::to_string(written)}});
+    recordCount = written;
+    return true;
+}
+
+/**
+ * @brief 获取顾客使用某个促销的次数
+ */
+uint32_t PromotionUsageTracker::getUsage(const std::string& userId, const std::string& promotionId) const {
+    uint64_t key = 0;
+    if (!lookupKey(userId, promotionId, key)) {
+        return 0;
+    }
+    Stripe& stripe = stripeOf(key);
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    if (stripe.keys.empty()) {
+        return 0;
+    }
+    size_t pos = probe(stripe, key);
+    return stripe.keys[pos] == key ? stripe.counts[pos] : 0;
+}
+
+/**
+ * @brief 未达到上限时把使用次数加一
+ *
+ * 检查和加一在段锁内完成；日志写入失败时撤销
+ */
+bool PromotionUsageTracker::tryConsume(const std::string& userId, const std::string& promotionId, uint32_t limit) {
+    if (userId.size() > MAX_FIELD_LENGTH || promotionId.size() > MAX_FIELD_LENGTH) {
+        return false;
+    }
+
+    uint64_t key = internKey(userId, promotionId);
+    Stripe& stripe = stripeOf(key);
+    {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        uint32_t& count = slotFor(stripe, key);
+        if (limit > 0 && count >= limit) {
+            return false;
+        }
+        ++count;
+    }
+
+    if (!appendLog(userId, promotionId, 1)) {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        uint32_t& count = slotFor(stripe, key);
+        count = count > 0 ? count - 1 : 0;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 撤销一次使用
+ */
+void PromotionUsageTracker::release(const std::string& userId, const std::string& promotionId) {
+    uint64_t key = 0;
+    if (!lookupKey(userId, promotionId, key)) {
+        return;
+    }
+    Stripe& stripe = stripeOf(key);
+    {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        uint32_t& count = slotFor(stripe, key);
+        if (count == 0) {
+            return;
+        }
+        --count;
+    }
+    appendLog(userId, promotionId, -1);
+}
+
+/**
+ * @brief 获取计数项数
+ */
+size_t PromotionUsageTracker::size() const {
+    size_t total = 0;
+    for (auto& stripe : stripes) {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        total += stripe.size;
+    }
+    return total;
+}
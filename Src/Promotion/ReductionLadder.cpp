@@ -0,0 +1,200 @@
+/**
+ * @file ReductionLadder.cpp
+ * @brief 满减阶梯的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Promotion/ReductionLadder.h"
+#include <algorithm>
+#include <map>
+#include <cmath>
+
+namespace {
+
+const size_t MEMO_LIMIT = 4096;     // 查询缓存的最大条目数，超过后清空
+
+} // namespace
+
+/**
+ * @brief 门槛不超过amount的档数
+ */
+size_t ReductionLadder::Ladder::reachable(double amount) const {
+    return static_cast<size_t>(std::upper_bound(thresholds.begin(), thresholds.end(), amount) - thresholds.begin());
+}
+
+/**
+ * @brief 构造函数实现
+ */
+ReductionLadder::ReductionLadder() : policy(StackingPolicy::STACK_ALL), maxStacked(1) {
+}
+
+/**
+ * @brief 按门槛排序并计算前缀最优
+ */
+void ReductionLadder::buildLadder(Ladder& ladder, std::vector<size_t> members) {
+    std::sort(members.begin(), members.end(), [this](size_t a, size_t b) {
+        return promotions[a]->getThresholdAmount() < promotions[b]->getThresholdAmount();
+    });
+
+    ladder = Ladder();
+    for (size_t i = 0; i < members.size(); ++i) {
+        size_t index = members[i];
+        ladder.thresholds.push_back(promotions[index]->getThresholdAmount());
+        ladder.promotionIndex.push_back(index);
+
+        size_t best = index;
+        if (i > 0 && promotions[ladder.prefixBest[i - 1]]->getReductionAmount() >= promotions[index]->getReductionAmount()) {
+            best = ladder.prefixBest[i - 1];
+        }
+        ladder.prefixBest.push_back(best);
+    }
+}
+
+/**
+ * @brief 编译满减阶梯
+ */
+void ReductionLadder::compile(const std::vector<std::shared_ptr<Promotion>>& reductions,
+                              StackingPolicy newPolicy, size_t newMaxStacked) {
+    policy = newPolicy;
+    maxStacked = newMaxStacked > 0 ? newMaxStacked : 1;
+    promotions = reductions;
+    groups.clear();
+    {
+        std::lock_guard<std::mutex> lock(memoMutex);
+        memo.clear();
+    }
+
+    allThresholds.clear();
+    for (const auto& p : promotions) {
+        allThresholds.push_back(p->getThresholdAmount());
+    }
+    std::sort(allThresholds.begin(), allThresholds.end());
+    allThresholds.erase(std::unique(allThresholds.begin(), allThresholds.end()), allThresholds.end());
+
+    // 只取最优时所有满减视为同一组
+    std::map<std::string, std::vector<size_t>> members;
+    std::vector<size_t> loose;
+    for (size_t i = 0; i < promotions.size(); ++i) {
+        if (policy == StackingPolicy::BEST_OF) {
+            members[""].push_back(i);
+        } else if (promotions[i]->getStackGroup().empty()) {
+            loose.push_back(i);
+        } else {
+            members[promotions[i]->getStackGroup()].push_back(i);
+        }
+    }
+    for (auto& entry : members) {
+        groups.emplace_back();
+        buildLadder(groups.back(), std::move(entry.second));
+    }
+    buildLadder(ungrouped, std::move(loose));
+
+    // 最多叠加N个时，未分组阶梯保存前缀前N名
+    if (policy != StackingPolicy::MAX_N) {
+        return;
+    }
+    for (size_t i = 0; i < ungrouped.promotionIndex.size(); ++i) {
+        size_t index = ungrouped.promotionIndex[i];
+        std::vector<size_t> top = i > 0 ? ungrouped.prefixTop[i - 1] : std::vector<size_t>();
+        auto pos = std::find_if(top.begin(), top.end(), [this, index](size_t other) {
+            return promotions[other]->getReductionAmount() < promotions[index]->getReductionAmount();
+        });
+        top.insert(pos, index);
+        if (top.size() > maxStacked) {
+            top.pop_back();
+        }
+        ungrouped.prefixTop.push_back(std::move(top));
+    }
+}
+
+/**
+ * @brief 查询金额下减免最多的合法满减组合
+ *
+ * 只在查找和写入缓存时持锁，计算过程不持锁
+ */
+ReductionPick ReductionLadder::best(double amount) const {
+    long long key = std::llround(amount * 100.0);
+    {
+        std::lock_guard<std::mutex> lock(memoMutex);
+        auto cached = memo.find(key);
+        if (cached != memo.end()) {
+            return cached->second;
+        }
+    }
+
+    // 候选：每个互斥组可用的最大减免，以及未分组阶梯中可用的满减
+    std::vector<size_t> candidates;
+    for (const auto& group : groups) {
+        size_t reached = group.reachable(amount);
+        if (reached > 0) {
+            candidates.push_back(group.prefixBest[reached - 1]);
+        }
+    }
+    size_t reached = ungrouped.reachable(amount);
+    if (reached > 0) {
+        if (policy == StackingPolicy::STACK_ALL) {
+            candidates.insert(candidates.end(), ungrouped.promotionIndex.begin(),
+                              ungrouped.promotionIndex.begin() + reached);
+        } else if (policy == StackingPolicy::MAX_N) {
+            const auto& top = ungrouped.prefixTop[reached - 1];
+            candidates.insert(candidates.end(), top.begin(), top.end());
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [this](size_t a, size_t b) {
+        return promotions[a]->getReductionAmount() > promotions[b]->getReductionAmount();
+    });
+    size_t limit = candidates.size();
+    if (policy == StackingPolicy::MAX_N) {
+        limit = std::min(limit, maxStacked);
+    } else if (policy == StackingPolicy::BEST_OF) {
+        limit = std::min<size_t>(limit, 1);
+    }
+
+    ReductionPick pick;
+    for (size_t i = 0; i < limit; ++i) {
+        pick.total += promotions[candidates[i]]->getReductionAmount();
+        pick.promotions.push_back(promotions[candidates[i]]);
+    }
+    std::lock_guard<std::mutex> lock(memoMutex);
+    if (memo.size() >= MEMO_LIMIT) {
+        memo.clear();
+    }
+    memo.emplace(key, pick);
+    return pick;
+}
+
+/**
+ * @brief 获取位于(low, high]之间的门槛
+ */
+std::vector<double> ReductionLadder::thresholdsBetween(double low, double high) const {
+    auto first = std::upper_bound(allThresholds.begin(), allThresholds.end(), low);
+    auto last = std::upper_bound(allThresholds.begin(), allThresholds.end(), high);
+    return std::vector<double>(first, last);
+}
+
+/**
+ * @brief 解析叠加策略字符串
+ */
+StackingPolicy ReductionLadder::parsePolicy(const std::string& str) {
+    if (str == "best_of") {
+        return StackingPolicy::BEST_OF;
+    }
+    if (str == "max_n") {
+        return StackingPolicy::MAX_N;
+    }
+    return StackingPolicy::STACK_ALL;
+}
+
+/**
+ * @brief 获取叠加策略的显示字符串
+ */
+std::string ReductionLadder::policyToString(StackingPolicy policy) {
+    switch (policy) {
+        case StackingPolicy::STACK_ALL: return "全部叠加";
+        case StackingPolicy::BEST_OF:   return "只取最优";
+        case StackingPolicy::MAX_N:     return "最多叠加N个";
+    }
+    return "未知";
+}
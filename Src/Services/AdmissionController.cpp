@@ -0,0 +1,127 @@
+/**
+ * @file AdmissionController.cpp
+ * @brief 准入控制器的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Services/AdmissionController.h"
+#include "Log/Logger.h"
+#include <algorithm>
+
+/**
+ * @brief 构造函数实现
+ */
+AdmissionController::AdmissionController() {
+    for (size_t i = 0; i < OPERATION_CLASS_COUNT; ++i) {
+        lanes[i].stats.operationClass = static_cast<OperationClass>(i);
+    }
+}
+
+/**
+ * @brief 设置某类操作的准入限制
+ */
+void AdmissionController::configure(OperationClass operationClass, const AdmissionLimits& limits) {
+    Lane& lane = lanes[static_cast<size_t>(operationClass)];
+    {
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        lane.limits = limits;
+    }
+    lane.ready.notify_all();
+    Logger::getInstance()->info("AdmissionController", "准入限制已设置",
+                                {{"class", classToString(operationClass)},
+                                 {"concurrent", std::to_string(limits.maxConcurrent)},
+                                 {"queue", std::to_string(limits.maxQueued)},
+                                 {"wait_ms", std::to_string(limits.maxWaitMs)}});
+}
+
+/**
+ * @brief 申请执行名额
+ *
+ * 排队者只在自己位于队首且有空位时准入，保证先到先得；
+ * 准入或超时离开队列后唤醒其他排队者，让新的队首重新判断
+ */
+AdmissionController::Permit AdmissionController::admit(OperationClass operationClass) {
+    Lane& lane = lanes[static_cast<size_t>(operationClass)];
+    Clock::time_point arrived = Clock::now();
+    std::unique_lock<std::mutex> lock(lane.mutex);
+
+    size_t limit = lane.limits.maxConcurrent;
+    if (limit == 0 || (lane.running < limit && lane.waiting.empty())) {
+        ++lane.running;
+        ++lane.stats.admitted;
+        return Permit(this, operationClass, 0.0);
+    }
+    if (lane.waiting.size() >= lane.limits.maxQueued) {
+        ++lane.stats.rejected;
+        return Permit();
+    }
+
+    uint64_t ticket = lane.nextTicket++;
+    lane.waiting.push_back(ticket);
+    lane.stats.peakQueued = std::max(lane.stats.peakQueued, lane.waiting.size());
+    Clock::time_point deadline = arrived + std::chrono::milliseconds(std::max(0, lane.limits.maxWaitMs));
+    bool ready = lane.ready.wait_until(lock, deadline, [&lane, ticket]() {
+        return lane.waiting.front() == ticket &&
+               (lane.limits.maxConcurrent == 0 || lane.running < lane.limits.maxConcurrent);
+    });
+
+    double waitedMs = std::chrono::duration<double, std::milli>(Clock::now() - arrived).count();
+    if (!ready) {
+        lane.waiting.erase(std::find(lane.waiting.begin(), lane.waiting.end(), ticket));
+        ++lane.stats.timedOut;
+        lock.unlock();
+        lane.ready.notify_all();
+        return Permit();
+    }
+
+    lane.waiting.pop_front();
+    ++lane.running;
+    ++lane.stats.admitted;
+    ++lane.stats.queuedAdmitted;
+    lane.stats.totalWaitMs += waitedMs;
+    lane.stats.maxWaitMs = std::max(lane.stats.maxWaitMs, waitedMs);
+    lock.unlock();
+    lane.ready.notify_all();
+    return Permit(this, operationClass, waitedMs);
+}
+
+/**
+ * @brief 归还执行名额
+ */
+void AdmissionController::release(OperationClass operationClass) {
+    Lane& lane = lanes[static_cast<size_t>(operationClass)];
+    {
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        --lane.running;
+    }
+    lane.ready.notify_all();
+}
+
+/**
+ * @brief 获取各类操作的统计
+ */
+std::vector<AdmissionStats> AdmissionController::getStats() const {
+    std::vector<AdmissionStats> result;
+    for (const auto& lane : lanes) {
+        std::lock_guard<std::mutex> lock(lane.mutex);
+        AdmissionStats stats = lane.stats;
+        stats.limits = lane.limits;
+        stats.running = lane.running;
+        stats.queued = lane.waiting.size();
+        result.push_back(stats);
+    }
+    return result;
+}
+
+/**
+ * @brief 获取操作类别的显示字符串
+ */
+std::string AdmissionController::classToString(OperationClass operationClass) {
+    switch (operationClass) {
+        case OperationClass::SEARCH:    return "模糊搜索";
+        case OperationClass::LISTING:   return "商品列表";
+        case OperationClass::REPORT:    return "报表生成";
+    }
+    return "未知";
+}
@@ -0,0 +1,386 @@
+/**
+ * @file CoPurchaseEngine.cpp
+ * @brief “经常一起购买”推荐引擎的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Services/CoPurchaseEngine.h"
+#include "Log/Logger.h"
+#include <algorithm>
+#include <future>
+#include <thread>
+#include <chrono>
+#include <unordered_set>
+
+namespace {
+
+const size_t MAX_ITEMS_PER_ORDER = 64;      // 单个订单参与共现统计的商品种类上限（避免平方级膨胀）
+
+/**
+ * @brief 邻居排序：共现次数降序，次数相同时按下标升序
+ */
+bool neighborBefore(const CoPurchaseEngine::Neighbor& a, const CoPurchaseEngine::Neighbor& b) {
+    return a.count != b.count ? a.count > b.count : a.item < b.item;
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数实现
+ */
+CoPurchaseEngine::CoPurchaseEngine(size_t neighborsPerItem)
+    : neighborsPerItem(neighborsPerItem > 0 ? neighborsPerItem : 1), rowOffsets(1, 0) {
+}
+
+/**
+ * @brief 获取或分配商品下标
+ */
+uint32_t CoPurchaseEngine::internItem(const std::string& itemId) {
+    auto it = indexOf.find(itemId);
+    if (it != indexOf.end()) {
+        return it->second;
+    }
+    uint32_t index = static_cast<uint32_t>(itemIds.size());
+    indexOf.emplace(itemId, index);
+    itemIds.push_back(itemId);
+    counts.emplace_back();
+    return index;
+}
+
+/**
+ * @brief 从一行完整计数中选出前K个邻居
+ */
+std::vector<CoPurchaseEngine::Neighbor>
+CoPurchaseEngine::topNeighbors(const std::vector<Neighbor>& row) const {
+    std::vector<Neighbor> result(row);
+    size_t keep = std::min(neighborsPerItem, result.size());
+    std::partial_sort(result.begin(), result.begin() + keep, result.end(), neighborBefore);
+    result.resize(keep);
+    return result;
+}
+
+/**
+ * @brief 获取某行当前的邻居列表
+ */
+void CoPurchaseEngine::rowNeighbors(uint32_t row, const Neighbor*& begin, const Neighbor*& end) const {
+    begin = end = nullptr;
+    auto it = overlay.find(row);
+    if (it != overlay.end()) {
+        begin = it->second.data();
+        end = begin + it->second.size();
+        return;
+    }
+    if (static_cast<size_t>(row) + 1 < rowOffsets.size()) {
+        begin = neighbors.data() + rowOffsets[row];
+        end = neighbors.data() + rowOffsets[row + 1];
+    }
+}
+
+/**
+ * @brief 把覆盖表合并回CSR
+ */
+void CoPurchaseEngine::compact() {
+    std::vector<uint64_t> newOffsets(itemIds.size() + 1, 0);
+    std::vector<Neighbor> newNeighbors;
+    newNeighbors.reserve(neighbors.size() + overlay.size() * neighborsPerItem);
+
+    for (uint32_t row = 0; row < itemIds.size(); ++row) {
+        const Neighbor* begin;
+        const Neighbor* end;
+        rowNeighbors(row, begin, end);
+        newNeighbors.insert(newNeighbors.end(), begin, end);
+        newOffsets[row + 1] = newNeighbors.size();
+    }
+
+    rowOffsets.swap(newOffsets);
+    neighbors.swap(newNeighbors);
+    overlay.clear();
+}
+
+/**
+ * @brief 用全部订单重建共现矩阵
+ *
+ * 1. 并行收集各分块中出现的商品ID，合并后分配下标
+ * 2. 并行把各订单转换为去重后的下标列表，同时统计每个分块中每行的共现对数
+ * 3. 由各行、各分块的共现对数算出写入位置，并行把共现对的列下标写入按行分段的数组（计数排序）
+ * 4. 按行分段并行排序、合并相同列得到完整计数，并截取前K个邻居
+ * 5. 按行拼接为CSR
+ */
+void CoPurchaseEngine::rebuild(const std::vector<std::shared_ptr<Order>>& orders, size_t threadCount) {
+    auto startTime = std::chrono::steady_clock::now();
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t chunkSize = std::max<size_t>(1, (orders.size() + threadCount - 1) / threadCount);
+    std::vector<std::pair<size_t, size_t>> chunks;
+    for (size_t begin = 0; begin < orders.size(); begin += chunkSize) {
+        chunks.emplace_back(begin, std::min(orders.size(), begin + chunkSize));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    indexOf.clear();
+    itemIds.clear();
+    counts.clear();
+    overlay.clear();
+
+    // 1. 收集商品ID
+    std::vector<std::future<std::unordered_set<std::string>>> idWorkers;
+    for (const auto& chunk : chunks) {
+        idWorkers.push_back(std::async(std::launch::async, [&orders, chunk]() {
+            std::unordered_set<std::string> ids;
+            for (size_t i = chunk.first; i < chunk.second; ++i) {
+                for (const auto& orderItem : orders[i]->getItems()) {
+                    ids.insert(orderItem.itemId);
+                }
+            }
+            return ids;
+        }));
+    }
+    for (auto& worker : idWorkers) {
+        for (const auto& itemId : worker.get()) {
+            internItem(itemId);
+        }
+    }
+    const size_t rowCount = itemIds.size();
+
+    // 2. 订单转换为下标列表并统计每行的共现对数（只读访问indexOf）
+    struct ChunkRows {
+        std::vector<uint32_t> rows;         // 各订单的下标列表依次拼接
+        std::vector<size_t> orderEnds;      // 各订单在rows中的结束位置
+        std::vector<uint64_t> pairCounts;   // 每行的共现对数
+    };
+    std::vector<std::future<ChunkRows>> rowWorkers;
+    for (const auto& chunk : chunks) {
+        rowWorkers.push_back(std::async(std::launch::async, [this, &orders, chunk, rowCount]() {
+            ChunkRows result;
+            result.pairCounts.assign(rowCount, 0);
+            result.orderEnds.reserve(chunk.second - chunk.first);
+            for (size_t i = chunk.first; i < chunk.second; ++i) {
+                size_t begin = result.rows.size();
+                for (const auto& orderItem : orders[i]->getItems()) {
+                    result.rows.push_back(indexOf.at(orderItem.itemId));
+                }
+                auto first = result.rows.begin() + begin;
+                std::sort(first, result.rows.end());
+                result.rows.erase(std::unique(first, result.rows.end()), result.rows.end());
+                if (result.rows.size() - begin > MAX_ITEMS_PER_ORDER) {
+                    result.rows.resize(begin + MAX_ITEMS_PER_ORDER);
+                }
+                size_t length = result.rows.size() - begin;
+                for (size_t k = begin; k < result.rows.size(); ++k) {
+                    result.pairCounts[result.rows[k]] += length - 1;
+                }
+                result.orderEnds.push_back(result.rows.size());
+            }
+            return result;
+        }));
+    }
+    std::vector<ChunkRows> chunkRows;
+    for (auto& worker : rowWorkers) {
+        chunkRows.push_back(worker.get());
+    }
+
+    // 3. 计算写入位置后并行写入列下标
+    std::vector<uint64_t> pairOffsets(rowCount + 1, 0);
+    for (size_t row = 0; row < rowCount; ++row) {
+        uint64_t total = 0;
+        for (const auto& chunk : chunkRows) {
+            total += chunk.pairCounts[row];
+        }
+        pairOffsets[row + 1] = pairOffsets[row] + total;
+    }
+    for (size_t row = 0; row < rowCount; ++row) {
+        uint64_t cursor = pairOffsets[row];
+        for (auto& chunk : chunkRows) {
+            uint64_t pairs = chunk.pairCounts[row];
+            chunk.pairCounts[row] = cursor;   // 改为该分块在该行的写入位置
+            cursor += pairs;
+        }
+    }
+
+    std::vector<uint32_t> columns(pairOffsets.back());
+    std::vector<std::future<void>> scatterWorkers;
+    for (auto& chunk : chunkRows) {
+        scatterWorkers.push_back(std::async(std::launch::async, [&chunk, &columns]() {
+            size_t begin = 0;
+            for (size_t end : chunk.orderEnds) {
+                for (size_t a = begin; a < end; ++a) {
+                    uint64_t& cursor = chunk.pairCounts[chunk.rows[a]];
+                    for (size_t b = begin; b < end; ++b) {
+                        if (a != b) {
+                            columns[cursor++] = chunk.rows[b];
+                        }
+                    }
+                }
+                begin = end;
+            }
+            std::vector<uint32_t>().swap(chunk.rows);
+        }));
+    }
+    for (auto& worker : scatterWorkers) {
+        worker.get();
+    }
+    chunkRows.clear();
+
+    // 4. 按行分段排序、合并计数并截取前K个邻居
+    std::vector<std::vector<Neighbor>> topRows(rowCount);
+    size_t rowsPerWorker = std::max<size_t>(1, (rowCount + threadCount - 1) / threadCount);
+    std::vector<std::future<void>> mergeWorkers;
+    for (size_t first = 0; first < rowCount; first += rowsPerWorker) {
+        size_t last = std::min(rowCount, first + rowsPerWorker);
+        mergeWorkers.push_back(std::async(std::launch::async, [this, first, last, &pairOffsets, &columns, &topRows]() {
+            for (size_t row = first; row < last; ++row) {
+                auto begin = columns.begin() + pairOffsets[row];
+                auto end = columns.begin() + pairOffsets[row + 1];
+                std::sort(begin, end);
+                std::vector<Neighbor>& full = counts[row];
+                for (auto it = begin; it != end;) {
+                    auto next = std::upper_bound(it, end, *it);
+                    full.push_back(Neighbor{*it, static_cast<uint32_t>(next - it)});
+                    it = next;
+                }
+                topRows[row] = topNeighbors(full);
+            }
+        }));
+    }
+    for (auto& worker : mergeWorkers) {
+        worker.get();
+    }
+
+    // 5. 拼接CSR
+    rowOffsets.assign(rowCount + 1, 0);
+    for (size_t row = 0; row < rowCount; ++row) {
+        rowOffsets[row + 1] = rowOffsets[row] + topRows[row].size();
+    }
+    neighbors.clear();
+    neighbors.reserve(rowOffsets.back());
+    for (const auto& row : topRows) {
+        neighbors.insert(neighbors.end(), row.begin(), row.end());
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    Logger::getInstance()->info("CoPurchaseEngine", "共现矩阵构建完成",
+                                {{"orders", std::to_string(orders.size())},
+                                 {"items", std::to_string(itemIds.size())},
+                                 {"edges", std::to_string(neighbors.size())},
+                                 {"seconds", std::to_string(seconds)}});
+}
+
+/**
+ * @brief 增量加入一个订单
+ *
+ * 只重算订单中各商品所在行的邻居列表
+ */
+void CoPurchaseEngine::addOrder(const Order& order) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<uint32_t> rows;
+    for (const auto& orderItem : order.getItems()) {
+        rows.push_back(internItem(orderItem.itemId));
+    }
+    std::sort(rows.begin(), rows.end());
+    rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    if (rows.size() > MAX_ITEMS_PER_ORDER) {
+        rows.resize(MAX_ITEMS_PER_ORDER);
+    }
+    if (rows.size() < 2) {
+        return;
+    }
+
+    for (uint32_t a : rows) {
+        std::vector<Neighbor>& full = counts[a];
+        for (uint32_t b : rows) {
+            if (a == b) {
+                continue;
+            }
+            auto it = std::lower_bound(full.begin(), full.end(), b,
+                                       [](const Neighbor& n, uint32_t item) { return n.item < item; });
+            if (it != full.end() && it->item == b) {
+                ++it->count;
+            } else {
+                full.insert(it, Neighbor{b, 1});
+            }
+        }
+        overlay[a] = topNeighbors(full);
+    }
+
+    // 覆盖表超过商品数的四分之一时合并回CSR
+    if (overlay.size() > std::max<size_t>(64, itemIds.size() / 4)) {
+        compact();
+    }
+}
+
+/**
+ * @brief 获取与某商品经常一起购买的商品
+ */
+std::vector<RelatedItem> CoPurchaseEngine::relatedItems(const std::string& itemId, size_t limit) const {
+    std::vector<RelatedItem> result;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = indexOf.find(itemId);
+    if (it == indexOf.end()) {
+        return result;
+    }
+
+    const Neighbor* begin;
+    const Neighbor* end;
+    rowNeighbors(it->second, begin, end);
+    for (const Neighbor* n = begin; n != end && result.size() < limit; ++n) {
+        result.push_back(RelatedItem{itemIds[n->item], n->count});
+    }
+    return result;
+}
+
+/**
+ * @brief 获取与购物车中的商品经常一起购买的商品
+ */
+std::vector<RelatedItem> CoPurchaseEngine::relatedToCart(const std::vector<std::string>& cartItemIds,
+                                                         size_t limit) const {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::vector<uint32_t> cartRows;
+    for (const auto& itemId : cartItemIds) {
+        auto it = indexOf.find(itemId);
+        if (it != indexOf.end()) {
+            cartRows.push_back(it->second);
+        }
+    }
+
+    std::unordered_map<uint32_t, uint64_t> scores;
+    for (uint32_t row : cartRows) {
+        const Neighbor* begin;
+        const Neighbor* end;
+        rowNeighbors(row, begin, end);
+        for (const Neighbor* n = begin; n != end; ++n) {
+            scores[n->item] += n->count;
+        }
+    }
+    for (uint32_t row : cartRows) {
+        scores.erase(row);
+    }
+
+    std::vector<std::pair<uint64_t, uint32_t>> ranked;
+    ranked.reserve(scores.size());
+    for (const auto& entry : scores) {
+        ranked.emplace_back(entry.second, entry.first);
+    }
+    size_t keep = std::min(limit, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + keep, ranked.end(),
+                      [](const std::pair<uint64_t, uint32_t>& a, const std::pair<uint64_t, uint32_t>& b) {
+                          return a.first != b.first ? a.first > b.first : a.second < b.second;
+                      });
+
+    std::vector<RelatedItem> result;
+    for (size_t i = 0; i < keep; ++i) {
+        result.push_back(RelatedItem{itemIds[ranked[i].second], ranked[i].first});
+    }
+    return result;
+}
+
+/**
+ * @brief 获取参与共现的商品数
+ */
+size_t CoPurchaseEngine::itemCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return itemIds.size();
+}
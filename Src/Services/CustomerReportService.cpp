@@ -105,6 +105,17 @@ void CustomerReportService::analyzeOrders(
     }
 }
 
+/**
+ * @brief 统计一组订单的类别和商品数据
+ */
+void CustomerReportService::CollectStatistics(
+    const std::vector<std::shared_ptr<Order>>& orders,
+    IItemRepository* itemManager,
+    std::map<std::string, CategoryStatistics>& categoryStats,
+    std::map<std::string, ItemStatistics>& itemStats) {
+    analyzeOrders(orders, itemManager, categoryStats, itemStats);
+}
+
 /**
  * @brief 将统计数据写入CSV文件
  * 
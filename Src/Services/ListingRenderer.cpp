@@ -0,0 +1,480 @@
+/**
+ * @file ListingRenderer.cpp
+ * @brief 列表渲染器的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Services/ListingRenderer.h"
+#include <iomanip>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+namespace {
+
+/**
+ * @brief 格式化时间
+ * @param time 时间戳
+ * @param pattern strftime格式
+ * @return 时间字符串
+ */
+std::string formatTime(time_t time, const char* pattern) {
+    char buffer[20];
+    struct tm* timeinfo = std::localtime(&time);
+    std::strftime(buffer, sizeof(buffer), pattern, timeinfo);
+    return buffer;
+}
+
+/**
+ * @brief 转义CSV字段（含逗号、引号或换行时加引号）
+ */
+std::string csvField(const std::string& value) {
+    if (value.find_first_of(",\"\n") == std::string::npos) {
+        return value;
+    }
+    std::string escaped = "\"";
+    for (char c : value) {
+        if (c == '"') {
+            escaped += '"';
+        }
+        escaped += c;
+    }
+    escaped += '"';
+    return escaped;
+}
+
+/**
+ * @brief 转义JSON字符串并加引号
+ */
+std::string jsonString(const std::string& value) {
+    std::string escaped = "\"";
+    for (unsigned char c : value) {
+        switch (c) {
+            case '"':  escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                    escaped += buffer;
+                } else {
+                    escaped += static_cast<char>(c);
+                }
+        }
+    }
+    escaped += '"';
+    return escaped;
+}
+
+/**
+ * @brief 金额保留两位小数
+ */
+std::string money(double value) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2f", value);
+    return buffer;
+}
+
+} // namespace
+
+/**
+ * @brief 渲染商品列表
+ */
+void ListingRenderer::renderItems(const ItemListing& listing, RenderFormat format, std::ostream& os) {
+    if (format == RenderFormat::CSV) {
+        os << "item_id,item_name,category,price,description,stock,promotion\n";
+        for (const auto& row : listing.rows) {
+            os << csvField(row.itemId) << ',' << csvField(row.itemName) << ','
+               << csvField(row.category) << ',' << money(row.price) << ','
+               << csvField(row.description) << ',' << row.stock << ','
+               << csvField(row.promotionTag) << '\n';
+        }
+        return;
+    }
+
+    if (format == RenderFormat::JSON) {
+        os << "[";
+        for (size_t i = 0; i < listing.rows.size(); ++i) {
+            const auto& row = listing.rows[i];
+            os << (i > 0 ? ",\n " : "\n ")
+               << "{\"item_id\":" << jsonString(row.itemId)
+               << ",\"item_name\":" << jsonString(row.itemName)
+               << ",\"category\":" << jsonString(row.category)
+               << ",\"price\":" << money(row.price)
+               << ",\"description\":" << jsonString(row.description)
+               << ",\"stock\":" << row.stock
+               << ",\"promotion\":" << jsonString(row.promotionTag) << "}";
+        }
+        os << (listing.rows.empty() ? "]\n" : "\n]\n");
+        return;
+    }
+
+    if (listing.rows.empty()) {
+        os << "暂无商品信息。" << std::endl;
+        return;
+    }
+
+    os << "\n========== 商品列表 ==========\n";
+    os << std::left
+       << std::setw(8) << "ID"
+       << std::setw(25) << "名称"
+       << std::setw(12) << "类别"
+       << std::setw(10) << "价格"
+       << std::setw(30) << "描述"
+       << std::setw(8) << "库存"
+       << '\n';
+    os << "-------------------------------------------------------------------------------------\n";
+
+    for (const auto& row : listing.rows) {
+        std::string nameWithTag = row.itemName;
+        if (!row.promotionTag.empty()) {
+            nameWithTag += " [" + row.promotionTag + "]";
+        }
+
+        os << std::left
+           << std::setw(8) << row.itemId
+           << std::setw(25) << nameWithTag
+           << std::setw(12) << row.category
+           << std::setw(10) << std::fixed << std::setprecision(2) << row.price
+           << std::setw(30) << row.description
+           << std::setw(8) << row.stock
+           << '\n';
+    }
+
+    os << "=============================\n";
+    os << "共 " << listing.rows.size() << " 件商品。\n";
+
+    // 显示当前有效的满减活动
+    if (!listing.fullReductionTags.empty()) {
+        os << "\n【当前满减活动】：";
+        for (size_t i = 0; i < listing.fullReductionTags.size(); ++i) {
+            if (i > 0) os << "、";
+            os << listing.fullReductionTags[i];
+        }
+        os << '\n';
+    }
+    os << std::flush;
+}
+
+/**
+ * @brief 渲染订单列表
+ */
+void ListingRenderer::renderOrders(const std::vector<OrderRow>& rows, bool includeUser,
+                                   RenderFormat format, std::ostream& os) {
+    if (format == RenderFormat::CSV) {
+        os << "order_id," << (includeUser ? "user_id," : "") << "order_time,total_amount,status\n";
+        for (const auto& row : rows) {
+            os << csvField(row.orderId) << ',';
+            if (includeUser) {
+                os << csvField(row.userId) << ',';
+            }
+            os << formatTime(row.orderTime, "%Y-%m-%d %H:%M:%S") << ','
+               << money(row.totalAmount) << ',' << csvField(row.status) << '\n';
+        }
+        return;
+    }
+
+    if (format == RenderFormat::JSON) {
+        os << "[";
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const auto& row = rows[i];
+            os << (i > 0 ? ",\n " : "\n ")
+               << "{\"order_id\":" << jsonString(row.orderId);
+            if (includeUser) {
+                os << ",\"user_id\":" << jsonString(row.userId);
+            }
+            os << ",\"order_time\":" << jsonString(formatTime(row.orderTime, "%Y-%m-%d %H:%M:%S"))
+               << ",\"total_amount\":" << money(row.totalAmount)
+               << ",\"status\":" << jsonString(row.status) << "}";
+        }
+        os << (rows.empty() ? "]\n" : "\n]\n");
+        return;
+    }
+
+    if (rows.empty()) {
+        os << (includeUser ? "暂无订单信息。" : "\n您还没有订单。") << std::endl;
+        return;
+    }
+
+    const std::string separator(includeUser ? 79 : 60, '-');
+    const std::string border(includeUser ? 79 : 60, '=');
+
+    os << (includeUser ? "\n========== 订单列表 ==========\n" : "\n========== 我的订单 ==========\n");
+    os << std::left << std::setw(20) << "订单编号";
+    if (includeUser) {
+        os << std::setw(15) << "用户ID";
+    }
+    os << std::setw(20) << "订单时间"
+       << std::setw(12) << "订单总额"
+       << std::setw(12) << "订单状态"
+       << '\n';
+    os << separator << '\n';
+
+    for (const auto& row : rows) {
+        os << std::left << std::setw(20) << row.orderId;
+        if (includeUser) {
+            os << std::setw(15) << row.userId;
+        }
+        os << std::setw(20) << formatTime(row.orderTime, "%Y-%m-%d %H:%M:%S")
+           << std::setw(12) << std::fixed << std::setprecision(2) << row.totalAmount
+           << std::setw(12) << row.status
+           << '\n';
+    }
+
+    os << border << '\n';
+    os << "共 " << rows.size() << " 个订单。" << std::endl;
+}
+
+/**
+ * @brief 渲染促销活动列表
+ */
+void ListingRenderer::renderPromotions(const std::vector<PromotionRow>& rows, RenderFormat format,
+                                       std::ostream& os) {
+    if (format == RenderFormat::CSV) {
+        os << "promotion_id,promotion_name,type,is_active,end_date,tag\n";
+        for (const auto& row : rows) {
+            os << csvField(row.promotionId) << ',' << csvField(row.promotionName) << ','
+               << csvField(row.type) << ',' << (row.isActive ? 1 : 0) << ','
+               << formatTime(row.endTime, "%Y-%m-%d") << ',' << csvField(row.displayTag) << '\n';
+        }
+        return;
+    }
+
+    if (format == RenderFormat::JSON) {
+        os << "[";
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const auto& row = rows[i];
+            os << (i > 0 ? ",\n " : "\n ")
+               << "{\"promotion_id\":" << jsonString(row.promotionId)
+               << ",\"promotion_name\":" << jsonString(row.promotionName)
+               << ",\"type\":" << jsonString(row.type)
+               << ",\"is_active\":" << (row.isActive ? "true" : "false")
+               << ",\"end_date\":" << jsonString(formatTime(row.endTime, "%Y-%m-%d"))
+               << ",\"tag\":" << jsonString(row.displayTag) << "}";
+        }
+        os << (rows.empty() ? "]\n" : "\n]\n");
+        return;
+    }
+
+    if (rows.empty()) {
+        os << "暂无促销活动" << std::endl;
+        return;
+    }
+
+    os << "\n========== 所有促销活动 ==========\n";
+    os << std::left << std::setw(12) << "促销ID"
+       << std::setw(20) << "促销名称"
+       << std::setw(15) << "类型"
+       << std::setw(10) << "状态"
+       << std::setw(15) << "有效期至"
+       << '\n';
+    os << std::string(72, '-') << '\n';
+
+    for (const auto& row : rows) {
+        os << std::left << std::setw(12) << row.promotionId
+           << std::setw(20) << row.promotionName
+           << std::setw(15) << row.type
+           << std::setw(10) << (row.isActive ? "启用" : "禁用")
+           << std::setw(15) << formatTime(row.endTime, "%Y-%m-%d")
+           << '\n';
+    }
+    os << "================================" << std::endl;
+}
+
+/**
+ * @brief 以简要形式渲染当前有效的促销活动
+ */
+void ListingRenderer::renderActivePromotions(const std::vector<PromotionRow>& rows, std::ostream& os) {
+    bool anyValid = std::any_of(rows.begin(), rows.end(),
+                                [](const PromotionRow& row) { return row.isValid; });
+    if (!anyValid) {
+        os << "当前无有效的促销活动" << std::endl;
+        return;
+    }
+
+    os << "\n========== 当前有效促销 ==========\n";
+    for (const auto& row : rows) {
+        if (row.isValid) {
+            os << "• " << row.promotionName << " [" << row.displayTag << "]\n";
+        }
+    }
+    os << "================================" << std::endl;
+}
+
+/**
+ * @brief 渲染顾客列表
+ */
+void ListingRenderer::renderCustomers(const std::vector<CustomerRow>& rows, RenderFormat format,
+                                      std::ostream& os) {
+    if (format == RenderFormat::CSV) {
+        os << "username,password,phone\n";
+        for (const auto& row : rows) {
+            os << csvField(row.username) << ',' << csvField(row.password) << ','
+               << csvField(row.phone) << '\n';
+        }
+        return;
+    }
+
+    if (format == RenderFormat::JSON) {
+        os << "[";
+        for (size_t i = 0; i < rows.size(); ++i) {
+            const auto& row = rows[i];
+            os << (i > 0 ? ",\n " : "\n ")
+               << "{\"username\":" << jsonString(row.username)
+               << ",\"password\":" << jsonString(row.password)
+               << ",\"phone\":" << jsonString(row.phone) << "}";
+        }
+        os << (rows.empty() ? "]\n" : "\n]\n");
+        return;
+    }
+
+    os << "\n===== 所有顾客信息 =====\n";
+    os << "用户名\t\t密码\t\t手机号\n";
+    os << "----------------------------------------\n";
+    for (const auto& row : rows) {
+        os << row.username << "\t\t" << row.password << "\t\t" << row.phone << '\n';
+    }
+    os << "========================\n";
+    os << "共 " << rows.size() << " 个顾客。" << std::endl;
+}
+
+/**
+ * @brief 渲染搜索结果
+ */
+void ListingRenderer::renderSearchResults(const std::vector<SearchResult>& results, bool showSimilarity,
+                                          RenderFormat format, std::ostream& os) {
+    if (format == RenderFormat::CSV) {
+        os << "item_id,item_name,category,price,stock" << (showSimilarity ? ",similarity" : "") << '\n';
+        for (const auto& result : results) {
+            const auto& item = result.item;
+            os << csvField(item->getItemId()) << ',' << csvField(item->getItemName()) << ','
+               << csvField(item->getCategory()) << ',' << money(item->getPrice()) << ','
+               << item->getStock();
+            if (showSimilarity) {
+                os << ',' << money(result.similarityScore);
+            }
+            os << '\n';
+        }
+        return;
+    }
+
+    if (format == RenderFormat::JSON) {
+        os << "[";
+        for (size_t i = 0; i < results.size(); ++i) {
+            const auto& item = results[i].item;
+            os << (i > 0 ? ",\n " : "\n ")
+               << "{\"item_id\":" << jsonString(item->getItemId())
+               << ",\"item_name\":" << jsonString(item->getItemName())
+               << ",\"category\":" << jsonString(item->getCategory())
+               << ",\"price\":" << money(item->getPrice())
+               << ",\"stock\":" << item->getStock();
+            if (showSimilarity) {
+                os << ",\"similarity\":" << money(results[i].similarityScore);
+            }
+            os << "}";
+        }
+        os << (results.empty() ? "]\n" : "\n]\n");
+        return;
+    }
+
+    if (results.empty()) {
+        os << "没有找到相关商品。" << std::endl;
+        return;
+    }
+
+    os << "\n========== 搜索结果 ==========\n";
+    os << std::left
+       << std::setw(8) << "ID"
+       << std::setw(20) << "名称"
+       << std::setw(12) << "类别"
+       << std::setw(10) << "价格"
+       << std::setw(8) << "库存";
+    if (showSimilarity) {
+        os << std::setw(10) << "相似度";
+    }
+    os << '\n';
+    os << "-------------------------------------------------------------------------------------\n";
+
+    for (const auto& result : results) {
+        const auto& item = result.item;
+        os << std::left
+           << std::setw(8) << item->getItemId()
+           << std::setw(20) << item->getItemName()
+           << std::setw(12) << item->getCategory()
+           << std::setw(10) << std::fixed << std::setprecision(2) << item->getPrice()
+           << std::setw(8) << item->getStock();
+        if (showSimilarity) {
+            os << std::setw(10) << std::fixed << std::setprecision(2)
+               << (result.similarityScore * 100) << "%";
+        }
+        os << '\n';
+    }
+
+    os << "=============================\n";
+    os << "共找到 " << results.size() << " 件商品。" << std::endl;
+}
+
+/**
+ * @brief 输出搜索的匹配摘要
+ */
+void ListingRenderer::renderSearchSummary(const SearchOutcome& outcome, std::ostream& os) {
+    size_t count = outcome.results.size();
+
+    switch (outcome.kind) {
+        case SearchMatchKind::EXACT_NAME:
+            os << "找到 " << count << " 个精确匹配结果（按名称）。\n";
+            break;
+        case SearchMatchKind::CATEGORY:
+            os << "找到 " << count << " 个类别匹配结果。\n";
+            break;
+        case SearchMatchKind::PRICE_RANGE:
+            if (count > 0) {
+                os << "找到 " << count << " 个价格区间匹配结果（"
+                   << outcome.minPrice << " - " << outcome.maxPrice << "元）。\n";
+            } else {
+                os << "在价格区间 " << outcome.minPrice << " - " << outcome.maxPrice
+                   << " 元内未找到商品。\n";
+            }
+            break;
+        case SearchMatchKind::FUZZY:
+            if (count > 0) {
+                os << "找到 " << count << " 个模糊匹配结果。\n";
+            } else {
+                os << "未找到相关商品。\n";
+            }
+            break;
+        case SearchMatchKind::DEGRADED:
+            os << "未找到精确匹配的商品；系统繁忙，暂不提供模糊搜索，请稍后再试或输入完整名称。\n";
+            break;
+        case SearchMatchKind::INVALID_PRICE_FORMAT:
+            os << "价格区间格式错误！请使用格式：最小价格-最大价格（例如：1000-5000）\n";
+            break;
+        case SearchMatchKind::INVALID_PRICE_VALUE:
+            os << "价格解析失败！请输入有效的数字。\n";
+            break;
+    }
+}
+
+/**
+ * @brief 将字符串解析为输出格式
+ */
+bool ListingRenderer::parseFormat(const std::string& str, RenderFormat& format) {
+    std::string lower = str;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+        [](unsigned char c) { return std::tolower(c); });
+
+    if (lower == "console") {
+        format = RenderFormat::CONSOLE;
+    } else if (lower == "csv") {
+        format = RenderFormat::CSV;
+    } else if (lower == "json") {
+        format = RenderFormat::JSON;
+    } else {
+        return false;
+    }
+    return true;
+}
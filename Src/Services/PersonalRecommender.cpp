@@ -0,0 +1,314 @@
+/**
+ * @file PersonalRecommender.cpp
+ * @brief 基于顾客类别偏好的个性化推荐服务的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Services/PersonalRecommender.h"
+#include "Services/CustomerReportService.h"
+#include "Log/Logger.h"
+#include <algorithm>
+#include <queue>
+#include <map>
+#include <tuple>
+
+/**
+ * @brief 构造函数实现
+ */
+PersonalRecommender::PersonalRecommender(OrderManager* orderManager, IItemRepository* itemRepository,
+                                         size_t topN, size_t perCategoryLimit)
+    : orderManager(orderManager), itemRepository(itemRepository),
+      topN(topN > 0 ? topN : 1), perCategoryLimit(perCategoryLimit > 0 ? perCategoryLimit : 1) {
+    if (itemRepository) {
+        itemRepository->addChangeListener(this);
+    }
+}
+
+/**
+ * @brief 析构函数实现
+ */
+PersonalRecommender::~PersonalRecommender() {
+    if (itemRepository) {
+        itemRepository->removeChangeListener(this);
+    }
+}
+
+/**
+ * @brief 标记类别热销榜需要重算
+ */
+void PersonalRecommender::markDirty(const std::string& category) {
+    categories[category].dirty = true;
+}
+
+/**
+ * @brief 获取类别热销榜，必要时重算
+ *
+ * 只保留有货商品，按销量降序截取前perCategoryLimit个；
+ * 热度 = (销量 + 1) / (类别最高销量 + 1)，没有销量的新品也能得到较低的热度
+ */
+PersonalRecommender::CategoryTable& PersonalRecommender::tableFor(const std::string& category) {
+    CategoryTable& table = categories[category];
+    if (!table.dirty) {
+        return table;
+    }
+
+    std::vector<std::pair<long long, std::string>> ranked;
+    if (itemRepository) {
+        for (const auto& item : itemRepository->getItemsByCategory(category)) {
+            if (item->getStock() <= 0) {
+                continue;
+            }
+            auto it = sales.find(item->getItemId());
+            ranked.emplace_back(it != sales.end() ? it->second : 0, item->getItemId());
+        }
+    }
+    size_t keep = std::min(perCategoryLimit, ranked.size());
+    std::partial_sort(ranked.begin(), ranked.begin() + keep, ranked.end(),
+                      [](const std::pair<long long, std::string>& a, const std::pair<long long, std::string>& b) {
+                          return a.first != b.first ? a.first > b.first : a.second < b.second;
+                      });
+
+    table.top.clear();
+    double maxSales = keep > 0 ? static_cast<double>(ranked.front().first) + 1.0 : 1.0;
+    for (size_t i = 0; i < keep; ++i) {
+        table.top.push_back(Candidate{ranked[i].second, (static_cast<double>(ranked[i].first) + 1.0) / maxSales});
+    }
+    ++table.version;
+    table.dirty = false;
+    return table;
+}
+
+/**
+ * @brief 由顾客的订单计算偏好向量和已购商品
+ *
+ * 偏好 = 0.5 × 类别金额占比 + 0.5 × 类别频度占比
+ */
+PersonalRecommender::CustomerProfile PersonalRecommender::buildProfile(const std::string& username) const {
+    CustomerProfile profile;
+    if (!orderManager) {
+        return profile;
+    }
+
+    std::map<std::string, CategoryStatistics> categoryStats;
+    std::map<std::string, ItemStatistics> itemStats;
+    CustomerReportService::CollectStatistics(orderManager->getOrdersByUserId(username), itemRepository,
+                                             categoryStats, itemStats);
+
+    double totalAmount = 0.0;
+    double totalFrequency = 0.0;
+    for (const auto& entry : categoryStats) {
+        totalAmount += entry.second.totalAmount;
+        totalFrequency += entry.second.purchaseFrequency;
+    }
+    for (const auto& entry : categoryStats) {
+        double weight = 0.0;
+        if (totalAmount > 0.0) {
+            weight += 0.5 * entry.second.totalAmount / totalAmount;
+        }
+        if (totalFrequency > 0.0) {
+            weight += 0.5 * entry.second.purchaseFrequency / totalFrequency;
+        }
+        if (weight > 0.0) {
+            profile.affinity.emplace_back(entry.first, weight);
+        }
+    }
+    for (const auto& entry : itemStats) {
+        profile.purchased.insert(entry.first);
+    }
+    return profile;
+}
+
+/**
+ * @brief 按偏好向量多路归并各类别热销榜，计算前N个推荐
+ *
+ * 每个类别的榜单按热度降序，乘以同一个偏好系数后仍然有序，
+ * 因此用大小为类别数的堆归并，取够N个即可停止
+ */
+void PersonalRecommender::computeRecommendations(CustomerProfile& profile) {
+    // 没有购买记录时按所有类别均匀偏好
+    std::vector<std::pair<std::string, double>> affinity = profile.affinity;
+    if (affinity.empty() && itemRepository) {
+        std::unordered_set<std::string> seen;
+        for (const auto& item : itemRepository->getAllItems()) {
+            if (seen.insert(item->getCategory()).second) {
+                affinity.emplace_back(item->getCategory(), 0.0);
+            }
+        }
+        for (auto& entry : affinity) {
+            entry.second = 1.0 / affinity.size();
+        }
+    }
+
+    std::vector<const CategoryTable*> tables;
+    profile.versions.clear();
+    for (const auto& entry : affinity) {
+        const CategoryTable& table = tableFor(entry.first);
+        tables.push_back(&table);
+        profile.versions.push_back(table.version);
+    }
+
+    // 堆元素：(得分, 类别序号, 榜单位置)
+    using Cursor = std::tuple<double, size_t, size_t>;
+    std::priority_queue<Cursor> heap;
+    for (size_t c = 0; c < tables.size(); ++c) {
+        if (!tables[c]->top.empty()) {
+            heap.emplace(affinity[c].second * tables[c]->top[0].popularity, c, 0);
+        }
+    }
+
+    profile.cached.clear();
+    while (!heap.empty() && profile.cached.size() < topN) {
+        double score;
+        size_t c;
+        size_t pos;
+        std::tie(score, c, pos) = heap.top();
+        heap.pop();
+
+        const Candidate& candidate = tables[c]->top[pos];
+        if (profile.purchased.find(candidate.itemId) == profile.purchased.end()) {
+            profile.cached.push_back(Recommendation{candidate.itemId, affinity[c].first, score});
+        }
+        if (pos + 1 < tables[c]->top.size()) {
+            heap.emplace(affinity[c].second * tables[c]->top[pos + 1].popularity, c, pos + 1);
+        }
+    }
+    profile.cacheValid = true;
+
+    // 均匀偏好也保存下来，使版本记录与偏好类别一一对应
+    if (profile.affinity.empty()) {
+        profile.affinity.swap(affinity);
+    }
+}
+
+/**
+ * @brief 检查缓存依赖的榜单版本是否仍然有效
+ */
+bool PersonalRecommender::isCacheFresh(CustomerProfile& profile) {
+    if (!profile.cacheValid || profile.versions.size() != profile.affinity.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < profile.affinity.size(); ++i) {
+        auto it = categories.find(profile.affinity[i].first);
+        if (it == categories.end() || it->second.dirty || it->second.version != profile.versions[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 用全部订单和商品重建销量和热销榜
+ */
+void PersonalRecommender::rebuild() {
+    std::unordered_map<std::string, long long> newSales;
+    if (orderManager) {
+        for (const auto& order : orderManager->getAllOrders()) {
+            for (const auto& orderItem : order->getItems()) {
+                newSales[orderItem.itemId] += orderItem.quantity;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    sales.swap(newSales);
+    items.clear();
+    categories.clear();
+    profiles.clear();
+    if (itemRepository) {
+        for (const auto& item : itemRepository->getAllItems()) {
+            items[item->getItemId()] = ItemInfo{item->getCategory(), item->getStock() > 0};
+            markDirty(item->getCategory());
+        }
+    }
+    for (auto& entry : categories) {
+        tableFor(entry.first);
+    }
+
+    Logger::getInstance()->info("PersonalRecommender", "个性化推荐热销榜构建完成",
+                                {{"items", std::to_string(items.size())},
+                                 {"categories", std::to_string(categories.size())}});
+}
+
+/**
+ * @brief 获取顾客的个性化推荐
+ *
+ * 偏好向量需要读取订单，在锁外计算；计算期间该顾客又下单时只使用本次结果而不缓存偏好
+ */
+std::vector<Recommendation> PersonalRecommender::recommend(const std::string& username, size_t limit) {
+    uint64_t epoch = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = profiles.find(username);
+        if (it != profiles.end()) {
+            if (!isCacheFresh(it->second)) {
+                computeRecommendations(it->second);
+            }
+            const auto& cached = it->second.cached;
+            return std::vector<Recommendation>(cached.begin(), cached.begin() + std::min(limit, cached.size()));
+        }
+        epoch = orderEpochs[username];
+    }
+
+    CustomerProfile profile = buildProfile(username);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    computeRecommendations(profile);
+    std::vector<Recommendation> result(profile.cached.begin(),
+                                       profile.cached.begin() + std::min(limit, profile.cached.size()));
+    if (orderEpochs[username] == epoch) {
+        profiles[username] = std::move(profile);
+    }
+    return result;
+}
+
+/**
+ * @brief 订单创建事件
+ */
+void PersonalRecommender::onOrderCreated(const Order& order) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& orderItem : order.getItems()) {
+        sales[orderItem.itemId] += orderItem.quantity;
+        auto it = items.find(orderItem.itemId);
+        if (it != items.end()) {
+            markDirty(it->second.category);
+        }
+    }
+    ++orderEpochs[order.getUserId()];
+    profiles.erase(order.getUserId());
+}
+
+/**
+ * @brief 商品变更事件
+ *
+ * 价格变化不影响推荐；库存变化只在有货状态翻转时使榜单失效
+ */
+void PersonalRecommender::onItemsChanged(const std::vector<std::string>& itemIds, ItemChangeKind kind) {
+    if (kind == ItemChangeKind::PRICE) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& itemId : itemIds) {
+        auto known = items.find(itemId);
+        auto item = itemRepository ? itemRepository->findItemById(itemId) : nullptr;
+
+        if (!item) {
+            if (known != items.end()) {
+                markDirty(known->second.category);
+                items.erase(known);
+            }
+            continue;
+        }
+
+        ItemInfo info{item->getCategory(), item->getStock() > 0};
+        if (known == items.end()) {
+            markDirty(info.category);
+            items.emplace(itemId, info);
+        } else if (known->second.category != info.category || known->second.available != info.available) {
+            markDirty(known->second.category);
+            markDirty(info.category);
+            known->second = info;
+        }
+    }
+}
@@ -0,0 +1,497 @@
+/**
+ * @file TopSellerLeaderboard.cpp
+ * @brief 滑动时间窗口热销排行榜的实现
+ * @author Hazuki Keatsu
+ * @date 2026-10-18
+ */
+
+#include "Services/TopSellerLeaderboard.h"
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+const std::string ALL_CATEGORIES = "";          // 全部商品榜单的键
+const std::string UNKNOWN_CATEGORY = "未知类别";
+const size_t SKETCH_CANDIDATE_FACTOR = 4;       // 近似模式下榜单多保留的候选倍数（桶过期后用于补位）
+
+/**
+ * @brief 堆中元素的比较：销量小的在前，销量相同时ID大的在前（ID小的优先留在榜上）
+ */
+bool entryLess(const std::pair<long long, std::string>& a, const std::pair<long long, std::string>& b) {
+    return a.first != b.first ? a.first < b.first : a.second > b.second;
+}
+
+size_t windowIndex(LeaderboardWindow window) {
+    return static_cast<size_t>(window);
+}
+
+} // namespace
+
+/**
+ * @brief 构造函数实现
+ */
+TopSellerLeaderboard::TopSellerLeaderboard(IItemRepository* itemRepository, size_t topK, bool useSketch,
+                                           size_t sketchWidth, size_t sketchDepth)
+    : itemRepository(itemRepository), topK(topK > 0 ? topK : 1), useSketch(useSketch),
+      sketchWidth(sketchWidth > 0 ? sketchWidth : 1), sketchDepth(sketchDepth > 0 ? sketchDepth : 1),
+      boardCapacity(useSketch ? this->topK * SKETCH_CANDIDATE_FACTOR : this->topK),
+      minuteBuckets(MINUTE_BUCKETS), hourBuckets(HOUR_BUCKETS), minuteHead(-1), hourHead(-1) {
+    resetLocked();
+}
+
+/**
+ * @brief 获取商品类别
+ */
+const std::string& TopSellerLeaderboard::categoryOf(const std::string& itemId) {
+    auto it = itemCategories.find(itemId);
+    if (it != itemCategories.end()) {
+        return it->second;
+    }
+    auto item = itemRepository ? itemRepository->findItemById(itemId) : nullptr;
+    return itemCategories.emplace(itemId, item ? item->getCategory() : UNKNOWN_CATEGORY).first->second;
+}
+
+/**
+ * @brief 计算商品在Sketch第row行的位置（双重哈希）
+ */
+size_t TopSellerLeaderboard::cellIndex(const std::string& itemId, size_t row) const {
+    uint64_t h1 = std::hash<std::string>{}(itemId);
+    uint64_t h2 = ((h1 * 0x9E3779B97F4A7C15ULL) >> 32) | 1;
+    return row * sketchWidth + static_cast<size_t>((h1 + row * h2) % sketchWidth);
+}
+
+/**
+ * @brief 在Sketch中累加计数
+ */
+void TopSellerLeaderboard::sketchAdd(std::vector<uint32_t>& cells, const std::string& itemId,
+                                     long long quantity) const {
+    for (size_t row = 0; row < sketchDepth; ++row) {
+        cells[cellIndex(itemId, row)] += static_cast<uint32_t>(quantity);
+    }
+}
+
+/**
+ * @brief 从Sketch中估计计数
+ */
+long long TopSellerLeaderboard::sketchEstimate(const std::vector<uint32_t>& cells,
+                                               const std::string& itemId) const {
+    uint32_t estimate = UINT32_MAX;
+    for (size_t row = 0; row < sketchDepth; ++row) {
+        estimate = std::min(estimate, cells[cellIndex(itemId, row)]);
+    }
+    return estimate;
+}
+
+/**
+ * @brief 交换堆中两个位置
+ */
+void TopSellerLeaderboard::swapAt(Board& board, size_t a, size_t b) {
+    std::swap(board.heap[a], board.heap[b]);
+    board.position[board.heap[a].second] = a;
+    board.position[board.heap[b].second] = b;
+}
+
+/**
+ * @brief 上浮
+ */
+size_t TopSellerLeaderboard::siftUp(Board& board, size_t index) {
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (!entryLess(board.heap[index], board.heap[parent])) {
+            break;
+        }
+        swapAt(board, index, parent);
+        index = parent;
+    }
+    return index;
+}
+
+/**
+ * @brief 下沉
+ */
+void TopSellerLeaderboard::siftDown(Board& board, size_t index) {
+    const size_t count = board.heap.size();
+    while (true) {
+        size_t smallest = index;
+        size_t left = index * 2 + 1;
+        size_t right = left + 1;
+        if (left < count && entryLess(board.heap[left], board.heap[smallest])) {
+            smallest = left;
+        }
+        if (right < count && entryLess(board.heap[right], board.heap[smallest])) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            return;
+        }
+        swapAt(board, index, smallest);
+        index = smallest;
+    }
+}
+
+/**
+ * @brief 把商品的最新销量提交给榜单
+ *
+ * 已在榜：更新销量后调整位置（销量降为0时移出）；
+ * 未在榜：榜未满直接加入，否则销量超过堆顶（最后一名）时替换堆顶
+ */
+void TopSellerLeaderboard::offer(Board& board, const std::string& itemId, long long quantity) {
+    auto it = board.position.find(itemId);
+    if (it != board.position.end()) {
+        size_t index = it->second;
+        if (quantity <= 0) {
+            size_t last = board.heap.size() - 1;
+            if (index != last) {
+                swapAt(board, index, last);
+            }
+            board.heap.pop_back();
+            board.position.erase(itemId);
+            if (index < board.heap.size()) {
+                siftDown(board, siftUp(board, index));
+            }
+        } else {
+            board.heap[index].first = quantity;
+            siftDown(board, siftUp(board, index));
+        }
+        board.snapshotValid = false;
+        return;
+    }
+
+    if (quantity <= 0) {
+        return;
+    }
+    std::pair<long long, std::string> entry(quantity, itemId);
+    if (board.heap.size() < boardCapacity) {
+        board.heap.push_back(entry);
+        board.position[itemId] = board.heap.size() - 1;
+        siftUp(board, board.heap.size() - 1);
+        board.snapshotValid = false;
+    } else if (entryLess(board.heap.front(), entry)) {
+        board.position.erase(board.heap.front().second);
+        board.heap.front() = entry;
+        board.position[itemId] = 0;
+        siftDown(board, 0);
+        board.snapshotValid = false;
+    }
+}
+
+/**
+ * @brief 把一笔销量计入窗口
+ */
+void TopSellerLeaderboard::addToWindow(LeaderboardWindow window, const std::string& itemId, long long quantity) {
+    WindowState& state = windows[windowIndex(window)];
+    const std::string& category = categoryOf(itemId);
+
+    long long total;
+    if (useSketch) {
+        sketchAdd(state.cells, itemId, quantity);
+        total = sketchEstimate(state.cells, itemId);
+    } else {
+        total = (state.counts[category][itemId] += quantity);
+    }
+    offer(state.boards[category], itemId, total);
+    offer(state.boards[ALL_CATEGORIES], itemId, total);
+}
+
+/**
+ * @brief 从窗口中减去一个过期的桶
+ */
+void TopSellerLeaderboard::expireFromWindow(LeaderboardWindow window, const Bucket& bucket,
+                                            std::unordered_set<std::string>& affected) {
+    WindowState& state = windows[windowIndex(window)];
+    if (useSketch) {
+        bool any = false;
+        for (size_t i = 0; i < state.cells.size(); ++i) {
+            if (bucket.cells[i] != 0) {
+                state.cells[i] -= bucket.cells[i];
+                any = true;
+            }
+        }
+        // Sketch无法列出桶中的商品，所有榜单都需要重估
+        if (any) {
+            for (const auto& entry : state.boards) {
+                affected.insert(entry.first);
+            }
+        }
+        return;
+    }
+
+    for (const auto& entry : bucket.counts) {
+        const std::string& category = categoryOf(entry.first);
+        auto categoryIt = state.counts.find(category);
+        if (categoryIt == state.counts.end()) {
+            continue;
+        }
+        auto itemIt = categoryIt->second.find(entry.first);
+        if (itemIt != categoryIt->second.end()) {
+            itemIt->second -= entry.second;
+            if (itemIt->second <= 0) {
+                categoryIt->second.erase(itemIt);
+            }
+        }
+        affected.insert(category);
+    }
+}
+
+/**
+ * @brief 销量下降后重建受影响类别的榜单
+ *
+ * 精确模式按类别计数重建（全部商品榜单遍历所有计数）；
+ * 近似模式只能重估已在榜商品的销量
+ */
+void TopSellerLeaderboard::rebuildBoards(LeaderboardWindow window, const std::unordered_set<std::string>& affected) {
+    if (affected.empty()) {
+        return;
+    }
+    WindowState& state = windows[windowIndex(window)];
+
+    if (useSketch) {
+        for (const auto& category : affected) {
+            Board& board = state.boards[category];
+            std::vector<std::string> members;
+            for (const auto& entry : board.heap) {
+                members.push_back(entry.second);
+            }
+            board = Board();
+            for (const auto& itemId : members) {
+                offer(board, itemId, sketchEstimate(state.cells, itemId));
+            }
+        }
+        return;
+    }
+
+    for (const auto& category : affected) {
+        Board& board = state.boards[category];
+        board = Board();
+        auto it = state.counts.find(category);
+        if (it == state.counts.end()) {
+            continue;
+        }
+        for (const auto& entry : it->second) {
+            offer(board, entry.first, entry.second);
+        }
+    }
+
+    Board& all = state.boards[ALL_CATEGORIES];
+    all = Board();
+    for (const auto& category : state.counts) {
+        for (const auto& entry : category.second) {
+            offer(all, entry.first, entry.second);
+        }
+    }
+}
+
+/**
+ * @brief 重置桶的内容
+ */
+void TopSellerLeaderboard::resetBucket(Bucket& bucket, long long slot) const {
+    bucket.slot = slot;
+    bucket.counts.clear();
+    if (useSketch) {
+        bucket.cells.assign(sketchWidth * sketchDepth, 0);
+    }
+}
+
+/**
+ * @brief 清空所有桶和窗口
+ */
+void TopSellerLeaderboard::resetLocked() {
+    for (auto& bucket : minuteBuckets) {
+        resetBucket(bucket, -1);
+    }
+    for (auto& bucket : hourBuckets) {
+        resetBucket(bucket, -1);
+    }
+    for (auto& state : windows) {
+        state = WindowState();
+        if (useSketch) {
+            state.cells.assign(sketchWidth * sketchDepth, 0);
+        }
+    }
+}
+
+/**
+ * @brief 推进时间，滚出过期的桶
+ *
+ * 每前进一个时间片，环形数组中被复用的桶先从对应窗口中减去；
+ * 一天窗口只覆盖最近24个小时桶，第24个之前的小时桶滚出一天窗口但仍留在一周窗口中
+ */
+void TopSellerLeaderboard::advance(time_t now) {
+    long long minute = static_cast<long long>(now) / 60;
+    long long hour = static_cast<long long>(now) / 3600;
+
+    // 首次使用或超过一周没有推进：所有桶都已过期
+    if (hourHead < 0 || hour - hourHead >= static_cast<long long>(HOUR_BUCKETS)) {
+        resetLocked();
+        minuteHead = minute;
+        hourHead = hour;
+        return;
+    }
+
+    if (minute > minuteHead) {
+        std::unordered_set<std::string> affected;
+        if (minute - minuteHead >= static_cast<long long>(MINUTE_BUCKETS)) {
+            // 整个小时窗口都已过期
+            for (auto& bucket : minuteBuckets) {
+                if (bucket.slot >= 0) {
+                    expireFromWindow(LeaderboardWindow::HOUR, bucket, affected);
+                }
+                resetBucket(bucket, -1);
+            }
+        } else {
+            for (long long slot = minuteHead + 1; slot <= minute; ++slot) {
+                Bucket& bucket = minuteBuckets[slot % MINUTE_BUCKETS];
+                if (bucket.slot >= 0) {
+                    expireFromWindow(LeaderboardWindow::HOUR, bucket, affected);
+                }
+                resetBucket(bucket, slot);
+            }
+        }
+        minuteHead = minute;
+        rebuildBoards(LeaderboardWindow::HOUR, affected);
+    }
+
+    if (hour > hourHead) {
+        std::unordered_set<std::string> dayAffected;
+        std::unordered_set<std::string> weekAffected;
+        for (long long slot = hourHead + 1; slot <= hour; ++slot) {
+            // 滚出一天窗口的小时桶
+            long long leaving = slot - static_cast<long long>(DAY_HOURS);
+            if (leaving >= 0 && hourBuckets[leaving % HOUR_BUCKETS].slot == leaving) {
+                expireFromWindow(LeaderboardWindow::DAY, hourBuckets[leaving % HOUR_BUCKETS], dayAffected);
+            }
+            // 被复用的小时桶滚出一周窗口
+            Bucket& bucket = hourBuckets[slot % HOUR_BUCKETS];
+            if (bucket.slot >= 0) {
+                expireFromWindow(LeaderboardWindow::WEEK, bucket, weekAffected);
+            }
+            resetBucket(bucket, slot);
+        }
+        hourHead = hour;
+        rebuildBoards(LeaderboardWindow::DAY, dayAffected);
+        rebuildBoards(LeaderboardWindow::WEEK, weekAffected);
+    }
+}
+
+/**
+ * @brief 把一笔销量计入所在的桶和窗口
+ */
+void TopSellerLeaderboard::recordLocked(const std::string& itemId, long long quantity, time_t time) {
+    if (quantity <= 0) {
+        return;
+    }
+    long long minute = static_cast<long long>(time) / 60;
+    long long hour = static_cast<long long>(time) / 3600;
+
+    if (minute > minuteHead - static_cast<long long>(MINUTE_BUCKETS) && minute <= minuteHead) {
+        Bucket& bucket = minuteBuckets[minute % MINUTE_BUCKETS];
+        if (bucket.slot != minute) {
+            resetBucket(bucket, minute);
+        }
+        if (useSketch) {
+            sketchAdd(bucket.cells, itemId, quantity);
+        } else {
+            bucket.counts[itemId] += quantity;
+        }
+        addToWindow(LeaderboardWindow::HOUR, itemId, quantity);
+    }
+
+    if (hour > hourHead - static_cast<long long>(HOUR_BUCKETS) && hour <= hourHead) {
+        Bucket& bucket = hourBuckets[hour % HOUR_BUCKETS];
+        if (bucket.slot != hour) {
+            resetBucket(bucket, hour);
+        }
+        if (useSketch) {
+            sketchAdd(bucket.cells, itemId, quantity);
+        } else {
+            bucket.counts[itemId] += quantity;
+        }
+        if (hour > hourHead - static_cast<long long>(DAY_HOURS)) {
+            addToWindow(LeaderboardWindow::DAY, itemId, quantity);
+        }
+        addToWindow(LeaderboardWindow::WEEK, itemId, quantity);
+    }
+}
+
+/**
+ * @brief 记录一笔销量
+ */
+void TopSellerLeaderboard::record(const std::string& itemId, long long quantity, time_t time) {
+    std::lock_guard<std::mutex> lock(mutex);
+    advance(time);
+    recordLocked(itemId, quantity, time);
+}
+
+/**
+ * @brief 用历史订单预热
+ *
+ * 先把时间推进到当前，再逐笔计入；早于一周的订单被忽略，订单不必按时间排序
+ */
+void TopSellerLeaderboard::seed(const std::vector<std::shared_ptr<Order>>& orders) {
+    std::lock_guard<std::mutex> lock(mutex);
+    time_t now = time(nullptr);
+    advance(now);
+    for (const auto& order : orders) {
+        if (order->getOrderTime() > now) {
+            continue;
+        }
+        for (const auto& orderItem : order->getItems()) {
+            recordLocked(orderItem.itemId, orderItem.quantity, order->getOrderTime());
+        }
+    }
+}
+
+/**
+ * @brief 订单创建事件
+ */
+void TopSellerLeaderboard::onOrderCreated(const Order& order) {
+    std::lock_guard<std::mutex> lock(mutex);
+    advance(order.getOrderTime());
+    for (const auto& orderItem : order.getItems()) {
+        recordLocked(orderItem.itemId, orderItem.quantity, order.getOrderTime());
+    }
+}
+
+/**
+ * @brief 获取热销排行
+ */
+std::vector<LeaderboardEntry> TopSellerLeaderboard::top(LeaderboardWindow window, const std::string& category,
+                                                        size_t limit) {
+    std::lock_guard<std::mutex> lock(mutex);
+    advance(time(nullptr));
+
+    WindowState& state = windows[windowIndex(window)];
+    auto it = state.boards.find(category);
+    if (it == state.boards.end()) {
+        return {};
+    }
+
+    Board& board = it->second;
+    if (!board.snapshotValid) {
+        std::vector<std::pair<long long, std::string>> sorted(board.heap);
+        std::sort(sorted.begin(), sorted.end(),
+                  [](const std::pair<long long, std::string>& a, const std::pair<long long, std::string>& b) {
+                      return entryLess(b, a);
+                  });
+        board.snapshot.clear();
+        for (const auto& entry : sorted) {
+            board.snapshot.push_back(LeaderboardEntry{entry.second, entry.first});
+        }
+        board.snapshotValid = true;
+    }
+    size_t count = std::min(std::min(limit, topK), board.snapshot.size());
+    return std::vector<LeaderboardEntry>(board.snapshot.begin(), board.snapshot.begin() + count);
+}
+
+/**
+ * @brief 获取窗口的显示名称
+ */
+std::string TopSellerLeaderboard::windowToString(LeaderboardWindow window) {
+    switch (window) {
+        case LeaderboardWindow::HOUR: return "最近一小时";
+        case LeaderboardWindow::DAY:  return "最近一天";
+        case LeaderboardWindow::WEEK: return "最近一周";
+        default: return "未知";
+    }
+}
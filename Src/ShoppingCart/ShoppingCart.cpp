@@ -14,14 +14,14 @@
  * @brief 默认构造函数实现
  */
 ShoppingCart::ShoppingCart() 
-    : owner(nullptr) {
+    : owner(nullptr), cachedTotalPrice(0.0), totalPriceValid(false) {
 }
 
 /**
  * @brief 构造函数实现
  */
 ShoppingCart::ShoppingCart(std::shared_ptr<Customer> owner)
-    : owner(owner) {
+    : owner(owner), cachedTotalPrice(0.0), totalPriceValid(false) {
 }
 
 /**
@@ -29,7 +29,17 @@ ShoppingCart::ShoppingCart(std::shared_ptr<Customer> owner)
  */
 ShoppingCart::ShoppingCart(std::shared_ptr<Customer> owner, 
                            const std::vector<std::pair<std::shared_ptr<Item>, int>>& items)
-    : owner(owner), cartItems(items) {
+    : owner(owner), cartItems(items), cachedTotalPrice(0.0), totalPriceValid(false) {
+}
+
+/**
+ * @brief 通知商品增删并使总价缓存失效
+ */
+void ShoppingCart::notifyMembership(const std::string& itemId, bool inCart) {
+    totalPriceValid = false;
+    if (membershipListener) {
+        membershipListener(itemId, inCart);
+    }
 }
 
 /**
@@ -91,6 +101,7 @@ bool ShoppingCart::addItem(std::shared_ptr<Item> item, int quantity) {
             }
             
             it->second = newQuantity;
+            totalPriceValid = false;
             std::cout << "成功！商品数量已更新为：" << newQuantity << std::endl;
             return true;
         } else {
@@ -100,6 +111,7 @@ bool ShoppingCart::addItem(std::shared_ptr<Item> item, int quantity) {
     } else {
         // 商品不存在，直接添加
         cartItems.push_back(std::make_pair(item, quantity));
+        notifyMembership(item->getItemId(), true);
         std::cout << "成功添加商品\"" << item->getItemName() << "\"到购物车，数量：" << quantity << std::endl;
         return true;
     }
@@ -114,6 +126,7 @@ bool ShoppingCart::removeItem(const std::string& itemId) {
     if (it != cartItems.end()) {
         std::string itemName = it->first->getItemName();
         cartItems.erase(it);
+        notifyMembership(itemId, false);
         std::cout << "成功从购物车中删除商品：" << itemName << std::endl;
         return true;
     } else {
@@ -161,6 +174,7 @@ bool ShoppingCart::updateItemQuantity(const std::string& itemId, int newQuantity
         if (choice == 'y' || choice == 'Y') {
             std::string itemName = it->first->getItemName();
             cartItems.erase(it);
+            notifyMembership(itemId, false);
             std::cout << "已删除商品：" << itemName << std::endl;
             return true;
         } else {
@@ -184,6 +198,7 @@ bool ShoppingCart::updateItemQuantity(const std::string& itemId, int newQuantity
     // 更新数量
     int oldQuantity = it->second;
     it->second = newQuantity;
+    totalPriceValid = false;
     std::cout << "成功更新商品\"" << it->first->getItemName() 
               << "\"的数量：" << oldQuantity << " -> " << newQuantity << std::endl;
     return true;
@@ -255,13 +270,19 @@ int ShoppingCart::getTotalItemCount() const {
 }
 
 /**
- * @brief 计算购物车中商品的总价格
+ * @brief 计算购物车中商品的总价格（使用缓存）
  */
 double ShoppingCart::getTotalPrice() const {
+    if (totalPriceValid) {
+        return cachedTotalPrice;
+    }
+    
     double totalPrice = 0.0;
     for (const auto& pair : cartItems) {
         totalPrice += pair.first->getPrice() * pair.second;
     }
+    cachedTotalPrice = totalPrice;
+    totalPriceValid = true;
     return totalPrice;
 }
 
@@ -269,7 +290,11 @@ double ShoppingCart::getTotalPrice() const {
  * @brief 清空购物车
  */
 void ShoppingCart::clear() {
-    cartItems.clear();
+    std::vector<std::pair<std::shared_ptr<Item>, int>> removed;
+    removed.swap(cartItems);
+    for (const auto& pair : removed) {
+        notifyMembership(pair.first->getItemId(), false);
+    }
     std::cout << "购物车已清空！" << std::endl;
 }
 
@@ -279,9 +304,23 @@ void ShoppingCart::clear() {
 void ShoppingCart::addItemDirect(std::shared_ptr<Item> item, int quantity) {
     if (item && quantity > 0) {
         cartItems.push_back(std::make_pair(item, quantity));
+        notifyMembership(item->getItemId(), true);
     }
 }
 
+/**
+ * @brief 从购物车中移除商品，不产生输出
+ */
+bool ShoppingCart::discardItem(const std::string& itemId) {
+    auto it = findItemById(itemId);
+    if (it == cartItems.end()) {
+        return false;
+    }
+    cartItems.erase(it);
+    notifyMembership(itemId, false);
+    return true;
+}
+
 /**
  * @brief 析构函数
  */
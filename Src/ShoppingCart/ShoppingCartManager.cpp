@@ -6,6 +6,7 @@
  */
 
 #include "ShoppingCart/ShoppingCartManager.h"
+#include "Log/Logger.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -17,6 +18,62 @@
 ShoppingCartManager::ShoppingCartManager(const std::string& filePath, 
                                          std::shared_ptr<IItemRepository> itemMgr)
     : filePath(filePath), itemManager(itemMgr) {
+    if (itemManager) {
+        itemManager->addChangeListener(this);
+    }
+}
+
+/**
+ * @brief 设置商品管理器
+ */
+void ShoppingCartManager::setItemManager(std::shared_ptr<IItemRepository> itemMgr) {
+    if (itemManager) {
+        itemManager->removeChangeListener(this);
+    }
+    itemManager = itemMgr;
+    if (itemManager) {
+        itemManager->addChangeListener(this);
+    }
+}
+
+/**
+ * @brief 更新反向索引中的一条关系
+ */
+void ShoppingCartManager::updateReverseIndex(const std::string& itemId, const std::string& username, bool inCart) {
+    if (inCart) {
+        cartsByItem[itemId].insert(username);
+        return;
+    }
+    
+    auto it = cartsByItem.find(itemId);
+    if (it != cartsByItem.end()) {
+        it->second.erase(username);
+        if (it->second.empty()) {
+            cartsByItem.erase(it);
+        }
+    }
+}
+
+/**
+ * @brief 把购物车接入反向索引
+ */
+void ShoppingCartManager::attachCart(const std::string& username, const std::shared_ptr<ShoppingCart>& cart) {
+    for (const auto& pair : cart->getCartItems()) {
+        updateReverseIndex(pair.first->getItemId(), username, true);
+    }
+    cart->setMembershipListener([this, username](const std::string& itemId, bool inCart) {
+        updateReverseIndex(itemId, username, inCart);
+    });
+}
+
+/**
+ * @brief 从反向索引中移除购物车
+ */
+void ShoppingCartManager::detachCart(const std::string& username, const std::shared_ptr<ShoppingCart>& cart) {
+    cart->setMembershipListener(nullptr);
+    for (const auto& pair : cart->getCartItems()) {
+        updateReverseIndex(pair.first->getItemId(), username, false);
+    }
 }
 
 /**
@@ -70,7 +127,7 @@ std::vector<int> ShoppingCartManager::parseArrayString(const std::string& arrayS
             try {
                 result.push_back(std::stoi(item));
             } catch (const std::exception& e) {
-                std::cerr << "解析数字失败: " << item << std::endl;
+                Logger::getInstance()->warn("ShoppingCartManager", "解析数字失败", {{"value", item}});
             }
         }
     }
@@ -109,12 +166,16 @@ std::string ShoppingCartManager::vectorToArrayString(const std::vector<int>& vec
 bool ShoppingCartManager::loadFromFile() {
     std::ifstream file(filePath);
     if (!file.is_open()) {
-        std::cout << "购物车数据文件不存在，将创建新文件。" << std::endl;
+        Logger::getInstance()->info("ShoppingCartManager", "购物车数据文件不存在，将创建新文件", {{"path", filePath}});
         return true;
     }
     
     // 清空现有数据
+    for (const auto& pair : carts) {
+        pair.second->setMembershipListener(nullptr);
+    }
     carts.clear();
+    cartsByItem.clear();
     
     std::string line;
     bool isFirstLine = true;
@@ -156,13 +217,13 @@ bool ShoppingCartManager::loadFromFile() {
         
         // 检查两个数组长度是否一致
         if (itemIds.size() != quantities.size()) {
-            std::cerr << "警告：用户 " << username << " 的购物车数据不一致，跳过。" << std::endl;
+            Logger::getInstance()->warn("ShoppingCartManager", "购物车数据不一致，跳过", {{"user", username}});
             continue;
         }
         
         // 创建购物车并添加商品
         if (!itemManager) {
-            std::cerr << "错误：商品管理器未初始化！" << std::endl;
+            Logger::getInstance()->error("ShoppingCartManager", "商品管理器未初始化");
             file.close();
             return false;
         }
@@ -180,17 +241,24 @@ bool ShoppingCartManager::loadFromFile() {
                 // 直接添加商品（不进行重复检查）
                 cart->addItemDirect(item, quantities[i]);
             } else {
-                std::cerr << "警告：商品ID " << itemId << " 不存在，跳过。" << std::endl;
+                Logger::getInstance()->warn("ShoppingCartManager", "购物车中的商品不存在，跳过",
+                                            {{"user", username}, {"item_id", itemId}});
             }
         }
         
         // 将购物车添加到管理器
+        auto existing = carts.find(username);
+        if (existing != carts.end()) {
+            detachCart(username, existing->second);
+        }
         carts[username] = cart;
+        attachCart(username, cart);
     }
     
     file.close();
     
-    std::cout << "成功加载 " << carts.size() << " 个购物车数据。" << std::endl;
+    Logger::getInstance()->info("ShoppingCartManager", "成功加载购物车数据",
+                                {{"count", std::to_string(carts.size())}, {"path", filePath}});
     return true;
 }
 
@@ -200,7 +268,7 @@ bool ShoppingCartManager::loadFromFile() {
 bool ShoppingCartManager::saveToFile() {
     std::ofstream file(filePath);
     if (!file.is_open()) {
-        std::cerr << "无法打开文件进行写入: " << filePath << std::endl;
+        Logger::getInstance()->error("ShoppingCartManager", "无法打开文件进行写入", {{"path", filePath}});
         return false;
     }
     
@@ -239,7 +307,7 @@ bool ShoppingCartManager::saveToFile() {
     }
     
     file.close();
-    std::cout << "购物车数据已保存到文件。" << std::endl;
+    Logger::getInstance()->debug("ShoppingCartManager", "购物车数据已保存到文件", {{"path", filePath}});
     return true;
 }
 
@@ -259,6 +327,7 @@ std::shared_ptr<ShoppingCart> ShoppingCartManager::getCart(const std::string& us
         // 创建新的购物车
         auto newCart = std::make_shared<ShoppingCart>(customer);
         carts[username] = newCart;
+        attachCart(username, newCart);
         return newCart;
     }
 }
@@ -270,6 +339,19 @@ bool ShoppingCartManager::hasCart(const std::string& username) const {
     return carts.find(username) != carts.end();
 }
 
+/**
+ * @brief 获取所有非空购物车
+ */
+std::vector<std::shared_ptr<ShoppingCart>> ShoppingCartManager::getAllCarts() const {
+    std::vector<std::shared_ptr<ShoppingCart>> result;
+    for (const auto& pair : carts) {
+        if (!pair.second->isEmpty()) {
+            result.push_back(pair.second);
+        }
+    }
+    return result;
+}
+
 /**
  * @brief 删除指定用户的购物车
  */
@@ -277,11 +359,12 @@ bool ShoppingCartManager::removeCart(const std::string& username) {
     auto it = carts.find(username);
     
     if (it != carts.end()) {
+        detachCart(username, it->second);
         carts.erase(it);
-        std::cout << "已删除用户 " << username << " 的购物车。" << std::endl;
+        Logger::getInstance()->info("ShoppingCartManager", "已删除用户购物车", {{"user", username}});
         return true;
     } else {
-        std::cout << "用户 " << username << " 没有购物车。" << std::endl;
+        Logger::getInstance()->debug("ShoppingCartManager", "用户没有购物车", {{"user", username}});
         return false;
     }
 }
@@ -290,13 +373,80 @@ bool ShoppingCartManager::removeCart(const std::string& username) {
  * @brief 清空所有购物车
  */
 void ShoppingCartManager::clearAllCarts() {
+    for (const auto& pair : carts) {
+        pair.second->setMembershipListener(nullptr);
+    }
     carts.clear();
-    std::cout << "已清空所有购物车。" << std::endl;
+    cartsByItem.clear();
+    Logger::getInstance()->info("ShoppingCartManager", "已清空所有购物车");
+}
+
+/**
+ * @brief 统计购物车中有指定商品的用户数
+ */
+size_t ShoppingCartManager::countCartsContaining(const std::string& itemId) const {
+    auto it = cartsByItem.find(itemId);
+    return it == cartsByItem.end() ? 0 : it->second.size();
+}
+
+/**
+ * @brief 获取购物车中有指定商品的用户
+ */
+std::vector<std::string> ShoppingCartManager::getCartsContaining(const std::string& itemId) const {
+    auto it = cartsByItem.find(itemId);
+    if (it == cartsByItem.end()) {
+        return {};
+    }
+    return std::vector<std::string>(it->second.begin(), it->second.end());
+}
+
+/**
+ * @brief 响应商品变更
+ * 
+ * 通过反向索引只访问受影响的购物车，不扫描全部购物车
+ */
+void ShoppingCartManager::onItemsChanged(const std::vector<std::string>& itemIds, ItemChangeKind kind) {
+    if (kind == ItemChangeKind::REMOVED) {
+        size_t affected = 0;
+        for (const auto& itemId : itemIds) {
+            // 先复制用户列表，清理时回调会修改反向索引
+            for (const auto& username : getCartsContaining(itemId)) {
+                auto cartIt = carts.find(username);
+                if (cartIt != carts.end() && cartIt->second->discardItem(itemId)) {
+                    ++affected;
+                }
+            }
+        }
+        if (affected > 0) {
+            saveToFile();
+            Logger::getInstance()->info("ShoppingCartManager", "已从购物车中清理下架商品",
+                                        {{"items", std::to_string(itemIds.size())},
+                                         {"carts", std::to_string(affected)}});
+        }
+    } else if (kind == ItemChangeKind::PRICE) {
+        for (const auto& itemId : itemIds) {
+            auto it = cartsByItem.find(itemId);
+            if (it == cartsByItem.end()) {
+                continue;
+            }
+            for (const auto& username : it->second) {
+                auto cartIt = carts.find(username);
+                if (cartIt != carts.end()) {
+                    cartIt->second->invalidatePriceCache();
+                }
+            }
+        }
+    }
 }
 
 /**
  * @brief 析构函数
  */
 ShoppingCartManager::~ShoppingCartManager() {
-    // 清理资源
+    if (itemManager) {
+        itemManager->removeChangeListener(this);
+    }
+    for (const auto& pair : carts) {
+        pair.second->setMembershipListener(nullptr);
+    }
 }
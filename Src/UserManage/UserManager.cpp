@@ -6,6 +6,7 @@
  */
 
 #include "UserManage/UserManager.h"
+#include "Log/Logger.h"
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -57,7 +58,7 @@ bool UserManager::loadFromFile() {
     std::ifstream file(filePath);
     if (!file.is_open()) {
         // 文件不存在时不报错，创建空列表
-        std::cout << "用户数据文件不存在，将创建新文件。" << std::endl;
+        Logger::getInstance()->info("UserManager", "用户数据文件不存在，将创建新文件", {{"path", filePath}});
         return true;
     }
     
@@ -66,6 +67,7 @@ bool UserManager::loadFromFile() {
     
     // 清空现有数据
     customers.clear();
+    usernameIndex.clear();
     
     // 逐行读取文件
     while (std::getline(file, line)) {
@@ -86,11 +88,13 @@ bool UserManager::loadFromFile() {
             // 创建Customer对象并添加到列表
             auto customer = std::make_shared<Customer>(fields[0], fields[1], fields[2]);
             customers.push_back(customer);
+            usernameIndex[customer->getUsername()] = customer;
         }
     }
     
     file.close();
-    std::cout << "成功加载 " << customers.size() << " 个用户数据。" << std::endl;
+    Logger::getInstance()->info("UserManager", "成功加载用户数据",
+                                {{"count", std::to_string(customers.size())}, {"path", filePath}});
     return true;
 }
 
@@ -100,7 +104,7 @@ bool UserManager::loadFromFile() {
 bool UserManager::saveToFile() {
     std::ofstream file(filePath);
     if (!file.is_open()) {
-        std::cerr << "无法打开文件进行写入: " << filePath << std::endl;
+        Logger::getInstance()->error("UserManager", "无法打开文件进行写入", {{"path", filePath}});
         return false;
     }
     
@@ -129,6 +133,7 @@ bool UserManager::addCustomer(std::shared_ptr<Customer> customer) {
     
     // 添加到列表
     customers.push_back(customer);
+    usernameIndex[customer->getUsername()] = customer;
     
     // 保存到文件
     return saveToFile();
@@ -138,14 +143,9 @@ bool UserManager::addCustomer(std::shared_ptr<Customer> customer) {
  * @brief 根据用户名查找顾客
  */
 std::shared_ptr<Customer> UserManager::findCustomer(const std::string& username) {
-    // 使用lambda表达式查找用户
-    auto it = std::find_if(customers.begin(), customers.end(),
-        [&username](const std::shared_ptr<Customer>& c) {
-            return c->getUsername() == username;
-        });
-    
-    if (it != customers.end()) {
-        return *it;
+    auto it = usernameIndex.find(username);
+    if (it != usernameIndex.end()) {
+        return it->second;
     }
     
     return nullptr;
@@ -175,6 +175,41 @@ bool UserManager::updatePassword(const std::string& username, const std::string&
     return saveToFile();
 }
 
+/**
+ * @brief 按用户名分页查询顾客
+ */
+ListPage<CustomerRow> UserManager::queryCustomerPage(const std::string& cursor, bool descending,
+                                                     size_t limit) const {
+    ListPage<CustomerRow> page;
+    page.totalCount = usernameIndex.size();
+    
+    auto appendRow = [&page](const std::shared_ptr<Customer>& customer) {
+        page.rows.push_back(CustomerRow{customer->getUsername(), customer->getPassword(),
+                                        customer->getPhone()});
+    };
+    
+    if (!descending) {
+        auto it = cursor.empty() ? usernameIndex.begin() : usernameIndex.upper_bound(cursor);
+        for (; it != usernameIndex.end() && page.rows.size() < limit; ++it) {
+            appendRow(it->second);
+        }
+        if (it != usernameIndex.end() && !page.rows.empty()) {
+            page.nextCursor = page.rows.back().username;
+        }
+    } else {
+        auto it = cursor.empty() ? usernameIndex.end() : usernameIndex.lower_bound(cursor);
+        while (it != usernameIndex.begin() && page.rows.size() < limit) {
+            --it;
+            appendRow(it->second);
+        }
+        if (it != usernameIndex.begin() && !page.rows.empty()) {
+            page.nextCursor = page.rows.back().username;
+        }
+    }
+    
+    return page;
+}
+
 /**
  * @brief 析构函数
  */